@@ -4,6 +4,8 @@
 #include <kyros/evidence.hpp>
 #include <kyros/types.hpp>
 
+#include <map>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -16,6 +18,7 @@ struct Candidate {
     // Process information (for stdio transport)
     int pid = 0;
     std::string command;
+    std::vector<std::string> argv;  // Unjoined command line, when the platform provides it
     std::string process_name;
     int parent_pid = 0;
     std::map<std::string, std::string> environment;
@@ -28,6 +31,7 @@ struct Candidate {
     std::string url;
     std::string address;
     int port = 0;
+    std::string socket_protocol;  // Listener protocol: "tcp" or "udp"
 
     // Container information (if applicable)
     std::optional<DockerContainer> docker_container;
@@ -27,8 +27,20 @@ struct PassiveScanConfig {
     // Performance
     int max_candidates = 1000;
 
+    // Run the detection engines concurrently (one thread each). Results
+    // are merged in engine order either way.
+    bool parallel_engines = true;
+
     // Config file paths (empty = use defaults)
     std::vector<std::string> additional_config_paths;
+
+    // Keep file watches on config locations between scans and re-parse
+    // only files that changed (for long-running scanners such as the daemon)
+    bool watch_configs = false;
+
+    // Reload rulepack files from a background thread when they change;
+    // scans keep the rules they started with (platforms with a FileWatcher)
+    bool watch_rulepacks = false;
 };
 
 /**
@@ -48,6 +60,9 @@ struct InterrogationConfig {
     int max_resources = 100;
     int max_prompts = 50;
 
+    // Pages followed per list through nextCursor
+    int max_pages = 10;
+
     // Timeout for each interrogation request
     std::chrono::milliseconds timeout{5000};
 };
@@ -69,6 +84,29 @@ struct ActiveScanConfig {
     bool require_confirmation = false;
     std::vector<int> skip_pids;
     std::vector<std::string> skip_urls;
+
+    // Adaptive probe deadlines (LatencyTracker): a candidate whose endpoint
+    // has answered before gets latency_headroom times its p99 handshake
+    // latency, within [min_probe_timeout_ms, probe_timeout_ms], and is
+    // hedged at the p99: an HTTP probe still unanswered there is sent
+    // again and the first answer wins (stdio probes are not repeated).
+    // Endpoints that never answered get probe_timeout_ms, halved per
+    // timeout in a row but not below what their transport's p99 gives.
+    bool adaptive_timeouts = true;
+    int min_probe_timeout_ms = 250;
+    double latency_headroom = 3.0;
+    std::string latency_history_path;  // Kept in memory only while empty
+
+    // Sniff listener candidates before probing (Preflight), dropping UDP
+    // listeners, dual-stack duplicates and endpoints that do not speak HTTP
+    bool preflight = true;
+    int preflight_timeout_ms = 200;
+
+    // Probe result cache (ProbeCache); off while the path is empty
+    std::string probe_cache_path;
+    bool refresh_probe_cache = false;  // Probe everything, then rewrite the entries probed
+    int probe_cache_ttl_seconds = 3600;
+    int probe_cache_failure_ttl_seconds = 300;
 };
 
 /**
@@ -105,6 +143,9 @@ struct ActiveScanResults {
     int candidates_tested_count = 0;
     int servers_confirmed_count = 0;
     int tests_failed_count = 0;
+    int cached_results_count = 0;  // Outcomes taken from the probe cache
+    int preflight_filtered_count = 0;  // Listeners failed by the preflight, not probed
+    int hedged_probes_count = 0;  // Probes sent again at their hedge point
     double scan_duration_seconds = 0.0;
     Timestamp scan_timestamp;
 
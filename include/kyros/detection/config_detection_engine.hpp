@@ -3,7 +3,9 @@
 
 #include <kyros/detection/detection_engine.hpp>
 #include <kyros/scan_types/config_scan.hpp>
+#include <kyros/platform/file_watcher.hpp>
 
+#include <memory>
 #include <nlohmann/json.hpp>
 
 namespace kyros {
@@ -24,20 +26,52 @@ public:
     std::string name() const override { return "ConfigDetectionEngine"; }
     std::vector<Candidate> detect() override;
 
+    // Watch mode: keep watches on config locations between scans and
+    // re-parse only files that changed. Falls back to full scans on
+    // platforms without a FileWatcher.
+    void set_watch_mode(bool enabled);
+    bool watch_mode() const { return watch_mode_; }
+
+    // Block up to timeout_ms for a config change (watch mode only). Lets a
+    // scheduler trigger a scan as soon as a server is added.
+    bool wait_for_changes(int timeout_ms);
+
     // Get statistics from last scan
     int get_last_scan_config_count() const { return last_scan_config_count_; }
+    int get_last_scan_parsed_count() const { return last_scan_parsed_count_; }
 
 private:
+    // Result of the last read of one configured path
+    struct ConfigEntry {
+        std::string source_path;    // As configured (may contain ~ or $VARS)
+        std::string expanded_path;
+        bool exists = false;
+        std::vector<Candidate> candidates;
+    };
+
     std::shared_ptr<ConfigScan> scan_type_;
 
+    bool watch_mode_ = false;
+    std::unique_ptr<FileWatcher> watcher_;
+    bool watches_primed_ = false;         // Cache is complete and watches are in place
+    bool pending_overflow_ = false;
+    std::vector<std::string> pending_changes_;
+    std::vector<ConfigEntry> config_cache_;
+    std::vector<std::string> extension_bases_;
+    std::vector<Candidate> extension_cache_;
+
     // Helper methods
     std::vector<ServerConfig> parse_config_file(const std::string& path);
     Candidate create_candidate_from_config(const ServerConfig& config,
                                           const std::string& config_path);
     std::vector<Candidate> scan_claude_extensions();
+    void refresh_config_entry(const std::string& path, ConfigEntry& entry);
+    void watch_parent_of(const std::string& path);
+    static bool is_affected(const std::string& path, const std::vector<std::string>& changed);
 
     // Statistics from last scan
     int last_scan_config_count_ = 0;
+    int last_scan_parsed_count_ = 0;
 };
 
 } // namespace kyros
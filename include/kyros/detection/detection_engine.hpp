@@ -33,10 +33,25 @@ public:
         platform_ = adapter;
     }
 
+    // Share one process snapshot between engines for the duration of a scan.
+    // Pass nullptr to go back to taking a fresh snapshot per detect().
+    void set_process_snapshot(std::shared_ptr<const ProcessTable> snapshot) {
+        snapshot_ = std::move(snapshot);
+    }
+
 protected:
     DetectionEngine() = default;
     std::shared_ptr<PlatformAdapter> platform_;
 
+    // Process table for the current scan: the shared snapshot when one was
+    // set, otherwise a fresh one from the platform adapter
+    std::shared_ptr<const ProcessTable> process_snapshot() const {
+        if (snapshot_) {
+            return snapshot_;
+        }
+        return platform_ ? platform_->snapshot_processes() : nullptr;
+    }
+
     // Helper to create evidence
     Evidence make_evidence(const std::string& type,
                           const std::string& description,
@@ -44,6 +59,9 @@ protected:
                           const std::string& source = "") const {
         return Evidence(type, description, confidence, source);
     }
+
+private:
+    std::shared_ptr<const ProcessTable> snapshot_;
 };
 
 } // namespace kyros
@@ -2,6 +2,10 @@
 #define KYROS_PROCESS_DETECTION_ENGINE_HPP
 
 #include <kyros/detection/detection_engine.hpp>
+#include <kyros/platform/environ_scanner.hpp>
+
+#include <cstdint>
+#include <unordered_map>
 
 namespace kyros {
 
@@ -13,14 +17,43 @@ public:
     // Get statistics from last scan
     int get_last_scan_process_count() const { return last_scan_process_count_; }
 
+    // Processes that were new or changed (exec'd) since the previous scan
+    int get_last_scan_evaluated_count() const { return last_scan_evaluated_count_; }
+
+    // Environment variable prefixes to report in addition to the built-in
+    // MCP_, ANTHROPIC_ and CLAUDE_ (typically from loaded rulepacks)
+    void set_environment_prefixes(const std::vector<std::string>& extra_prefixes);
+
 private:
+    // Per-process results kept between scans, keyed by PID and validated
+    // against the process' start time, exec count and command line
+    struct CachedProcess {
+        uint64_t start_time = 0;
+        uint32_t exec_count = 0;
+        size_t command_hash = 0;
+        std::vector<Evidence> environment_evidence;
+    };
+
     // Helper methods for detection
-    void check_parent_process(int pid, Candidate& candidate);
-    void check_file_descriptors(int pid, Candidate& candidate);
-    void check_environment(int pid, Candidate& candidate);
+    void check_parent_process(const ProcessTable& table, size_t row, Candidate& candidate);
+    void check_file_descriptors(const ProcessTable& table, const PipeIndex* pipes,
+                                int pid, Candidate& candidate);
+    void check_environment(const ProcessTable& table, size_t row, Candidate& candidate,
+                           std::unordered_map<int, CachedProcess>& next_cache);
+    std::vector<Evidence> read_environment_evidence(int pid);
+
+    static bool is_known_client(const std::string& name);
 
     // Statistics from last scan
     int last_scan_process_count_ = 0;
+    int last_scan_evaluated_count_ = 0;
+
+    std::unordered_map<int, CachedProcess> process_cache_;
+
+    // Environment matching, reused across processes
+    EnvironScanner environ_scanner_;
+    std::string environ_block_;
+    std::vector<EnvironMatch> environ_matches_;
 };
 
 } // namespace kyros
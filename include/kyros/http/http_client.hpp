@@ -1,9 +1,14 @@
 #ifndef KYROS_HTTP_CLIENT_HPP
 #define KYROS_HTTP_CLIENT_HPP
 
+#include <atomic>
 #include <chrono>
+#include <functional>
 #include <map>
+#include <memory>
 #include <string>
+#include <string_view>
+#include <vector>
 
 namespace kyros {
 
@@ -16,15 +21,79 @@ struct HttpResponse {
     std::map<std::string, std::string> headers;
     bool success = false;
     std::string error_message;
+    bool timed_out = false;  // Failed because the timeout ran out (not cancelled)
+};
+
+/**
+ * Cancels in-flight requests of the clients it is attached to
+ *
+ * Backed by a pipe that becomes readable on cancel(), so a request
+ * blocked in poll() wakes at once rather than at its deadline. Safe to
+ * cancel from any thread.
+ */
+class HttpCancelToken {
+public:
+    HttpCancelToken();
+    ~HttpCancelToken();
+
+    HttpCancelToken(const HttpCancelToken&) = delete;
+    HttpCancelToken& operator=(const HttpCancelToken&) = delete;
+
+    void cancel();
+    bool cancelled() const { return cancelled_; }
+
+    // Readable once cancelled
+    int fd() const { return pipe_[0]; }
+
+private:
+    int pipe_[2];
+    std::atomic<bool> cancelled_{false};
 };
 
 /**
  * HTTP client for MCP server communication
+ *
+ * Plain http:// requests are made in-process over non-blocking sockets
+ * with millisecond deadlines, and connections are kept alive in a small
+ * per-host:port pool so consecutive probes of one server (SSE, the
+ * fallback paths, interrogation) share a TCP connection. https:// is
+ * still delegated to curl.
+ *
+ * A text/event-stream response never ends on its own; the body is
+ * returned once the first event has arrived, or whatever arrived by the
+ * deadline, and that connection is not reused.
+ *
+ * A body handler can consume a response while it arrives instead; the
+ * body limit does not apply to it, and a connection whose body it left
+ * unread is closed rather than reused.
+ *
+ * Not thread-safe: each probe worker owns its own client.
  */
 class HttpClient {
 public:
+    // Idle connections kept per host:port
+    static constexpr size_t kMaxIdlePerHost = 4;
+
+    // Larger response heads or bodies fail the request (the body limit
+    // is the default of set_max_body_bytes())
+    static constexpr size_t kMaxHeadBytes = 64 * 1024;
+    static constexpr size_t kMaxBodyBytes = 16 * 1024 * 1024;
+
+    // The next piece of a body as it arrives, an empty view at its end.
+    // The view is valid until the next call. Throws if the read fails.
+    using BodyReader = std::function<std::string_view()>;
+
+    // Consumes a body through the reader, given the response head (status
+    // and headers). Not called for bodiless or text/event-stream responses,
+    // which are returned as usual. An exception fails the request with its
+    // message.
+    using BodyHandler = std::function<void(const HttpResponse& head, const BodyReader& read)>;
+
     HttpClient() = default;
-    ~HttpClient() = default;
+    ~HttpClient();
+
+    HttpClient(const HttpClient&) = delete;
+    HttpClient& operator=(const HttpClient&) = delete;
 
     /**
      * Send HTTP POST request
@@ -39,6 +108,14 @@ public:
                      const std::map<std::string, std::string>& headers = {},
                      std::chrono::milliseconds timeout = std::chrono::milliseconds(5000));
 
+    // POST with the body passed to `handler` as it arrives; the returned
+    // response then has an empty body. An empty handler reads it whole.
+    HttpResponse post(const std::string& url,
+                      const std::string& body,
+                      const std::map<std::string, std::string>& headers,
+                      std::chrono::milliseconds timeout,
+                      const BodyHandler& handler);
+
     /**
      * Send HTTP GET request
      * @param url The target URL
@@ -50,6 +127,23 @@ public:
                     const std::map<std::string, std::string>& headers = {},
                     std::chrono::milliseconds timeout = std::chrono::milliseconds(5000));
 
+    // Pooled keep-alive connections, across all hosts
+    size_t idle_connections() const;
+
+    // Move other's pooled connections into this client's pool
+    void adopt_idle_connections(HttpClient& other);
+
+    // Requests fail with "Request cancelled" once the token is cancelled;
+    // nullptr detaches it
+    void set_cancel_token(std::shared_ptr<HttpCancelToken> token) { cancel_token_ = std::move(token); }
+
+    // Close every pooled connection
+    void close_idle_connections();
+
+    // Largest response body accepted over plain http://
+    void set_max_body_bytes(size_t bytes) { max_body_bytes_ = bytes; }
+    size_t max_body_bytes() const { return max_body_bytes_; }
+
 private:
     // Helper to parse URL into host, port, path
     struct ParsedUrl {
@@ -61,6 +155,28 @@ private:
     };
 
     ParsedUrl parse_url(const std::string& url);
+
+    // Idle sockets by "host:port"
+    std::map<std::string, std::vector<int>> idle_;
+    std::shared_ptr<HttpCancelToken> cancel_token_;
+    size_t max_body_bytes_ = kMaxBodyBytes;
+
+    HttpResponse request(const std::string& method,
+                         const std::string& url,
+                         const std::string* body,
+                         const std::map<std::string, std::string>& headers,
+                         std::chrono::milliseconds timeout,
+                         const BodyHandler* handler = nullptr);
+    HttpResponse request_with_curl(const std::string& method,
+                                   const std::string& url,
+                                   const std::string* body,
+                                   const std::map<std::string, std::string>& headers,
+                                   std::chrono::milliseconds timeout,
+                                   const BodyHandler* handler);
+
+    // Pop a live pooled connection, or -1
+    int acquire(const std::string& key);
+    void release(const std::string& key, int fd);
 };
 
 } // namespace kyros
@@ -0,0 +1,72 @@
+#ifndef KYROS_HTTP_PARSER_HPP
+#define KYROS_HTTP_PARSER_HPP
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace kyros {
+
+enum class HttpParseResult {
+    Complete,    // Everything needed was in the input
+    Incomplete,  // Need more bytes
+    Invalid      // Not HTTP/1.x, or a malformed field
+};
+
+/**
+ * A header field as views into the receive buffer
+ */
+struct HttpHeaderView {
+    std::string_view name;
+    std::string_view value;  // Surrounding whitespace trimmed
+};
+
+/**
+ * Status line and header fields of an HTTP/1.x response
+ *
+ * Filled by parse_response_head() without copying: every view points into
+ * the buffer that was parsed and is only valid while it is unchanged.
+ */
+struct HttpResponseHead {
+    int minor_version = 1;
+    int status_code = 0;
+    std::vector<HttpHeaderView> headers;
+    size_t size = 0;  // Bytes up to and including the blank line
+
+    // Value of the first header named `name` (case-insensitive), or empty
+    std::string_view find(std::string_view name) const;
+};
+
+// Parse a response head from the start of `data`
+HttpParseResult parse_response_head(std::string_view data, HttpResponseHead& head);
+
+// Case-insensitive ASCII comparison, for header names and tokens
+bool http_iequals(std::string_view a, std::string_view b);
+
+/**
+ * Incremental decoder for "Transfer-Encoding: chunked" bodies
+ *
+ * Input can be split anywhere, including inside a chunk-size line; the
+ * caller drops the consumed bytes and calls again with the rest plus
+ * whatever arrived next. Chunk extensions and trailers are skipped.
+ */
+class ChunkedDecoder {
+public:
+    // Decode from `data`, appending payload to `body`. `consumed` is set
+    // to the number of input bytes used. Complete once the last chunk and
+    // trailers are through.
+    HttpParseResult decode(std::string_view data, size_t& consumed, std::string& body);
+
+    bool done() const { return state_ == State::Done; }
+
+private:
+    enum class State { Size, Data, DataEnd, Trailer, Done };
+
+    State state_ = State::Size;
+    size_t remaining_ = 0;
+};
+
+} // namespace kyros
+
+#endif // KYROS_HTTP_PARSER_HPP
@@ -21,6 +21,10 @@
 
 // Configuration
 #include <kyros/config.hpp>
+#include <kyros/probe_cache.hpp>
+#include <kyros/latency_tracker.hpp>
+#include <kyros/rule_matcher.hpp>
+#include <kyros/rulepack_binary.hpp>
 
 // Scan types
 #include <kyros/scan_types/scan_type.hpp>
@@ -41,6 +45,7 @@
 #include <kyros/testing/stdio_testing_engine.hpp>
 #include <kyros/testing/http_testing_engine.hpp>
 #include <kyros/testing/server_interrogator.hpp>
+#include <kyros/testing/preflight.hpp>
 
 // Reporting
 #include <kyros/reporting/reporter.hpp>
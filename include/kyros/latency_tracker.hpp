@@ -0,0 +1,123 @@
+#ifndef KYROS_LATENCY_TRACKER_HPP
+#define KYROS_LATENCY_TRACKER_HPP
+
+#include <kyros/candidate.hpp>
+#include <kyros/types.hpp>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <string>
+
+namespace kyros {
+
+/**
+ * Handshake latencies of confirmed servers and timeouts of silent ones,
+ * kept across scans to size probe deadlines
+ *
+ * Each confirmed probe is recorded twice: under its endpoint (the stdio
+ * command or the URL) and under its transport. The deadline of an
+ * endpoint that has answered is `headroom` times its p99 latency, clamped
+ * to [floor, ceiling]; transport history can only lengthen it. Its hedge
+ * point, where a duplicate probe may go out, is the p99 itself.
+ *
+ * Timeouts are counted apart from latencies, as a streak per endpoint
+ * that the next answer ends. Each timeout in the streak doubles the
+ * deadline and the hedge point of an endpoint that has answered, until a
+ * probe at the ceiling timed out too and the cycle starts over. Endpoints
+ * that never answered get the ceiling, halved for each timeout in the
+ * streak but not below the deadline the transport p99 gives, and the
+ * ceiling again every recheck_every-th probe; they are not hedged.
+ *
+ * Histograms have log-spaced buckets (a factor of sqrt(2) apart, 1 ms to
+ * about 65 s) and halve their counts once they hold kMaxSamples, so old
+ * scans fade out. The file is JSON; load() treats a missing or unreadable
+ * file as empty, save() drops endpoints not seen for 30 days and replaces
+ * the file atomically.
+ */
+class LatencyTracker {
+public:
+    static constexpr size_t kBuckets = 33;
+    static constexpr uint32_t kMaxSamples = 256;
+
+    class Histogram {
+    public:
+        void record(std::chrono::milliseconds latency);
+
+        // Upper bound of the bucket holding the p-th sample (0 < p <= 1);
+        // zero when empty
+        std::chrono::milliseconds percentile(double p) const;
+
+        uint32_t count() const { return count_; }
+        const std::array<uint32_t, kBuckets>& buckets() const { return buckets_; }
+        void set_buckets(const std::array<uint32_t, kBuckets>& buckets);
+
+        static std::chrono::milliseconds upper_bound(size_t bucket);
+
+    private:
+        std::array<uint32_t, kBuckets> buckets_{};
+        uint32_t count_ = 0;
+    };
+
+    struct DeadlinePolicy {
+        std::chrono::milliseconds floor{250};
+        std::chrono::milliseconds ceiling{5000};
+        double headroom = 3.0;
+        uint32_t min_transport_samples = 10;  // Before the transport p99 counts
+        uint32_t recheck_every = 8;           // Timeouts in a streak between full deadlines
+    };
+
+    // Empty path: kept in memory only
+    explicit LatencyTracker(std::string path = "");
+
+    // $XDG_CACHE_HOME/kyros/probe-latency.json, else ~/.cache/kyros/...;
+    // empty if neither variable is set
+    static std::string default_path();
+
+    // "stdio" for candidates probed by spawning their command, else "http"
+    static std::string transport_key(const Candidate& candidate);
+    static std::string endpoint_key(const Candidate& candidate);
+
+    void load();
+    bool save() const;
+
+    // An answer; ends the endpoint's timeout streak
+    void record(const Candidate& candidate, std::chrono::milliseconds latency, Timestamp now);
+    // A probe that ran out of its deadline; the endpoint only
+    void record_timeout(const Candidate& candidate, Timestamp now);
+
+    // How long a probe of the candidate may wait for its answer
+    std::chrono::milliseconds deadline(const Candidate& candidate,
+                                       const DeadlinePolicy& policy) const;
+    // When a still unanswered probe is sent again; zero without answer
+    // history, or when the hedge would not come before the deadline
+    std::chrono::milliseconds hedge_point(const Candidate& candidate,
+                                          const DeadlinePolicy& policy) const;
+
+    // Probes of the endpoint that timed out since its last answer
+    uint32_t timeout_streak(const Candidate& candidate) const;
+
+    const Histogram* endpoint(const Candidate& candidate) const;
+    const Histogram* transport(const Candidate& candidate) const;
+    const std::string& path() const { return path_; }
+
+private:
+    // p99 of the endpoint, or of its transport once that has enough samples
+    std::chrono::milliseconds usual_latency(const Candidate& candidate,
+                                            const DeadlinePolicy& policy) const;
+
+    struct Entry {
+        Histogram histogram;
+        uint32_t timeouts = 0;  // Streak; endpoints only
+        Timestamp last_seen;
+    };
+
+    std::string path_;
+    std::map<std::string, Entry> transports_;
+    std::map<std::string, Entry> endpoints_;
+};
+
+} // namespace kyros
+
+#endif // KYROS_LATENCY_TRACKER_HPP
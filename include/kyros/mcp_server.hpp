@@ -4,10 +4,14 @@
 #include <kyros/candidate.hpp>
 #include <kyros/types.hpp>
 
+#include <memory>
+
 #include <nlohmann/json.hpp>
 
 namespace kyros {
 
+class McpSession;
+
 // Tool definition from tools/list
 struct ToolDefinition {
     std::string name;
@@ -65,6 +69,10 @@ struct MCPServer {
     nlohmann::json capabilities;
     TransportType transport_type = TransportType::Unknown;
 
+    // Initialized connection kept from the confirming probe for
+    // interrogation; released once interrogation is done
+    std::shared_ptr<McpSession> session;
+
     // Interrogation results (empty if not interrogated)
     std::vector<ToolDefinition> tools;
     std::vector<ResourceDefinition> resources;
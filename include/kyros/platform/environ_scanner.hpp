@@ -0,0 +1,54 @@
+#ifndef KYROS_ENVIRON_SCANNER_HPP
+#define KYROS_ENVIRON_SCANNER_HPP
+
+#include <array>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace kyros {
+
+/**
+ * An environment variable found in a raw environ block
+ */
+struct EnvironMatch {
+    std::string_view name;
+    std::string_view value;
+};
+
+/**
+ * Prefix matcher over raw NUL-separated environment blocks
+ *
+ * Scans the block as the kernel hands it over ("KEY=value\0KEY=value\0")
+ * instead of splitting it into a map first. Variable boundaries are found
+ * 16 bytes at a time with SSE2 where available (memchr otherwise), and
+ * only variables whose first byte can start a prefix are compared. The
+ * scanner allocates nothing; matches are views into the block.
+ */
+class EnvironScanner {
+public:
+    // Scans for default_prefixes()
+    EnvironScanner();
+    explicit EnvironScanner(const std::vector<std::string>& prefixes);
+
+    // MCP_, ANTHROPIC_ and CLAUDE_
+    static const std::vector<std::string>& default_prefixes();
+
+    const std::vector<std::string>& prefixes() const { return prefixes_; }
+
+    // Append every variable whose name starts with one of the prefixes.
+    // Returns the number of matches added.
+    size_t scan(std::string_view block, std::vector<EnvironMatch>& matches) const;
+
+private:
+    std::vector<std::string> prefixes_;
+    std::array<bool, 256> first_bytes_{};  // Bytes that can start a prefix
+
+    // Check the variable starting at offset and record it if it matches
+    void match_at(std::string_view block, size_t offset,
+                  std::vector<EnvironMatch>& matches) const;
+};
+
+} // namespace kyros
+
+#endif // KYROS_ENVIRON_SCANNER_HPP
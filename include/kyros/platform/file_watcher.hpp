@@ -0,0 +1,35 @@
+#ifndef KYROS_FILE_WATCHER_HPP
+#define KYROS_FILE_WATCHER_HPP
+
+#include <string>
+#include <vector>
+
+namespace kyros {
+
+/**
+ * Change notifications for configuration files
+ *
+ * Watches are placed on directories rather than files, so editors and
+ * tools that replace a file by renaming a temporary over it are seen the
+ * same way as in-place writes, and files that don't exist yet are picked
+ * up when they are created.
+ */
+class FileWatcher {
+public:
+    virtual ~FileWatcher() = default;
+
+    // Watch a directory for entries being created, written, renamed or
+    // removed. Watching the same directory twice is a no-op. Returns false
+    // if the directory doesn't exist or can't be watched.
+    virtual bool watch_directory(const std::string& path) = 0;
+
+    // Wait up to timeout_ms (0 = don't block) and append the full paths
+    // of changed entries to `changed`. Returns false if the event queue
+    // overflowed, in which case `changed` is incomplete and every watched
+    // path must be treated as changed.
+    virtual bool poll(std::vector<std::string>& changed, int timeout_ms = 0) = 0;
+};
+
+} // namespace kyros
+
+#endif // KYROS_FILE_WATCHER_HPP
@@ -0,0 +1,127 @@
+#ifndef KYROS_FRAME_READER_HPP
+#define KYROS_FRAME_READER_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <stdexcept>
+#include <string_view>
+#include <sys/types.h>
+#include <vector>
+
+namespace kyros {
+
+// A read that gave up because its timeout ran out
+class ReadTimeout : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+/**
+ * How messages are delimited on a probe's stdout
+ */
+enum class FrameFormat {
+    Line,           // Every '\n'-terminated line as-is, including blank ones
+    Ndjson,         // Newline-delimited JSON; blank lines skipped, '\r' trimmed
+    ContentLength   // LSP-style "Content-Length: N\r\n\r\n" header + body
+};
+
+/**
+ * Buffered framing over a pipe
+ *
+ * Reads in large chunks into one buffer and cuts frames out of it, so a
+ * burst of messages costs one read() instead of one per byte, and several
+ * frames that arrive together are returned without touching the pipe
+ * again. Frames are returned as string_views into the buffer; a view is
+ * valid until the next call on the same reader. Consumed bytes are
+ * reclaimed by sliding the unread tail to the front only when the free
+ * space at the end runs out.
+ *
+ * No frame may exceed max_frame_bytes. An oversized frame is reported as
+ * TooLarge and then skipped (up to the next newline, or past the declared
+ * Content-Length body), so the buffer never grows beyond the limit no
+ * matter what a server writes.
+ */
+class FrameReader {
+public:
+    enum class Result {
+        Frame,      // frame holds a complete message
+        NeedMore,   // No complete frame buffered yet
+        TooLarge,   // A frame exceeded the limit and is being discarded
+        Malformed   // Unparseable Content-Length header block (dropped)
+    };
+
+    static constexpr size_t kDefaultMaxFrameBytes = 4 * 1024 * 1024;
+
+    explicit FrameReader(size_t max_frame_bytes = kDefaultMaxFrameBytes);
+
+    // Cut the next frame out of buffered data without reading
+    Result extract(FrameFormat format, std::string_view& frame);
+
+    // After EOF: the trailing unterminated line, if any, as a last frame
+    // (never for ContentLength, whose frames can't end early)
+    bool extract_final(FrameFormat format, std::string_view& frame);
+
+    // Append bytes from a source other than a file descriptor
+    void append(const char* data, size_t size);
+
+    // One read() into the free space. Returns what read() returned
+    // (0 at EOF, -1 with errno set on error).
+    ssize_t fill(int fd);
+
+    // Poll and fill until a frame is available. At EOF a trailing
+    // unterminated line is returned as the last frame. Throws ReadTimeout
+    // on timeout and std::runtime_error on EOF, read errors and oversized
+    // or malformed frames; stream_name is used in the messages.
+    std::string_view read_frame(int fd, FrameFormat format,
+                                std::chrono::milliseconds timeout,
+                                const char* stream_name);
+
+    // Line streaming, for a parser that consumes a message as it arrives:
+    // the next piece of the current line, without waiting for the rest of
+    // it. `end` is set on the piece that completes the line (its '\n' is
+    // not included). Nothing is kept once returned, so a line of any
+    // length passes through in buffer-sized pieces; max_frame_bytes does
+    // not apply. NeedMore if nothing is buffered.
+    Result extract_partial(std::string_view& piece, bool& end);
+
+    // Poll and fill until extract_partial() has a piece. EOF ends a line
+    // that has started with an empty last piece; otherwise it throws, as
+    // do timeouts and read errors.
+    std::string_view read_partial(int fd, std::chrono::milliseconds timeout,
+                                  const char* stream_name, bool& end);
+
+    // Bytes buffered but not yet returned as frames
+    size_t buffered() const { return tail_ - head_; }
+
+    size_t max_frame_bytes() const { return max_frame_bytes_; }
+
+    // Applies from the next frame cut; a frame already being discarded
+    // stays discarded
+    void set_max_frame_bytes(size_t bytes) { max_frame_bytes_ = bytes; }
+
+private:
+    std::vector<char> buffer_;
+    size_t head_ = 0;         // First unconsumed byte
+    size_t tail_ = 0;         // One past the last buffered byte
+    size_t scanned_ = 0;      // Bytes after head_ already searched for '\n'
+    size_t max_frame_bytes_;
+    size_t discard_bytes_ = 0;    // Remaining body of an oversized Content-Length frame
+    bool discard_line_ = false;   // Skipping the rest of an oversized line
+    bool eof_ = false;
+    bool partial_line_ = false;   // extract_partial() is inside a line
+
+    Result extract_line(bool ndjson, std::string_view& frame);
+    Result extract_content_length(std::string_view& frame);
+    bool drain_discard();
+    void consume(size_t count);
+    void reserve_tail();
+
+    // Wait for fd and read once (setting eof_ at EOF); throws on timeout
+    // and errors
+    void wait_and_fill(int fd, std::chrono::steady_clock::time_point deadline,
+                       const char* stream_name);
+};
+
+} // namespace kyros
+
+#endif // KYROS_FRAME_READER_HPP
@@ -0,0 +1,67 @@
+#ifndef KYROS_CHILD_REAPER_HPP
+#define KYROS_CHILD_REAPER_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace kyros {
+
+/**
+ * Background reaper for terminated probe children
+ *
+ * One thread waits on the pidfds of every adopted child with epoll and
+ * reaps each as soon as it exits. Children still alive at their deadline
+ * are sent SIGKILL. Children without a pidfd are checked with waitpid()
+ * every few milliseconds. Remaining children are killed and reaped when
+ * the reaper is destroyed at exit.
+ */
+class ChildReaper {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static ChildReaper& instance();
+
+    ChildReaper(const ChildReaper&) = delete;
+    ChildReaper& operator=(const ChildReaper&) = delete;
+
+    // Take ownership of a child that has already been asked to exit.
+    // pidfd may be -1; the reaper closes it once the child is reaped.
+    void adopt(int pid, int pidfd, Clock::time_point kill_deadline);
+
+    // Children adopted but not yet reaped
+    size_t pending() const;
+
+    // Block until every adopted child is reaped or timeout expires
+    bool wait_idle(std::chrono::milliseconds timeout) const;
+
+private:
+    struct Child {
+        int pid;
+        int pidfd;
+        Clock::time_point deadline;
+        bool killed;
+    };
+
+    ChildReaper();
+    ~ChildReaper();
+
+    void run();
+    void wake();
+    int next_timeout_ms(Clock::time_point now) const;
+
+    mutable std::mutex mutex_;
+    mutable std::condition_variable idle_;
+    std::vector<Child> children_;
+    int epoll_fd_ = -1;
+    int wake_fd_ = -1;
+    bool stopping_ = false;
+    std::thread thread_;
+};
+
+} // namespace kyros
+
+#endif // KYROS_CHILD_REAPER_HPP
@@ -0,0 +1,101 @@
+#ifndef KYROS_EPOLL_PROBE_REACTOR_HPP
+#define KYROS_EPOLL_PROBE_REACTOR_HPP
+
+#include <kyros/platform/frame_reader.hpp>
+#include <kyros/platform/probe_reactor.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <queue>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace kyros {
+
+class LinuxProcess;
+
+/**
+ * ProbeReactor on one epoll set
+ *
+ * Every in-flight probe registers its stdout and stderr pipes and its
+ * pidfd; a single timerfd is armed for the earliest deadline. Probes move
+ * through Queued -> AwaitingResponse -> Done, and only the loop thread
+ * ever touches them, so no locking is needed. A probe handed to the
+ * response handler is Kept in between: its stderr and pidfd stay watched,
+ * through duplicates the reactor owns, until the process exits. The
+ * number of probes in flight, kept ones included, is capped by
+ * max_in_flight and by the descriptor limit (raised to the hard limit on
+ * first use).
+ */
+class EpollProbeReactor : public ProbeReactor {
+public:
+    static constexpr size_t kDefaultMaxInFlight = 512;
+
+    explicit EpollProbeReactor(size_t max_in_flight = kDefaultMaxInFlight);
+    ~EpollProbeReactor() override;
+
+    EpollProbeReactor(const EpollProbeReactor&) = delete;
+    EpollProbeReactor& operator=(const EpollProbeReactor&) = delete;
+
+    bool is_open() const { return epoll_fd_ >= 0 && timer_fd_ >= 0; }
+
+    size_t add(SpawnFunction spawn, std::string request,
+               std::chrono::milliseconds timeout) override;
+    std::vector<Result> run() override;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    enum class State { Queued, AwaitingResponse, Kept, Done };
+
+    struct Probe {
+        SpawnFunction spawn;
+        std::string request;
+        std::chrono::milliseconds timeout{0};
+        State state = State::Queued;
+
+        std::unique_ptr<Process> process;
+        LinuxProcess* linux_process = nullptr;
+        FrameReader stdout_frames;
+        Clock::time_point started;
+        Clock::time_point deadline;
+
+        // Owned duplicates of the stderr pipe and pidfd while Kept
+        int kept_stderr_fd = -1;
+        int kept_exit_fd = -1;
+
+        Result result;
+    };
+
+    // Earliest deadline first
+    using Deadline = std::pair<Clock::time_point, size_t>;
+    struct LaterDeadline {
+        bool operator()(const Deadline& a, const Deadline& b) const { return a.first > b.first; }
+    };
+
+    int epoll_fd_ = -1;
+    int timer_fd_ = -1;
+    size_t max_in_flight_;
+    std::vector<Probe> probes_;
+    std::priority_queue<Deadline, std::vector<Deadline>, LaterDeadline> deadlines_;
+    size_t in_flight_ = 0;
+
+    size_t slot_limit() const;
+    void start(size_t index);
+    void on_stdout(size_t index);
+    void on_stderr(size_t index);
+    void on_exit(size_t index);
+    void expire_deadlines();
+    void arm_timer();
+    void finish(size_t index, Status status, std::string error = "");
+    bool keep(size_t index);
+    void release(size_t index);
+    void close_kept_fds(Probe& probe);
+    bool watch(int fd, size_t index, uint32_t kind);
+};
+
+} // namespace kyros
+
+#endif // KYROS_EPOLL_PROBE_REACTOR_HPP
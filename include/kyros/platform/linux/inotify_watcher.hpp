@@ -0,0 +1,35 @@
+#ifndef KYROS_INOTIFY_WATCHER_HPP
+#define KYROS_INOTIFY_WATCHER_HPP
+
+#include <kyros/platform/file_watcher.hpp>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace kyros {
+
+/**
+ * FileWatcher backed by inotify
+ */
+class InotifyWatcher : public FileWatcher {
+public:
+    InotifyWatcher();
+    ~InotifyWatcher() override;
+
+    InotifyWatcher(const InotifyWatcher&) = delete;
+    InotifyWatcher& operator=(const InotifyWatcher&) = delete;
+
+    bool is_open() const { return fd_ >= 0; }
+
+    bool watch_directory(const std::string& path) override;
+    bool poll(std::vector<std::string>& changed, int timeout_ms = 0) override;
+
+private:
+    int fd_ = -1;
+    std::unordered_map<int, std::string> directories_;  // Watch descriptor -> path
+};
+
+} // namespace kyros
+
+#endif // KYROS_INOTIFY_WATCHER_HPP
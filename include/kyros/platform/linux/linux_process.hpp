@@ -0,0 +1,65 @@
+#ifndef KYROS_LINUX_PROCESS_HPP
+#define KYROS_LINUX_PROCESS_HPP
+
+#include <kyros/platform/process.hpp>
+
+namespace kyros {
+
+/**
+ * Linux child process with a pidfd for exit notification
+ *
+ * Exit is observed by polling the pidfd instead of sleeping between
+ * waitpid() calls. terminate() sends SIGTERM and waits only briefly; a
+ * child that takes longer is handed to the shared ChildReaper, which
+ * escalates to SIGKILL and reaps it in the background, so many probes
+ * can shut down at once. Kernels without pidfd_open (< 5.3) fall back
+ * to waitpid() polling.
+ */
+class LinuxProcess : public Process {
+public:
+    LinuxProcess(int pid, int stdin_fd, int stdout_fd, int stderr_fd);
+    ~LinuxProcess() override;
+
+    void write_stdin(const std::string& data) override;
+    std::string read_stdout_line(std::chrono::milliseconds timeout) override;
+    std::string read_stderr_line(std::chrono::milliseconds timeout) override;
+    std::string_view read_stdout_frame(std::chrono::milliseconds timeout,
+                                       FrameFormat format) override;
+    std::string_view read_stdout_partial(std::chrono::milliseconds timeout, bool& end) override;
+    void set_max_frame_bytes(size_t bytes) override { stdout_frames_.set_max_frame_bytes(bytes); }
+    void terminate() override;
+    bool is_running() const override;
+    int exit_code() const override;
+
+    // Wait up to timeout for the child to exit; true if it has
+    bool wait_for_exit(std::chrono::milliseconds timeout);
+
+    // Close the pipes, send SIGTERM and hand the child straight to the
+    // reaper without waiting (for event loops that must not block)
+    void terminate_in_background();
+
+    // Raw descriptors for event loops (-1 once closed or unavailable)
+    int stdin_fd() const { return stdin_fd_; }
+    int stdout_fd() const { return stdout_fd_; }
+    int stderr_fd() const { return stderr_fd_; }
+    int pidfd() const { return pidfd_; }
+
+private:
+    int pidfd_;
+    int stdin_fd_;
+    int stdout_fd_;
+    int stderr_fd_;
+    FrameReader stdout_frames_;
+    FrameReader stderr_frames_;
+    int exit_code_;
+    bool exited_;
+    bool detached_;  // Handed to the reaper; no longer ours to wait on
+
+    void close_fds();
+    bool try_reap();
+    void detach_to_reaper();
+};
+
+} // namespace kyros
+
+#endif // KYROS_LINUX_PROCESS_HPP
@@ -0,0 +1,43 @@
+#ifndef KYROS_PROC_EVENTS_HPP
+#define KYROS_PROC_EVENTS_HPP
+
+#include <unordered_set>
+
+namespace kyros {
+
+/**
+ * Subscription to the kernel proc connector (NETLINK_CONNECTOR, CN_IDX_PROC)
+ *
+ * Receives fork/exec/exit/comm notifications so incremental snapshots only
+ * re-read the PIDs that changed. Subscribing needs CAP_NET_ADMIN in the
+ * initial namespaces; without it is_open() is false and callers fall back
+ * to revalidating every PID from /proc/<pid>/stat.
+ */
+class ProcEvents {
+public:
+    ProcEvents();
+    ~ProcEvents();
+
+    ProcEvents(const ProcEvents&) = delete;
+    ProcEvents& operator=(const ProcEvents&) = delete;
+
+    bool is_open() const { return fd_ >= 0; }
+
+    // Add every PID with an event since the previous drain to `changed`,
+    // those that exec'd to `execed` as well, and the parent of every fork
+    // to `forked` (its descriptors may have changed, e.g. the pipes for a
+    // child's stdio). Returns false if events were dropped (receive buffer
+    // overrun), in which case the sets are incomplete and every PID must
+    // be revalidated.
+    bool drain(std::unordered_set<int>& changed, std::unordered_set<int>& execed,
+               std::unordered_set<int>& forked);
+
+private:
+    int fd_ = -1;
+
+    bool subscribe();
+};
+
+} // namespace kyros
+
+#endif // KYROS_PROC_EVENTS_HPP
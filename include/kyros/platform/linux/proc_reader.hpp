@@ -0,0 +1,90 @@
+#ifndef KYROS_PROC_READER_HPP
+#define KYROS_PROC_READER_HPP
+
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace kyros {
+
+/**
+ * Parsed contents of a single /proc/<pid> entry
+ */
+struct ProcEntry {
+    int pid = 0;
+    int ppid = 0;
+    unsigned int uid = 0;
+    unsigned long long start_time = 0;  // Clock ticks since boot (stat field 22)
+    std::string name;                   // comm, or argv[0] basename when comm is truncated
+    std::vector<std::string> argv;      // NUL-separated /proc/<pid>/cmdline
+
+    // Space-joined argv (empty for kernel threads)
+    std::string command_line() const;
+};
+
+/**
+ * Low-level /proc reader
+ *
+ * Holds a directory fd on the proc root and opens per-PID files with
+ * openat() relative to a single /proc/<pid> dirfd, reading into a
+ * reusable buffer. One ProcReader is not thread-safe; callers that share
+ * it across threads must serialize access.
+ */
+class ProcReader {
+public:
+    explicit ProcReader(const std::string& proc_root = "/proc");
+    ~ProcReader();
+
+    ProcReader(const ProcReader&) = delete;
+    ProcReader& operator=(const ProcReader&) = delete;
+
+    bool is_open() const { return proc_fd_ >= 0; }
+
+    // Numeric entries of the proc root
+    std::vector<int> list_pids();
+
+    // read(), read_stat() and read_cmdline() share a scratch buffer and
+    // must not run concurrently on one reader; the other readers may.
+
+    // Read stat and cmdline for one PID (single pid dirfd)
+    bool read(int pid, ProcEntry& entry);
+
+    // Read only stat (name is the raw comm, argv is left empty) or only
+    // cmdline. Used to revalidate a known PID cheaply between scans.
+    bool read_stat(int pid, ProcEntry& entry);
+    bool read_cmdline(int pid, std::vector<std::string>& argv);
+
+    // Replace a truncated comm with the argv[0] basename it prefixes
+    static void resolve_name(ProcEntry& entry);
+
+    // Raw NUL-separated environment block
+    bool read_environ(int pid, std::string& block);
+
+    // Target of /proc/<pid>/fd/<fd> (e.g. "pipe:[1234]")
+    bool read_fd_link(int pid, int fd, std::string& target);
+
+    // Walk /proc/*/fd once, calling visit(pid, fd, link target) for every
+    // descriptor we are allowed to read. visit returns false to stop early.
+    using FdVisitor = std::function<bool(int pid, int fd, std::string_view target)>;
+    void for_each_fd(const FdVisitor& visit);
+
+    // The same for one PID. Returns false if visit stopped the walk.
+    bool for_each_fd(int pid, const FdVisitor& visit);
+
+    // Parsers (public for testing)
+    static bool parse_stat(const std::string& stat, ProcEntry& entry);
+    static std::vector<std::string> split_nul(const char* data, size_t size);
+
+private:
+    int proc_fd_ = -1;
+    std::string buffer_;
+
+    int open_pid_dir(int pid) const;
+    bool read_stat_at(int pid_fd, int pid, ProcEntry& entry);
+    bool read_file_at(int dir_fd, const char* name, std::string& out);
+};
+
+} // namespace kyros
+
+#endif // KYROS_PROC_READER_HPP
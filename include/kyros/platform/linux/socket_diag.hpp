@@ -0,0 +1,44 @@
+#ifndef KYROS_SOCKET_DIAG_HPP
+#define KYROS_SOCKET_DIAG_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace kyros {
+
+/**
+ * A listening TCP socket or bound UDP socket, before PID attribution
+ */
+struct SocketEntry {
+    uint64_t inode = 0;
+    std::string address;   // Numeric, without brackets ("0.0.0.0", "::1")
+    int port = 0;
+    std::string protocol;  // "tcp" or "udp"
+};
+
+/**
+ * Listener enumeration for the Linux platform adapter
+ *
+ * query_netlink() dumps TCP sockets in LISTEN and unconnected UDP sockets
+ * for IPv4 and IPv6 over NETLINK_SOCK_DIAG (inet_diag). When netlink is
+ * unavailable (seccomp, old kernels, restricted containers) read_proc_net()
+ * parses /proc/net/{tcp,tcp6,udp,udp6} instead. Neither spawns a process.
+ */
+class SocketDiag {
+public:
+    // Returns false if the netlink socket cannot be used at all
+    static bool query_netlink(std::vector<SocketEntry>& entries);
+
+    // Fallback parser over /proc/net
+    static std::vector<SocketEntry> read_proc_net(const std::string& proc_root = "/proc");
+
+    // Parse one row of /proc/net/{tcp,udp}[6] (public for testing). Returns
+    // false for the header, malformed rows and non-listening sockets.
+    static bool parse_proc_net_line(const std::string& line, bool ipv6,
+                                    const std::string& protocol, SocketEntry& entry);
+};
+
+} // namespace kyros
+
+#endif // KYROS_SOCKET_DIAG_HPP
@@ -13,6 +13,9 @@ public:
     void write_stdin(const std::string& data) override;
     std::string read_stdout_line(std::chrono::milliseconds timeout) override;
     std::string read_stderr_line(std::chrono::milliseconds timeout) override;
+    std::string_view read_stdout_frame(std::chrono::milliseconds timeout,
+                                       FrameFormat format) override;
+    std::string_view read_stdout_partial(std::chrono::milliseconds timeout, bool& end) override;
     void terminate() override;
     bool is_running() const override;
     int exit_code() const override;
@@ -21,11 +24,12 @@ private:
     int stdin_fd_;
     int stdout_fd_;
     int stderr_fd_;
+    FrameReader stdout_frames_;
+    FrameReader stderr_frames_;
     int exit_code_;
     bool exited_;
 
     void close_fds();
-    std::string read_line_from_fd(int fd, std::chrono::milliseconds timeout, const char* stream_name);
 };
 
 } // namespace kyros
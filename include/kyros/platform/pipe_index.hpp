@@ -0,0 +1,61 @@
+#ifndef KYROS_PIPE_INDEX_HPP
+#define KYROS_PIPE_INDEX_HPP
+
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace kyros {
+
+/**
+ * Index of which processes hold which pipes
+ *
+ * Built from every process' open descriptors; platforms may keep those
+ * between scans and re-read only processes that changed. Only pipe
+ * descriptors are recorded, keyed by the pipe's identity (the pipefs
+ * inode on Linux). For a stdio MCP server the client holds the other end
+ * of the server's stdin and stdout pipes on ordinary (> 2) descriptors,
+ * which is how find_client() tells a client apart from the neighbours of
+ * a shell pipeline, who hold the same pipe on fd 0 or 1.
+ */
+class PipeIndex {
+public:
+    // Record that pid has pipe `inode` open as descriptor fd
+    void add(int pid, int fd, uint64_t inode);
+
+    bool empty() const { return holders_.empty(); }
+
+    // Pipe behind fd 0 / fd 1 of pid, or 0 if that descriptor is not a pipe
+    uint64_t stdin_pipe(int pid) const;
+    uint64_t stdout_pipe(int pid) const;
+
+    // stdin and stdout are both pipes
+    bool has_bidirectional_pipes(int pid) const;
+
+    // Other processes holding the given pipe
+    std::vector<int> holders(uint64_t inode, int exclude_pid = 0) const;
+
+    // Process holding the far end of pid's stdio pipes on a non-stdio
+    // descriptor. A process holding both pipes wins; ties go to the
+    // lowest PID so the result is deterministic.
+    std::optional<int> find_client(int pid) const;
+
+private:
+    struct Holder {
+        int pid;
+        int fd;
+    };
+
+    struct StdioPipes {
+        uint64_t in = 0;
+        uint64_t out = 0;
+    };
+
+    std::unordered_map<uint64_t, std::vector<Holder>> holders_;
+    std::unordered_map<int, StdioPipes> stdio_;
+};
+
+} // namespace kyros
+
+#endif // KYROS_PIPE_INDEX_HPP
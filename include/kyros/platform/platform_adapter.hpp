@@ -2,7 +2,11 @@
 #define KYROS_PLATFORM_ADAPTER_HPP
 
 #include <kyros/types.hpp>
+#include <kyros/platform/file_watcher.hpp>
+#include <kyros/platform/pipe_index.hpp>
+#include <kyros/platform/probe_reactor.hpp>
 #include <kyros/platform/process.hpp>
+#include <kyros/platform/process_table.hpp>
 
 #include <map>
 #include <memory>
@@ -17,6 +21,10 @@ namespace kyros {
  * Platform abstraction layer
  *
  * Provides cross-platform access to OS-level functionality
+ *
+ * One adapter is shared by all detection engines, which PassiveScanner
+ * runs on separate threads. Every method must therefore be safe to call
+ * concurrently; implementations lock whatever scratch state they keep.
  */
 class PlatformAdapter {
 public:
@@ -31,7 +39,20 @@ public:
     virtual nlohmann::json read_json_file(const std::string& path) = 0;
     virtual std::vector<std::string> list_directory(const std::string& path) = 0;
 
+    // Change notifications for config watching (optional). Returns nullptr
+    // where unsupported; callers then re-read files on every scan.
+    virtual std::unique_ptr<FileWatcher> create_file_watcher() {
+        return nullptr;
+    }
+
     // Process operations
+    //
+    // snapshot_processes() returns the whole process table in one call and is
+    // what detection engines use. The default implementation assembles it
+    // from the per-PID getters below; platforms override it to read
+    // everything in a single pass.
+    virtual std::shared_ptr<const ProcessTable> snapshot_processes();
+
     virtual std::vector<int> get_process_list() = 0;
     virtual std::string get_command_line(int pid) = 0;
     virtual std::string get_process_name(int pid) = 0;
@@ -39,6 +60,36 @@ public:
     virtual std::map<std::string, std::string> get_environment(int pid) = 0;
     virtual bool has_bidirectional_pipes(int pid) = 0;
 
+    // Environment as the raw "KEY=value\0KEY=value\0" block, written into
+    // a caller-owned buffer so it can be reused across PIDs. Returns false
+    // if the environment cannot be read. The default implementation
+    // serializes get_environment(); platforms override it to skip the map.
+    virtual bool get_environment_block(int pid, std::string& block);
+
+    // Pipe ownership for every process in the latest snapshot, from their
+    // open descriptors. Returns nullptr where unsupported; callers then
+    // fall back to has_bidirectional_pipes() per PID.
+    virtual std::shared_ptr<const PipeIndex> build_pipe_index() {
+        return nullptr;
+    }
+
+    // Command line as an argv vector. Platforms that only expose a joined
+    // string fall back to splitting it on whitespace.
+    virtual std::vector<std::string> get_command_args(int pid) {
+        std::vector<std::string> args;
+        std::string cmdline = get_command_line(pid);
+        size_t pos = 0;
+        while (pos < cmdline.size()) {
+            size_t start = cmdline.find_first_not_of(' ', pos);
+            if (start == std::string::npos) break;
+            size_t end = cmdline.find(' ', start);
+            if (end == std::string::npos) end = cmdline.size();
+            args.push_back(cmdline.substr(start, end - start));
+            pos = end;
+        }
+        return args;
+    }
+
     // Network operations
     virtual std::vector<NetworkListener> get_listening_sockets() = 0;
 
@@ -47,6 +98,13 @@ public:
         const std::string& command,
         const std::vector<std::string>& args = {}) = 0;
 
+    // Event loop for running many stdio probes from one thread (optional).
+    // Returns nullptr where unsupported; callers then probe each process
+    // with blocking reads.
+    virtual std::unique_ptr<ProbeReactor> create_probe_reactor() {
+        return nullptr;
+    }
+
     // Container support (optional)
     virtual std::vector<DockerContainer> docker_list_containers() {
         return {};
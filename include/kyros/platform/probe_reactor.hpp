@@ -0,0 +1,76 @@
+#ifndef KYROS_PROBE_REACTOR_HPP
+#define KYROS_PROBE_REACTOR_HPP
+
+#include <kyros/platform/process.hpp>
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace kyros {
+
+/**
+ * Event loop that runs many stdio request/response probes on one thread
+ *
+ * Each probe is a process that is sent one request on stdin and is
+ * expected to answer with a newline-delimited JSON message on stdout.
+ * Probes are spawned lazily as earlier ones finish, so at most a bounded
+ * number of children and pipes exist at a time. A probe's stderr is
+ * drained continuously so a chatty child never blocks on a full pipe.
+ * Every probe is terminated when it finishes, unless a response handler
+ * takes it over; slow exits are reaped in the background.
+ */
+class ProbeReactor {
+public:
+    enum class Status {
+        Response,   // `frame` holds the first message on stdout
+        Timeout,    // Nothing arrived before the deadline
+        Closed,     // stdout closed, or the process exited, without a message
+        Error       // Spawn, write or framing failure (see `error`)
+    };
+
+    struct Result {
+        Status status = Status::Error;
+        std::string frame;
+        std::string error;
+        std::string stderr_tail;  // Last bytes written to stderr, for diagnostics
+        std::chrono::milliseconds elapsed{0};  // From the request being written to the outcome
+
+        // The process that answered, left running, while it is passed to
+        // the response handler; the handler moves it out
+        std::unique_ptr<Process> process;
+    };
+
+    using SpawnFunction = std::function<std::unique_ptr<Process>()>;
+    using ResponseHandler = std::function<void(size_t index, Result& result)>;
+
+    virtual ~ProbeReactor() = default;
+
+    // Queue a probe. spawn() is called from run() when a slot is free; the
+    // timeout starts once the request is written. Returns the index of
+    // the probe's entry in run()'s results.
+    virtual size_t add(SpawnFunction spawn, std::string request,
+                       std::chrono::milliseconds timeout) = 0;
+
+    // Run every queued probe to completion. Results are in add() order.
+    virtual std::vector<Result> run() = 0;
+
+    // Hand each process that answers to handler, in Result::process,
+    // instead of terminating it, so the caller can continue the
+    // conversation. The handler runs on run()'s thread as soon as the
+    // probe answers and must not block; pass the process on to another
+    // thread. The probe keeps its slot, and its stderr is still drained,
+    // until the process exits, and run() returns only once every handed
+    // over process has. Bytes written to stdout after the first message
+    // are not kept. Null terminates responders again.
+    void set_response_handler(ResponseHandler handler) { response_handler_ = std::move(handler); }
+
+protected:
+    ResponseHandler response_handler_;
+};
+
+} // namespace kyros
+
+#endif // KYROS_PROBE_REACTOR_HPP
@@ -1,15 +1,20 @@
 #ifndef KYROS_PROCESS_HPP
 #define KYROS_PROCESS_HPP
 
+#include <kyros/platform/frame_reader.hpp>
+
 #include <chrono>
 #include <string>
+#include <string_view>
 
 namespace kyros {
 
 /**
  * Cross-platform process abstraction
  *
- * Represents a spawned process with stdin/stdout pipes
+ * Represents a spawned process with stdin/stdout pipes. Reads are capped
+ * at FrameReader::kDefaultMaxFrameBytes per line or frame unless
+ * set_max_frame_bytes() changes the stdout limit.
  */
 class Process {
 public:
@@ -20,6 +25,23 @@ public:
     virtual std::string read_stdout_line(std::chrono::milliseconds timeout) = 0;
     virtual std::string read_stderr_line(std::chrono::milliseconds timeout) = 0;
 
+    // Next message on stdout in the given framing. The view is valid until
+    // the next read from stdout. Throws like read_stdout_line, and also on
+    // frames over the size limit. The default implementation is built on
+    // read_stdout_line; platform processes read the pipe directly.
+    virtual std::string_view read_stdout_frame(std::chrono::milliseconds timeout,
+                                               FrameFormat format);
+
+    // Next piece of the current stdout line, handed out as it arrives so a
+    // parser can consume a message of any length without it being held
+    // whole. `end` is set on the piece that completes the line. The view
+    // is valid until the next read from stdout. Throws like
+    // read_stdout_line.
+    virtual std::string_view read_stdout_partial(std::chrono::milliseconds timeout, bool& end);
+
+    // Largest frame read_stdout_frame() accepts
+    virtual void set_max_frame_bytes(size_t bytes) { line_frames_.set_max_frame_bytes(bytes); }
+
     // Process control
     virtual void terminate() = 0;
     virtual bool is_running() const = 0;
@@ -31,6 +53,9 @@ public:
 protected:
     Process() = default;
     int pid_ = 0;
+
+private:
+    FrameReader line_frames_;  // Reassembles frames for the default read_stdout_frame
 };
 
 } // namespace kyros
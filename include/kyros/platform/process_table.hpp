@@ -0,0 +1,99 @@
+#ifndef KYROS_PROCESS_TABLE_HPP
+#define KYROS_PROCESS_TABLE_HPP
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace kyros {
+
+/**
+ * Point-in-time snapshot of the process table
+ *
+ * Stored as a struct of arrays: row i of every column describes the same
+ * process. Names and command lines live in one shared string arena and
+ * are addressed by offset, so a snapshot of tens of thousands of processes
+ * is a handful of allocations. Engines receive it as
+ * std::shared_ptr<const ProcessTable> and never modify it.
+ */
+class ProcessTable {
+public:
+    // Number of processes
+    size_t size() const { return pids_.size(); }
+    bool empty() const { return pids_.empty(); }
+
+    // Column accessors
+    int pid(size_t row) const { return pids_[row]; }
+    int ppid(size_t row) const { return ppids_[row]; }
+    uint32_t uid(size_t row) const { return uids_[row]; }
+
+    // Process start time in platform units (clock ticks since boot on Linux,
+    // microseconds since the epoch on macOS). Only meaningful for equality:
+    // the same (pid, start_time) pair always identifies the same process.
+    uint64_t start_time(size_t row) const { return start_times_[row]; }
+
+    // Execs seen for this process since an earlier snapshot first listed
+    // it. An exec keeps pid and start time, so caches of anything fixed at
+    // exec (command line, environment) also key on this. Only counted
+    // where the platform reports execs (the Linux proc connector, or a
+    // changed name otherwise).
+    uint32_t exec_count(size_t row) const { return exec_counts_[row]; }
+
+    std::string_view name(size_t row) const {
+        return view(name_spans_[row]);
+    }
+
+    // Arguments joined with single spaces
+    std::string_view command_line(size_t row) const {
+        return view(command_spans_[row]);
+    }
+
+    // Individual arguments (views into the command line)
+    std::vector<std::string_view> argv(size_t row) const;
+
+    const std::vector<int>& pids() const { return pids_; }
+
+    // Row index for a PID
+    std::optional<size_t> find(int pid) const;
+
+    // Append a process (used by platform adapters while building a snapshot)
+    void add(int pid, int ppid, uint32_t uid, uint64_t start_time,
+             std::string_view name, const std::vector<std::string>& argv,
+             uint32_t exec_count = 0);
+
+    // Append a row of another table unchanged (used by incremental snapshots)
+    void copy_row(const ProcessTable& source, size_t row);
+
+    void reserve(size_t count);
+
+private:
+    struct Span {
+        uint32_t offset = 0;
+        uint32_t length = 0;
+    };
+
+    std::vector<int> pids_;
+    std::vector<int> ppids_;
+    std::vector<uint32_t> uids_;
+    std::vector<uint64_t> start_times_;
+    std::vector<uint32_t> exec_counts_;
+    std::vector<Span> name_spans_;
+    std::vector<Span> command_spans_;
+    std::vector<uint32_t> argv_begin_;  // First entry in argv_spans_ for each row
+    std::vector<Span> argv_spans_;
+    std::string arena_;
+    std::unordered_map<int, size_t> index_;
+
+    std::string_view view(const Span& span) const {
+        return std::string_view(arena_.data() + span.offset, span.length);
+    }
+
+    Span append(std::string_view text);
+};
+
+} // namespace kyros
+
+#endif // KYROS_PROCESS_TABLE_HPP
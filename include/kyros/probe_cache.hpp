@@ -0,0 +1,76 @@
+#ifndef KYROS_PROBE_CACHE_HPP
+#define KYROS_PROBE_CACHE_HPP
+
+#include <kyros/candidate.hpp>
+#include <kyros/mcp_server.hpp>
+#include <kyros/types.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+
+namespace kyros {
+
+/**
+ * On-disk cache of active probe outcomes, so unchanged targets are not
+ * spawned and handshaken again on every run
+ *
+ * Entries are keyed by a fingerprint that changes when the target does:
+ * the command line plus the executable's device, inode and mtime for
+ * stdio candidates (the running image when the process is known), and
+ * the URL plus the start time of the process listening on it for HTTP
+ * candidates. HTTP candidates whose listening process is unknown are not
+ * cached. A confirmed server is
+ * reused for `ttl`, a failed probe for `failure_ttl`.
+ *
+ * The file is JSON. load() treats a missing or unreadable file as an empty
+ * cache; save() drops expired entries and replaces the file atomically.
+ */
+class ProbeCache {
+public:
+    struct Entry {
+        bool confirmed = false;
+        bool interrogated = false;     // Server metadata includes interrogation results
+        std::optional<MCPServer> server;  // Confirmed: everything but candidate and session
+        std::string error;             // Failed: why
+        Timestamp stored_at;
+    };
+
+    ProbeCache(std::string path, std::chrono::seconds ttl, std::chrono::seconds failure_ttl);
+
+    // $XDG_CACHE_HOME/kyros/probe-cache.json, else ~/.cache/kyros/...;
+    // empty if neither variable is set
+    static std::string default_path();
+
+    // Fingerprint of a candidate, or empty (not cached) if it has neither
+    // a command nor a URL, or has a URL but no known owner process.
+    // owner_start_time is the start time of candidate.pid (0 if unknown).
+    static std::string fingerprint(const Candidate& candidate, uint64_t owner_start_time);
+
+    void load();
+    bool save() const;
+
+    // Entry younger than its TTL, or nullptr
+    const Entry* find(const std::string& fingerprint, Timestamp now) const;
+
+    void store_confirmed(const std::string& fingerprint, const MCPServer& server,
+                         bool interrogated, Timestamp now);
+    void store_failure(const std::string& fingerprint, const std::string& error, Timestamp now);
+
+    const std::string& path() const { return path_; }
+    size_t size() const { return entries_.size(); }
+
+private:
+    std::string path_;
+    std::chrono::seconds ttl_;
+    std::chrono::seconds failure_ttl_;
+    std::map<std::string, Entry> entries_;
+
+    bool fresh(const Entry& entry, Timestamp now) const;
+};
+
+} // namespace kyros
+
+#endif // KYROS_PROBE_CACHE_HPP
@@ -0,0 +1,169 @@
+#ifndef KYROS_RULE_MATCHER_HPP
+#define KYROS_RULE_MATCHER_HPP
+
+#include <kyros/rulepack.hpp>
+#include <kyros/utils/binary_io.hpp>
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace kyros {
+
+/**
+ * Set of literal byte strings found in one pass over a text
+ * (Aho-Corasick)
+ *
+ * The automaton is a dense DFA over byte classes: bytes that appear in no
+ * pattern share class 0, so the table has one column per distinct pattern
+ * byte rather than 256. Identical patterns share an id. An empty pattern
+ * matches every text.
+ */
+class PatternSet {
+public:
+    // Id of the pattern; adding after build() requires another build()
+    size_t add(std::string_view pattern);
+    void build();
+
+    size_t size() const { return patterns_.size(); }
+    const std::string& pattern(size_t id) const { return patterns_[id]; }
+
+    // Flat form of a built set: patterns and automaton tables. read()
+    // replaces the set and validates every table entry, so a damaged
+    // file cannot make scan() index out of range.
+    void write(BinaryWriter& out) const;
+    void read(BinaryReader& in);
+
+    // Call on_match(id) for every occurrence of a pattern in text; a
+    // pattern occurring more than once is reported more than once
+    template <typename OnMatch>
+    void scan(std::string_view text, OnMatch&& on_match) const {
+        for (size_t id : empty_patterns_) {
+            on_match(id);
+        }
+        if (next_.empty()) {
+            return;
+        }
+        uint32_t state = 0;
+        for (unsigned char c : text) {
+            state = next_[state * class_count_ + classes_[c]];
+            for (uint32_t s = output_[state] >= 0 ? state : dict_link_[state]; s != 0;
+                 s = dict_link_[s]) {
+                on_match(static_cast<size_t>(output_[s]));
+            }
+        }
+    }
+
+private:
+    std::vector<std::string> patterns_;
+    std::map<std::string, size_t, std::less<>> ids_;
+    std::vector<size_t> empty_patterns_;
+
+    std::array<uint8_t, 256> classes_{};
+    size_t class_count_ = 1;
+    std::vector<uint32_t> next_;        // state * class_count_ + class -> state
+    std::vector<int32_t> output_;       // Pattern ending at the state, or -1
+    std::vector<uint32_t> dict_link_;   // Longest proper suffix state with an output, or 0
+};
+
+/**
+ * The rules of a set of rulepacks, compiled for matching
+ *
+ * Literal conditions (process_name, command_contains, url_contains,
+ * config_file) of every rule are merged into one PatternSet per candidate
+ * field, so each field is scanned once per candidate whatever the number
+ * of rules. Regexes are compiled once; one that does not compile never
+ * matches, as in RuleMatch::matches().
+ *
+ * Each rule is indexed under one condition it cannot match without: a
+ * literal (reached through the field scans), a port, or an evidence type.
+ * Rules with none of those (regex-only or unconditional) form a residual
+ * list, and rules with a parent_process condition, which never matches,
+ * are left out. apply() evaluates only the rules reached through the
+ * index, so its cost follows the rules that could match rather than the
+ * rules loaded.
+ *
+ * Rules run in rulepack order with the same results as Rulepack::apply().
+ * Evidence added by a rule makes later rules indexed under its type
+ * plausible, so chained has_evidence_type rules behave as before.
+ *
+ * apply_batch() does the same for a whole scan's candidates column by
+ * column. The distinct values of each field are laid out in one contiguous
+ * buffer and scanned once each, literal hits become one bitset over
+ * candidates per pattern, and each literal- or port-indexed rule ANDs the
+ * bitsets of its literal and port conditions. Actions run last, per
+ * candidate and in rulepack order, for the rules those bitsets left.
+ */
+class RuleMatcher {
+public:
+    explicit RuleMatcher(const std::vector<Rulepack>& rulepacks);
+
+    // As above, reading the pattern tables from write_tables() instead of
+    // building them. Throws std::runtime_error if the tables were written
+    // for other rulepacks.
+    RuleMatcher(const std::vector<Rulepack>& rulepacks, BinaryReader& tables);
+
+    void write_tables(BinaryWriter& out) const;
+
+    // Returns the number of rules evaluated
+    size_t apply(Candidate& candidate) const;
+    size_t apply_batch(std::vector<Candidate>& candidates) const;
+
+    size_t rule_count() const { return rules_.size(); }
+
+private:
+    enum Field { ProcessNameField, CommandField, UrlField, ConfigFileField, kFieldCount };
+
+    struct Condition {
+        RuleMatch::Type type;
+        int field = -1;          // Literal conditions: the field scanned
+        size_t pattern = 0;      // Literal conditions: id in that field's PatternSet
+        std::shared_ptr<const std::regex> regex;  // CommandRegex; null if invalid
+        int port = 0;            // PortEquals
+        std::string value;       // EvidenceType
+    };
+
+    struct CompiledRule {
+        std::vector<Condition> conditions;
+        std::vector<RuleAction> actions;
+    };
+
+    using RuleList = std::vector<uint32_t>;  // Rule indices, ascending
+
+    std::array<PatternSet, kFieldCount> patterns_;
+    std::vector<CompiledRule> rules_;
+
+    // Dispatch index
+    std::array<std::vector<RuleList>, kFieldCount> by_pattern_;
+    std::unordered_map<int, RuleList> by_port_;
+    std::unordered_map<std::string, RuleList> by_evidence_;
+    RuleList residual_;
+
+    struct Scratch;  // Per-thread evaluation state
+    static Scratch& scratch();
+
+    void compile(const std::vector<Rulepack>& rulepacks, BinaryReader* tables);
+    void index(uint32_t rule);
+
+    // Start a pass over one candidate; previous stamps become stale
+    void begin(Scratch& scratch) const;
+    // Queue a rule, or the rules of a list after `after`, unless already queued
+    static void push(Scratch& scratch, uint32_t rule);
+    static void enqueue(Scratch& scratch, const RuleList& rules, int64_t after);
+    // Queue the evidence-indexed and residual rules, then run the queue
+    size_t evaluate(Candidate& candidate, Scratch& scratch) const;
+
+    bool matches(const Condition& condition, const Candidate& candidate,
+                 const std::array<const uint32_t*, kFieldCount>& pattern_stamps,
+                 uint32_t epoch) const;
+};
+
+} // namespace kyros
+
+#endif // KYROS_RULE_MATCHER_HPP
@@ -2,7 +2,11 @@
 #define KYROS_RULEPACK_HPP
 
 #include <kyros/candidate.hpp>
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <nlohmann/json.hpp>
 
@@ -102,6 +106,10 @@ struct Rulepack {
     std::string description;
     std::vector<Rule> rules;
 
+    // Environment variable name prefixes that count as MCP evidence, in
+    // addition to ProcessDetectionEngine's built-in MCP_/ANTHROPIC_/CLAUDE_
+    std::vector<std::string> environment_prefixes;
+
     // Load from JSON file
     static Rulepack load_from_file(const std::string& path);
 
@@ -112,25 +120,67 @@ struct Rulepack {
     void apply(Candidate& candidate) const;
 };
 
+class RuleMatcher;
+
 /**
  * Manages multiple rulepacks
+ *
+ * The loaded rulepacks and their compiled RuleMatcher are published
+ * together as an immutable Snapshot. Loading, adding or reloading builds
+ * and compiles a new snapshot on the caller's thread and then swaps it in
+ * atomically; readers never wait for that. A scan holding a snapshot keeps
+ * using it until it lets go, even if a newer one has been published.
  */
 class RuleEngine {
 public:
+    struct Snapshot {
+        std::vector<Rulepack> rulepacks;
+        std::vector<std::string> paths;  // File of each rulepack; empty if added directly
+        std::shared_ptr<const RuleMatcher> matcher;
+        std::vector<std::string> environment_prefixes;  // Without duplicates
+        uint64_t generation = 0;  // Incremented by every publish
+    };
+
+    RuleEngine();
+
     // Add a rulepack
     void add_rulepack(const Rulepack& rulepack);
 
-    // Load rulepack from file
+    // Load rulepack from file; a compiled rulepack file (see
+    // rulepack_binary.hpp) may hold several
     void load_rulepack(const std::string& path);
 
-    // Apply all rulepacks to a candidate
+    // Add the rulepacks of a compiled rulepack file's contents. Into an
+    // empty engine this uses the file's pattern tables as they are.
+    void load_compiled(std::string_view data);
+
+    // Read every rulepack loaded from a file again and publish the result.
+    // Throws if any of them fails to load; the current snapshot stays.
+    void reload();
+
+    // The current snapshot; safe to call concurrently with a publish
+    std::shared_ptr<const Snapshot> snapshot() const;
+
+    // Apply all rulepacks to a candidate; safe to call concurrently
     void apply(Candidate& candidate) const;
 
+    // Apply all rulepacks to every candidate in one columnar pass
+    void apply(std::vector<Candidate>& candidates) const;
+
+    // environment_prefixes of every loaded rulepack, without duplicates
+    std::vector<std::string> environment_prefixes() const;
+
     // Get all loaded rulepacks
-    const std::vector<Rulepack>& rulepacks() const { return rulepacks_; }
+    std::vector<Rulepack> rulepacks() const;
 
 private:
-    std::vector<Rulepack> rulepacks_;
+    std::shared_ptr<const Snapshot> snapshot_;  // Accessed with std::atomic_load/store
+    std::mutex publish_mutex_;                   // Serializes publishers only
+
+    void publish(std::vector<Rulepack> rulepacks, std::vector<std::string> paths,
+                 std::shared_ptr<const RuleMatcher> matcher = nullptr);
+    void append(std::vector<Rulepack> added, const std::string& path,
+                std::shared_ptr<const RuleMatcher> matcher);
 };
 
 } // namespace kyros
@@ -0,0 +1,59 @@
+#ifndef KYROS_RULEPACK_BINARY_HPP
+#define KYROS_RULEPACK_BINARY_HPP
+
+#include <kyros/rule_matcher.hpp>
+#include <kyros/rulepack.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace kyros {
+
+/**
+ * Precompiled rulepacks (.kyrb)
+ *
+ * A flat little-endian file holding one or more rulepacks together with the
+ * pattern tables of their RuleMatcher, so loading one parses no JSON and
+ * builds no automaton:
+ *
+ *   "KYROSRB\0"                 magic
+ *   u32 version                 kCompiledRulepackVersion
+ *   u32 count, rulepacks        every field of Rulepack, Rule, RuleMatch
+ *                               and RuleAction, in declaration order
+ *   pattern tables              RuleMatcher::write_tables()
+ *
+ * A file with another version is rejected rather than converted; compile
+ * the JSON again. Loading checks every count, enum and table entry, so a
+ * damaged file throws instead of producing a matcher that reads out of
+ * range.
+ */
+constexpr char kCompiledRulepackMagic[8] = {'K', 'Y', 'R', 'O', 'S', 'R', 'B', '\0'};
+constexpr uint32_t kCompiledRulepackVersion = 1;
+
+struct CompiledRulepacks {
+    std::vector<Rulepack> rulepacks;
+    std::shared_ptr<const RuleMatcher> matcher;
+};
+
+// The data starts with kCompiledRulepackMagic
+bool is_compiled_rulepack(std::string_view data);
+
+std::string compile_rulepacks(const std::vector<Rulepack>& rulepacks);
+
+// Load JSON rulepack files, in order, and compile them into one file's
+// contents; throws std::runtime_error as Rulepack::load_from_file() does
+std::string compile_rulepack_files(const std::vector<std::string>& paths);
+
+// Throws std::runtime_error on a bad magic, version or body
+CompiledRulepacks load_compiled_rulepacks(std::string_view data);
+
+// The default and exclusion rulepacks compiled into the binary at build
+// time (KYROS_EMBED_RULEPACKS); empty when the build embeds none
+std::string_view embedded_rulepacks();
+
+} // namespace kyros
+
+#endif // KYROS_RULEPACK_BINARY_HPP
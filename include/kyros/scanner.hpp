@@ -16,6 +16,7 @@ class ReportingEngine;
 class PlatformAdapter;
 class ServerInterrogator;
 class HttpClient;
+class LatencyTracker;
 
 /**
  * Main Kyros scanner
@@ -30,6 +31,9 @@ public:
     // Main scan entry point
     ScanResults scan(const ScanConfig& config);
 
+    // See PassiveScanner::wait_for_config_changes()
+    bool wait_for_config_changes(int timeout_ms);
+
     // Component access (for advanced usage)
     ReportingEngine& reporting_engine();
     const ReportingEngine& reporting_engine() const;
@@ -40,6 +44,7 @@ public:
     // Rulepack management
     void load_rulepack(const std::string& path);
     void load_default_rulepacks();
+    bool reload_rulepacks();
 
 private:
     class Impl;
@@ -59,22 +64,47 @@ public:
 
     PassiveScanResults scan(const PassiveScanConfig& config);
 
+    // Block up to timeout_ms for a change to a config file seen by the last
+    // scan (PassiveScanConfig::watch_configs). Returns true as soon as one
+    // arrives; without a config watch it waits out the timeout and returns
+    // false, so a rescan loop never spins.
+    bool wait_for_config_changes(int timeout_ms);
+
     void set_platform_adapter(std::shared_ptr<PlatformAdapter> adapter);
 
     // Load rulepacks
     void load_rulepack(const std::string& path);
     void load_default_rulepacks();
 
+    // Read the loaded rulepack files again and swap in the result; scans
+    // already running finish with the rules they started with. Returns
+    // false (with a warning) and keeps the current rules if a file fails
+    // to load.
+    bool reload_rulepacks();
+
+    const RuleEngine& rule_engine() const { return *rule_engine_; }
+
 private:
+    // Background thread reloading rulepacks when their files change
+    struct RulepackWatch;
+
     std::shared_ptr<PlatformAdapter> platform_;
     std::vector<std::unique_ptr<DetectionEngine>> engines_;
     std::unique_ptr<RuleEngine> rule_engine_;
+    std::unique_ptr<RulepackWatch> rulepack_watch_;  // Stopped before rule_engine_ goes
 
     void initialize_engines();
+    void set_rulepack_watch(bool enabled);
 };
 
 /**
  * Active scanner (for internal use)
+ *
+ * Probes up to ActiveScanConfig::max_parallel_probes candidates at once.
+ * Results are reported in candidate order regardless of which probe
+ * finishes first. Handshake latencies are kept between scans to shorten
+ * the deadlines of endpoints known to answer quickly, and to hedge their
+ * probes.
  */
 class ActiveScanner {
 public:
@@ -88,12 +118,15 @@ public:
     void set_platform_adapter(std::shared_ptr<PlatformAdapter> adapter);
 
 private:
+    // Testing engines, HTTP client and interrogator owned by one probe
+    // worker thread; workers never share them
+    struct ProbeWorker;
+
     std::shared_ptr<PlatformAdapter> platform_;
-    std::shared_ptr<HttpClient> http_client_;
-    std::vector<std::unique_ptr<TestingEngine>> testing_engines_;
-    std::unique_ptr<ServerInterrogator> interrogator_;
+    std::vector<std::unique_ptr<ProbeWorker>> workers_;
+    std::unique_ptr<LatencyTracker> latency_;
 
-    void initialize_engines();
+    std::unique_ptr<ProbeWorker> create_worker() const;
 };
 
 } // namespace kyros
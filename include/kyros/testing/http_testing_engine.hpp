@@ -4,7 +4,9 @@
 #include <kyros/testing/testing_engine.hpp>
 #include <kyros/http/http_client.hpp>
 
+#include <chrono>
 #include <memory>
+#include <vector>
 
 namespace kyros {
 
@@ -18,10 +20,22 @@ public:
 private:
     std::shared_ptr<HttpClient> http_client_;
 
+    // One client per raced variant (SSE, then each path), then one per
+    // hedged copy of each; their pooled connections are handed to
+    // http_client_ after every test
+    std::vector<std::unique_ptr<HttpClient>> variant_clients_;
+
     // Helper methods
     void extract_server_info(const nlohmann::json& response, MCPServer& server);
-    std::optional<MCPServer> try_sse_transport(const Candidate& candidate);
+    // `timed_out` is set when a request ran out of `timeout`
+    std::optional<MCPServer> try_sse_transport(const Candidate& candidate, HttpClient& client,
+                                               std::chrono::milliseconds timeout, bool& timed_out);
+    std::optional<MCPServer> try_path(const Candidate& candidate, const std::string& path,
+                                      HttpClient& client, std::chrono::milliseconds timeout,
+                                      bool& timed_out);
     std::string parse_sse_endpoint(const std::string& sse_body);
+    std::shared_ptr<McpSession> make_session(const std::string& url, const HttpResponse& response,
+                                             const MCPServer& server) const;
 };
 
 } // namespace kyros
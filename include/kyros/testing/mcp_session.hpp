@@ -0,0 +1,199 @@
+#ifndef KYROS_MCP_SESSION_HPP
+#define KYROS_MCP_SESSION_HPP
+
+#include <kyros/http/http_client.hpp>
+#include <kyros/platform/process.hpp>
+
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+namespace kyros {
+
+// Entry caps for the arrays of a JSON-RPC result, by member name (e.g.
+// "tools" -> 100)
+using ResultLimits = std::map<std::string, size_t>;
+
+// Parse one JSON-RPC message (or batch) with a SAX handler that keeps at
+// most the capped number of entries of each limited result array; later
+// entries are skipped without being built. Returns a discarded value for
+// invalid JSON.
+nlohmann::json parse_capped_message(std::string_view text, const ResultLimits& limits);
+
+// The next piece of a message as it arrives; sets `end` on the last one.
+// Throws on transport errors and timeouts.
+using MessageReader = std::function<std::string_view(bool& end)>;
+
+// parse_capped_message over a message read while it arrives, holding no
+// more than max_bytes of it: the kept values plus the token being parsed
+// (skipped entries do not count). Throws past that bound. Once a single
+// response's capped array is full and its id has been seen, the parse
+// stops and the rest of the message is left unread for the caller to
+// drain or discard.
+nlohmann::json parse_capped_message(const MessageReader& read, const ResultLimits& limits,
+                                    size_t max_bytes);
+
+/**
+ * An initialized MCP connection, handed from a testing engine to the
+ * interrogator
+ *
+ * A testing engine that confirms a server has already completed the
+ * initialize exchange; the session keeps that connection (the live stdio
+ * process, or the HTTP endpoint and its session id) so interrogation does
+ * not start the server a second time. The "notifications/initialized"
+ * notification that completes the handshake is sent before the first
+ * request.
+ *
+ * A session is used by one thread at a time. Closing it (or destroying
+ * the last reference) terminates a stdio server.
+ */
+class McpSession {
+public:
+    virtual ~McpSession() = default;
+
+    // The initialize request Kyros sends
+    static nlohmann::json initialize_request(int id);
+
+    // Run the initialize exchange on a fresh connection and record what it
+    // negotiated. Sessions handed over by a testing engine skip this.
+    nlohmann::json initialize(std::chrono::milliseconds timeout);
+
+    // Send a JSON-RPC request and return the response with the same id,
+    // completing the handshake first if needed. Throws on transport errors
+    // and timeouts.
+    nlohmann::json request(const nlohmann::json& request, std::chrono::milliseconds timeout);
+
+    // Send several requests with distinct ids at once and return their
+    // responses in request order, sharing one timeout. A request that
+    // failed (transport error, bad reply) or that the server never
+    // answered gets a null response and, in `errors` if given, the reason;
+    // the others keep their responses. Throws only if the session is
+    // closed.
+    std::vector<nlohmann::json> request_all(const std::vector<nlohmann::json>& requests,
+                                            std::chrono::milliseconds timeout,
+                                            std::vector<std::string>* errors = nullptr);
+
+    virtual bool is_open() const = 0;
+    virtual void close() = 0;
+
+    // Negotiated in the initialize exchange
+    const std::string& protocol_version() const { return protocol_version_; }
+    const nlohmann::json& capabilities() const { return capabilities_; }
+
+    // Caps applied while parsing later responses (parse_capped_message)
+    void set_result_limits(ResultLimits limits) { result_limits_ = std::move(limits); }
+
+    // Most of a response held at once. Responses are parsed as they
+    // arrive, so this bounds what the caps keep, not the response size;
+    // event-stream bodies over HTTP are still read whole up to it.
+    virtual void set_max_message_bytes(size_t bytes) = 0;
+
+protected:
+    McpSession(std::string protocol_version, nlohmann::json capabilities)
+        : protocol_version_(std::move(protocol_version)), capabilities_(std::move(capabilities)) {}
+
+    std::string protocol_version_;
+    nlohmann::json capabilities_;
+    ResultLimits result_limits_;
+
+    nlohmann::json parse_message(std::string_view text) const {
+        return parse_capped_message(text, result_limits_);
+    }
+
+    // Transport: one request/response, and one one-way notification
+    virtual nlohmann::json exchange(const nlohmann::json& request,
+                                    std::chrono::milliseconds timeout) = 0;
+    virtual void notify(const nlohmann::json& notification, std::chrono::milliseconds timeout) = 0;
+
+    // Several requests; one exchange() after another unless the transport
+    // can overlap them. Failures are reported per request in `errors`
+    // (sized like `requests`) rather than thrown.
+    virtual std::vector<nlohmann::json> exchange_all(const std::vector<nlohmann::json>& requests,
+                                                     std::chrono::milliseconds timeout,
+                                                     std::vector<std::string>& errors);
+
+private:
+    bool initialized_sent_ = false;
+
+    void complete_handshake(std::chrono::milliseconds timeout);
+};
+
+/**
+ * Session over a spawned server's stdin/stdout
+ *
+ * Several requests are pipelined: written back to back, with responses
+ * matched to them by id in whatever order they arrive.
+ */
+class StdioMcpSession : public McpSession {
+public:
+    StdioMcpSession(std::unique_ptr<Process> process, std::string protocol_version,
+                    nlohmann::json capabilities);
+    ~StdioMcpSession() override;
+
+    bool is_open() const override;
+    void close() override;
+    void set_max_message_bytes(size_t bytes) override;
+
+protected:
+    nlohmann::json exchange(const nlohmann::json& request,
+                            std::chrono::milliseconds timeout) override;
+    void notify(const nlohmann::json& notification, std::chrono::milliseconds timeout) override;
+    std::vector<nlohmann::json> exchange_all(const std::vector<nlohmann::json>& requests,
+                                             std::chrono::milliseconds timeout,
+                                             std::vector<std::string>& errors) override;
+
+private:
+    std::unique_ptr<Process> process_;
+    size_t max_message_bytes_ = FrameReader::kDefaultMaxFrameBytes;
+};
+
+/**
+ * Session over HTTP POSTs to the endpoint that answered initialize
+ *
+ * Carries the Mcp-Session-Id the server assigned, if any. Responses sent
+ * as a text/event-stream are unwrapped from their data: lines. Several
+ * requests go out as one JSON-RPC batch; once a server rejects a batch,
+ * the session sends them one at a time instead.
+ */
+class HttpMcpSession : public McpSession {
+public:
+    HttpMcpSession(std::shared_ptr<HttpClient> client, std::string url, std::string session_id,
+                   std::string protocol_version, nlohmann::json capabilities);
+
+    bool is_open() const override { return client_ != nullptr; }
+    void close() override { client_.reset(); }
+    void set_max_message_bytes(size_t bytes) override { max_body_bytes_ = bytes; }
+
+    const std::string& url() const { return url_; }
+    const std::string& session_id() const { return session_id_; }
+
+protected:
+    nlohmann::json exchange(const nlohmann::json& request,
+                            std::chrono::milliseconds timeout) override;
+    void notify(const nlohmann::json& notification, std::chrono::milliseconds timeout) override;
+    std::vector<nlohmann::json> exchange_all(const std::vector<nlohmann::json>& requests,
+                                             std::chrono::milliseconds timeout,
+                                             std::vector<std::string>& errors) override;
+
+private:
+    std::shared_ptr<HttpClient> client_;
+    std::string url_;
+    std::string session_id_;
+    bool batch_rejected_ = false;
+    size_t max_body_bytes_ = HttpClient::kMaxBodyBytes;  // The client is shared; set per post
+
+    // POST `message`. With `parsed`, a 200 JSON body is parsed into it as
+    // it arrives rather than returned in the response.
+    HttpResponse post(const nlohmann::json& message, std::chrono::milliseconds timeout,
+                      nlohmann::json* parsed = nullptr);
+};
+
+} // namespace kyros
+
+#endif // KYROS_MCP_SESSION_HPP
@@ -0,0 +1,55 @@
+#ifndef KYROS_PREFLIGHT_HPP
+#define KYROS_PREFLIGHT_HPP
+
+#include <kyros/candidate.hpp>
+
+#include <chrono>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace kyros {
+
+/**
+ * Cheap checks on listener candidates before any MCP handshake
+ *
+ * Listener candidates (those with an address and port) are filtered in
+ * three steps: UDP listeners are dropped, dual-stack duplicates of the same
+ * pid:port (IPv4 and IPv6 wildcard or loopback) keep only their first
+ * entry, and each remaining endpoint gets one non-blocking connect and a
+ * minimal HTTP request. An endpoint whose first bytes cannot start an HTTP
+ * status line (an SSH or SMTP banner, a database handshake, a TLS alert)
+ * or that refuses the connection is rejected. Endpoints that stay silent
+ * until the deadline are kept, as the full probe decides those.
+ *
+ * All endpoints are sniffed together from one poll() loop. Candidates
+ * without a port pass through untouched.
+ */
+class Preflight {
+public:
+    enum class Verdict {
+        Http,       // Starts with "HTTP/"
+        NotHttp,    // Cannot be an HTTP response
+        Undecided   // Too few bytes to tell
+    };
+
+    explicit Preflight(std::chrono::milliseconds timeout = std::chrono::milliseconds(200));
+
+    // Why each candidate should not be probed, in order; an empty reason
+    // means probe it
+    std::vector<std::string> check(const std::vector<const Candidate*>& candidates);
+
+    // Classify the first bytes an endpoint sent back
+    static Verdict classify(std::string_view first_bytes);
+
+private:
+    std::chrono::milliseconds timeout_;
+
+    // Sniff the endpoints at these positions, filling in their reasons
+    void sniff(const std::vector<const Candidate*>& candidates, const std::vector<size_t>& positions,
+               std::vector<std::string>& reasons);
+};
+
+} // namespace kyros
+
+#endif // KYROS_PREFLIGHT_HPP
@@ -19,6 +19,9 @@ public:
         std::shared_ptr<HttpClient> http_client
     );
 
+    // Lists the server's tools, resources and prompts. Uses server.session
+    // when the testing engine kept one, otherwise connects and initializes
+    // afresh; either way the session is closed afterwards.
     void interrogate(MCPServer& server);
 
     // Request creation helpers (public for testing)
@@ -39,10 +42,7 @@ private:
     std::shared_ptr<HttpClient> http_client_;
 
     // Helper methods for interrogation
-    void interrogate_tools(MCPServer& server, const std::function<nlohmann::json(const nlohmann::json&)>& send_request);
-    void interrogate_resources(MCPServer& server, const std::function<nlohmann::json(const nlohmann::json&)>& send_request);
-    void interrogate_resource_templates(MCPServer& server, const std::function<nlohmann::json(const nlohmann::json&)>& send_request);
-    void interrogate_prompts(MCPServer& server, const std::function<nlohmann::json(const nlohmann::json&)>& send_request);
+    std::shared_ptr<McpSession> open_session(MCPServer& server);
 };
 
 } // namespace kyros
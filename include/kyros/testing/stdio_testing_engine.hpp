@@ -13,10 +13,22 @@ public:
     std::string name() const override { return "StdioTestingEngine"; }
     std::optional<MCPServer> test(const Candidate& candidate) override;
 
+    // Runs all probes from one ProbeReactor when the platform has one
+    std::vector<std::optional<MCPServer>> test_batch(
+        const std::vector<const Candidate*>& candidates,
+        std::vector<ProbeTiming>* timings = nullptr) override;
+    bool prefers_batch() override;
+
 private:
     std::shared_ptr<PlatformAdapter> platform_;
+    std::unique_ptr<ProbeReactor> reactor_;
+    bool reactor_checked_ = false;
 
     // Helper methods
+    bool should_probe(const Candidate& candidate) const;
+    std::unique_ptr<Process> spawn(const Candidate& candidate) const;
+    std::optional<MCPServer> parse_response(const Candidate& candidate,
+                                            std::string_view response_line);
     void extract_server_info(const nlohmann::json& response, MCPServer& server);
 };
 
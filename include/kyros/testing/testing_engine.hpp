@@ -4,23 +4,93 @@
 #include <kyros/candidate.hpp>
 #include <kyros/mcp_server.hpp>
 #include <nlohmann/json.hpp>
+#include <algorithm>
 #include <chrono>
+#include <functional>
 #include <optional>
+#include <vector>
 
 namespace kyros {
 
 class TestingEngine {
 public:
+    // How long probing one candidate took, whether it ended because its
+    // timeout ran out rather than with an answer or a refusal, and
+    // whether a second probe went out at its hedge point
+    struct ProbeTiming {
+        std::chrono::milliseconds elapsed{0};
+        bool timed_out = false;
+        bool hedged = false;
+    };
+
+    // Timeout (or hedge point) for one candidate, in place of timeout()
+    using TimeoutFunction = std::function<std::chrono::milliseconds(const Candidate&)>;
+
+    // Continues the conversation with a confirmed server over its kept
+    // session; `thread` (< the thread count given) says which handler
+    // thread is calling
+    using SessionHandler = std::function<void(MCPServer& server, size_t thread)>;
+
     virtual ~TestingEngine() = default;
 
     virtual std::string name() const = 0;
     virtual std::optional<MCPServer> test(const Candidate& candidate) = 0;
 
+    // Test several candidates at once; results are in candidate order. The
+    // default calls test() for each. Engines that can overlap their probes
+    // override this and return true from prefers_batch(), which tells the
+    // scanner to hand them every candidate in one call instead of one per
+    // worker thread. `timings` is filled in candidate order.
+    virtual std::vector<std::optional<MCPServer>> test_batch(
+        const std::vector<const Candidate*>& candidates,
+        std::vector<ProbeTiming>* timings = nullptr);
+    virtual bool prefers_batch() { return false; }
+
     void set_timeout(std::chrono::milliseconds timeout) { timeout_ = timeout; }
     std::chrono::milliseconds timeout() const { return timeout_; }
 
+    // Per-candidate timeouts (adaptive deadlines); null restores timeout()
+    // for every candidate
+    void set_timeout_function(TimeoutFunction function) { timeout_function_ = std::move(function); }
+
+    // When a probe still unanswered is sent again, the first answer of
+    // either winning; zero or a null function means never. Engines whose
+    // probes cannot be repeated without side effects ignore this.
+    void set_hedge_function(TimeoutFunction function) { hedge_function_ = std::move(function); }
+
+    // Timing of the last test() call
+    const ProbeTiming& last_probe() const { return last_probe_; }
+
+    // Keep the initialized connection of a confirmed server in
+    // MCPServer::session instead of closing it (set when the server will
+    // be interrogated next)
+    void set_keep_sessions(bool keep) { keep_sessions_ = keep; }
+
+    // Have test_batch() run handler on each kept session as soon as its
+    // server is confirmed, on up to `threads` threads while the rest are
+    // still being probed, and close the session afterwards. An engine that
+    // probes in batches holds a probe's slot until then; one that does not
+    // ignores this and returns the sessions as test() does.
+    void set_session_handler(SessionHandler handler, size_t threads) {
+        session_handler_ = std::move(handler);
+        session_threads_ = std::max<size_t>(threads, 1);
+    }
+
 protected:
     std::chrono::milliseconds timeout_{5000};
+    bool keep_sessions_ = false;
+    SessionHandler session_handler_;
+    size_t session_threads_ = 1;
+    TimeoutFunction timeout_function_;
+    TimeoutFunction hedge_function_;
+    ProbeTiming last_probe_;  // Filled by test()
+
+    std::chrono::milliseconds timeout_for(const Candidate& candidate) const {
+        return timeout_function_ ? timeout_function_(candidate) : timeout_;
+    }
+    std::chrono::milliseconds hedge_for(const Candidate& candidate) const {
+        return hedge_function_ ? hedge_function_(candidate) : std::chrono::milliseconds(0);
+    }
 
     bool is_valid_mcp_response(const nlohmann::json& response) const;
     nlohmann::json create_initialize_request(int id = 1) const;
@@ -0,0 +1,120 @@
+#ifndef KYROS_BINARY_IO_HPP
+#define KYROS_BINARY_IO_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace kyros {
+
+/**
+ * Little-endian encoding for flat binary files
+ *
+ * Integers are written byte by byte, so files read the same on any host.
+ * Strings are a u32 length followed by the bytes. BinaryReader throws
+ * std::runtime_error on any read past the end of its data.
+ */
+class BinaryWriter {
+public:
+    explicit BinaryWriter(std::string& out) : out_(out) {}
+
+    void u8(uint8_t value) { out_.push_back(static_cast<char>(value)); }
+
+    void u32(uint32_t value) {
+        for (int shift = 0; shift < 32; shift += 8) {
+            u8(static_cast<uint8_t>(value >> shift));
+        }
+    }
+
+    void u64(uint64_t value) {
+        for (int shift = 0; shift < 64; shift += 8) {
+            u8(static_cast<uint8_t>(value >> shift));
+        }
+    }
+
+    void f64(double value) {
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        u64(bits);
+    }
+
+    void bytes(std::string_view data) { out_.append(data.data(), data.size()); }
+
+    void str(std::string_view value) {
+        u32(static_cast<uint32_t>(value.size()));
+        bytes(value);
+    }
+
+private:
+    std::string& out_;
+};
+
+class BinaryReader {
+public:
+    explicit BinaryReader(std::string_view data) : data_(data) {}
+
+    uint8_t u8() {
+        need(1);
+        return static_cast<uint8_t>(data_[pos_++]);
+    }
+
+    uint32_t u32() {
+        uint32_t value = 0;
+        for (int shift = 0; shift < 32; shift += 8) {
+            value |= static_cast<uint32_t>(u8()) << shift;
+        }
+        return value;
+    }
+
+    uint64_t u64() {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 8) {
+            value |= static_cast<uint64_t>(u8()) << shift;
+        }
+        return value;
+    }
+
+    double f64() {
+        uint64_t bits = u64();
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    std::string_view bytes(size_t size) {
+        need(size);
+        std::string_view view = data_.substr(pos_, size);
+        pos_ += size;
+        return view;
+    }
+
+    std::string str() { return std::string(bytes(u32())); }
+
+    // A count of elements at least min_size bytes each; rejects counts the
+    // remaining data cannot hold before anything is allocated for them
+    uint32_t count(size_t min_size = 1) {
+        uint32_t n = u32();
+        if (static_cast<uint64_t>(n) * min_size > remaining()) {
+            throw std::runtime_error("Truncated binary data");
+        }
+        return n;
+    }
+
+    size_t remaining() const { return data_.size() - pos_; }
+
+private:
+    std::string_view data_;
+    size_t pos_ = 0;
+
+    void need(size_t size) const {
+        if (size > remaining()) {
+            throw std::runtime_error("Truncated binary data");
+        }
+    }
+};
+
+} // namespace kyros
+
+#endif // KYROS_BINARY_IO_HPP
@@ -0,0 +1,33 @@
+#ifndef KYROS_CACHE_FILE_HPP
+#define KYROS_CACHE_FILE_HPP
+
+#include <kyros/types.hpp>
+
+#include <cstdint>
+#include <string>
+#include <nlohmann/json.hpp>
+
+namespace kyros {
+
+/**
+ * Helpers for the JSON state files kept between runs (probe cache, latency
+ * history)
+ */
+
+// `name` in $XDG_CACHE_HOME/kyros, else in ~/.cache/kyros; empty if
+// neither variable is set
+std::string cache_file_path(const std::string& name);
+
+// Replace the file at `path` with `json`, creating missing directories.
+// The JSON is written beside the file and renamed over it, so a concurrent
+// run never reads half a file. Throws std::runtime_error (or
+// std::filesystem::filesystem_error) on failure.
+void write_json_atomically(const std::string& path, const nlohmann::json& json);
+
+// Timestamps are stored as whole seconds since the epoch
+int64_t to_epoch_seconds(Timestamp time);
+Timestamp from_epoch_seconds(int64_t seconds);
+
+} // namespace kyros
+
+#endif // KYROS_CACHE_FILE_HPP
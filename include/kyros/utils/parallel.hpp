@@ -0,0 +1,35 @@
+#ifndef KYROS_PARALLEL_HPP
+#define KYROS_PARALLEL_HPP
+
+#include <cstddef>
+#include <functional>
+
+namespace kyros {
+
+/**
+ * Run body(i) for every i in [0, count) on up to max_workers threads
+ *
+ * The calling thread is one of the workers. Indices are handed out in
+ * ascending order from a shared counter, so with fewer workers than items
+ * the earliest items start first. With max_workers <= 1, or a single
+ * item, everything runs inline on the calling thread.
+ *
+ * Callers write results into per-index slots and merge them afterwards;
+ * that keeps the output independent of scheduling. If body throws, the
+ * remaining items still run and the exception from the lowest index is
+ * rethrown once every worker has finished.
+ */
+void parallel_for(size_t count, size_t max_workers, const std::function<void(size_t)>& body);
+
+// As above, also passing the index of the worker running the item
+// (0 <= worker < min(count, max_workers)), for callers that keep
+// per-worker state such as connections or scratch buffers
+void parallel_for_workers(size_t count, size_t max_workers,
+                          const std::function<void(size_t index, size_t worker)>& body);
+
+// Number of workers parallel_for_workers() will use
+size_t parallel_worker_count(size_t count, size_t max_workers);
+
+} // namespace kyros
+
+#endif // KYROS_PARALLEL_HPP
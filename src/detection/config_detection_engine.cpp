@@ -9,9 +9,34 @@ namespace kyros {
 ConfigDetectionEngine::ConfigDetectionEngine(std::shared_ptr<ConfigScan> scan_type)
     : scan_type_(scan_type) {}
 
+void ConfigDetectionEngine::set_watch_mode(bool enabled) {
+    if (watch_mode_ == enabled) {
+        return;
+    }
+
+    watch_mode_ = enabled;
+    watcher_.reset();
+    watches_primed_ = false;
+    pending_overflow_ = false;
+    pending_changes_.clear();
+}
+
+bool ConfigDetectionEngine::wait_for_changes(int timeout_ms) {
+    if (!watcher_ || !watches_primed_) {
+        return false;
+    }
+
+    size_t before = pending_changes_.size();
+    if (!watcher_->poll(pending_changes_, timeout_ms)) {
+        pending_overflow_ = true;
+    }
+    return pending_overflow_ || pending_changes_.size() > before;
+}
+
 std::vector<Candidate> ConfigDetectionEngine::detect() {
     std::vector<Candidate> candidates;
     last_scan_config_count_ = 0;
+    last_scan_parsed_count_ = 0;
 
     if (!scan_type_ || !scan_type_->is_enabled()) {
         return candidates;
@@ -21,43 +46,129 @@ std::vector<Candidate> ConfigDetectionEngine::detect() {
         return candidates;
     }
 
+    // In watch mode only paths touched by a change notification are read
+    // again; everything else is served from the previous scan
+    bool rescan_all = true;
+    std::vector<std::string> changed;
+    if (watch_mode_) {
+        if (!watcher_) {
+            watcher_ = platform_->create_file_watcher();
+        }
+        if (watcher_ && watches_primed_) {
+            changed.swap(pending_changes_);
+            bool complete = watcher_->poll(changed) && !pending_overflow_;
+            pending_overflow_ = false;
+            rescan_all = !complete;
+        }
+    }
+
     // Get all config paths to scan
     auto config_paths = scan_type_->get_all_paths();
+    if (config_paths.size() != config_cache_.size()) {
+        rescan_all = true;
+    }
+    config_cache_.resize(config_paths.size());
 
-    for (const auto& path : config_paths) {
-        try {
-            // Expand path (handle ~ and environment variables)
-            std::string expanded_path = platform_->expand_path(path);
+    for (size_t i = 0; i < config_paths.size(); i++) {
+        ConfigEntry& entry = config_cache_[i];
+        if (rescan_all || entry.source_path != config_paths[i] ||
+            is_affected(entry.expanded_path, changed)) {
+            refresh_config_entry(config_paths[i], entry);
+        }
 
-            // Check if file exists
-            if (!platform_->file_exists(expanded_path)) {
-                continue;
+        if (!entry.exists) {
+            continue;
+        }
+
+        // Count this config file as checked
+        last_scan_config_count_++;
+        candidates.insert(candidates.end(), entry.candidates.begin(), entry.candidates.end());
+    }
+
+    // Scan Claude Extensions directory
+    bool extensions_changed = rescan_all;
+    for (const auto& base : extension_bases_) {
+        if (extensions_changed) break;
+        extensions_changed = is_affected(base, changed);
+        for (const auto& path : changed) {
+            if (is_affected(path, {base})) {
+                extensions_changed = true;  // Something inside an extension
+                break;
             }
+        }
+    }
+    if (extensions_changed) {
+        extension_cache_ = scan_claude_extensions();
+    }
+    candidates.insert(candidates.end(), extension_cache_.begin(), extension_cache_.end());
+    last_scan_config_count_ += static_cast<int>(extension_cache_.size());
 
-            // Count this config file as checked
-            last_scan_config_count_++;
+    watches_primed_ = (watcher_ != nullptr);
+    return candidates;
+}
 
-            // Parse config file
-            auto server_configs = parse_config_file(expanded_path);
+void ConfigDetectionEngine::refresh_config_entry(const std::string& path, ConfigEntry& entry) {
+    entry.source_path = path;
+    entry.exists = false;
+    entry.candidates.clear();
 
-            // Create candidate for each server found
-            for (const auto& config : server_configs) {
-                auto candidate = create_candidate_from_config(config, expanded_path);
-                candidates.push_back(candidate);
-            }
+    try {
+        // Expand path (handle ~ and environment variables)
+        entry.expanded_path = platform_->expand_path(path);
 
-        } catch (const std::exception& e) {
-            // Log error but continue processing other files
-            std::cerr << "Error processing config file " << path << ": "
-                     << e.what() << std::endl;
+        // Watch before reading so a write in between isn't missed
+        if (watcher_) {
+            watch_parent_of(entry.expanded_path);
+        }
+
+        // Check if file exists
+        if (!platform_->file_exists(entry.expanded_path)) {
+            return;
         }
+        entry.exists = true;
+
+        // Parse config file
+        last_scan_parsed_count_++;
+        auto server_configs = parse_config_file(entry.expanded_path);
+
+        // Create candidate for each server found
+        for (const auto& config : server_configs) {
+            entry.candidates.push_back(create_candidate_from_config(config, entry.expanded_path));
+        }
+
+    } catch (const std::exception& e) {
+        // Log error but continue processing other files
+        std::cerr << "Error processing config file " << path << ": "
+                 << e.what() << std::endl;
     }
+}
 
-    // Scan Claude Extensions directory
-    auto extension_candidates = scan_claude_extensions();
-    candidates.insert(candidates.end(), extension_candidates.begin(), extension_candidates.end());
+void ConfigDetectionEngine::watch_parent_of(const std::string& path) {
+    // Watch the closest existing directory above path. If intermediate
+    // directories don't exist yet, their creation is reported there.
+    std::string dir = path;
+    while (true) {
+        size_t slash = dir.find_last_of('/');
+        if (slash == std::string::npos || slash == 0) {
+            return;
+        }
+        dir.resize(slash);
+        if (watcher_->watch_directory(dir)) {
+            return;
+        }
+    }
+}
 
-    return candidates;
+bool ConfigDetectionEngine::is_affected(const std::string& path,
+                                        const std::vector<std::string>& changed) {
+    // A change to the file itself, or to any directory on its path
+    for (const auto& entry : changed) {
+        if (path.compare(0, entry.size(), entry) == 0 &&
+            (path.size() == entry.size() || path[entry.size()] == '/')) {
+            return true;
+        }
+    }
+    return false;
 }
 
 std::vector<ServerConfig> ConfigDetectionEngine::parse_config_file(const std::string& path) {
@@ -208,9 +319,16 @@ std::vector<Candidate> ConfigDetectionEngine::scan_claude_extensions() {
         "~/.config/Claude/Claude Extensions",  // Linux
     };
 
+    extension_bases_.clear();
     for (const auto& base_path : extension_base_paths) {
         try {
             std::string expanded_base = platform_->expand_path(base_path);
+            extension_bases_.push_back(expanded_base);
+
+            // The base directory itself, or its closest existing ancestor
+            if (watcher_) {
+                watch_parent_of(expanded_base + "/");
+            }
 
             // Check if directory exists
             if (!platform_->file_exists(expanded_base)) {
@@ -229,6 +347,13 @@ std::vector<Candidate> ConfigDetectionEngine::scan_claude_extensions() {
                         continue;
                     }
 
+                    // Entry points appear inside these directories
+                    if (watcher_) {
+                        watcher_->watch_directory(extension_path);
+                        watcher_->watch_directory(extension_path + "/dist");
+                        watcher_->watch_directory(extension_path + "/build");
+                    }
+
                     // Look for entry point: dist/index.js (most common)
                     std::string entry_point = extension_path + "/dist/index.js";
 
@@ -264,7 +389,6 @@ std::vector<Candidate> ConfigDetectionEngine::scan_claude_extensions() {
                     candidate.add_evidence(extension_evidence);
 
                     candidates.push_back(candidate);
-                    last_scan_config_count_++;  // Count as a config source
 
                 } catch (const std::exception& e) {
                     std::cerr << "Error processing extension " << extension_name << ": "
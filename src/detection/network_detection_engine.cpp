@@ -18,10 +18,18 @@ std::vector<Candidate> NetworkDetectionEngine::detect() {
     auto listeners = platform_->get_listening_sockets();
     last_scan_socket_count_ = static_cast<int>(listeners.size());
 
+    // Owning processes are resolved from the scan's process snapshot,
+    // taken only once we know at least one listener has a PID
+    std::shared_ptr<const ProcessTable> table;
+    bool table_loaded = false;
+
     // Create candidate for each listener
     for (const auto& listener : listeners) {
         Candidate candidate;
         candidate.pid = listener.pid;
+        candidate.address = listener.address;
+        candidate.port = listener.port;
+        candidate.socket_protocol = listener.protocol;
 
         // Build URL for HTTP transport
         // Default to http:// for local addresses
@@ -44,8 +52,18 @@ std::vector<Candidate> NetworkDetectionEngine::detect() {
 
         // Get process info if available
         if (listener.pid > 0) {
-            candidate.process_name = platform_->get_process_name(listener.pid);
-            candidate.command = platform_->get_command_line(listener.pid);
+            if (!table_loaded) {
+                table = process_snapshot();
+                table_loaded = true;
+            }
+            auto row = table ? table->find(listener.pid) : std::nullopt;
+            if (row) {
+                candidate.process_name = std::string(table->name(*row));
+                candidate.command = std::string(table->command_line(*row));
+            } else {
+                candidate.process_name = platform_->get_process_name(listener.pid);
+                candidate.command = platform_->get_command_line(listener.pid);
+            }
         }
 
         // Add evidence
@@ -13,36 +13,57 @@ std::vector<Candidate> ProcessDetectionEngine::detect() {
 
     if (!platform_) {
         last_scan_process_count_ = 0;
+        last_scan_evaluated_count_ = 0;
         return candidates;
     }
 
-    // Get all running processes
-    std::vector<int> pids = platform_->get_process_list();
-    last_scan_process_count_ = static_cast<int>(pids.size());
+    // One snapshot of the process table; names, command lines and
+    // parents are resolved from it rather than per-PID platform calls
+    auto table = process_snapshot();
+    if (!table) {
+        last_scan_process_count_ = 0;
+        last_scan_evaluated_count_ = 0;
+        return candidates;
+    }
+    last_scan_process_count_ = static_cast<int>(table->size());
+    last_scan_evaluated_count_ = 0;
 
-    // Check each process for MCP server indicators
-    for (int pid : pids) {
-        Candidate candidate;
-        candidate.pid = pid;
+    // Entries for processes that are gone are dropped by rebuilding the
+    // cache from the rows seen in this scan
+    std::unordered_map<int, CachedProcess> next_cache;
+    next_cache.reserve(table->size());
 
-        // Get process name and command line
-        candidate.process_name = platform_->get_process_name(pid);
-        std::string cmdline = platform_->get_command_line(pid);
+    // Pipe ownership for all processes; the platform only re-reads the
+    // descriptors of processes that changed since it last built one. Null
+    // when the platform can only answer per PID
+    auto pipes = platform_->build_pipe_index();
+
+    // Check each process for MCP server indicators
+    for (size_t row = 0; row < table->size(); row++) {
+        std::string_view name = table->name(row);
+        std::string_view cmdline = table->command_line(row);
 
         // Skip if we can't get basic info
-        if (candidate.process_name.empty() && cmdline.empty()) {
+        if (name.empty() && cmdline.empty()) {
             continue;
         }
 
+        int pid = table->pid(row);
+        Candidate candidate;
+        candidate.pid = pid;
+        candidate.process_name = std::string(name);
+
         // Store command for reference
         if (!cmdline.empty()) {
-            candidate.command = cmdline;
+            candidate.command = std::string(cmdline);
+            auto args = table->argv(row);
+            candidate.argv.assign(args.begin(), args.end());
         }
 
         // Check various indicators
-        check_parent_process(pid, candidate);
-        check_file_descriptors(pid, candidate);
-        check_environment(pid, candidate);
+        check_parent_process(*table, row, candidate);
+        check_file_descriptors(*table, pipes.get(), pid, candidate);
+        check_environment(*table, row, candidate, next_cache);
 
         // Only add candidates with at least some evidence
         if (!candidate.evidence.empty()) {
@@ -50,85 +71,169 @@ std::vector<Candidate> ProcessDetectionEngine::detect() {
         }
     }
 
+    process_cache_.swap(next_cache);
     return candidates;
 }
 
-void ProcessDetectionEngine::check_parent_process(int pid, Candidate& candidate) {
-    if (!platform_) return;
-
-    int parent_pid = platform_->get_parent_pid(pid);
+void ProcessDetectionEngine::check_parent_process(const ProcessTable& table, size_t row,
+                                                  Candidate& candidate) {
+    int parent_pid = table.ppid(row);
     if (parent_pid <= 0) return;
 
-    std::string parent_name = platform_->get_process_name(parent_pid);
+    auto parent_row = table.find(parent_pid);
+    if (!parent_row) return;
+
+    std::string parent_name(table.name(*parent_row));
     if (parent_name.empty()) return;
 
+    // Check if parent is a known MCP client
+    if (is_known_client(parent_name)) {
+        Evidence evidence(
+            "parent_process",
+            "Parent process is MCP client: " + parent_name,
+            0.7,  // Confidence score
+            "",   // Source (empty)
+            Evidence::Strength::Weak  // Weak evidence - too many false positives alone
+        );
+        candidate.add_evidence(evidence);
+    }
+}
+
+bool ProcessDetectionEngine::is_known_client(const std::string& name) {
     // Known MCP client applications
-    const std::vector<std::string> known_clients = {
+    static const std::vector<std::string> known_clients = {
         "Claude", "claude", "Claude.app",
         "Cursor", "cursor",
         "code", "Code", "Visual Studio Code",
         "windsurf", "Windsurf"
     };
 
-    // Check if parent is a known MCP client
     for (const auto& client : known_clients) {
-        if (parent_name.find(client) != std::string::npos) {
-            Evidence evidence(
-                "parent_process",
-                "Parent process is MCP client: " + parent_name,
-                0.7,  // Confidence score
-                "",   // Source (empty)
-                Evidence::Strength::Weak  // Weak evidence - too many false positives alone
-            );
-            candidate.add_evidence(evidence);
-            break;
+        if (name.find(client) != std::string::npos) {
+            return true;
         }
     }
+    return false;
 }
 
-void ProcessDetectionEngine::check_file_descriptors(int pid, Candidate& candidate) {
+void ProcessDetectionEngine::check_file_descriptors(const ProcessTable& table, const PipeIndex* pipes,
+                                                    int pid, Candidate& candidate) {
     if (!platform_) return;
 
     // Check if process has bidirectional pipes (stdin + stdout both pipes)
     // This is a strong indicator of MCP stdio transport
-    if (platform_->has_bidirectional_pipes(pid)) {
-        Evidence evidence(
-            "file_descriptors",
-            "Process has bidirectional pipes (stdio transport)",
-            0.6,  // Confidence score
+    bool bidirectional = pipes ? pipes->has_bidirectional_pipes(pid)
+                               : platform_->has_bidirectional_pipes(pid);
+    if (!bidirectional) return;
+
+    Evidence evidence(
+        "file_descriptors",
+        "Process has bidirectional pipes (stdio transport)",
+        0.6,  // Confidence score
+        "",   // Source (empty)
+        Evidence::Strength::Moderate  // Moderate - LSP/IPC also use pipes
+    );
+    candidate.add_evidence(evidence);
+    candidate.transport_hint = TransportType::Stdio;
+
+    // Find who holds the other end of stdin/stdout. Unlike the parent
+    // check this survives launchers and wrappers that exit after spawning.
+    if (!pipes) return;
+
+    auto client_pid = pipes->find_client(pid);
+    if (!client_pid) return;
+
+    auto client_row = table.find(*client_pid);
+    if (!client_row) return;
+
+    std::string client_name(table.name(*client_row));
+    if (is_known_client(client_name)) {
+        Evidence client_evidence(
+            "stdio_client",
+            "Connected over stdio pipes to MCP client: " + client_name +
+                " (pid " + std::to_string(*client_pid) + ")",
+            0.8,  // Confidence score
             "",   // Source (empty)
-            Evidence::Strength::Moderate  // Moderate - LSP/IPC also use pipes
+            Evidence::Strength::Strong  // Client holds the server's stdio - direct link
         );
-        candidate.add_evidence(evidence);
-        candidate.transport_hint = TransportType::Stdio;
+        candidate.add_evidence(client_evidence);
     }
 }
 
-void ProcessDetectionEngine::check_environment(int pid, Candidate& candidate) {
+void ProcessDetectionEngine::check_environment(const ProcessTable& table, size_t row,
+                                               Candidate& candidate,
+                                               std::unordered_map<int, CachedProcess>& next_cache) {
     if (!platform_) return;
 
-    auto env = platform_->get_environment(pid);
+    int pid = table.pid(row);
+    uint64_t start_time = table.start_time(row);
+    uint32_t exec_count = table.exec_count(row);
+    size_t command_hash = std::hash<std::string_view>()(table.command_line(row));
+
+    // The environment is fixed at exec, so the result for the same
+    // process generation (pid + start time + exec count) and command line
+    // is reused.
+    // A start time of 0 means the platform can't tell PID reuse apart.
+    CachedProcess entry;
+    auto cached = process_cache_.find(pid);
+    if (start_time != 0 && cached != process_cache_.end() &&
+        cached->second.start_time == start_time &&
+        cached->second.exec_count == exec_count &&
+        cached->second.command_hash == command_hash) {
+        entry = std::move(cached->second);
+    } else {
+        entry.start_time = start_time;
+        entry.exec_count = exec_count;
+        entry.command_hash = command_hash;
+        entry.environment_evidence = read_environment_evidence(pid);
+        last_scan_evaluated_count_++;
+    }
 
-    // Look for MCP-related environment variables
-    const std::vector<std::string> mcp_env_vars = {
-        "MCP_", "ANTHROPIC_", "CLAUDE_"
-    };
+    for (const auto& evidence : entry.environment_evidence) {
+        candidate.add_evidence(evidence);
+    }
 
-    for (const auto& [key, value] : env) {
-        for (const auto& prefix : mcp_env_vars) {
-            if (key.find(prefix) == 0) {
-                Evidence evidence(
-                    "environment",
-                    "Environment variable found: " + key,
-                    0.5,  // Confidence score
-                    "",   // Source (empty)
-                    Evidence::Strength::Moderate  // Moderate - good corroborating evidence
-                );
-                candidate.add_evidence(evidence);
-                break;
-            }
-        }
+    next_cache[pid] = std::move(entry);
+}
+
+std::vector<Evidence> ProcessDetectionEngine::read_environment_evidence(int pid) {
+    std::vector<Evidence> result;
+
+    // Scan the raw block for MCP-related prefixes; only matching
+    // variables are turned into strings
+    if (!platform_->get_environment_block(pid, environ_block_)) {
+        return result;
+    }
+
+    environ_matches_.clear();
+    environ_scanner_.scan(environ_block_, environ_matches_);
+
+    for (const auto& match : environ_matches_) {
+        Evidence evidence(
+            "environment",
+            "Environment variable found: " + std::string(match.name),
+            0.5,  // Confidence score
+            "",   // Source (empty)
+            Evidence::Strength::Moderate  // Moderate - good corroborating evidence
+        );
+        result.push_back(evidence);
     }
+
+    return result;
+}
+
+void ProcessDetectionEngine::set_environment_prefixes(const std::vector<std::string>& extra_prefixes) {
+    std::vector<std::string> prefixes = EnvironScanner::default_prefixes();
+    prefixes.insert(prefixes.end(), extra_prefixes.begin(), extra_prefixes.end());
+
+    EnvironScanner scanner(prefixes);
+    if (scanner.prefixes() == environ_scanner_.prefixes()) {
+        return;
+    }
+
+    // Cached environment evidence was matched against the old prefixes
+    environ_scanner_ = std::move(scanner);
+    process_cache_.clear();
 }
 
 } // namespace kyros
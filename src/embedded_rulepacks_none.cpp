@@ -0,0 +1,11 @@
+// Builds without KYROS_EMBED_RULEPACKS load the default rulepacks from disk
+
+#include <kyros/rulepack_binary.hpp>
+
+namespace kyros {
+
+std::string_view embedded_rulepacks() {
+    return {};
+}
+
+} // namespace kyros
@@ -1,13 +1,432 @@
+// HTTP/1.1 client: in-process sockets for http://, curl for https://
+
 #include <kyros/http/http_client.hpp>
+#include <kyros/http/http_parser.hpp>
 
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <limits>
 #include <sstream>
 #include <stdexcept>
-#include <cstdio>
-#include <memory>
-#include <array>
+
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
 
 namespace kyros {
 
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+#ifdef MSG_NOSIGNAL
+constexpr int kSendFlags = MSG_NOSIGNAL;
+#else
+constexpr int kSendFlags = 0;  // SO_NOSIGPIPE is set on the socket instead
+#endif
+
+constexpr size_t kReadChunk = 16 * 1024;
+
+// When a request must finish, and the token that can end it early
+struct Deadline {
+    Clock::time_point at;
+    const HttpCancelToken* cancel = nullptr;
+
+    bool expired() const { return Clock::now() >= at; }
+    bool cancelled() const { return cancel && cancel->cancelled(); }
+    bool timed_out() const { return !cancelled() && expired(); }
+
+    // Why a wait failed: cancellation, the deadline, or `otherwise`
+    const char* failure(const char* otherwise) const {
+        if (cancelled()) return "Request cancelled";
+        if (expired()) return "Request timed out";
+        return otherwise;
+    }
+};
+
+// Milliseconds left until the deadline, rounded up so poll() never spins
+int remaining_ms(const Deadline& deadline) {
+    auto left = std::chrono::duration_cast<std::chrono::microseconds>(deadline.at - Clock::now()).count();
+    if (left <= 0) {
+        return 0;
+    }
+    return static_cast<int>(std::min<long long>((left + 999) / 1000, INT_MAX));
+}
+
+// Wait for `events` on fd; false on deadline, cancellation or error
+bool wait_for(int fd, short events, const Deadline& deadline) {
+    while (true) {
+        struct pollfd pfds[2] = {{fd, events, 0}, {-1, POLLIN, 0}};
+        if (deadline.cancel) {
+            pfds[1].fd = deadline.cancel->fd();
+        }
+        int rc = poll(pfds, deadline.cancel ? 2 : 1, remaining_ms(deadline));
+        if (rc > 0) {
+            return pfds[1].revents == 0;
+        }
+        if (rc == 0 || errno != EINTR) {
+            return false;
+        }
+    }
+}
+
+// An idle keep-alive socket is reusable if the server has neither closed
+// it nor sent anything unsolicited
+bool is_idle_and_open(int fd) {
+    char byte;
+    ssize_t n = recv(fd, &byte, 1, MSG_PEEK | MSG_DONTWAIT);
+    return n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+}
+
+int connect_socket(const std::string& host, int port, const Deadline& deadline,
+                   std::string& error) {
+    struct addrinfo hints = {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+
+    struct addrinfo* addresses = nullptr;
+    std::string port_str = std::to_string(port);
+    if (getaddrinfo(host.c_str(), port_str.c_str(), &hints, &addresses) != 0 || !addresses) {
+        error = "Failed to resolve host";
+        return -1;
+    }
+
+    int fd = -1;
+    error = "Connection failed";
+    for (auto* address = addresses; address; address = address->ai_next) {
+        fd = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+        if (fd < 0) {
+            continue;
+        }
+        fcntl(fd, F_SETFD, FD_CLOEXEC);
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+#ifdef SO_NOSIGPIPE
+        setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+
+        if (connect(fd, address->ai_addr, address->ai_addrlen) == 0) {
+            break;
+        }
+        if (errno == EINPROGRESS) {
+            if (wait_for(fd, POLLOUT, deadline)) {
+                int so_error = 0;
+                socklen_t length = sizeof(so_error);
+                if (getsockopt(fd, SOL_SOCKET, SO_ERROR, &so_error, &length) == 0 && so_error == 0) {
+                    break;
+                }
+                error = std::string("Connection failed: ") + strerror(so_error);
+            } else if (deadline.expired() || deadline.cancelled()) {
+                error = deadline.cancelled() ? "Request cancelled" : "Connection timed out";
+                close(fd);
+                fd = -1;
+                break;
+            }
+        } else {
+            error = std::string("Connection failed: ") + strerror(errno);
+        }
+        close(fd);
+        fd = -1;
+    }
+
+    freeaddrinfo(addresses);
+    return fd;
+}
+
+bool send_all(int fd, const std::string& data, const Deadline& deadline) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = send(fd, data.data() + sent, data.size() - sent, kSendFlags);
+        if (n > 0) {
+            sent += static_cast<size_t>(n);
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            if (!wait_for(fd, POLLOUT, deadline)) {
+                return false;
+            }
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Append up to kReadChunk bytes. Returns bytes read, 0 on EOF, -1 on
+// deadline or error.
+ssize_t receive(int fd, std::string& buffer, const Deadline& deadline) {
+    while (true) {
+        size_t old_size = buffer.size();
+        buffer.resize(old_size + kReadChunk);
+        ssize_t n = recv(fd, &buffer[old_size], kReadChunk, 0);
+        buffer.resize(old_size + (n > 0 ? static_cast<size_t>(n) : 0));
+        if (n >= 0) {
+            return n;
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        if ((errno != EAGAIN && errno != EWOULDBLOCK) || !wait_for(fd, POLLIN, deadline)) {
+            return -1;
+        }
+    }
+}
+
+bool contains_token(std::string_view value, std::string_view token) {
+    std::string lower(value);
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return lower.find(token) != std::string::npos;
+}
+
+// An SSE body holds at least one event once a blank line has arrived
+bool has_complete_event(const std::string& body) {
+    return body.find("\n\n") != std::string::npos || body.find("\r\n\r\n") != std::string::npos;
+}
+
+bool has_header(const std::map<std::string, std::string>& headers, std::string_view name) {
+    for (const auto& [key, value] : headers) {
+        if (http_iequals(key, name)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Quote for a POSIX shell: 'it'\''s'
+std::string shell_quote(const std::string& value) {
+    std::string quoted = "'";
+    for (char c : value) {
+        if (c == '\'') {
+            quoted += "'\\''";
+        } else {
+            quoted += c;
+        }
+    }
+    return quoted + "'";
+}
+
+// Copy the parsed head into the response; header names are lowercased and
+// a repeated header keeps its last value
+void store_head(const HttpResponseHead& head, HttpResponse& response) {
+    response.status_code = head.status_code;
+    for (const auto& header : head.headers) {
+        std::string key(header.name);
+        for (char& c : key) {
+            c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        }
+        response.headers[key] = std::string(header.value);
+    }
+}
+
+enum class Exchange {
+    Done,     // Response (or error) is in `response`
+    Stale     // A pooled connection was closed before any byte arrived
+};
+
+// Read one response from fd, failing it if the body exceeds max_body.
+// `reusable` is set when the connection can serve another request. With a
+// handler, the body goes to it as it arrives instead (see BodyHandler).
+Exchange read_response(int fd, const std::string& method, const Deadline& deadline,
+                       size_t max_body, const HttpClient::BodyHandler* handler,
+                       HttpResponse& response, bool& reusable) {
+    reusable = false;
+    std::string buffer;
+    HttpResponseHead head;
+
+    auto fail = [&](const std::string& message) {
+        response = HttpResponse();
+        response.error_message = message;
+        response.timed_out = deadline.timed_out();
+        return Exchange::Done;
+    };
+
+    // Status line and headers, skipping interim 1xx responses
+    while (true) {
+        auto result = parse_response_head(buffer, head);
+        if (result == HttpParseResult::Complete) {
+            if (head.status_code >= 100 && head.status_code < 200 && head.status_code != 101) {
+                buffer.erase(0, head.size);
+                continue;
+            }
+            break;
+        }
+        if (result == HttpParseResult::Invalid) {
+            return fail("Malformed HTTP response");
+        }
+        if (buffer.size() > HttpClient::kMaxHeadBytes) {
+            return fail("HTTP response header too large");
+        }
+
+        size_t before = buffer.size();
+        ssize_t n = receive(fd, buffer, deadline);
+        if (n == 0 || (n < 0 && errno == ECONNRESET)) {
+            if (before == 0) {
+                return Exchange::Stale;
+            }
+            return fail("Connection closed before response was complete");
+        }
+        if (n < 0) {
+            return fail(deadline.failure("Failed to read response"));
+        }
+    }
+
+    store_head(head, response);
+
+    bool event_stream = contains_token(head.find("content-type"), "text/event-stream");
+    bool keep_alive = head.minor_version >= 1 ? !contains_token(head.find("connection"), "close")
+                                              : contains_token(head.find("connection"), "keep-alive");
+    bool no_body = method == "HEAD" || head.status_code == 204 || head.status_code == 304;
+    bool chunked = contains_token(head.find("transfer-encoding"), "chunked");
+    bool streamed = handler && *handler && !event_stream && !no_body;
+
+    // A streamed body is bounded by what its handler keeps
+    size_t length_limit = streamed ? std::numeric_limits<size_t>::max() / 16 : max_body;
+    std::string_view length_field = head.find("content-length");
+    bool has_length = !length_field.empty();
+    size_t content_length = 0;
+    if (has_length) {
+        for (char c : length_field) {
+            if (!std::isdigit(static_cast<unsigned char>(c)) ||
+                content_length > length_limit) {
+                return fail("Invalid Content-Length");
+            }
+            content_length = content_length * 10 + static_cast<size_t>(c - '0');
+        }
+        if (content_length > length_limit) {
+            return fail("HTTP response body too large");
+        }
+    }
+
+    buffer.erase(0, head.size);  // Views in `head` are dead from here on
+
+    if (no_body) {
+        reusable = keep_alive && buffer.empty();
+        response.success = response.status_code >= 200 && response.status_code < 300;
+        return Exchange::Done;
+    }
+
+    ChunkedDecoder decoder;
+    if (streamed) {
+        // Hand over what is buffered, then each read, holding one piece
+        size_t left = content_length;
+        bool done = !chunked && has_length && content_length == 0;
+        std::string piece;
+        HttpClient::BodyReader read = [&]() -> std::string_view {
+            piece.clear();
+            while (!done) {
+                if (chunked) {
+                    size_t consumed = 0;
+                    auto result = decoder.decode(buffer, consumed, piece);
+                    buffer.erase(0, consumed);
+                    if (result == HttpParseResult::Invalid) {
+                        throw std::runtime_error("Malformed chunked body");
+                    }
+                    done = result == HttpParseResult::Complete;
+                } else if (has_length && buffer.size() > left) {
+                    piece.assign(buffer, 0, left);
+                    buffer.erase(0, left);
+                    left = 0;
+                    done = true;
+                } else {
+                    piece.swap(buffer);
+                    buffer.clear();
+                    left -= has_length ? piece.size() : 0;
+                    done = has_length && left == 0;
+                }
+                if (!piece.empty() || done) {
+                    break;
+                }
+
+                ssize_t n = receive(fd, buffer, deadline);
+                if (n == 0 && !chunked && !has_length) {
+                    done = true;
+                } else if (n == 0) {
+                    throw std::runtime_error("Connection closed before response was complete");
+                } else if (n < 0) {
+                    throw std::runtime_error(deadline.failure("Failed to read response"));
+                }
+            }
+            return piece;
+        };
+
+        try {
+            (*handler)(response, read);
+        } catch (const std::exception& e) {
+            return fail(e.what());
+        }
+        reusable = keep_alive && done && buffer.empty();
+        response.success = response.status_code >= 200 && response.status_code < 300;
+        return Exchange::Done;
+    }
+
+    while (true) {
+        // Is the body complete?
+        if (chunked) {
+            size_t consumed = 0;
+            auto result = decoder.decode(buffer, consumed, response.body);
+            buffer.erase(0, consumed);
+            if (result == HttpParseResult::Invalid) {
+                return fail("Malformed chunked body");
+            }
+            if (result == HttpParseResult::Complete) {
+                reusable = keep_alive && buffer.empty();
+                break;
+            }
+        } else if (has_length && buffer.size() >= content_length) {
+            response.body = buffer.substr(0, content_length);
+            reusable = keep_alive && buffer.size() == content_length;
+            break;
+        }
+        // Need more bytes; without a length, the body runs until close
+
+        if (event_stream && has_complete_event(chunked ? response.body : buffer)) {
+            if (!chunked) {
+                response.body = buffer;
+            }
+            break;
+        }
+        if (response.body.size() + buffer.size() > max_body) {
+            return fail("HTTP response body too large");
+        }
+
+        ssize_t n = receive(fd, buffer, deadline);
+        if (n == 0 && !chunked && !has_length) {
+            response.body = buffer;
+            break;
+        }
+        if (n <= 0) {
+            if (event_stream && deadline.expired() && !deadline.cancelled()) {
+                // A stream that has not produced a full event in time:
+                // report what arrived
+                if (!chunked) {
+                    response.body = buffer;
+                }
+                break;
+            }
+            if (n == 0) {
+                return fail("Connection closed before response was complete");
+            }
+            return fail(deadline.failure("Failed to read response"));
+        }
+    }
+
+    response.success = response.status_code >= 200 && response.status_code < 300;
+    return Exchange::Done;
+}
+
+} // namespace
+
 HttpClient::ParsedUrl HttpClient::parse_url(const std::string& url) {
     ParsedUrl result;
 
@@ -73,10 +492,89 @@ HttpClient::ParsedUrl HttpClient::parse_url(const std::string& url) {
     return result;
 }
 
+HttpCancelToken::HttpCancelToken() {
+    if (pipe(pipe_) == 0) {
+        for (int fd : pipe_) {
+            fcntl(fd, F_SETFD, FD_CLOEXEC);
+        }
+    } else {
+        pipe_[0] = pipe_[1] = -1;
+    }
+}
+
+HttpCancelToken::~HttpCancelToken() {
+    for (int fd : pipe_) {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+}
+
+void HttpCancelToken::cancel() {
+    if (!cancelled_.exchange(true) && pipe_[1] >= 0) {
+        // The byte is never read: the pipe stays readable from now on
+        ssize_t ignored = write(pipe_[1], "x", 1);
+        (void)ignored;
+    }
+}
+
+HttpClient::~HttpClient() {
+    close_idle_connections();
+}
+
+size_t HttpClient::idle_connections() const {
+    size_t count = 0;
+    for (const auto& [key, fds] : idle_) {
+        count += fds.size();
+    }
+    return count;
+}
+
+void HttpClient::adopt_idle_connections(HttpClient& other) {
+    for (auto& [key, fds] : other.idle_) {
+        for (int fd : fds) {
+            release(key, fd);
+        }
+    }
+    other.idle_.clear();
+}
+
+void HttpClient::close_idle_connections() {
+    for (auto& [key, fds] : idle_) {
+        for (int fd : fds) {
+            close(fd);
+        }
+    }
+    idle_.clear();
+}
+
 HttpResponse HttpClient::post(const std::string& url,
                               const std::string& body,
                               const std::map<std::string, std::string>& headers,
                               std::chrono::milliseconds timeout) {
+    return request("POST", url, &body, headers, timeout);
+}
+
+HttpResponse HttpClient::post(const std::string& url,
+                              const std::string& body,
+                              const std::map<std::string, std::string>& headers,
+                              std::chrono::milliseconds timeout,
+                              const BodyHandler& handler) {
+    return request("POST", url, &body, headers, timeout, &handler);
+}
+
+HttpResponse HttpClient::get(const std::string& url,
+                             const std::map<std::string, std::string>& headers,
+                             std::chrono::milliseconds timeout) {
+    return request("GET", url, nullptr, headers, timeout);
+}
+
+HttpResponse HttpClient::request(const std::string& method,
+                                 const std::string& url,
+                                 const std::string* body,
+                                 const std::map<std::string, std::string>& headers,
+                                 std::chrono::milliseconds timeout,
+                                 const BodyHandler* handler) {
     HttpResponse response;
 
     // Parse URL
@@ -86,192 +584,231 @@ HttpResponse HttpClient::post(const std::string& url,
         return response;
     }
 
-    // Build curl command
-    std::ostringstream cmd;
-    cmd << "curl -X POST";
-    cmd << " -m " << (timeout.count() / 1000);  // Timeout in seconds
-    cmd << " -s";  // Silent mode
-    cmd << " -w '\\n%{http_code}'";  // Write status code at end
-    cmd << " -H 'Content-Type: application/json'";
-
-    // Add custom headers
-    for (const auto& [key, value] : headers) {
-        cmd << " -H '" << key << ": " << value << "'";
+    if (parsed.scheme == "https") {
+        return request_with_curl(method, url, body, headers, timeout, handler);
     }
-
-    // Add body
-    cmd << " -d '" << body << "'";
-
-    // Add URL
-    cmd << " '" << url << "'";
-
-    // Execute curl command
-    std::array<char, 128> buffer;
-    std::string result;
-    FILE* pipe = popen(cmd.str().c_str(), "r");
-
-    if (!pipe) {
-        response.error_message = "Failed to execute curl command";
+    if (parsed.scheme != "http") {
+        response.error_message = "Unsupported URL scheme: " + parsed.scheme;
         return response;
     }
 
-    while (fgets(buffer.data(), buffer.size(), pipe) != nullptr) {
-        result += buffer.data();
+    Deadline deadline{Clock::now() + timeout, cancel_token_.get()};
+    if (deadline.cancelled()) {
+        response.error_message = "Request cancelled";
+        return response;
     }
 
-    int exit_code = pclose(pipe);
+    // Build the request
+    std::string message = method + " " + parsed.path + " HTTP/1.1\r\n";
+    message += "Host: " + parsed.host;
+    if (parsed.port != 80) {
+        message += ":" + std::to_string(parsed.port);
+    }
+    message += "\r\n";
+    if (!has_header(headers, "User-Agent")) {
+        message += "User-Agent: kyros\r\n";
+    }
+    if (!has_header(headers, "Accept")) {
+        message += "Accept: */*\r\n";
+    }
+    if (body && !has_header(headers, "Content-Type")) {
+        message += "Content-Type: application/json\r\n";
+    }
+    for (const auto& [key, value] : headers) {
+        message += key + ": " + value + "\r\n";
+    }
+    if (body) {
+        message += "Content-Length: " + std::to_string(body->size()) + "\r\n";
+    }
+    message += "\r\n";
+    if (body) {
+        message += *body;
+    }
 
-    if (exit_code != 0) {
-        response.error_message = "curl command failed";
-        return response;
+    // IPv6 literals are bracketed in URLs but not for getaddrinfo()
+    std::string host = parsed.host;
+    if (host.size() > 2 && host.front() == '[' && host.back() == ']') {
+        host = host.substr(1, host.size() - 2);
     }
+    std::string key = host + ":" + std::to_string(parsed.port);
+
+    // A pooled connection may have been closed by the server in the
+    // meantime; if it fails before any response byte, retry on a new one
+    for (int attempt = 0; attempt < 2; attempt++) {
+        int fd = acquire(key);
+        bool reused = fd >= 0;
+        if (!reused) {
+            std::string error;
+            fd = connect_socket(host, parsed.port, deadline, error);
+            if (fd < 0) {
+                response.error_message = error;
+                response.timed_out = deadline.timed_out();
+                return response;
+            }
+        }
 
-    // Parse response - last line should be status code
-    size_t last_newline = result.rfind('\n');
-    if (last_newline != std::string::npos && last_newline > 0) {
-        size_t second_last_newline = result.rfind('\n', last_newline - 1);
-        if (second_last_newline != std::string::npos) {
-            std::string status_str = result.substr(second_last_newline + 1, last_newline - second_last_newline - 1);
-            response.body = result.substr(0, second_last_newline);
+        if (!send_all(fd, message, deadline)) {
+            close(fd);
+            if (reused) {
+                continue;
+            }
+            response.error_message = deadline.failure("Failed to send request");
+            response.timed_out = deadline.timed_out();
+            return response;
+        }
 
-            try {
-                response.status_code = std::stoi(status_str);
-                response.success = (response.status_code >= 200 && response.status_code < 300);
-            } catch (...) {
-                response.error_message = "Failed to parse status code";
+        bool reusable = false;
+        response = HttpResponse();
+        if (read_response(fd, method, deadline, max_body_bytes_, handler, response, reusable) == Exchange::Stale) {
+            close(fd);
+            if (reused) {
+                continue;
             }
+            response = HttpResponse();
+            response.error_message = "Connection closed without a response";
+            return response;
         }
+
+        if (reusable) {
+            release(key, fd);
+        } else {
+            close(fd);
+        }
+        return response;
     }
 
+    response.error_message = "Connection closed without a response";
     return response;
 }
 
-HttpResponse HttpClient::get(const std::string& url,
-                             const std::map<std::string, std::string>& headers,
-                             std::chrono::milliseconds timeout) {
+HttpResponse HttpClient::request_with_curl(const std::string& method,
+                                           const std::string& url,
+                                           const std::string* body,
+                                           const std::map<std::string, std::string>& headers,
+                                           std::chrono::milliseconds timeout,
+                                           const BodyHandler* handler) {
     HttpResponse response;
 
-    // Parse URL
-    auto parsed = parse_url(url);
-    if (!parsed.valid) {
-        response.error_message = "Invalid URL";
-        return response;
-    }
+    // Build curl command. The timeout keeps millisecond precision; a
+    // whole-second -m would turn sub-second timeouts into no timeout.
+    char max_time[32];
+    snprintf(max_time, sizeof(max_time), "%.3f", static_cast<double>(timeout.count()) / 1000.0);
 
-    // Build curl command with header dump
     std::ostringstream cmd;
-    cmd << "curl -X GET";
-    cmd << " -m " << (timeout.count() / 1000);  // Timeout in seconds
-    cmd << " -s";  // Silent mode
-    cmd << " -i";  // Include headers in output
-    cmd << " -w '\\n%{http_code}'";  // Write status code at end
+    cmd << "curl -X " << method;
+    cmd << " --max-time " << max_time;
+    cmd << " -s";         // Silent mode
+    cmd << " -i";         // Include headers in output
+    cmd << " --http1.1";  // Status line parseable as HTTP/1.x
+    if (body && !has_header(headers, "Content-Type")) {
+        cmd << " -H 'Content-Type: application/json'";
+    }
 
     // Add custom headers
     for (const auto& [key, value] : headers) {
-        cmd << " -H '" << key << ": " << value << "'";
+        cmd << " -H " << shell_quote(key + ": " + value);
+    }
+
+    // Add body
+    if (body) {
+        cmd << " --data-binary " << shell_quote(*body);
     }
 
     // Add URL
-    cmd << " '" << url << "'";
+    cmd << " " << shell_quote(url);
 
     // Execute curl command
-    std::array<char, 128> buffer;
-    std::string result;
     FILE* pipe = popen(cmd.str().c_str(), "r");
-
     if (!pipe) {
         response.error_message = "Failed to execute curl command";
         return response;
     }
 
-    while (fgets(buffer.data(), buffer.size(), pipe) != nullptr) {
-        result += buffer.data();
+    std::string output;
+    char buffer[4096];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), pipe)) > 0) {
+        output.append(buffer, n);
     }
-
     int exit_code = pclose(pipe);
-
-    if (exit_code != 0) {
-        response.error_message = "curl command failed";
-        return response;
-    }
-
-    // Parse response - last line should be status code
-    size_t last_newline = result.rfind('\n');
-    if (last_newline == std::string::npos) {
-        response.error_message = "Invalid response format";
-        return response;
+    // curl exits with 28 when --max-time runs out
+    bool timed_out = exit_code != -1 && WIFEXITED(exit_code) && WEXITSTATUS(exit_code) == 28;
+
+    // Parse the head; a timed-out event stream still has one
+    HttpResponseHead head;
+    size_t offset = 0;
+    while (true) {
+        if (parse_response_head(std::string_view(output).substr(offset), head) !=
+            HttpParseResult::Complete) {
+            response.error_message = exit_code != 0 ? "curl command failed"
+                                                    : "Invalid response format";
+            response.timed_out = timed_out;
+            return response;
+        }
+        if (head.status_code >= 100 && head.status_code < 200) {
+            offset += head.size;
+            continue;
+        }
+        break;
     }
 
-    size_t second_last_newline = result.rfind('\n', last_newline - 1);
-    if (second_last_newline == std::string::npos) {
-        response.error_message = "Invalid response format";
+    bool event_stream = contains_token(head.find("content-type"), "text/event-stream");
+    if (exit_code != 0 && !event_stream) {
+        response.error_message = "curl command failed";
+        response.timed_out = timed_out;
         return response;
     }
 
-    std::string status_str = result.substr(second_last_newline + 1, last_newline - second_last_newline - 1);
-    std::string full_response = result.substr(0, second_last_newline);
-
-    try {
-        response.status_code = std::stoi(status_str);
-        response.success = (response.status_code >= 200 && response.status_code < 300);
-    } catch (...) {
-        response.error_message = "Failed to parse status code";
-        return response;
+    store_head(head, response);
+    response.body = output.substr(offset + head.size);
+    response.success = response.status_code >= 200 && response.status_code < 300;
+
+    // curl has read it all already; the handler gets it in one piece
+    if (handler && *handler && !event_stream && !response.body.empty()) {
+        std::string body = std::move(response.body);
+        response.body.clear();
+        bool given = false;
+        BodyReader read = [&]() -> std::string_view {
+            if (given) {
+                return std::string_view();
+            }
+            given = true;
+            return body;
+        };
+        try {
+            (*handler)(response, read);
+        } catch (const std::exception& e) {
+            response = HttpResponse();
+            response.error_message = e.what();
+        }
     }
+    return response;
+}
 
-    // Parse headers and body (separated by \r\n\r\n or \n\n)
-    size_t header_end = full_response.find("\r\n\r\n");
-    if (header_end == std::string::npos) {
-        header_end = full_response.find("\n\n");
+int HttpClient::acquire(const std::string& key) {
+    auto it = idle_.find(key);
+    if (it == idle_.end()) {
+        return -1;
     }
-
-    if (header_end != std::string::npos) {
-        std::string header_section = full_response.substr(0, header_end);
-        response.body = full_response.substr(header_end + (full_response[header_end + 1] == '\r' ? 4 : 2));
-
-        // Parse headers
-        std::istringstream header_stream(header_section);
-        std::string line;
-        bool first_line = true;
-
-        while (std::getline(header_stream, line)) {
-            // Skip HTTP status line
-            if (first_line) {
-                first_line = false;
-                continue;
-            }
-
-            // Remove \r if present
-            if (!line.empty() && line.back() == '\r') {
-                line.pop_back();
-            }
-
-            // Parse header line (key: value)
-            size_t colon = line.find(':');
-            if (colon != std::string::npos) {
-                std::string key = line.substr(0, colon);
-                std::string value = line.substr(colon + 1);
-
-                // Trim whitespace from value
-                size_t value_start = value.find_first_not_of(" \t");
-                if (value_start != std::string::npos) {
-                    value = value.substr(value_start);
-                }
-
-                // Convert key to lowercase for case-insensitive lookup
-                for (char& c : key) {
-                    c = std::tolower(static_cast<unsigned char>(c));
-                }
-
-                response.headers[key] = value;
-            }
+    auto& fds = it->second;
+    while (!fds.empty()) {
+        int fd = fds.back();
+        fds.pop_back();
+        if (is_idle_and_open(fd)) {
+            return fd;
         }
-    } else {
-        // No header/body separation found, treat all as body
-        response.body = full_response;
+        close(fd);
     }
+    return -1;
+}
 
-    return response;
+void HttpClient::release(const std::string& key, int fd) {
+    auto& fds = idle_[key];
+    if (fds.size() >= kMaxIdlePerHost) {
+        close(fd);
+        return;
+    }
+    fds.push_back(fd);
 }
 
 } // namespace kyros
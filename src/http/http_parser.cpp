@@ -0,0 +1,205 @@
+// HTTP/1.x response head parsing and chunked transfer decoding
+
+#include <kyros/http/http_parser.hpp>
+
+#include <algorithm>
+#include <cctype>
+
+namespace kyros {
+
+namespace {
+
+std::string_view trim(std::string_view value) {
+    while (!value.empty() && (value.front() == ' ' || value.front() == '\t')) {
+        value.remove_prefix(1);
+    }
+    while (!value.empty() && (value.back() == ' ' || value.back() == '\t')) {
+        value.remove_suffix(1);
+    }
+    return value;
+}
+
+int hex_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// Upper bound for a single chunk; anything larger is treated as garbage
+constexpr size_t kMaxChunkSize = size_t(1) << 40;
+
+} // namespace
+
+bool http_iequals(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); i++) {
+        if (std::tolower(static_cast<unsigned char>(a[i])) !=
+            std::tolower(static_cast<unsigned char>(b[i]))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::string_view HttpResponseHead::find(std::string_view name) const {
+    for (const auto& header : headers) {
+        if (http_iequals(header.name, name)) {
+            return header.value;
+        }
+    }
+    return {};
+}
+
+HttpParseResult parse_response_head(std::string_view data, HttpResponseHead& head) {
+    head.headers.clear();
+    head.size = 0;
+
+    // Lines end in CRLF; a bare LF is tolerated
+    size_t pos = 0;
+    bool status_line = true;
+    while (true) {
+        size_t newline = data.find('\n', pos);
+        if (newline == std::string_view::npos) {
+            // Reject early if what we have cannot be a status line
+            if (status_line) {
+                std::string_view prefix = data.substr(0, 7);
+                if (prefix != std::string_view("HTTP/1.").substr(0, prefix.size())) {
+                    return HttpParseResult::Invalid;
+                }
+            }
+            return HttpParseResult::Incomplete;
+        }
+
+        std::string_view line = data.substr(pos, newline - pos);
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        pos = newline + 1;
+
+        if (status_line) {
+            // HTTP/1.x SP 3DIGIT [SP reason]
+            if (line.size() < 12 || line.compare(0, 7, "HTTP/1.") != 0 ||
+                !std::isdigit(static_cast<unsigned char>(line[7])) || line[8] != ' ' ||
+                !std::isdigit(static_cast<unsigned char>(line[9])) ||
+                !std::isdigit(static_cast<unsigned char>(line[10])) ||
+                !std::isdigit(static_cast<unsigned char>(line[11])) ||
+                (line.size() > 12 && line[12] != ' ')) {
+                return HttpParseResult::Invalid;
+            }
+            head.minor_version = line[7] - '0';
+            head.status_code = (line[9] - '0') * 100 + (line[10] - '0') * 10 + (line[11] - '0');
+            status_line = false;
+            continue;
+        }
+
+        if (line.empty()) {
+            head.size = pos;
+            return HttpParseResult::Complete;
+        }
+
+        if (line.front() == ' ' || line.front() == '\t') {
+            continue;  // Obsolete line folding; nothing we read uses it
+        }
+
+        size_t colon = line.find(':');
+        if (colon == 0 || colon == std::string_view::npos) {
+            return HttpParseResult::Invalid;
+        }
+        std::string_view name = line.substr(0, colon);
+        if (name.find_first_of(" \t") != std::string_view::npos) {
+            return HttpParseResult::Invalid;
+        }
+        head.headers.push_back({name, trim(line.substr(colon + 1))});
+    }
+}
+
+HttpParseResult ChunkedDecoder::decode(std::string_view data, size_t& consumed, std::string& body) {
+    size_t pos = 0;
+    consumed = 0;
+
+    while (state_ != State::Done) {
+        switch (state_) {
+            case State::Size: {
+                // chunk-size [; extensions] CRLF
+                size_t newline = data.find('\n', pos);
+                if (newline == std::string_view::npos) {
+                    return HttpParseResult::Incomplete;
+                }
+                size_t size = 0;
+                size_t digits = 0;
+                for (size_t i = pos; i < newline; i++, digits++) {
+                    int value = hex_value(data[i]);
+                    if (value < 0) {
+                        break;
+                    }
+                    size = size * 16 + static_cast<size_t>(value);
+                    if (size > kMaxChunkSize) {
+                        return HttpParseResult::Invalid;
+                    }
+                }
+                if (digits == 0) {
+                    return HttpParseResult::Invalid;
+                }
+                pos = newline + 1;
+                consumed = pos;
+                remaining_ = size;
+                state_ = size == 0 ? State::Trailer : State::Data;
+                break;
+            }
+
+            case State::Data: {
+                size_t available = std::min(remaining_, data.size() - pos);
+                body.append(data.data() + pos, available);
+                pos += available;
+                consumed = pos;
+                remaining_ -= available;
+                if (remaining_ > 0) {
+                    return HttpParseResult::Incomplete;
+                }
+                state_ = State::DataEnd;
+                break;
+            }
+
+            case State::DataEnd: {
+                // CRLF after the chunk data (a bare LF is tolerated)
+                if (pos < data.size() && data[pos] == '\n') {
+                    pos += 1;
+                } else if (data.size() - pos < 2) {
+                    return HttpParseResult::Incomplete;
+                } else if (data[pos] == '\r' && data[pos + 1] == '\n') {
+                    pos += 2;
+                } else {
+                    return HttpParseResult::Invalid;
+                }
+                consumed = pos;
+                state_ = State::Size;
+                break;
+            }
+
+            case State::Trailer: {
+                // Trailer fields, then an empty line
+                size_t newline = data.find('\n', pos);
+                if (newline == std::string_view::npos) {
+                    return HttpParseResult::Incomplete;
+                }
+                bool empty = newline == pos || (newline == pos + 1 && data[pos] == '\r');
+                pos = newline + 1;
+                consumed = pos;
+                if (empty) {
+                    state_ = State::Done;
+                }
+                break;
+            }
+
+            case State::Done:
+                break;
+        }
+    }
+
+    return HttpParseResult::Complete;
+}
+
+} // namespace kyros
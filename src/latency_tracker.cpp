@@ -0,0 +1,264 @@
+// Probe latency history and the deadlines derived from it
+
+#include <kyros/latency_tracker.hpp>
+#include <kyros/utils/cache_file.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+
+namespace kyros {
+
+namespace {
+
+// Version 1 recorded timeouts into the histograms
+constexpr int kFormatVersion = 2;
+
+// Endpoints not seen for this long are dropped on save
+constexpr std::chrono::hours kEndpointRetention(24 * 30);
+
+bool probed_over_stdio(const Candidate& candidate) {
+    return !candidate.command.empty() &&
+           (candidate.url.empty() || candidate.transport_hint == TransportType::Stdio);
+}
+
+nlohmann::json entry_to_json(const LatencyTracker::Histogram& histogram, uint32_t timeouts,
+                             Timestamp last_seen) {
+    return {{"buckets", histogram.buckets()},
+            {"timeouts", timeouts},
+            {"last_seen", to_epoch_seconds(last_seen)}};
+}
+
+std::chrono::milliseconds with_headroom(std::chrono::milliseconds latency, double headroom) {
+    return std::chrono::milliseconds(static_cast<int64_t>(
+        std::ceil(static_cast<double>(latency.count()) * headroom)));
+}
+
+} // namespace
+
+// Histogram
+
+std::chrono::milliseconds LatencyTracker::Histogram::upper_bound(size_t bucket) {
+    return std::chrono::milliseconds(
+        static_cast<int64_t>(std::ceil(std::pow(2.0, static_cast<double>(bucket) / 2.0))));
+}
+
+void LatencyTracker::Histogram::record(std::chrono::milliseconds latency) {
+    size_t bucket = 0;
+    while (bucket + 1 < kBuckets && latency > upper_bound(bucket)) {
+        bucket++;
+    }
+    buckets_[bucket]++;
+    count_++;
+
+    if (count_ >= kMaxSamples) {
+        count_ = 0;
+        for (auto& n : buckets_) {
+            n /= 2;
+            count_ += n;
+        }
+    }
+}
+
+std::chrono::milliseconds LatencyTracker::Histogram::percentile(double p) const {
+    if (count_ == 0) {
+        return std::chrono::milliseconds(0);
+    }
+    auto rank = static_cast<uint32_t>(std::ceil(p * count_));
+    uint32_t seen = 0;
+    for (size_t bucket = 0; bucket < kBuckets; bucket++) {
+        seen += buckets_[bucket];
+        if (seen >= std::max<uint32_t>(rank, 1)) {
+            return upper_bound(bucket);
+        }
+    }
+    return upper_bound(kBuckets - 1);
+}
+
+void LatencyTracker::Histogram::set_buckets(const std::array<uint32_t, kBuckets>& buckets) {
+    buckets_ = buckets;
+    count_ = 0;
+    for (uint32_t n : buckets_) {
+        count_ += n;
+    }
+}
+
+// LatencyTracker
+
+LatencyTracker::LatencyTracker(std::string path) : path_(std::move(path)) {}
+
+std::string LatencyTracker::default_path() {
+    return cache_file_path("probe-latency.json");
+}
+
+std::string LatencyTracker::transport_key(const Candidate& candidate) {
+    return probed_over_stdio(candidate) ? "stdio" : "http";
+}
+
+std::string LatencyTracker::endpoint_key(const Candidate& candidate) {
+    return probed_over_stdio(candidate) ? "stdio " + candidate.command : "http " + candidate.url;
+}
+
+void LatencyTracker::load() {
+    transports_.clear();
+    endpoints_.clear();
+    if (path_.empty()) {
+        return;
+    }
+
+    std::ifstream file(path_);
+    if (!file) {
+        return;  // First run
+    }
+
+    try {
+        nlohmann::json json = nlohmann::json::parse(file);
+        if (json.value("version", 0) != kFormatVersion) {
+            return;
+        }
+        auto read = [](const nlohmann::json& entries, std::map<std::string, Entry>& into) {
+            for (const auto& [key, e] : entries.items()) {
+                Entry entry;
+                entry.histogram.set_buckets(
+                    e.at("buckets").get<std::array<uint32_t, kBuckets>>());
+                entry.timeouts = e.value("timeouts", 0u);
+                entry.last_seen = from_epoch_seconds(e.at("last_seen").get<int64_t>());
+                into[key] = std::move(entry);
+            }
+        };
+        read(json.at("transports"), transports_);
+        read(json.at("endpoints"), endpoints_);
+    } catch (const std::exception& e) {
+        std::cerr << "Warning: Ignoring latency history " << path_ << ": " << e.what() << "\n";
+        transports_.clear();
+        endpoints_.clear();
+    }
+}
+
+bool LatencyTracker::save() const {
+    if (path_.empty()) {
+        return true;
+    }
+
+    auto now = std::chrono::system_clock::now();
+    nlohmann::json transports = nlohmann::json::object();
+    for (const auto& [key, entry] : transports_) {
+        transports[key] = entry_to_json(entry.histogram, entry.timeouts, entry.last_seen);
+    }
+    nlohmann::json endpoints = nlohmann::json::object();
+    for (const auto& [key, entry] : endpoints_) {
+        if (now - entry.last_seen < kEndpointRetention) {
+            endpoints[key] = entry_to_json(entry.histogram, entry.timeouts, entry.last_seen);
+        }
+    }
+    nlohmann::json json = {{"version", kFormatVersion},
+                           {"transports", std::move(transports)},
+                           {"endpoints", std::move(endpoints)}};
+
+    try {
+        write_json_atomically(path_, json);
+    } catch (const std::exception& e) {
+        std::cerr << "Warning: Failed to save latency history " << path_ << ": " << e.what()
+                  << "\n";
+        return false;
+    }
+    return true;
+}
+
+void LatencyTracker::record(const Candidate& candidate, std::chrono::milliseconds latency,
+                            Timestamp now) {
+    for (auto* entry : {&transports_[transport_key(candidate)],
+                        &endpoints_[endpoint_key(candidate)]}) {
+        entry->histogram.record(latency);
+        entry->timeouts = 0;
+        entry->last_seen = now;
+    }
+}
+
+void LatencyTracker::record_timeout(const Candidate& candidate, Timestamp now) {
+    Entry& entry = endpoints_[endpoint_key(candidate)];
+    entry.timeouts++;
+    entry.last_seen = now;
+}
+
+std::chrono::milliseconds LatencyTracker::deadline(const Candidate& candidate,
+                                                   const DeadlinePolicy& policy) const {
+    auto floor = std::min(policy.floor, policy.ceiling);
+    uint32_t streak = timeout_streak(candidate);
+
+    const Histogram* history = endpoint(candidate);
+    if (history && history->count() > 0) {
+        // Doubled per timeout; a probe that timed out at the ceiling too
+        // starts the cycle over
+        auto base = std::clamp(with_headroom(usual_latency(candidate, policy), policy.headroom),
+                               floor, policy.ceiling);
+        uint32_t cycle = 1;
+        for (auto d = base; d < policy.ceiling; d *= 2) {
+            cycle++;
+        }
+        auto scaled = base;
+        for (uint32_t i = 0; i < streak % cycle && scaled < policy.ceiling; i++) {
+            scaled *= 2;
+        }
+        return std::min(scaled, policy.ceiling);
+    }
+
+    // Never answered: halved per timeout, but not below what answers over
+    // the same transport usually take, so a slow server is still found
+    auto shortened = policy.ceiling;
+    uint32_t halvings = streak % std::max<uint32_t>(policy.recheck_every, 1);
+    for (uint32_t i = 0; i < halvings && shortened > floor; i++) {
+        shortened /= 2;
+    }
+    auto bound = policy.ceiling;
+    const Histogram* shared = transport(candidate);
+    if (shared && shared->count() >= policy.min_transport_samples) {
+        bound = std::clamp(with_headroom(shared->percentile(0.99), policy.headroom), floor,
+                           policy.ceiling);
+    }
+    return std::max({shortened, bound, floor});
+}
+
+std::chrono::milliseconds LatencyTracker::hedge_point(const Candidate& candidate,
+                                                      const DeadlinePolicy& policy) const {
+    const Histogram* history = endpoint(candidate);
+    if (!history || history->count() == 0) {
+        return std::chrono::milliseconds(0);
+    }
+    auto usual = usual_latency(candidate, policy);
+    auto base = std::clamp(with_headroom(usual, policy.headroom),
+                           std::min(policy.floor, policy.ceiling), policy.ceiling);
+    // As far behind the deadline as a timeout streak pushed it
+    auto limit = deadline(candidate, policy);
+    auto hedge = usual * limit.count() / std::max<int64_t>(base.count(), 1);
+    return hedge < limit ? hedge : std::chrono::milliseconds(0);
+}
+
+std::chrono::milliseconds LatencyTracker::usual_latency(const Candidate& candidate,
+                                                        const DeadlinePolicy& policy) const {
+    const Histogram* history = endpoint(candidate);
+    auto p99 = history ? history->percentile(0.99) : std::chrono::milliseconds(0);
+    const Histogram* shared = transport(candidate);
+    if (shared && shared->count() >= policy.min_transport_samples) {
+        p99 = std::max(p99, shared->percentile(0.99));
+    }
+    return p99;
+}
+
+uint32_t LatencyTracker::timeout_streak(const Candidate& candidate) const {
+    auto it = endpoints_.find(endpoint_key(candidate));
+    return it == endpoints_.end() ? 0 : it->second.timeouts;
+}
+
+const LatencyTracker::Histogram* LatencyTracker::endpoint(const Candidate& candidate) const {
+    auto it = endpoints_.find(endpoint_key(candidate));
+    return it == endpoints_.end() ? nullptr : &it->second.histogram;
+}
+
+const LatencyTracker::Histogram* LatencyTracker::transport(const Candidate& candidate) const {
+    auto it = transports_.find(transport_key(candidate));
+    return it == transports_.end() ? nullptr : &it->second.histogram;
+}
+
+} // namespace kyros
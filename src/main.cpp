@@ -8,6 +8,7 @@
 
 #include <CLI/CLI.hpp>
 #include <iostream>
+#include <fstream>
 #include <cstdlib>
 
 // CLI argument parsing with CLI11
@@ -16,12 +17,23 @@ struct CliArgs {
     std::string format = "cli";
     std::string output_file;
     bool interrogate = false;
+    bool no_cache = false;
+    bool refresh = false;
+    bool no_preflight = false;
+    bool fixed_timeout = false;
     bool verbose = false;
+    bool watch = false;
+    int watch_interval = 60;
     int timeout = 5000;
     bool show_version = false;
     bool show_help = false;
     std::vector<std::string> rulepack_paths;
 
+    // rules compile
+    bool rules_compile = false;
+    std::vector<std::string> compile_inputs;
+    std::string compile_output;
+
 #ifdef ENABLE_DAEMON
     bool daemon_mode = false;
     std::string daemon_command;  // start, stop, restart, status
@@ -47,9 +59,19 @@ EXAMPLES:
     # Full discovery with interrogation
     kyros --mode active --interrogate
 
+    # Re-probe everything instead of reusing cached results
+    kyros --mode active --refresh
+
     # JSON output to file
     kyros --mode active --format json -o scan.json
 
+    # Keep scanning: again on every config change, and every 5 minutes
+    kyros --watch --watch-interval 300
+
+    # Precompile custom rulepacks, then load the result with -r
+    kyros rules compile -o custom.kyrb custom.json exclusions.json
+    kyros -r custom.kyrb
+
     # Start daemon service (if enabled)
     kyros daemon start
 )";
@@ -81,6 +103,17 @@ int run_scan(const CliArgs& args) {
         // Set active options
         config.active_config.interrogate = args.interrogate;
         config.active_config.probe_timeout_ms = args.timeout;
+        if (!args.no_cache) {
+            config.active_config.probe_cache_path = kyros::ProbeCache::default_path();
+            config.active_config.latency_history_path = kyros::LatencyTracker::default_path();
+        }
+        config.active_config.refresh_probe_cache = args.refresh;
+        config.active_config.preflight = !args.no_preflight;
+        config.active_config.adaptive_timeouts = !args.fixed_timeout;
+
+        // Watch mode: keep config watches and reload rulepacks between scans
+        config.passive_config.watch_configs = args.watch;
+        config.passive_config.watch_rulepacks = args.watch;
 
         // Set output options
         config.verbose = args.verbose;
@@ -103,6 +136,18 @@ int run_scan(const CliArgs& args) {
             args.output_file
         );
 
+        // Watch mode runs until interrupted, scanning again when a config
+        // file changes or the interval passes, whichever comes first
+        while (args.watch) {
+            bool changed = scanner.wait_for_config_changes(args.watch_interval * 1000);
+            if (args.verbose) {
+                std::cout << (changed ? "Config change detected, rescanning...\n"
+                                      : "Watch interval elapsed, rescanning...\n");
+            }
+            results = scanner.scan(config);
+            scanner.reporting_engine().generate_report(args.format, results, args.output_file);
+        }
+
         // Return appropriate exit code
         if (config.mode == kyros::ScanMode::PassiveOnly) {
             // Passive mode: exit 0 if candidates found
@@ -118,6 +163,25 @@ int run_scan(const CliArgs& args) {
     }
 }
 
+int run_rules_compile(const CliArgs& args) {
+    try {
+        std::string data = kyros::compile_rulepack_files(args.compile_inputs);
+        std::ofstream file(args.compile_output, std::ios::binary | std::ios::trunc);
+        file << data;
+        if (!file.flush()) {
+            throw std::runtime_error("Failed to write " + args.compile_output);
+        }
+        if (args.verbose) {
+            std::cout << "Compiled " << args.compile_inputs.size() << " rulepack(s) into "
+                      << args.compile_output << " (" << data.size() << " bytes)\n";
+        }
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 2;
+    }
+}
+
 #ifdef ENABLE_DAEMON
 #include <kyros/daemon/daemon.hpp>
 
@@ -154,10 +218,31 @@ int main(int argc, char** argv) {
     // Interrogate flag
     app.add_flag("--interrogate", args.interrogate, "Interrogate confirmed servers");
 
+    // Probe cache
+    auto* no_cache_flag = app.add_flag(
+        "--no-cache", args.no_cache,
+        "Neither read nor write the probe result cache or latency history");
+    app.add_flag("--refresh", args.refresh, "Re-probe every candidate and refresh the probe cache")
+        ->excludes(no_cache_flag);
+
+    // Pre-flight sniffing of listeners
+    app.add_flag("--no-preflight", args.no_preflight,
+                 "Probe every listener, including UDP and non-HTTP ones");
+
     // Timeout
     app.add_option("-t,--timeout", args.timeout, "Probe timeout in milliseconds")
         ->default_val(5000)
         ->check(CLI::Range(100, 60000));
+    app.add_flag("--fixed-timeout", args.fixed_timeout,
+                 "Give every probe the full --timeout instead of learned deadlines");
+
+    // Watch mode
+    app.add_flag("--watch", args.watch,
+                 "Keep running and scan again whenever an MCP config file changes");
+    app.add_option("--watch-interval", args.watch_interval,
+                   "With --watch, also scan again after this many seconds without a change")
+        ->default_val(60)
+        ->check(CLI::Range(1, 86400));
 
     // Verbose flag
     app.add_flag("-v,--verbose", args.verbose, "Increase output verbosity");
@@ -166,6 +251,18 @@ int main(int argc, char** argv) {
     app.add_option("-r,--rulepack", args.rulepack_paths, "Load custom rulepack file(s)")
         ->check(CLI::ExistingFile);
 
+    // Rulepack tools
+    auto* rules_cmd = app.add_subcommand("rules", "Rulepack tools");
+    rules_cmd->require_subcommand(1);
+    auto* compile_cmd = rules_cmd->add_subcommand(
+        "compile", "Compile JSON rulepacks into a binary rulepack file (.kyrb)");
+    compile_cmd->add_option("inputs", args.compile_inputs, "JSON rulepack file(s)")
+        ->required()
+        ->check(CLI::ExistingFile);
+    compile_cmd->add_option("-o,--output", args.compile_output, "Compiled rulepack file to write")
+        ->required();
+    compile_cmd->callback([&args]() { args.rules_compile = true; });
+
 #ifdef ENABLE_DAEMON
     // Daemon subcommand
     auto* daemon_cmd = app.add_subcommand("daemon", "Daemon service management");
@@ -188,6 +285,10 @@ int main(int argc, char** argv) {
         return 0;
     }
 
+    if (args.rules_compile) {
+        return run_rules_compile(args);
+    }
+
 #ifdef ENABLE_DAEMON
     if (args.daemon_mode) {
         return run_daemon(args);
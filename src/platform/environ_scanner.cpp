@@ -0,0 +1,104 @@
+// Prefix matching over raw environ blocks
+
+#include <kyros/platform/environ_scanner.hpp>
+
+#include <cstring>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace kyros {
+
+EnvironScanner::EnvironScanner()
+    : EnvironScanner(default_prefixes()) {}
+
+EnvironScanner::EnvironScanner(const std::vector<std::string>& prefixes) {
+    for (const auto& prefix : prefixes) {
+        if (prefix.empty()) {
+            continue;  // Would match every variable
+        }
+        bool duplicate = false;
+        for (const auto& existing : prefixes_) {
+            duplicate = duplicate || existing == prefix;
+        }
+        if (!duplicate) {
+            prefixes_.push_back(prefix);
+            first_bytes_[static_cast<unsigned char>(prefix[0])] = true;
+        }
+    }
+}
+
+const std::vector<std::string>& EnvironScanner::default_prefixes() {
+    static const std::vector<std::string> prefixes = {"MCP_", "ANTHROPIC_", "CLAUDE_"};
+    return prefixes;
+}
+
+size_t EnvironScanner::scan(std::string_view block, std::vector<EnvironMatch>& matches) const {
+    size_t before = matches.size();
+    if (block.empty() || prefixes_.empty()) {
+        return 0;
+    }
+
+    const char* data = block.data();
+    size_t size = block.size();
+
+    // A variable starts at offset 0 and after every NUL
+    match_at(block, 0, matches);
+
+    size_t offset = 0;
+#ifdef __SSE2__
+    const __m128i zero = _mm_setzero_si128();
+    for (; offset + 16 <= size; offset += 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + offset));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, zero)));
+        while (mask != 0) {
+            size_t start = offset + static_cast<size_t>(__builtin_ctz(mask)) + 1;
+            if (start < size && first_bytes_[static_cast<unsigned char>(data[start])]) {
+                match_at(block, start, matches);
+            }
+            mask &= mask - 1;
+        }
+    }
+#endif
+
+    // Remaining bytes (or the whole block without SSE2)
+    while (offset < size) {
+        const void* nul = std::memchr(data + offset, '\0', size - offset);
+        if (!nul) {
+            break;
+        }
+        size_t start = static_cast<size_t>(static_cast<const char*>(nul) - data) + 1;
+        if (start < size && first_bytes_[static_cast<unsigned char>(data[start])]) {
+            match_at(block, start, matches);
+        }
+        offset = start;
+    }
+
+    return matches.size() - before;
+}
+
+void EnvironScanner::match_at(std::string_view block, size_t offset,
+                              std::vector<EnvironMatch>& matches) const {
+    if (!first_bytes_[static_cast<unsigned char>(block[offset])]) {
+        return;
+    }
+
+    std::string_view variable = block.substr(offset);
+    variable = variable.substr(0, variable.find('\0'));
+
+    size_t equals = variable.find('=');
+    if (equals == std::string_view::npos) {
+        return;  // Not a KEY=value entry
+    }
+
+    std::string_view name = variable.substr(0, equals);
+    for (const auto& prefix : prefixes_) {
+        if (name.compare(0, prefix.size(), prefix) == 0) {
+            matches.push_back({name, variable.substr(equals + 1)});
+            return;
+        }
+    }
+}
+
+} // namespace kyros
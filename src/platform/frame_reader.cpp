@@ -0,0 +1,421 @@
+// Buffered message framing over probe pipes
+
+#include <kyros/platform/frame_reader.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+
+namespace kyros {
+
+namespace {
+
+// Size of the first allocation; most probes never need more
+constexpr size_t kInitialCapacity = 64 * 1024;
+
+// A Content-Length header block longer than this is not a header block
+constexpr size_t kMaxHeaderBytes = 4096;
+
+bool is_blank(std::string_view text) {
+    return std::all_of(text.begin(), text.end(), [](char c) {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+    });
+}
+
+std::string_view strip_cr(std::string_view line) {
+    if (!line.empty() && line.back() == '\r') {
+        line.remove_suffix(1);
+    }
+    return line;
+}
+
+bool iequals(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); i++) {
+        char x = a[i];
+        char y = b[i];
+        if (x >= 'A' && x <= 'Z') x = static_cast<char>(x - 'A' + 'a');
+        if (y >= 'A' && y <= 'Z') y = static_cast<char>(y - 'A' + 'a');
+        if (x != y) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Content-Length value from a header block, or false if absent/invalid
+bool parse_content_length(std::string_view headers, size_t& length) {
+    bool found = false;
+    while (!headers.empty()) {
+        size_t eol = headers.find('\n');
+        std::string_view line = strip_cr(headers.substr(0, eol));
+        headers = (eol == std::string_view::npos) ? std::string_view() : headers.substr(eol + 1);
+
+        size_t colon = line.find(':');
+        if (colon == std::string_view::npos) {
+            continue;
+        }
+        if (!iequals(line.substr(0, colon), "content-length")) {
+            continue;
+        }
+
+        std::string_view value = line.substr(colon + 1);
+        while (!value.empty() && (value.front() == ' ' || value.front() == '\t')) {
+            value.remove_prefix(1);
+        }
+        while (!value.empty() && (value.back() == ' ' || value.back() == '\t')) {
+            value.remove_suffix(1);
+        }
+        if (value.empty() || value.size() > 18) {
+            return false;
+        }
+
+        size_t parsed = 0;
+        for (char c : value) {
+            if (c < '0' || c > '9') {
+                return false;
+            }
+            parsed = parsed * 10 + static_cast<size_t>(c - '0');
+        }
+        length = parsed;
+        found = true;
+    }
+    return found;
+}
+
+} // namespace
+
+FrameReader::FrameReader(size_t max_frame_bytes)
+    : max_frame_bytes_(max_frame_bytes) {}
+
+FrameReader::Result FrameReader::extract(FrameFormat format, std::string_view& frame) {
+    if (!drain_discard()) {
+        return Result::NeedMore;
+    }
+
+    switch (format) {
+        case FrameFormat::Line:
+            return extract_line(false, frame);
+        case FrameFormat::Ndjson:
+            return extract_line(true, frame);
+        case FrameFormat::ContentLength:
+            return extract_content_length(frame);
+    }
+    return Result::NeedMore;
+}
+
+void FrameReader::append(const char* data, size_t size) {
+    while (size > 0) {
+        reserve_tail();
+        size_t room = buffer_.size() - tail_;
+        if (room == 0) {
+            // Over the limit: keep the prefix so extract() reports TooLarge
+            return;
+        }
+        size_t count = std::min(room, size);
+        std::memcpy(buffer_.data() + tail_, data, count);
+        tail_ += count;
+        data += count;
+        size -= count;
+    }
+}
+
+bool FrameReader::extract_final(FrameFormat format, std::string_view& frame) {
+    if (format == FrameFormat::ContentLength || discard_line_ || buffered() == 0) {
+        return false;
+    }
+
+    std::string_view rest(buffer_.data() + head_, buffered());
+    consume(buffered());
+    if (format == FrameFormat::Line) {
+        frame = rest;
+        return true;
+    }
+    if (is_blank(rest)) {
+        return false;
+    }
+    frame = strip_cr(rest);
+    return true;
+}
+
+ssize_t FrameReader::fill(int fd) {
+    reserve_tail();
+    size_t room = buffer_.size() - tail_;
+    if (room == 0) {
+        errno = ENOBUFS;
+        return -1;
+    }
+
+    ssize_t count = read(fd, buffer_.data() + tail_, room);
+    if (count > 0) {
+        tail_ += static_cast<size_t>(count);
+    }
+    return count;
+}
+
+std::string_view FrameReader::read_frame(int fd, FrameFormat format,
+                                         std::chrono::milliseconds timeout,
+                                         const char* stream_name) {
+    if (fd < 0) {
+        throw std::runtime_error(std::string(stream_name) + " pipe not available");
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    std::string_view frame;
+
+    while (true) {
+        switch (extract(format, frame)) {
+            case Result::Frame:
+                return frame;
+            case Result::TooLarge:
+                throw std::runtime_error(std::string("Frame on ") + stream_name + " exceeds " +
+                                         std::to_string(max_frame_bytes_) + " bytes");
+            case Result::Malformed:
+                throw std::runtime_error(std::string("Malformed frame header on ") + stream_name);
+            case Result::NeedMore:
+                break;
+        }
+
+        if (eof_) {
+            // A final line without a newline still counts, as it always has
+            if (extract_final(format, frame)) {
+                return frame;
+            }
+            throw std::runtime_error(std::string("EOF on ") + stream_name);
+        }
+
+        wait_and_fill(fd, deadline, stream_name);
+    }
+}
+
+FrameReader::Result FrameReader::extract_partial(std::string_view& piece, bool& end) {
+    if (!drain_discard() || head_ == tail_) {
+        return Result::NeedMore;
+    }
+
+    const char* begin = buffer_.data() + head_;
+    const char* newline = static_cast<const char*>(std::memchr(begin, '\n', buffered()));
+    size_t length = newline ? static_cast<size_t>(newline - begin) : buffered();
+    piece = std::string_view(begin, length);
+    end = newline != nullptr;
+    consume(newline ? length + 1 : length);
+    partial_line_ = !end;
+    return Result::Frame;
+}
+
+std::string_view FrameReader::read_partial(int fd, std::chrono::milliseconds timeout,
+                                           const char* stream_name, bool& end) {
+    if (fd < 0) {
+        throw std::runtime_error(std::string(stream_name) + " pipe not available");
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    std::string_view piece;
+
+    while (true) {
+        if (extract_partial(piece, end) == Result::Frame) {
+            return piece;
+        }
+
+        if (eof_) {
+            // EOF ends a line that has started
+            if (partial_line_) {
+                partial_line_ = false;
+                end = true;
+                return std::string_view();
+            }
+            throw std::runtime_error(std::string("EOF on ") + stream_name);
+        }
+
+        wait_and_fill(fd, deadline, stream_name);
+    }
+}
+
+void FrameReader::wait_and_fill(int fd, std::chrono::steady_clock::time_point deadline,
+                                const char* stream_name) {
+    while (true) {
+        auto now = std::chrono::steady_clock::now();
+        if (now >= deadline) {
+            throw ReadTimeout(std::string("Timeout reading from ") + stream_name);
+        }
+
+        int remaining = static_cast<int>(
+            std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now).count()) + 1;
+
+        struct pollfd pfd = {fd, POLLIN, 0};
+        int result = poll(&pfd, 1, remaining);
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error(std::string("poll() failed on ") + stream_name +
+                                     ": " + strerror(errno));
+        } else if (result == 0) {
+            throw ReadTimeout(std::string("Timeout reading from ") + stream_name);
+        }
+
+        ssize_t count = fill(fd);
+        if (count < 0) {
+            if (errno == EINTR || errno == EAGAIN) {
+                continue;
+            }
+            throw std::runtime_error(std::string("Failed to read from ") + stream_name +
+                                     ": " + strerror(errno));
+        }
+        if (count == 0) {
+            eof_ = true;
+        }
+        return;
+    }
+}
+
+FrameReader::Result FrameReader::extract_line(bool ndjson, std::string_view& frame) {
+    while (head_ < tail_) {
+        const char* begin = buffer_.data() + head_;
+        const char* newline = static_cast<const char*>(
+            std::memchr(begin + scanned_, '\n', buffered() - scanned_));
+
+        if (!newline) {
+            scanned_ = buffered();
+            if (buffered() > max_frame_bytes_) {
+                consume(buffered());
+                discard_line_ = true;
+                return Result::TooLarge;
+            }
+            return Result::NeedMore;
+        }
+
+        size_t length = static_cast<size_t>(newline - begin);
+        std::string_view line(begin, length);
+        consume(length + 1);
+
+        if (line.size() > max_frame_bytes_) {
+            return Result::TooLarge;
+        }
+        if (ndjson) {
+            if (is_blank(line)) {
+                continue;
+            }
+            line = strip_cr(line);
+        }
+
+        frame = line;
+        return Result::Frame;
+    }
+    return Result::NeedMore;
+}
+
+FrameReader::Result FrameReader::extract_content_length(std::string_view& frame) {
+    // Tolerate stray line breaks between messages
+    while (head_ < tail_ && is_blank(std::string_view(buffer_.data() + head_, 1))) {
+        consume(1);
+    }
+    if (head_ == tail_) {
+        return Result::NeedMore;
+    }
+
+    std::string_view pending(buffer_.data() + head_, buffered());
+    size_t separator = pending.find("\r\n\r\n");
+    size_t separator_size = 4;
+    size_t bare = pending.find("\n\n");
+    if (bare != std::string_view::npos && bare < separator) {
+        separator = bare;
+        separator_size = 2;
+    }
+
+    if (separator == std::string_view::npos) {
+        if (buffered() > kMaxHeaderBytes) {
+            consume(buffered());
+            return Result::Malformed;
+        }
+        return Result::NeedMore;
+    }
+
+    size_t header_size = separator + separator_size;
+    size_t length = 0;
+    if (!parse_content_length(pending.substr(0, separator), length)) {
+        consume(header_size);
+        return Result::Malformed;
+    }
+
+    if (length > max_frame_bytes_) {
+        consume(header_size);
+        discard_bytes_ = length;
+        drain_discard();
+        return Result::TooLarge;
+    }
+
+    // Headers are re-parsed on the next call; they are tiny
+    if (pending.size() - header_size < length) {
+        return Result::NeedMore;
+    }
+
+    frame = pending.substr(header_size, length);
+    consume(header_size + length);
+    return Result::Frame;
+}
+
+bool FrameReader::drain_discard() {
+    if (discard_bytes_ > 0) {
+        size_t count = std::min(discard_bytes_, buffered());
+        consume(count);
+        discard_bytes_ -= count;
+        return discard_bytes_ == 0;
+    }
+
+    if (discard_line_) {
+        const char* begin = buffer_.data() + head_;
+        const void* newline = std::memchr(begin, '\n', buffered());
+        if (!newline) {
+            consume(buffered());
+            return false;
+        }
+        consume(static_cast<size_t>(static_cast<const char*>(newline) - begin) + 1);
+        discard_line_ = false;
+    }
+    return true;
+}
+
+void FrameReader::consume(size_t count) {
+    head_ += count;
+    scanned_ = 0;
+    if (head_ == tail_) {
+        // Empty: restart at the front (the bytes stay put, so a frame
+        // view handed out just before remains valid)
+        head_ = 0;
+        tail_ = 0;
+    }
+}
+
+void FrameReader::reserve_tail() {
+    if (tail_ < buffer_.size()) {
+        return;
+    }
+
+    // Slide the unread tail to the front before growing
+    if (head_ > 0) {
+        std::memmove(buffer_.data(), buffer_.data() + head_, buffered());
+        tail_ -= head_;
+        head_ = 0;
+        if (tail_ < buffer_.size()) {
+            return;
+        }
+    }
+
+    // Room for the largest frame plus its header block or line terminator
+    size_t limit = max_frame_bytes_ + kMaxHeaderBytes + 2;
+    if (buffer_.size() >= limit) {
+        return;
+    }
+    size_t grown = buffer_.empty() ? std::min(kInitialCapacity, limit)
+                                   : std::min(buffer_.size() * 2, limit);
+    buffer_.resize(grown);
+}
+
+} // namespace kyros
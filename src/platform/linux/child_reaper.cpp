@@ -0,0 +1,171 @@
+// Shared background reaper for probe children
+
+#include <kyros/platform/linux/child_reaper.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <signal.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace kyros {
+
+namespace {
+
+// Poll interval for children we have no pidfd for
+constexpr int kFallbackPollMs = 5;
+
+} // namespace
+
+ChildReaper& ChildReaper::instance() {
+    static ChildReaper reaper;
+    return reaper;
+}
+
+ChildReaper::ChildReaper() {
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+    if (epoll_fd_ >= 0 && wake_fd_ >= 0) {
+        struct epoll_event event = {};
+        event.events = EPOLLIN;
+        event.data.fd = wake_fd_;
+        epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wake_fd_, &event);
+    }
+
+    thread_ = std::thread(&ChildReaper::run, this);
+}
+
+ChildReaper::~ChildReaper() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+
+    // Don't leave zombies or stray servers behind at exit
+    for (const auto& child : children_) {
+        kill(child.pid, SIGKILL);
+        waitpid(child.pid, nullptr, 0);
+        if (child.pidfd >= 0) {
+            close(child.pidfd);
+        }
+    }
+
+    if (wake_fd_ >= 0) close(wake_fd_);
+    if (epoll_fd_ >= 0) close(epoll_fd_);
+}
+
+void ChildReaper::adopt(int pid, int pidfd, Clock::time_point kill_deadline) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        children_.push_back(Child{pid, pidfd, kill_deadline, false});
+
+        if (pidfd >= 0 && epoll_fd_ >= 0) {
+            struct epoll_event event = {};
+            event.events = EPOLLIN;
+            event.data.fd = pidfd;
+            epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, pidfd, &event);
+        }
+    }
+    wake();
+}
+
+size_t ChildReaper::pending() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return children_.size();
+}
+
+bool ChildReaper::wait_idle(std::chrono::milliseconds timeout) const {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return idle_.wait_for(lock, timeout, [this] { return children_.empty(); });
+}
+
+void ChildReaper::wake() {
+    if (wake_fd_ >= 0) {
+        uint64_t one = 1;
+        ssize_t ignored = write(wake_fd_, &one, sizeof(one));
+        (void)ignored;
+    }
+}
+
+int ChildReaper::next_timeout_ms(Clock::time_point now) const {
+    int timeout = -1;
+    for (const auto& child : children_) {
+        if (child.pidfd < 0 || epoll_fd_ < 0) {
+            timeout = (timeout < 0) ? kFallbackPollMs : std::min(timeout, kFallbackPollMs);
+        }
+        if (!child.killed) {
+            auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+                child.deadline - now).count();
+            int ms = static_cast<int>(std::max<long long>(0, remaining));
+            timeout = (timeout < 0) ? ms : std::min(timeout, ms);
+        }
+    }
+    return timeout;
+}
+
+void ChildReaper::run() {
+    struct epoll_event events[32];
+
+    while (true) {
+        int timeout;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (stopping_) {
+                return;
+            }
+            timeout = next_timeout_ms(Clock::now());
+        }
+
+        if (epoll_fd_ >= 0) {
+            int ready = epoll_wait(epoll_fd_, events, 32, timeout);
+            if (ready < 0 && errno != EINTR) {
+                return;
+            }
+        } else {
+            usleep(static_cast<useconds_t>((timeout < 0 ? kFallbackPollMs : timeout) * 1000));
+        }
+
+        if (wake_fd_ >= 0) {
+            uint64_t count;
+            ssize_t ignored = read(wake_fd_, &count, sizeof(count));
+            (void)ignored;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto now = Clock::now();
+
+        for (auto it = children_.begin(); it != children_.end();) {
+            pid_t result = waitpid(it->pid, nullptr, WNOHANG);
+            if (result == it->pid || (result < 0 && errno == ECHILD)) {
+                if (it->pidfd >= 0) {
+                    if (epoll_fd_ >= 0) {
+                        epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, it->pidfd, nullptr);
+                    }
+                    close(it->pidfd);
+                }
+                it = children_.erase(it);
+                continue;
+            }
+
+            if (!it->killed && now >= it->deadline) {
+                kill(it->pid, SIGKILL);
+                it->killed = true;
+            }
+            ++it;
+        }
+
+        if (children_.empty()) {
+            idle_.notify_all();
+        }
+    }
+}
+
+} // namespace kyros
@@ -0,0 +1,473 @@
+// Single-threaded epoll event loop for stdio probes
+
+#include <kyros/platform/linux/epoll_probe_reactor.hpp>
+#include <kyros/platform/linux/linux_process.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+namespace kyros {
+
+namespace {
+
+// epoll user data: probe index << 2 | descriptor kind
+constexpr uint32_t kStdout = 0;
+constexpr uint32_t kStderr = 1;
+constexpr uint32_t kExit = 2;
+constexpr uint64_t kTimerKey = ~uint64_t(0);
+
+// Descriptors a probe holds at once: three pipe ends and a pidfd, plus
+// the three far ends that exist while it is being spawned
+constexpr size_t kFdsPerProbe = 7;
+
+// Left for everything else in the process
+constexpr size_t kReservedFds = 64;
+
+// How much of stderr is kept for error messages
+constexpr size_t kStderrTailBytes = 512;
+
+constexpr int kMaxEvents = 256;
+
+void set_nonblocking(int fd) {
+    int flags = fcntl(fd, F_GETFL);
+    if (flags >= 0) {
+        fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+    }
+}
+
+// Allow as many descriptors as the hard limit permits
+void raise_fd_limit() {
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+}
+
+} // namespace
+
+EpollProbeReactor::EpollProbeReactor(size_t max_in_flight)
+    : max_in_flight_(std::max<size_t>(max_in_flight, 1)) {
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    timer_fd_ = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+
+    if (epoll_fd_ >= 0 && timer_fd_ >= 0) {
+        struct epoll_event event = {};
+        event.events = EPOLLIN;
+        event.data.u64 = kTimerKey;
+        epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, timer_fd_, &event);
+    }
+}
+
+EpollProbeReactor::~EpollProbeReactor() {
+    for (size_t i = 0; i < probes_.size(); i++) {
+        finish(i, Status::Error, "Reactor destroyed");
+    }
+    if (timer_fd_ >= 0) {
+        close(timer_fd_);
+    }
+    if (epoll_fd_ >= 0) {
+        close(epoll_fd_);
+    }
+}
+
+size_t EpollProbeReactor::add(SpawnFunction spawn, std::string request,
+                              std::chrono::milliseconds timeout) {
+    Probe probe;
+    probe.spawn = std::move(spawn);
+    probe.request = std::move(request);
+    probe.timeout = timeout;
+    probes_.push_back(std::move(probe));
+    return probes_.size() - 1;
+}
+
+std::vector<ProbeReactor::Result> EpollProbeReactor::run() {
+    if (!is_open()) {
+        for (size_t i = 0; i < probes_.size(); i++) {
+            finish(i, Status::Error, "epoll unavailable");
+        }
+    } else {
+        raise_fd_limit();
+    }
+
+    size_t limit = slot_limit();
+    size_t next = 0;
+    struct epoll_event events[kMaxEvents];
+
+    while (true) {
+        // Admit queued probes as slots free up
+        while (in_flight_ < limit && next < probes_.size()) {
+            start(next++);
+        }
+        if (in_flight_ == 0) {
+            if (next >= probes_.size()) {
+                break;
+            }
+            continue;
+        }
+
+        arm_timer();
+        int count = epoll_wait(epoll_fd_, events, kMaxEvents, -1);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            std::string error = std::string("epoll_wait() failed: ") + strerror(errno);
+            for (size_t i = 0; i < probes_.size(); i++) {
+                finish(i, Status::Error, error);
+            }
+            break;
+        }
+
+        for (int e = 0; e < count; e++) {
+            uint64_t key = events[e].data.u64;
+            if (key == kTimerKey) {
+                uint64_t expirations;
+                ssize_t ignored = read(timer_fd_, &expirations, sizeof(expirations));
+                (void)ignored;
+                expire_deadlines();
+                continue;
+            }
+
+            size_t index = static_cast<size_t>(key >> 2);
+            State state = probes_[index].state;
+            if (state != State::AwaitingResponse && state != State::Kept) {
+                continue;  // Finished earlier in this batch
+            }
+
+            switch (static_cast<uint32_t>(key & 3)) {
+                case kStdout:
+                    if (state == State::AwaitingResponse) {
+                        on_stdout(index);
+                    }
+                    break;
+                case kStderr: on_stderr(index); break;
+                case kExit: on_exit(index); break;
+            }
+        }
+    }
+
+    std::vector<Result> results;
+    results.reserve(probes_.size());
+    for (auto& probe : probes_) {
+        results.push_back(std::move(probe.result));
+    }
+    probes_.clear();
+    deadlines_ = {};
+    return results;
+}
+
+size_t EpollProbeReactor::slot_limit() const {
+    struct rlimit limit;
+    size_t by_fds = max_in_flight_;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur != RLIM_INFINITY) {
+        size_t available = static_cast<size_t>(limit.rlim_cur);
+        by_fds = available > kReservedFds + kFdsPerProbe
+                     ? (available - kReservedFds) / kFdsPerProbe : 1;
+    }
+    return std::max<size_t>(std::min(max_in_flight_, by_fds), 1);
+}
+
+void EpollProbeReactor::start(size_t index) {
+    Probe& probe = probes_[index];
+
+    try {
+        probe.process = probe.spawn();
+    } catch (const std::exception& e) {
+        finish(index, Status::Error, e.what());
+        return;
+    }
+    probe.spawn = nullptr;
+
+    // Stamped before the probe counts as in flight, so every finish()
+    // from here on measures elapsed time from a real start
+    probe.started = Clock::now();
+    probe.state = State::AwaitingResponse;
+    in_flight_++;
+
+    if (!probe.process) {
+        finish(index, Status::Error, "Failed to spawn process");
+        return;
+    }
+
+    probe.linux_process = dynamic_cast<LinuxProcess*>(probe.process.get());
+    if (!probe.linux_process || probe.linux_process->stdout_fd() < 0) {
+        finish(index, Status::Error, "Process has no pipes to watch");
+        return;
+    }
+
+    int stdout_fd = probe.linux_process->stdout_fd();
+    int stderr_fd = probe.linux_process->stderr_fd();
+    set_nonblocking(stdout_fd);
+    if (stderr_fd >= 0) {
+        set_nonblocking(stderr_fd);
+    }
+
+    if (!watch(stdout_fd, index, kStdout) ||
+        (stderr_fd >= 0 && !watch(stderr_fd, index, kStderr)) ||
+        (probe.linux_process->pidfd() >= 0 && !watch(probe.linux_process->pidfd(), index, kExit))) {
+        finish(index, Status::Error, std::string("epoll_ctl() failed: ") + strerror(errno));
+        return;
+    }
+
+    // The request is a few hundred bytes and the pipe is empty, so this
+    // write does not block. It fails if the child has already exited or
+    // closed stdin; the exit or the deadline then settles the probe.
+    try {
+        probe.process->write_stdin(probe.request);
+    } catch (const std::exception&) {
+    }
+    probe.request.clear();
+    probe.request.shrink_to_fit();
+
+    probe.deadline = probe.started + probe.timeout;
+    deadlines_.push({probe.deadline, index});
+}
+
+void EpollProbeReactor::on_stdout(size_t index) {
+    Probe& probe = probes_[index];
+    int fd = probe.linux_process->stdout_fd();
+    std::string_view frame;
+
+    while (true) {
+        ssize_t count = probe.stdout_frames.fill(fd);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN) {
+                return;
+            }
+            finish(index, Status::Error, std::string("Failed to read from stdout: ") + strerror(errno));
+            return;
+        }
+
+        if (count == 0) {
+            if (probe.stdout_frames.extract_final(FrameFormat::Ndjson, frame)) {
+                probe.result.frame.assign(frame.data(), frame.size());
+                finish(index, Status::Response);
+            } else {
+                finish(index, Status::Closed, "EOF on stdout");
+            }
+            return;
+        }
+
+        switch (probe.stdout_frames.extract(FrameFormat::Ndjson, frame)) {
+            case FrameReader::Result::Frame:
+                probe.result.frame.assign(frame.data(), frame.size());
+                finish(index, Status::Response);
+                return;
+            case FrameReader::Result::TooLarge:
+            case FrameReader::Result::Malformed:
+                finish(index, Status::Error, "Frame on stdout exceeds " +
+                       std::to_string(probe.stdout_frames.max_frame_bytes()) + " bytes");
+                return;
+            case FrameReader::Result::NeedMore:
+                break;
+        }
+    }
+}
+
+void EpollProbeReactor::on_stderr(size_t index) {
+    Probe& probe = probes_[index];
+    bool kept = probe.state == State::Kept;
+    int fd = kept ? probe.kept_stderr_fd : probe.linux_process->stderr_fd();
+    char buffer[4096];
+
+    while (true) {
+        ssize_t count = read(fd, buffer, sizeof(buffer));
+        if (count > 0) {
+            // Keep only the tail; the rest is discarded so the child never
+            // blocks on a full stderr pipe
+            std::string& tail = probe.result.stderr_tail;
+            tail.append(buffer, static_cast<size_t>(count));
+            if (tail.size() > kStderrTailBytes) {
+                tail.erase(0, tail.size() - kStderrTailBytes);
+            }
+            continue;
+        }
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count == 0 || errno != EAGAIN) {
+            // Closed: stop watching, or it stays readable forever. Without
+            // a pidfd this is the only sign a kept process has exited.
+            epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+            if (kept && probe.kept_exit_fd < 0) {
+                release(index);
+            }
+        }
+        return;
+    }
+}
+
+void EpollProbeReactor::on_exit(size_t index) {
+    if (probes_[index].state == State::Kept) {
+        if (probes_[index].kept_stderr_fd >= 0) {
+            on_stderr(index);
+        }
+        release(index);
+        return;
+    }
+
+    // Whatever the child wrote before exiting is already in the pipe
+    on_stdout(index);
+    if (probes_[index].state == State::AwaitingResponse) {
+        finish(index, Status::Closed, "Process exited before responding");
+    }
+}
+
+void EpollProbeReactor::expire_deadlines() {
+    auto now = Clock::now();
+    while (!deadlines_.empty() && deadlines_.top().first <= now) {
+        size_t index = deadlines_.top().second;
+        deadlines_.pop();
+        if (probes_[index].state == State::AwaitingResponse) {
+            finish(index, Status::Timeout, "Timeout reading from stdout");
+        }
+    }
+}
+
+void EpollProbeReactor::arm_timer() {
+    // Entries of finished probes are dropped lazily
+    while (!deadlines_.empty() && probes_[deadlines_.top().second].state != State::AwaitingResponse) {
+        deadlines_.pop();
+    }
+
+    struct itimerspec spec = {};
+    if (!deadlines_.empty()) {
+        auto remaining = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            deadlines_.top().first - Clock::now()).count();
+        if (remaining <= 0) {
+            remaining = 1;  // Already due; zero would disarm the timer
+        }
+        spec.it_value.tv_sec = static_cast<time_t>(remaining / 1000000000);
+        spec.it_value.tv_nsec = static_cast<long>(remaining % 1000000000);
+    }
+    timerfd_settime(timer_fd_, 0, &spec, nullptr);
+}
+
+void EpollProbeReactor::finish(size_t index, Status status, std::string error) {
+    Probe& probe = probes_[index];
+    if (probe.state == State::Done) {
+        return;
+    }
+    if (probe.state == State::Kept) {
+        release(index);  // Stop waiting for its exit
+        return;
+    }
+    bool was_in_flight = probe.state == State::AwaitingResponse;
+
+    probe.state = State::Done;
+    probe.result.status = status;
+    if (was_in_flight) {
+        probe.result.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            Clock::now() - probe.started);
+    }
+    probe.result.error = std::move(error);
+
+    if (probe.linux_process && status == Status::Response && response_handler_ && keep(index)) {
+        // Hand the live process over, with a blocking stdout again. The
+        // probe stays in flight until the process exits.
+        LinuxProcess* process = probe.linux_process;
+        int stdout_fd = process->stdout_fd();
+        fcntl(stdout_fd, F_SETFL, fcntl(stdout_fd, F_GETFL) & ~O_NONBLOCK);
+        probe.linux_process = nullptr;
+        probe.result.process = std::move(probe.process);
+        response_handler_(index, probe.result);
+        if (probe.result.process) {
+            // Not taken: the exit still releases the slot
+            process->terminate_in_background();
+            probe.result.process.reset();
+        }
+        return;
+    } else if (probe.linux_process) {
+        // Pick up any last words for the diagnostics
+        if (status != Status::Response && probe.linux_process->stderr_fd() >= 0) {
+            on_stderr(index);
+        }
+
+        // The pidfd outlives this probe (the reaper keeps it), so it must
+        // leave our epoll set explicitly; pipes leave it when closed
+        for (int fd : {probe.linux_process->stdout_fd(), probe.linux_process->stderr_fd(),
+                       probe.linux_process->pidfd()}) {
+            if (fd >= 0) {
+                epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+            }
+        }
+        probe.linux_process->terminate_in_background();
+    } else if (probe.process) {
+        probe.process->terminate();
+    }
+    probe.process.reset();
+    probe.linux_process = nullptr;
+    probe.spawn = nullptr;
+
+    if (was_in_flight) {
+        in_flight_--;
+    }
+}
+
+bool EpollProbeReactor::keep(size_t index) {
+    Probe& probe = probes_[index];
+    LinuxProcess& process = *probe.linux_process;
+
+    // The process's own descriptors leave the epoll set; the new owner may
+    // close them at any time. The duplicates share the stderr pipe's
+    // O_NONBLOCK, so only the reactor reads stderr from here on.
+    for (int fd : {process.stdout_fd(), process.stderr_fd(), process.pidfd()}) {
+        if (fd >= 0) {
+            epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+        }
+    }
+    if (process.stderr_fd() >= 0) {
+        probe.kept_stderr_fd = fcntl(process.stderr_fd(), F_DUPFD_CLOEXEC, 0);
+    }
+    if (process.pidfd() >= 0) {
+        probe.kept_exit_fd = fcntl(process.pidfd(), F_DUPFD_CLOEXEC, 0);
+    }
+
+    // Without a way to see the exit the slot cannot be held
+    bool watched = probe.kept_exit_fd >= 0 ? watch(probe.kept_exit_fd, index, kExit)
+                                           : probe.kept_stderr_fd >= 0;
+    if (watched && probe.kept_stderr_fd >= 0) {
+        watched = watch(probe.kept_stderr_fd, index, kStderr);
+    }
+    if (!watched) {
+        close_kept_fds(probe);
+        return false;
+    }
+    probe.state = State::Kept;
+    return true;
+}
+
+void EpollProbeReactor::release(size_t index) {
+    close_kept_fds(probes_[index]);
+    probes_[index].state = State::Done;
+    in_flight_--;
+}
+
+void EpollProbeReactor::close_kept_fds(Probe& probe) {
+    for (int* fd : {&probe.kept_stderr_fd, &probe.kept_exit_fd}) {
+        if (*fd >= 0) {
+            epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, *fd, nullptr);
+            close(*fd);
+            *fd = -1;
+        }
+    }
+}
+
+bool EpollProbeReactor::watch(int fd, size_t index, uint32_t kind) {
+    struct epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.u64 = (static_cast<uint64_t>(index) << 2) | kind;
+    return epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) == 0;
+}
+
+} // namespace kyros
@@ -0,0 +1,101 @@
+// inotify-backed config file watcher
+
+#include <kyros/platform/linux/inotify_watcher.hpp>
+
+#include <cerrno>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+namespace kyros {
+
+namespace {
+
+constexpr uint32_t kWatchMask = IN_CREATE | IN_CLOSE_WRITE | IN_MODIFY | IN_ATTRIB |
+                                IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE |
+                                IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR;
+
+} // namespace
+
+InotifyWatcher::InotifyWatcher() {
+    fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+}
+
+InotifyWatcher::~InotifyWatcher() {
+    if (fd_ >= 0) {
+        close(fd_);
+    }
+}
+
+bool InotifyWatcher::watch_directory(const std::string& path) {
+    if (fd_ < 0) {
+        return false;
+    }
+
+    int wd = inotify_add_watch(fd_, path.c_str(), kWatchMask);
+    if (wd < 0) {
+        return false;
+    }
+
+    // inotify returns the existing descriptor for an already-watched inode
+    directories_[wd] = path;
+    return true;
+}
+
+bool InotifyWatcher::poll(std::vector<std::string>& changed, int timeout_ms) {
+    if (fd_ < 0) {
+        return false;
+    }
+
+    if (timeout_ms > 0) {
+        struct pollfd pfd = {fd_, POLLIN, 0};
+        if (::poll(&pfd, 1, timeout_ms) <= 0) {
+            return true;
+        }
+    }
+
+    bool complete = true;
+    alignas(struct inotify_event) char buffer[16384];
+    while (true) {
+        ssize_t received = read(fd_, buffer, sizeof(buffer));
+        if (received < 0) {
+            if (errno == EINTR) continue;
+            break;  // EAGAIN: queue drained
+        }
+        if (received == 0) {
+            break;
+        }
+
+        for (char* p = buffer; p < buffer + received;) {
+            auto* event = reinterpret_cast<struct inotify_event*>(p);
+            p += sizeof(struct inotify_event) + event->len;
+
+            if (event->mask & IN_Q_OVERFLOW) {
+                complete = false;
+                continue;
+            }
+
+            auto dir = directories_.find(event->wd);
+            if (dir == directories_.end()) {
+                continue;
+            }
+
+            if (event->mask & IN_IGNORED) {
+                // Directory was removed; its path changed as a whole
+                changed.push_back(dir->second);
+                directories_.erase(dir);
+                continue;
+            }
+
+            if (event->len > 0) {
+                changed.push_back(dir->second + "/" + event->name);
+            } else {
+                changed.push_back(dir->second);
+            }
+        }
+    }
+
+    return complete;
+}
+
+} // namespace kyros
@@ -1,85 +1,583 @@
 // Linux Platform Adapter Implementation
 //
-// TODO: Implement Linux platform support using /proc filesystem
+// Process information is read directly from /proc. snapshot_processes() takes
+// a single pass over every PID (stat + cmdline through one dirfd each); the
+// per-PID getters are answered from the latest snapshot when possible.
+// Later snapshots are incremental: known PIDs are revalidated from stat
+// alone, or skipped entirely when the proc connector reports no events.
+// Pipe and socket descriptors are kept per PID between scans as well; only
+// PIDs a snapshot re-read (or whose parent forked) have /proc/<pid>/fd
+// walked again. The pipe index and socket ownership are built from them.
+// Listening sockets come from NETLINK_SOCK_DIAG (or /proc/net as a fallback).
+//
+// Detection engines call in from several threads at once. snapshot_mutex_
+// covers the snapshot state and ProcReader's stat/cmdline scratch buffer;
+// descriptor_mutex_ covers the kept descriptors. environ, fd and socket
+// reads only share the /proc dirfd and need no lock of their own.
 
 #include <kyros/platform/platform_adapter.hpp>
+#include <kyros/platform/linux/epoll_probe_reactor.hpp>
+#include <kyros/platform/linux/inotify_watcher.hpp>
+#include <kyros/platform/linux/linux_process.hpp>
+#include <kyros/platform/linux/proc_events.hpp>
+#include <kyros/platform/linux/proc_reader.hpp>
+#include <kyros/platform/linux/socket_diag.hpp>
 #include <stdexcept>
+#include <filesystem>
+#include <fstream>
+#include <cstdlib>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pwd.h>
 
 namespace kyros {
 
 class LinuxPlatformAdapter : public PlatformAdapter {
 public:
+    LinuxPlatformAdapter() {
+        // The proc connector is root-only; don't pay for a failed
+        // subscription handshake otherwise
+        if (geteuid() == 0) {
+            events_ = std::make_unique<ProcEvents>();
+            if (!events_->is_open()) {
+                events_.reset();
+            }
+        }
+    }
+
     std::string platform_name() const override {
         return "Linux";
     }
 
     bool file_exists(const std::string& path) override {
-        (void)path;
-        throw std::runtime_error("Linux platform not yet implemented");
+        std::error_code ec;
+        return std::filesystem::exists(std::filesystem::path(path), ec);
     }
 
     std::string expand_path(const std::string& path) override {
-        (void)path;
-        throw std::runtime_error("Linux platform not yet implemented");
+        if (path.empty()) {
+            return path;
+        }
+
+        // Manual ~ expansion
+        if (path[0] == '~') {
+            const char* home = std::getenv("HOME");
+            if (!home) {
+                struct passwd* pw = getpwuid(getuid());
+                home = pw ? pw->pw_dir : nullptr;
+            }
+            if (home) {
+                if (path.length() == 1) {
+                    return std::string(home);
+                } else if (path[1] == '/') {
+                    return std::string(home) + path.substr(1);
+                }
+            }
+        }
+
+        // Basic $VAR and ${VAR} expansion
+        std::string result = path;
+        size_t pos = 0;
+        while ((pos = result.find('$', pos)) != std::string::npos) {
+            size_t end_pos = pos + 1;
+            bool has_braces = (end_pos < result.length() && result[end_pos] == '{');
+
+            if (has_braces) {
+                end_pos++;
+                size_t close_brace = result.find('}', end_pos);
+                if (close_brace == std::string::npos) {
+                    break;
+                }
+                std::string var_name = result.substr(end_pos, close_brace - end_pos);
+                const char* var_value = std::getenv(var_name.c_str());
+                if (var_value) {
+                    result = result.substr(0, pos) + std::string(var_value) + result.substr(close_brace + 1);
+                } else {
+                    pos = close_brace + 1;
+                }
+            } else {
+                while (end_pos < result.length() &&
+                       (isalnum(static_cast<unsigned char>(result[end_pos])) || result[end_pos] == '_')) {
+                    end_pos++;
+                }
+                if (end_pos > pos + 1) {
+                    std::string var_name = result.substr(pos + 1, end_pos - pos - 1);
+                    const char* var_value = std::getenv(var_name.c_str());
+                    if (var_value) {
+                        result = result.substr(0, pos) + std::string(var_value) + result.substr(end_pos);
+                    } else {
+                        pos = end_pos;
+                    }
+                } else {
+                    pos++;
+                }
+            }
+        }
+
+        return result;
     }
 
     nlohmann::json read_json_file(const std::string& path) override {
-        (void)path;
-        throw std::runtime_error("Linux platform not yet implemented");
+        std::ifstream file(path);
+        if (!file.is_open()) {
+            throw std::runtime_error("Failed to open file: " + path);
+        }
+
+        nlohmann::json result;
+        try {
+            file >> result;
+        } catch (const nlohmann::json::parse_error& e) {
+            throw std::runtime_error("Failed to parse JSON from " + path + ": " + e.what());
+        }
+
+        return result;
     }
 
     std::vector<std::string> list_directory(const std::string& path) override {
-        (void)path;
-        throw std::runtime_error("Linux platform not yet implemented");
+        std::vector<std::string> result;
+        try {
+            for (const auto& entry : std::filesystem::directory_iterator(path)) {
+                result.push_back(entry.path().filename().string());
+            }
+        } catch (const std::filesystem::filesystem_error& e) {
+            throw std::runtime_error(std::string("Failed to list directory: ") + e.what());
+        }
+        return result;
+    }
+
+    std::unique_ptr<FileWatcher> create_file_watcher() override {
+        auto watcher = std::make_unique<InotifyWatcher>();
+        if (!watcher->is_open()) {
+            return nullptr;  // inotify instance limit reached
+        }
+        return watcher;
+    }
+
+    std::shared_ptr<const ProcessTable> snapshot_processes() override {
+        std::lock_guard<std::mutex> lock(snapshot_mutex_);
+        auto table = std::make_shared<ProcessTable>();
+        auto previous = last_snapshot_;
+
+        // With the proc connector, PIDs without events since the previous
+        // snapshot are copied over without touching /proc at all
+        std::unordered_set<int> changed;
+        std::unordered_set<int> execed;
+        std::unordered_set<int> forked;
+        bool events_complete = previous && events_ && events_->drain(changed, execed, forked);
+        if (events_complete && !changed.empty()) {
+            // Children of an exited process are reparented without an event
+            for (size_t row = 0; row < previous->size(); row++) {
+                if (changed.count(previous->ppid(row))) {
+                    changed.insert(previous->pid(row));
+                }
+            }
+        }
+
+        std::vector<int> pids = reader_.list_pids();
+        table->reserve(pids.size());
+
+        ProcEntry entry;
+        for (int pid : pids) {
+            auto prev_row = previous ? previous->find(pid) : std::nullopt;
+
+            if (prev_row && events_complete && changed.count(pid) == 0) {
+                table->copy_row(*previous, *prev_row);
+                continue;
+            }
+
+            uint32_t exec_count = 0;
+            if (prev_row) {
+                // Known PID: re-read stat only and keep the previous cmdline
+                // when start time (same process) and comm match and the
+                // proc connector, if any, reported no exec. An exec that
+                // keeps comm is only visible through the connector.
+                if (!reader_.read_stat(pid, entry)) {
+                    continue;
+                }
+                std::string comm = entry.name;
+                auto prev_args = previous->argv(*prev_row);
+                entry.argv.assign(prev_args.begin(), prev_args.end());
+                ProcReader::resolve_name(entry);
+
+                bool same_process = entry.start_time == previous->start_time(*prev_row);
+                bool exec = same_process && (execed.count(pid) != 0 ||
+                                             entry.name != previous->name(*prev_row));
+                if (same_process) {
+                    exec_count = previous->exec_count(*prev_row) + (exec ? 1 : 0);
+                }
+                if (!same_process || exec) {
+                    entry.name = std::move(comm);
+                    reader_.read_cmdline(pid, entry.argv);
+                    ProcReader::resolve_name(entry);
+                }
+            } else if (!reader_.read(pid, entry)) {
+                continue;  // Exited between readdir and open
+            }
+
+            table->add(entry.pid, entry.ppid, entry.uid, entry.start_time,
+                       entry.name, entry.argv, exec_count);
+            stale_descriptors_.insert(entry.pid);
+        }
+        if (events_complete) {
+            stale_descriptors_.insert(forked.begin(), forked.end());
+        }
+
+        // Per-PID getters below are served from the latest snapshot
+        last_snapshot_ = table;
+        return table;
     }
 
     std::vector<int> get_process_list() override {
-        throw std::runtime_error("Linux platform not yet implemented");
+        return snapshot_processes()->pids();
     }
 
     std::string get_command_line(int pid) override {
-        (void)pid;
-        throw std::runtime_error("Linux platform not yet implemented");
+        std::lock_guard<std::mutex> lock(snapshot_mutex_);
+        ProcEntry entry;
+        if (auto row = cached_row(pid)) {
+            return std::string(last_snapshot_->command_line(*row));
+        }
+        return read_entry(pid, entry) ? entry.command_line() : "";
+    }
+
+    std::vector<std::string> get_command_args(int pid) override {
+        std::lock_guard<std::mutex> lock(snapshot_mutex_);
+        ProcEntry entry;
+        if (auto row = cached_row(pid)) {
+            auto args = last_snapshot_->argv(*row);
+            return std::vector<std::string>(args.begin(), args.end());
+        }
+        return read_entry(pid, entry) ? entry.argv : std::vector<std::string>();
     }
 
     std::string get_process_name(int pid) override {
-        (void)pid;
-        throw std::runtime_error("Linux platform not yet implemented");
+        std::lock_guard<std::mutex> lock(snapshot_mutex_);
+        ProcEntry entry;
+        if (auto row = cached_row(pid)) {
+            return std::string(last_snapshot_->name(*row));
+        }
+        return read_entry(pid, entry) ? entry.name : "";
     }
 
     int get_parent_pid(int pid) override {
-        (void)pid;
-        throw std::runtime_error("Linux platform not yet implemented");
+        std::lock_guard<std::mutex> lock(snapshot_mutex_);
+        ProcEntry entry;
+        if (auto row = cached_row(pid)) {
+            return last_snapshot_->ppid(*row);
+        }
+        return read_entry(pid, entry) ? entry.ppid : -1;
     }
 
     std::map<std::string, std::string> get_environment(int pid) override {
-        (void)pid;
-        throw std::runtime_error("Linux platform not yet implemented");
+        std::map<std::string, std::string> result;
+
+        // environ is only readable for our own processes (or as root)
+        std::string block;
+        if (!reader_.read_environ(pid, block)) {
+            return result;
+        }
+
+        for (auto& var : ProcReader::split_nul(block.data(), block.size())) {
+            size_t eq_pos = var.find('=');
+            if (eq_pos != std::string::npos) {
+                result[var.substr(0, eq_pos)] = var.substr(eq_pos + 1);
+            }
+        }
+
+        return result;
+    }
+
+    bool get_environment_block(int pid, std::string& block) override {
+        return reader_.read_environ(pid, block);
     }
 
     bool has_bidirectional_pipes(int pid) override {
-        (void)pid;
-        throw std::runtime_error("Linux platform not yet implemented");
+        std::string target;
+        if (!reader_.read_fd_link(pid, 0, target) || target.compare(0, 5, "pipe:") != 0) {
+            return false;
+        }
+        if (!reader_.read_fd_link(pid, 1, target) || target.compare(0, 5, "pipe:") != 0) {
+            return false;
+        }
+        return true;
+    }
+
+    std::shared_ptr<const PipeIndex> build_pipe_index() override {
+        std::lock_guard<std::mutex> lock(descriptor_mutex_);
+        refresh_descriptors();
+        if (pipe_index_) {
+            return pipe_index_;  // No process changed since it was built
+        }
+
+        auto index = std::make_shared<PipeIndex>();
+        for (const auto& [pid, descriptors] : descriptors_) {
+            for (const auto& descriptor : descriptors) {
+                if (!descriptor.socket) {
+                    index->add(pid, descriptor.fd, descriptor.inode);
+                }
+            }
+        }
+        pipe_index_ = index;
+        return index;
     }
 
     std::vector<NetworkListener> get_listening_sockets() override {
-        throw std::runtime_error("Linux platform not yet implemented");
+        std::vector<SocketEntry> sockets;
+        if (!SocketDiag::query_netlink(sockets)) {
+            sockets = SocketDiag::read_proc_net();
+        }
+
+        // Attribute socket inodes to PIDs from the kept descriptors. A
+        // socket shared by several processes (pre-forked workers) goes to
+        // the lowest PID, normally the parent.
+        std::unordered_map<uint64_t, int> owners;
+        for (const auto& socket : sockets) {
+            owners.emplace(socket.inode, 0);
+        }
+
+        if (!owners.empty()) {
+            std::lock_guard<std::mutex> lock(descriptor_mutex_);
+            refresh_descriptors();
+
+            for (const auto& [pid, descriptors] : descriptors_) {
+                for (const auto& descriptor : descriptors) {
+                    if (!descriptor.socket) continue;
+                    auto it = owners.find(descriptor.inode);
+                    if (it != owners.end() && (it->second == 0 || pid < it->second)) {
+                        it->second = pid;
+                    }
+                }
+            }
+
+            // A process can open a listener without any proc connector
+            // event, so sockets nobody is known to hold send us on one walk
+            // over /proc/*/fd, in ascending PID order, stopping once they
+            // are resolved. Those that no readable process holds (kernel
+            // listeners, other users' processes) are remembered so they do
+            // not cause a walk on every scan.
+            size_t pending = 0;
+            for (const auto& [inode, pid] : owners) {
+                if (pid == 0 && ownerless_sockets_.count(inode) == 0) {
+                    pending++;
+                }
+            }
+            bool walked = pending > 0;
+            if (walked) {
+                reader_.for_each_fd([&](int pid, int, std::string_view target) {
+                    uint64_t inode = 0;
+                    if (parse_inode_link(target, "socket:[", inode)) {
+                        auto it = owners.find(inode);
+                        if (it != owners.end() && it->second == 0) {
+                            it->second = pid;
+                            // Its kept descriptors are out of date
+                            descriptors_.erase(pid);
+                            pipe_index_.reset();
+                            if (ownerless_sockets_.count(inode) == 0) {
+                                pending--;
+                            }
+                        }
+                    }
+                    return pending > 0;
+                });
+            }
+
+            std::unordered_set<uint64_t> ownerless;
+            for (const auto& [inode, pid] : owners) {
+                if (pid == 0 && (walked || ownerless_sockets_.count(inode))) {
+                    ownerless.insert(inode);
+                }
+            }
+            ownerless_sockets_.swap(ownerless);
+        }
+
+        std::vector<NetworkListener> result;
+        result.reserve(sockets.size());
+        for (auto& socket : sockets) {
+            NetworkListener listener;
+            listener.pid = owners[socket.inode];  // 0 when owned by a process we cannot inspect
+            listener.address = std::move(socket.address);
+            listener.port = socket.port;
+            listener.protocol = std::move(socket.protocol);
+            result.push_back(std::move(listener));
+        }
+
+        return result;
+    }
+
+    std::unique_ptr<ProbeReactor> create_probe_reactor() override {
+        auto reactor = std::make_unique<EpollProbeReactor>();
+        if (!reactor->is_open()) {
+            return nullptr;
+        }
+        return reactor;
     }
 
     std::unique_ptr<Process> spawn_process_with_pipes(
         const std::string& command,
         const std::vector<std::string>& args) override {
-        (void)command;
-        (void)args;
-        throw std::runtime_error("Linux platform not yet implemented");
+
+        // Create pipes: [0] = read end, [1] = write end. O_CLOEXEC keeps
+        // concurrently spawned probes from inheriting each other's pipes.
+        int stdin_pipe[2] = {-1, -1};
+        int stdout_pipe[2] = {-1, -1};
+        int stderr_pipe[2] = {-1, -1};
+
+        if (pipe2(stdin_pipe, O_CLOEXEC) < 0 || pipe2(stdout_pipe, O_CLOEXEC) < 0 ||
+            pipe2(stderr_pipe, O_CLOEXEC) < 0) {
+            for (int fd : {stdin_pipe[0], stdin_pipe[1], stdout_pipe[0], stdout_pipe[1],
+                           stderr_pipe[0], stderr_pipe[1]}) {
+                if (fd >= 0) close(fd);
+            }
+            throw std::runtime_error("Failed to create pipes");
+        }
+
+        // Build argument vector before forking (no allocation in the child)
+        std::vector<char*> argv;
+        argv.push_back(const_cast<char*>(command.c_str()));
+        for (const auto& arg : args) {
+            argv.push_back(const_cast<char*>(arg.c_str()));
+        }
+        argv.push_back(nullptr);
+
+        pid_t pid = fork();
+
+        if (pid < 0) {
+            // Fork failed
+            close(stdin_pipe[0]); close(stdin_pipe[1]);
+            close(stdout_pipe[0]); close(stdout_pipe[1]);
+            close(stderr_pipe[0]); close(stderr_pipe[1]);
+            throw std::runtime_error("Failed to fork process");
+        }
+
+        if (pid == 0) {
+            // Child process: dup2 clears O_CLOEXEC on the stdio copies, and
+            // every other pipe end is closed by exec
+            dup2(stdin_pipe[0], STDIN_FILENO);
+            dup2(stdout_pipe[1], STDOUT_FILENO);
+            dup2(stderr_pipe[1], STDERR_FILENO);
+
+            // Execute command
+            execvp(command.c_str(), argv.data());
+
+            // If execvp returns, it failed
+            const char message[] = "Failed to execute: ";
+            ssize_t ignored = write(STDERR_FILENO, message, sizeof(message) - 1);
+            ignored = write(STDERR_FILENO, command.c_str(), command.size());
+            ignored = write(STDERR_FILENO, "\n", 1);
+            (void)ignored;
+            _exit(1);
+        }
+
+        // Parent process
+
+        // Close unused pipe ends
+        close(stdin_pipe[0]);  // Don't need read end of stdin
+        close(stdout_pipe[1]); // Don't need write end of stdout
+        close(stderr_pipe[1]); // Don't need write end of stderr
+
+        // Create and return Process object
+        return std::make_unique<LinuxProcess>(
+            pid,
+            stdin_pipe[1],  // Write to child's stdin
+            stdout_pipe[0], // Read from child's stdout
+            stderr_pipe[0]  // Read from child's stderr
+        );
     }
 
-    std::vector<DockerContainer> docker_list_containers() override {
-        throw std::runtime_error("Linux platform not yet implemented");
+private:
+    // A pipe or socket descriptor of a process, as of its last fd walk
+    struct Descriptor {
+        int fd;
+        uint64_t inode;
+        bool socket;
+    };
+
+    ProcReader reader_;
+    std::unique_ptr<ProcEvents> events_;
+    std::shared_ptr<const ProcessTable> last_snapshot_;
+    // PIDs whose descriptors must be walked again: re-read by a snapshot
+    // (new, exec'd, or every PID without the proc connector) or forked
+    std::unordered_set<int> stale_descriptors_;
+    std::mutex snapshot_mutex_;  // Guards events_, last_snapshot_, stale_descriptors_ and reader_'s stat/cmdline reads
+
+    std::unordered_map<int, std::vector<Descriptor>> descriptors_;
+    std::shared_ptr<const PipeIndex> pipe_index_;  // Built from descriptors_; null when out of date
+    std::unordered_set<uint64_t> ownerless_sockets_;
+    std::mutex descriptor_mutex_;  // Guards the three above
+
+    // Bring descriptors_ up to date with the latest snapshot: PIDs that are
+    // gone are dropped, stale and unknown ones walked, the rest kept.
+    // Without a snapshot every process is walked. Callers hold
+    // descriptor_mutex_.
+    void refresh_descriptors() {
+        std::shared_ptr<const ProcessTable> snapshot;
+        std::unordered_set<int> stale;
+        {
+            std::lock_guard<std::mutex> lock(snapshot_mutex_);
+            snapshot = last_snapshot_;
+            stale.swap(stale_descriptors_);
+        }
+
+        std::vector<int> pids = snapshot ? snapshot->pids() : reader_.list_pids();
+        std::unordered_map<int, std::vector<Descriptor>> next;
+        next.reserve(pids.size());
+
+        bool changed = false;
+        for (int pid : pids) {
+            auto kept = descriptors_.find(pid);
+            if (snapshot && kept != descriptors_.end() && stale.count(pid) == 0) {
+                next.emplace(pid, std::move(kept->second));
+                continue;
+            }
+
+            changed = true;
+            auto& descriptors = next[pid];
+            reader_.for_each_fd(pid, [&](int, int fd, std::string_view target) {
+                uint64_t inode = 0;
+                if (parse_inode_link(target, "pipe:[", inode)) {
+                    descriptors.push_back(Descriptor{fd, inode, false});
+                } else if (parse_inode_link(target, "socket:[", inode)) {
+                    descriptors.push_back(Descriptor{fd, inode, true});
+                }
+                return true;
+            });
+        }
+
+        if (changed || next.size() != descriptors_.size()) {
+            pipe_index_.reset();
+        }
+        descriptors_.swap(next);
+    }
+
+    // Callers hold snapshot_mutex_
+    std::optional<size_t> cached_row(int pid) const {
+        return last_snapshot_ ? last_snapshot_->find(pid) : std::nullopt;
+    }
+
+    // "socket:[12345]" / "pipe:[12345]" -> 12345
+    static bool parse_inode_link(std::string_view target, std::string_view prefix, uint64_t& inode) {
+        if (target.size() <= prefix.size() + 1 || target.compare(0, prefix.size(), prefix) != 0 ||
+            target.back() != ']') {
+            return false;
+        }
+
+        inode = 0;
+        for (size_t i = prefix.size(); i + 1 < target.size(); i++) {
+            char c = target[i];
+            if (c < '0' || c > '9') {
+                return false;
+            }
+            inode = inode * 10 + static_cast<uint64_t>(c - '0');
+        }
+        return true;
     }
 
-    std::vector<std::string> get_docker_mcp_servers() override {
-        throw std::runtime_error("Linux platform not yet implemented");
+    // Direct read for PIDs that are not part of the latest snapshot
+    bool read_entry(int pid, ProcEntry& entry) {
+        return pid > 0 && reader_.read(pid, entry);
     }
 };
 
@@ -1,13 +1,238 @@
 // Linux Process Implementation
-//
-// TODO: Implement Linux process management
 
-#include <kyros/platform/process.hpp>
+#include <kyros/platform/linux/linux_process.hpp>
+#include <kyros/platform/linux/child_reaper.hpp>
+#include <algorithm>
 #include <stdexcept>
+#include <unistd.h>
+#include <signal.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <errno.h>
+#include <cstring>
 
 namespace kyros {
 
-// Linux Process stub - to be implemented
-// This file exists to satisfy CMake build requirements for Linux platform
+namespace {
+
+// How long terminate() waits inline before handing the child to the reaper
+constexpr std::chrono::milliseconds kInlineGrace(20);
+
+// Time between SIGTERM and SIGKILL
+constexpr std::chrono::milliseconds kKillGrace(1000);
+
+int open_pidfd(int pid) {
+#ifdef SYS_pidfd_open
+    int fd = static_cast<int>(syscall(SYS_pidfd_open, pid, 0));
+    return fd >= 0 ? fd : -1;
+#else
+    (void)pid;
+    return -1;
+#endif
+}
+
+} // namespace
+
+LinuxProcess::LinuxProcess(int pid, int stdin_fd, int stdout_fd, int stderr_fd)
+    : pidfd_(open_pidfd(pid))
+    , stdin_fd_(stdin_fd)
+    , stdout_fd_(stdout_fd)
+    , stderr_fd_(stderr_fd)
+    , exit_code_(-1)
+    , exited_(false)
+    , detached_(false)
+{
+    pid_ = pid;
+}
+
+LinuxProcess::~LinuxProcess() {
+    if (is_running()) {
+        terminate();
+    }
+    close_fds();
+    if (pidfd_ >= 0 && !detached_) {
+        close(pidfd_);
+    }
+}
+
+void LinuxProcess::write_stdin(const std::string& data) {
+    if (stdin_fd_ < 0) {
+        throw std::runtime_error("stdin pipe not available");
+    }
+
+    // A child that already exited must surface as EPIPE, not kill us with
+    // SIGPIPE: block it for this thread and discard any pending instance
+    sigset_t sigpipe_set;
+    sigset_t old_set;
+    sigemptyset(&sigpipe_set);
+    sigaddset(&sigpipe_set, SIGPIPE);
+    pthread_sigmask(SIG_BLOCK, &sigpipe_set, &old_set);
+
+    int write_errno = 0;
+    size_t total_written = 0;
+    while (total_written < data.size()) {
+        ssize_t written = write(stdin_fd_, data.c_str() + total_written,
+                               data.size() - total_written);
+
+        if (written < 0) {
+            if (errno != EINTR) {
+                write_errno = errno;
+                break;
+            }
+        } else {
+            total_written += written;
+        }
+    }
+
+    if (write_errno == EPIPE) {
+        struct timespec no_wait = {0, 0};
+        sigtimedwait(&sigpipe_set, nullptr, &no_wait);
+    }
+    pthread_sigmask(SIG_SETMASK, &old_set, nullptr);
+
+    if (write_errno == EPIPE) {
+        throw std::runtime_error("Broken pipe - process may have terminated");
+    } else if (write_errno != 0) {
+        throw std::runtime_error(std::string("Failed to write to stdin: ") +
+                               strerror(write_errno));
+    }
+}
+
+std::string LinuxProcess::read_stdout_line(std::chrono::milliseconds timeout) {
+    return std::string(stdout_frames_.read_frame(stdout_fd_, FrameFormat::Line, timeout, "stdout"));
+}
+
+std::string LinuxProcess::read_stderr_line(std::chrono::milliseconds timeout) {
+    return std::string(stderr_frames_.read_frame(stderr_fd_, FrameFormat::Line, timeout, "stderr"));
+}
+
+std::string_view LinuxProcess::read_stdout_frame(std::chrono::milliseconds timeout,
+                                       FrameFormat format) {
+    return stdout_frames_.read_frame(stdout_fd_, format, timeout, "stdout");
+}
+
+std::string_view LinuxProcess::read_stdout_partial(std::chrono::milliseconds timeout, bool& end) {
+    return stdout_frames_.read_partial(stdout_fd_, timeout, "stdout", end);
+}
+
+void LinuxProcess::terminate() {
+    if (!is_running()) {
+        close_fds();
+        return;
+    }
+
+    // EOF on stdin is enough for most stdio servers; SIGTERM covers the rest
+    close_fds();
+    kill(pid_, SIGTERM);
+
+    // A prompt exit is observed on the pidfd within microseconds
+    if (wait_for_exit(kInlineGrace)) {
+        return;
+    }
+
+    // Slow to exit: let the shared reaper escalate and collect it so the
+    // caller (and other probes) don't wait
+    detach_to_reaper();
+}
+
+void LinuxProcess::terminate_in_background() {
+    close_fds();
+    if (!is_running()) {
+        return;
+    }
+
+    kill(pid_, SIGTERM);
+    detach_to_reaper();
+}
+
+void LinuxProcess::detach_to_reaper() {
+    ChildReaper::instance().adopt(pid_, pidfd_, ChildReaper::Clock::now() + kKillGrace);
+    pidfd_ = -1;
+    detached_ = true;
+    exited_ = true;
+    exit_code_ = -1;
+}
+
+bool LinuxProcess::is_running() const {
+    if (exited_) {
+        return false;
+    }
+    return !const_cast<LinuxProcess*>(this)->try_reap();
+}
+
+int LinuxProcess::exit_code() const {
+    if (!exited_) {
+        throw std::runtime_error("Process has not exited yet");
+    }
+    return exit_code_;
+}
+
+bool LinuxProcess::wait_for_exit(std::chrono::milliseconds timeout) {
+    if (exited_) {
+        return true;
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (!try_reap()) {
+        auto now = std::chrono::steady_clock::now();
+        if (now >= deadline) {
+            return false;
+        }
+
+        int remaining = static_cast<int>(
+            std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now).count()) + 1;
+
+        if (pidfd_ >= 0) {
+            // pidfd becomes readable when the child exits
+            struct pollfd pfd = {pidfd_, POLLIN, 0};
+            if (poll(&pfd, 1, remaining) < 0 && errno != EINTR) {
+                return try_reap();
+            }
+        } else {
+            usleep(static_cast<useconds_t>(std::min(remaining, 5) * 1000));
+        }
+    }
+    return true;
+}
+
+bool LinuxProcess::try_reap() {
+    if (exited_) {
+        return true;
+    }
+
+    int status;
+    pid_t result = waitpid(pid_, &status, WNOHANG);
+
+    if (result == 0) {
+        // Process is still running
+        return false;
+    } else if (result == pid_) {
+        // Process has exited
+        exit_code_ = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+        exited_ = true;
+        return true;
+    } else {
+        // Error or no such process
+        exited_ = true;
+        return true;
+    }
+}
+
+void LinuxProcess::close_fds() {
+    if (stdin_fd_ >= 0) {
+        close(stdin_fd_);
+        stdin_fd_ = -1;
+    }
+    if (stdout_fd_ >= 0) {
+        close(stdout_fd_);
+        stdout_fd_ = -1;
+    }
+    if (stderr_fd_ >= 0) {
+        close(stderr_fd_);
+        stderr_fd_ = -1;
+    }
+}
 
 } // namespace kyros
@@ -0,0 +1,160 @@
+// Kernel proc connector subscription for incremental process snapshots
+
+#include <kyros/platform/linux/proc_events.hpp>
+
+#include <cerrno>
+#include <cstring>
+#include <linux/cn_proc.h>
+#include <linux/connector.h>
+#include <linux/netlink.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace kyros {
+
+namespace {
+
+// How long to wait for the kernel to acknowledge PROC_CN_MCAST_LISTEN
+constexpr int kSubscribeTimeoutMs = 100;
+
+const struct proc_event* event_from(const struct nlmsghdr* header) {
+    auto* message = static_cast<const struct cn_msg*>(NLMSG_DATA(header));
+    if (message->id.idx != CN_IDX_PROC || message->id.val != CN_VAL_PROC) {
+        return nullptr;
+    }
+    return reinterpret_cast<const struct proc_event*>(message->data);
+}
+
+} // namespace
+
+ProcEvents::ProcEvents() {
+    fd_ = socket(AF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC, NETLINK_CONNECTOR);
+    if (fd_ < 0) {
+        return;
+    }
+
+    if (!subscribe()) {
+        close(fd_);
+        fd_ = -1;
+    }
+}
+
+ProcEvents::~ProcEvents() {
+    if (fd_ >= 0) {
+        close(fd_);
+    }
+}
+
+bool ProcEvents::subscribe() {
+    struct sockaddr_nl local;
+    std::memset(&local, 0, sizeof(local));
+    local.nl_family = AF_NETLINK;
+    local.nl_groups = CN_IDX_PROC;
+    if (bind(fd_, reinterpret_cast<struct sockaddr*>(&local), sizeof(local)) != 0) {
+        return false;
+    }
+
+    // nlmsghdr | cn_msg | proc_cn_mcast_op
+    alignas(struct nlmsghdr) char request[NLMSG_SPACE(sizeof(struct cn_msg) + sizeof(enum proc_cn_mcast_op))];
+    std::memset(request, 0, sizeof(request));
+
+    auto* header = reinterpret_cast<struct nlmsghdr*>(request);
+    header->nlmsg_len = NLMSG_LENGTH(sizeof(struct cn_msg) + sizeof(enum proc_cn_mcast_op));
+    header->nlmsg_type = NLMSG_DONE;
+    header->nlmsg_pid = 0;
+
+    auto* message = static_cast<struct cn_msg*>(NLMSG_DATA(header));
+    message->id.idx = CN_IDX_PROC;
+    message->id.val = CN_VAL_PROC;
+    message->len = sizeof(enum proc_cn_mcast_op);
+
+    enum proc_cn_mcast_op op = PROC_CN_MCAST_LISTEN;
+    std::memcpy(message->data, &op, sizeof(op));
+
+    if (send(fd_, request, header->nlmsg_len, 0) < 0) {
+        return false;
+    }
+
+    // The kernel answers with a PROC_EVENT_NONE ack carrying the error
+    // code; without CAP_NET_ADMIN it is EPERM, or no answer at all
+    alignas(struct nlmsghdr) char buffer[4096];
+    struct pollfd pfd = {fd_, POLLIN, 0};
+    while (poll(&pfd, 1, kSubscribeTimeoutMs) > 0) {
+        ssize_t received = recv(fd_, buffer, sizeof(buffer), 0);
+        if (received <= 0) {
+            return false;
+        }
+
+        int remaining = static_cast<int>(received);
+        for (auto* header = reinterpret_cast<struct nlmsghdr*>(buffer);
+             NLMSG_OK(header, remaining);
+             header = NLMSG_NEXT(header, remaining)) {
+            const struct proc_event* event = event_from(header);
+            if (event && event->what == proc_event::PROC_EVENT_NONE) {
+                return event->event_data.ack.err == 0;
+            }
+        }
+    }
+
+    return false;
+}
+
+bool ProcEvents::drain(std::unordered_set<int>& changed, std::unordered_set<int>& execed,
+                       std::unordered_set<int>& forked) {
+    if (fd_ < 0) {
+        return false;
+    }
+
+    bool complete = true;
+    alignas(struct nlmsghdr) char buffer[16384];
+    while (true) {
+        ssize_t received = recv(fd_, buffer, sizeof(buffer), MSG_DONTWAIT);
+        if (received < 0) {
+            if (errno == EINTR) continue;
+            if (errno == ENOBUFS) {
+                complete = false;  // Kernel dropped events; keep draining
+                continue;
+            }
+            break;  // EAGAIN: nothing left
+        }
+        if (received == 0) {
+            break;
+        }
+
+        int remaining = static_cast<int>(received);
+        for (auto* header = reinterpret_cast<struct nlmsghdr*>(buffer);
+             NLMSG_OK(header, remaining);
+             header = NLMSG_NEXT(header, remaining)) {
+            const struct proc_event* event = event_from(header);
+            if (!event) continue;
+
+            // Thread events carry the owning process in the tgid fields
+            switch (event->what) {
+                case proc_event::PROC_EVENT_FORK:
+                    changed.insert(event->event_data.fork.child_tgid);
+                    // A new thread shares its process' descriptor table
+                    if (event->event_data.fork.child_tgid != event->event_data.fork.parent_tgid) {
+                        forked.insert(event->event_data.fork.parent_tgid);
+                    }
+                    break;
+                case proc_event::PROC_EVENT_EXEC:
+                    changed.insert(event->event_data.exec.process_tgid);
+                    execed.insert(event->event_data.exec.process_tgid);
+                    break;
+                case proc_event::PROC_EVENT_EXIT:
+                    changed.insert(event->event_data.exit.process_tgid);
+                    break;
+                case proc_event::PROC_EVENT_COMM:
+                    changed.insert(event->event_data.comm.process_tgid);
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+
+    return complete;
+}
+
+} // namespace kyros
@@ -0,0 +1,315 @@
+// /proc reader for the Linux platform adapter
+
+#include <kyros/platform/linux/proc_reader.hpp>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace kyros {
+
+std::string ProcEntry::command_line() const {
+    std::string result;
+    for (size_t i = 0; i < argv.size(); i++) {
+        if (i > 0) result += ' ';
+        result += argv[i];
+    }
+    return result;
+}
+
+ProcReader::ProcReader(const std::string& proc_root) {
+    proc_fd_ = open(proc_root.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    buffer_.reserve(4096);
+}
+
+ProcReader::~ProcReader() {
+    if (proc_fd_ >= 0) {
+        close(proc_fd_);
+    }
+}
+
+std::vector<int> ProcReader::list_pids() {
+    std::vector<int> result;
+    if (proc_fd_ < 0) {
+        return result;
+    }
+
+    // fdopendir takes ownership of the fd, so hand it a duplicate
+    int dir_fd = fcntl(proc_fd_, F_DUPFD_CLOEXEC, 0);
+    if (dir_fd < 0) {
+        return result;
+    }
+
+    DIR* dir = fdopendir(dir_fd);
+    if (!dir) {
+        close(dir_fd);
+        return result;
+    }
+
+    rewinddir(dir);
+    while (struct dirent* entry = readdir(dir)) {
+        const char* name = entry->d_name;
+        if (name[0] < '1' || name[0] > '9') {
+            continue;
+        }
+
+        char* end = nullptr;
+        long pid = std::strtol(name, &end, 10);
+        if (*end == '\0' && pid > 0) {
+            result.push_back(static_cast<int>(pid));
+        }
+    }
+
+    closedir(dir);
+    return result;
+}
+
+bool ProcReader::read(int pid, ProcEntry& entry) {
+    int pid_fd = open_pid_dir(pid);
+    if (pid_fd < 0) {
+        return false;
+    }
+
+    bool ok = read_stat_at(pid_fd, pid, entry);
+    if (ok && read_file_at(pid_fd, "cmdline", buffer_)) {
+        entry.argv = split_nul(buffer_.data(), buffer_.size());
+    }
+    close(pid_fd);
+
+    if (!ok) {
+        return false;
+    }
+
+    resolve_name(entry);
+    return true;
+}
+
+bool ProcReader::read_stat(int pid, ProcEntry& entry) {
+    int pid_fd = open_pid_dir(pid);
+    if (pid_fd < 0) {
+        return false;
+    }
+
+    bool ok = read_stat_at(pid_fd, pid, entry);
+    close(pid_fd);
+    return ok;
+}
+
+bool ProcReader::read_cmdline(int pid, std::vector<std::string>& argv) {
+    int pid_fd = open_pid_dir(pid);
+    if (pid_fd < 0) {
+        return false;
+    }
+
+    bool ok = read_file_at(pid_fd, "cmdline", buffer_);
+    close(pid_fd);
+
+    argv = ok ? split_nul(buffer_.data(), buffer_.size()) : std::vector<std::string>();
+    return ok;
+}
+
+void ProcReader::resolve_name(ProcEntry& entry) {
+    // comm is truncated to 15 characters; prefer argv[0] basename when it extends it
+    if (entry.argv.empty()) {
+        return;
+    }
+
+    const std::string& argv0 = entry.argv[0];
+    size_t slash = argv0.find_last_of('/');
+    std::string base = (slash == std::string::npos) ? argv0 : argv0.substr(slash + 1);
+    if (base.size() > entry.name.size() && base.compare(0, entry.name.size(), entry.name) == 0) {
+        entry.name = base;
+    }
+}
+
+bool ProcReader::read_environ(int pid, std::string& block) {
+    int pid_fd = open_pid_dir(pid);
+    if (pid_fd < 0) {
+        return false;
+    }
+
+    bool ok = read_file_at(pid_fd, "environ", block);
+    close(pid_fd);
+    return ok;
+}
+
+bool ProcReader::read_fd_link(int pid, int fd, std::string& target) {
+    int pid_fd = open_pid_dir(pid);
+    if (pid_fd < 0) {
+        return false;
+    }
+
+    char path[32];
+    std::snprintf(path, sizeof(path), "fd/%d", fd);
+
+    char link[256];
+    ssize_t len = readlinkat(pid_fd, path, link, sizeof(link) - 1);
+    close(pid_fd);
+
+    if (len < 0) {
+        return false;
+    }
+
+    target.assign(link, static_cast<size_t>(len));
+    return true;
+}
+
+void ProcReader::for_each_fd(const FdVisitor& visit) {
+    for (int pid : list_pids()) {
+        if (!for_each_fd(pid, visit)) {
+            return;
+        }
+    }
+}
+
+bool ProcReader::for_each_fd(int pid, const FdVisitor& visit) {
+    int pid_fd = open_pid_dir(pid);
+    if (pid_fd < 0) {
+        return true;
+    }
+
+    int fd_dir_fd = openat(pid_fd, "fd", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    close(pid_fd);
+    if (fd_dir_fd < 0) {
+        return true;  // Other users' processes without privileges
+    }
+
+    DIR* dir = fdopendir(fd_dir_fd);
+    if (!dir) {
+        close(fd_dir_fd);
+        return true;
+    }
+
+    char link[256];
+    bool keep_going = true;
+    while (keep_going) {
+        struct dirent* entry = readdir(dir);
+        if (!entry) break;
+        if (entry->d_name[0] < '0' || entry->d_name[0] > '9') {
+            continue;
+        }
+
+        ssize_t len = readlinkat(dirfd(dir), entry->d_name, link, sizeof(link) - 1);
+        if (len < 0) {
+            continue;
+        }
+
+        int fd = static_cast<int>(std::strtol(entry->d_name, nullptr, 10));
+        keep_going = visit(pid, fd, std::string_view(link, static_cast<size_t>(len)));
+    }
+
+    closedir(dir);
+    return keep_going;
+}
+
+bool ProcReader::parse_stat(const std::string& stat, ProcEntry& entry) {
+    // Format: pid (comm) state ppid pgrp session tty_nr tpgid flags minflt
+    //         cminflt majflt cmajflt utime stime cutime cstime priority nice
+    //         num_threads itrealvalue starttime ...
+    // comm may itself contain spaces and parentheses, so anchor on the last ')'
+    size_t open_paren = stat.find('(');
+    size_t close_paren = stat.rfind(')');
+    if (open_paren == std::string::npos || close_paren == std::string::npos ||
+        close_paren < open_paren) {
+        return false;
+    }
+
+    entry.name = stat.substr(open_paren + 1, close_paren - open_paren - 1);
+
+    // Fields after comm start at field 3 (state)
+    const char* p = stat.c_str() + close_paren + 1;
+    int field = 3;
+    while (*p != '\0' && field <= 22) {
+        while (*p == ' ') p++;
+        if (*p == '\0') break;
+
+        if (field == 4) {
+            entry.ppid = static_cast<int>(std::strtol(p, nullptr, 10));
+        } else if (field == 22) {
+            entry.start_time = std::strtoull(p, nullptr, 10);
+        }
+
+        while (*p != ' ' && *p != '\0') p++;
+        field++;
+    }
+
+    return field > 22;
+}
+
+std::vector<std::string> ProcReader::split_nul(const char* data, size_t size) {
+    std::vector<std::string> result;
+    size_t start = 0;
+    for (size_t i = 0; i < size; i++) {
+        // Empty arguments are real argv entries ("prog --prefix '' x"),
+        // so only the terminator itself is dropped
+        if (data[i] == '\0') {
+            result.emplace_back(data + start, i - start);
+            start = i + 1;
+        }
+    }
+    // Some processes rewrite their cmdline without a trailing NUL
+    if (start < size) {
+        result.emplace_back(data + start, size - start);
+    }
+    return result;
+}
+
+bool ProcReader::read_stat_at(int pid_fd, int pid, ProcEntry& entry) {
+    entry = ProcEntry();
+    entry.pid = pid;
+
+    // Owner of /proc/<pid> is the process' effective uid
+    struct stat st;
+    if (fstat(pid_fd, &st) == 0) {
+        entry.uid = st.st_uid;
+    }
+
+    return read_file_at(pid_fd, "stat", buffer_) && parse_stat(buffer_, entry);
+}
+
+int ProcReader::open_pid_dir(int pid) const {
+    if (proc_fd_ < 0) {
+        return -1;
+    }
+
+    char name[16];
+    std::snprintf(name, sizeof(name), "%d", pid);
+    return openat(proc_fd_, name, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+}
+
+bool ProcReader::read_file_at(int dir_fd, const char* name, std::string& out) {
+    int fd = openat(dir_fd, name, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+
+    // procfs files report size 0, so read until EOF growing the buffer as needed
+    out.resize(out.capacity() > 0 ? out.capacity() : 4096);
+    size_t total = 0;
+    while (true) {
+        if (total == out.size()) {
+            out.resize(out.size() * 2);
+        }
+
+        ssize_t n = ::read(fd, &out[total], out.size() - total);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            close(fd);
+            out.clear();
+            return false;
+        }
+        if (n == 0) break;
+        total += static_cast<size_t>(n);
+    }
+
+    close(fd);
+    out.resize(total);
+    return true;
+}
+
+} // namespace kyros
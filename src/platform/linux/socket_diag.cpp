@@ -0,0 +1,223 @@
+// Listener enumeration over NETLINK_SOCK_DIAG with a /proc/net fallback
+
+#include <kyros/platform/linux/socket_diag.hpp>
+
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <linux/inet_diag.h>
+#include <linux/netlink.h>
+#include <linux/sock_diag.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace kyros {
+
+namespace {
+
+// Kernel socket states (include/net/tcp_states.h)
+constexpr int kStateClose = 7;    // Unconnected UDP
+constexpr int kStateListen = 10;  // Listening TCP
+
+std::string format_address(int family, const void* addr) {
+    char buffer[INET6_ADDRSTRLEN] = {};
+    if (!inet_ntop(family, addr, buffer, sizeof(buffer))) {
+        return "";
+    }
+    return buffer;
+}
+
+// One inet_diag dump for a (family, protocol) pair. Returns false if the
+// kernel rejects the request; entries gathered so far are kept.
+bool dump_family(int nl_fd, uint8_t family, uint8_t protocol, std::vector<SocketEntry>& entries) {
+    struct {
+        struct nlmsghdr header;
+        struct inet_diag_req_v2 request;
+    } message;
+    std::memset(&message, 0, sizeof(message));
+
+    message.header.nlmsg_len = sizeof(message);
+    message.header.nlmsg_type = SOCK_DIAG_BY_FAMILY;
+    message.header.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+    message.request.sdiag_family = family;
+    message.request.sdiag_protocol = protocol;
+    message.request.idiag_states = (protocol == IPPROTO_TCP) ? (1u << kStateListen)
+                                                             : (1u << kStateClose);
+
+    struct sockaddr_nl kernel;
+    std::memset(&kernel, 0, sizeof(kernel));
+    kernel.nl_family = AF_NETLINK;
+
+    if (sendto(nl_fd, &message, sizeof(message), 0,
+               reinterpret_cast<struct sockaddr*>(&kernel), sizeof(kernel)) < 0) {
+        return false;
+    }
+
+    const char* protocol_name = (protocol == IPPROTO_TCP) ? "tcp" : "udp";
+
+    // Large enough for a few hundred sockets per recv
+    alignas(struct nlmsghdr) char buffer[32768];
+    while (true) {
+        ssize_t received = recv(nl_fd, buffer, sizeof(buffer), 0);
+        if (received < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        if (received == 0) {
+            return false;
+        }
+
+        int remaining = static_cast<int>(received);
+        for (struct nlmsghdr* header = reinterpret_cast<struct nlmsghdr*>(buffer);
+             NLMSG_OK(header, remaining);
+             header = NLMSG_NEXT(header, remaining)) {
+            if (header->nlmsg_type == NLMSG_DONE) {
+                return true;
+            }
+            if (header->nlmsg_type == NLMSG_ERROR) {
+                return false;
+            }
+            if (header->nlmsg_type != SOCK_DIAG_BY_FAMILY) {
+                continue;
+            }
+
+            auto* diag = static_cast<struct inet_diag_msg*>(NLMSG_DATA(header));
+            int port = ntohs(diag->id.idiag_sport);
+            if (port == 0) {
+                continue;  // Unbound UDP socket
+            }
+
+            SocketEntry entry;
+            entry.inode = diag->idiag_inode;
+            entry.port = port;
+            entry.protocol = protocol_name;
+            entry.address = format_address(diag->idiag_family, diag->id.idiag_src);
+            entries.push_back(std::move(entry));
+        }
+    }
+}
+
+// Decode the hex address printed by /proc/net: each 32-bit word is the raw
+// network-order value printed as a native integer
+bool decode_proc_address(const std::string& hex, bool ipv6, std::string& address) {
+    size_t words = ipv6 ? 4 : 1;
+    if (hex.size() != words * 8) {
+        return false;
+    }
+
+    uint32_t raw[4] = {};
+    for (size_t i = 0; i < words; i++) {
+        char* end = nullptr;
+        std::string word = hex.substr(i * 8, 8);
+        unsigned long value = std::strtoul(word.c_str(), &end, 16);
+        if (*end != '\0') {
+            return false;
+        }
+        raw[i] = static_cast<uint32_t>(value);
+    }
+
+    address = format_address(ipv6 ? AF_INET6 : AF_INET, raw);
+    return !address.empty();
+}
+
+} // namespace
+
+bool SocketDiag::query_netlink(std::vector<SocketEntry>& entries) {
+    int nl_fd = socket(AF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC, NETLINK_SOCK_DIAG);
+    if (nl_fd < 0) {
+        return false;
+    }
+
+    std::vector<SocketEntry> result;
+    bool ok = dump_family(nl_fd, AF_INET, IPPROTO_TCP, result) &&
+              dump_family(nl_fd, AF_INET6, IPPROTO_TCP, result) &&
+              dump_family(nl_fd, AF_INET, IPPROTO_UDP, result) &&
+              dump_family(nl_fd, AF_INET6, IPPROTO_UDP, result);
+    close(nl_fd);
+
+    if (!ok) {
+        return false;
+    }
+
+    entries.insert(entries.end(), result.begin(), result.end());
+    return true;
+}
+
+std::vector<SocketEntry> SocketDiag::read_proc_net(const std::string& proc_root) {
+    struct Source {
+        const char* file;
+        bool ipv6;
+        const char* protocol;
+    };
+    const Source sources[] = {
+        {"/net/tcp", false, "tcp"},
+        {"/net/tcp6", true, "tcp"},
+        {"/net/udp", false, "udp"},
+        {"/net/udp6", true, "udp"},
+    };
+
+    std::vector<SocketEntry> result;
+    for (const auto& source : sources) {
+        std::ifstream file(proc_root + source.file);
+        if (!file.is_open()) {
+            continue;  // IPv6 disabled, or not mounted
+        }
+
+        std::string line;
+        SocketEntry entry;
+        while (std::getline(file, line)) {
+            if (parse_proc_net_line(line, source.ipv6, source.protocol, entry)) {
+                result.push_back(entry);
+            }
+        }
+    }
+
+    return result;
+}
+
+bool SocketDiag::parse_proc_net_line(const std::string& line, bool ipv6,
+                                     const std::string& protocol, SocketEntry& entry) {
+    // Format: sl local_address rem_address st tx_queue:rx_queue tr:tm->when
+    //         retrnsmt uid timeout inode ...
+    std::istringstream iss(line);
+    std::string slot, local, remote, state, queues, timer, retransmits, uid, timeout, inode;
+    if (!(iss >> slot >> local >> remote >> state >> queues >> timer >> retransmits
+              >> uid >> timeout >> inode)) {
+        return false;
+    }
+    if (slot.empty() || slot.back() != ':') {
+        return false;  // Header row
+    }
+
+    int wanted = (protocol == "tcp") ? kStateListen : kStateClose;
+    if (std::strtol(state.c_str(), nullptr, 16) != wanted) {
+        return false;
+    }
+
+    size_t colon = local.find(':');
+    if (colon == std::string::npos) {
+        return false;
+    }
+
+    std::string address;
+    if (!decode_proc_address(local.substr(0, colon), ipv6, address)) {
+        return false;
+    }
+
+    int port = static_cast<int>(std::strtol(local.c_str() + colon + 1, nullptr, 16));
+    if (port == 0) {
+        return false;
+    }
+
+    entry.inode = std::strtoull(inode.c_str(), nullptr, 10);
+    entry.address = address;
+    entry.port = port;
+    entry.protocol = protocol;
+    return true;
+}
+
+} // namespace kyros
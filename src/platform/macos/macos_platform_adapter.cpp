@@ -5,6 +5,7 @@
 #include <stdexcept>
 #include <filesystem>
 #include <fstream>
+#include <mutex>
 #include <sstream>
 #include <iostream>
 #include <cstdlib>
@@ -16,6 +17,7 @@
 #include <vector>
 #include <libproc.h>
 #include <sys/proc_info.h>
+#include <sys/sysctl.h>
 #include <libgen.h>
 #include <array>
 #include <cstring>
@@ -126,56 +128,60 @@ public:
         return result;
     }
 
-    std::vector<int> get_process_list() override {
-        std::vector<int> result;
+    std::shared_ptr<const ProcessTable> snapshot_processes() override {
+        auto table = std::make_shared<ProcessTable>();
 
-        // Get number of processes
-        int num_pids = proc_listallpids(nullptr, 0);
-        if (num_pids <= 0) {
-            return result;  // Return empty vector if failed
-        }
+        std::vector<int> pids = list_all_pids();
+        table->reserve(pids.size());
 
-        // Allocate buffer for PIDs
-        std::vector<pid_t> pids(num_pids);
+        // One proc_pidinfo + one KERN_PROCARGS2 sysctl per PID
+        std::vector<std::string> argv;
+        std::string exec_path;
+        for (int pid : pids) {
+            struct proc_bsdinfo info;
+            if (proc_pidinfo(pid, PROC_PIDTBSDINFO, 0, &info, sizeof(info)) <= 0) {
+                continue;  // Exited or not visible to us
+            }
 
-        // Get actual PIDs
-        num_pids = proc_listallpids(pids.data(), static_cast<int>(pids.size() * sizeof(pid_t)));
-        if (num_pids <= 0) {
-            return result;
-        }
+            uint64_t start_time = static_cast<uint64_t>(info.pbi_start_tvsec) * 1000000ULL +
+                                  static_cast<uint64_t>(info.pbi_start_tvusec);
 
-        // Convert to int vector
-        for (int i = 0; i < num_pids; i++) {
-            if (pids[i] > 0) {
-                result.push_back(static_cast<int>(pids[i]));
+            std::string name;
+            if (read_procargs(pid, exec_path, argv) && !exec_path.empty()) {
+                name = path_basename(exec_path);
+            } else {
+                argv.clear();
+                name = info.pbi_name[0] != '\0' ? info.pbi_name : info.pbi_comm;
             }
+
+            table->add(pid, static_cast<int>(info.pbi_ppid), info.pbi_uid, start_time, name, argv);
         }
 
-        return result;
+        return table;
+    }
+
+    std::vector<int> get_process_list() override {
+        return list_all_pids();
     }
 
     std::string get_command_line(int pid) override {
-        // Use ps command to get full command line
-        std::string cmd = "ps -p " + std::to_string(pid) + " -o command=";
-        FILE* pipe = popen(cmd.c_str(), "r");
-        if (!pipe) {
-            return "";
-        }
+        std::vector<std::string> args = get_command_args(pid);
 
         std::string result;
-        std::array<char, 4096> buffer;
-        while (fgets(buffer.data(), buffer.size(), pipe) != nullptr) {
-            result += buffer.data();
+        for (size_t i = 0; i < args.size(); i++) {
+            if (i > 0) result += ' ';
+            result += args[i];
         }
+        return result;
+    }
 
-        pclose(pipe);
-
-        // Trim trailing newline
-        if (!result.empty() && result.back() == '\n') {
-            result.pop_back();
+    std::vector<std::string> get_command_args(int pid) override {
+        std::string exec_path;
+        std::vector<std::string> argv;
+        if (!read_procargs(pid, exec_path, argv)) {
+            return {};
         }
-
-        return result;
+        return argv;
     }
 
     std::string get_process_name(int pid) override {
@@ -443,6 +449,95 @@ public:
     }
 
 private:
+    std::vector<char> procargs_buffer_;
+    std::mutex procargs_mutex_;  // Engines call in concurrently
+
+    std::vector<int> list_all_pids() {
+        std::vector<int> result;
+
+        // Get number of processes
+        int num_pids = proc_listallpids(nullptr, 0);
+        if (num_pids <= 0) {
+            return result;  // Return empty vector if failed
+        }
+
+        // Allocate buffer for PIDs
+        std::vector<pid_t> pids(num_pids);
+
+        // Get actual PIDs
+        num_pids = proc_listallpids(pids.data(), static_cast<int>(pids.size() * sizeof(pid_t)));
+        if (num_pids <= 0) {
+            return result;
+        }
+
+        // Convert to int vector
+        for (int i = 0; i < num_pids; i++) {
+            if (pids[i] > 0) {
+                result.push_back(static_cast<int>(pids[i]));
+            }
+        }
+
+        return result;
+    }
+
+    // Read executable path and argv via sysctl(KERN_PROCARGS2), replacing the
+    // previous `ps -p <pid>` popen. Layout: int argc, exec path, NUL padding,
+    // then argc NUL-terminated arguments followed by the environment.
+    bool read_procargs(int pid, std::string& exec_path, std::vector<std::string>& argv) {
+        std::lock_guard<std::mutex> lock(procargs_mutex_);
+        exec_path.clear();
+        argv.clear();
+
+        if (procargs_buffer_.empty()) {
+            int argmax = 0;
+            size_t argmax_size = sizeof(argmax);
+            int argmax_mib[2] = {CTL_KERN, KERN_ARGMAX};
+            if (sysctl(argmax_mib, 2, &argmax, &argmax_size, nullptr, 0) != 0 || argmax <= 0) {
+                argmax = 256 * 1024;
+            }
+            procargs_buffer_.resize(static_cast<size_t>(argmax));
+        }
+
+        int mib[3] = {CTL_KERN, KERN_PROCARGS2, pid};
+        size_t size = procargs_buffer_.size();
+        if (sysctl(mib, 3, procargs_buffer_.data(), &size, nullptr, 0) != 0 || size < sizeof(int)) {
+            return false;
+        }
+
+        const char* data = procargs_buffer_.data();
+        const char* end = data + size;
+
+        int argc = 0;
+        std::memcpy(&argc, data, sizeof(argc));
+        const char* p = data + sizeof(argc);
+
+        const char* path_end = static_cast<const char*>(std::memchr(p, '\0', end - p));
+        if (!path_end) {
+            return false;
+        }
+        exec_path.assign(p, path_end);
+        p = path_end;
+
+        // Skip padding between the exec path and argv[0]
+        while (p < end && *p == '\0') p++;
+
+        while (p < end && static_cast<int>(argv.size()) < argc) {
+            const char* arg_end = static_cast<const char*>(std::memchr(p, '\0', end - p));
+            if (!arg_end) {
+                arg_end = end;
+            }
+            argv.emplace_back(p, arg_end);
+            p = arg_end + 1;
+        }
+
+        return true;
+    }
+
+    static std::string path_basename(const std::string& path) {
+        size_t slash = path.find_last_of('/');
+        return slash == std::string::npos ? path : path.substr(slash + 1);
+    }
+
     DockerContainer docker_inspect_container(const std::string& id) {
         DockerContainer container;
 
@@ -5,7 +5,6 @@
 #include <unistd.h>
 #include <signal.h>
 #include <sys/wait.h>
-#include <sys/select.h>
 #include <errno.h>
 #include <fcntl.h>
 #include <cstring>
@@ -53,11 +52,20 @@ void MacOSProcess::write_stdin(const std::string& data) {
 }
 
 std::string MacOSProcess::read_stdout_line(std::chrono::milliseconds timeout) {
-    return read_line_from_fd(stdout_fd_, timeout, "stdout");
+    return std::string(stdout_frames_.read_frame(stdout_fd_, FrameFormat::Line, timeout, "stdout"));
 }
 
 std::string MacOSProcess::read_stderr_line(std::chrono::milliseconds timeout) {
-    return read_line_from_fd(stderr_fd_, timeout, "stderr");
+    return std::string(stderr_frames_.read_frame(stderr_fd_, FrameFormat::Line, timeout, "stderr"));
+}
+
+std::string_view MacOSProcess::read_stdout_frame(std::chrono::milliseconds timeout,
+                                       FrameFormat format) {
+    return stdout_frames_.read_frame(stdout_fd_, format, timeout, "stdout");
+}
+
+std::string_view MacOSProcess::read_stdout_partial(std::chrono::milliseconds timeout, bool& end) {
+    return stdout_frames_.read_partial(stdout_fd_, timeout, "stdout", end);
 }
 
 void MacOSProcess::terminate() {
@@ -132,70 +140,4 @@ void MacOSProcess::close_fds() {
     }
 }
 
-std::string MacOSProcess::read_line_from_fd(int fd, std::chrono::milliseconds timeout,
-                              const char* stream_name) {
-    if (fd < 0) {
-        throw std::runtime_error(std::string(stream_name) + " pipe not available");
-    }
-
-    std::string line;
-    auto deadline = std::chrono::steady_clock::now() + timeout;
-
-    while (true) {
-        // Calculate remaining timeout
-        auto now = std::chrono::steady_clock::now();
-        if (now >= deadline) {
-            throw std::runtime_error(std::string("Timeout reading from ") + stream_name);
-        }
-
-        auto remaining = std::chrono::duration_cast<std::chrono::microseconds>(
-            deadline - now);
-
-        // Use select for timeout
-        fd_set read_fds;
-        FD_ZERO(&read_fds);
-        FD_SET(fd, &read_fds);
-
-        struct timeval tv;
-        tv.tv_sec = remaining.count() / 1000000;
-        tv.tv_usec = remaining.count() % 1000000;
-
-        int result = select(fd + 1, &read_fds, nullptr, nullptr, &tv);
-
-        if (result < 0) {
-            if (errno == EINTR) {
-                continue; // Interrupted, retry
-            }
-            throw std::runtime_error(std::string("select() failed on ") + stream_name +
-                                   ": " + strerror(errno));
-        } else if (result == 0) {
-            throw std::runtime_error(std::string("Timeout reading from ") + stream_name);
-        }
-
-        // Data available, read one character
-        char ch;
-        ssize_t bytes_read = read(fd, &ch, 1);
-
-        if (bytes_read < 0) {
-            if (errno == EINTR) {
-                continue; // Interrupted, retry
-            }
-            throw std::runtime_error(std::string("Failed to read from ") + stream_name +
-                                   ": " + strerror(errno));
-        } else if (bytes_read == 0) {
-            // EOF - return what we have
-            if (!line.empty()) {
-                return line;
-            }
-            throw std::runtime_error(std::string("EOF on ") + stream_name);
-        }
-
-        if (ch == '\n') {
-            return line; // Complete line
-        }
-
-        line += ch;
-    }
-}
-
 } // namespace kyros
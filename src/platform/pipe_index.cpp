@@ -0,0 +1,81 @@
+#include <kyros/platform/pipe_index.hpp>
+
+#include <map>
+
+namespace kyros {
+
+void PipeIndex::add(int pid, int fd, uint64_t inode) {
+    holders_[inode].push_back(Holder{pid, fd});
+
+    if (fd == 0) {
+        stdio_[pid].in = inode;
+    } else if (fd == 1) {
+        stdio_[pid].out = inode;
+    }
+}
+
+uint64_t PipeIndex::stdin_pipe(int pid) const {
+    auto it = stdio_.find(pid);
+    return it == stdio_.end() ? 0 : it->second.in;
+}
+
+uint64_t PipeIndex::stdout_pipe(int pid) const {
+    auto it = stdio_.find(pid);
+    return it == stdio_.end() ? 0 : it->second.out;
+}
+
+bool PipeIndex::has_bidirectional_pipes(int pid) const {
+    return stdin_pipe(pid) != 0 && stdout_pipe(pid) != 0;
+}
+
+std::vector<int> PipeIndex::holders(uint64_t inode, int exclude_pid) const {
+    std::vector<int> result;
+    auto it = holders_.find(inode);
+    if (it == holders_.end()) {
+        return result;
+    }
+
+    for (const auto& holder : it->second) {
+        if (holder.pid != exclude_pid &&
+            (result.empty() || result.back() != holder.pid)) {
+            result.push_back(holder.pid);
+        }
+    }
+    return result;
+}
+
+std::optional<int> PipeIndex::find_client(int pid) const {
+    auto stdio = stdio_.find(pid);
+    if (stdio == stdio_.end()) {
+        return std::nullopt;
+    }
+
+    // Count, per candidate peer, how many of our stdio pipes it holds
+    std::map<int, int> matches;
+    for (uint64_t inode : {stdio->second.in, stdio->second.out}) {
+        if (inode == 0) continue;
+
+        auto it = holders_.find(inode);
+        if (it == holders_.end()) continue;
+
+        int last_pid = 0;
+        for (const auto& holder : it->second) {
+            // Pipeline neighbours hold the pipe as their own stdio
+            if (holder.pid == pid || holder.fd <= 2 || holder.pid == last_pid) continue;
+            matches[holder.pid]++;
+            last_pid = holder.pid;
+        }
+    }
+
+    std::optional<int> best;
+    int best_count = 0;
+    for (const auto& [peer, count] : matches) {
+        if (count > best_count) {
+            best = peer;
+            best_count = count;
+        }
+    }
+    return best;
+}
+
+} // namespace kyros
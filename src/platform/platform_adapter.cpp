@@ -0,0 +1,30 @@
+#include <kyros/platform/platform_adapter.hpp>
+
+namespace kyros {
+
+std::shared_ptr<const ProcessTable> PlatformAdapter::snapshot_processes() {
+    auto table = std::make_shared<ProcessTable>();
+
+    std::vector<int> pids = get_process_list();
+    table->reserve(pids.size());
+
+    for (int pid : pids) {
+        table->add(pid, get_parent_pid(pid), 0, 0,
+                   get_process_name(pid), get_command_args(pid));
+    }
+
+    return table;
+}
+
+bool PlatformAdapter::get_environment_block(int pid, std::string& block) {
+    block.clear();
+    for (const auto& [key, value] : get_environment(pid)) {
+        block.append(key);
+        block += '=';
+        block.append(value);
+        block += '\0';
+    }
+    return true;
+}
+
+} // namespace kyros
@@ -1,13 +1,57 @@
 #include <kyros/platform/process.hpp>
 
+#include <stdexcept>
+
 namespace kyros {
 
-// Process implementation is platform-specific and is provided by:
+// Process I/O is platform-specific and is provided by:
 // - platform/linux/linux_process.cpp
 // - platform/macos/macos_process.cpp
 // - platform/windows/windows_process.cpp
 
-// This file exists to satisfy the build system but contains no implementation
-// as all methods are pure virtual and implemented in platform-specific files
+std::string_view Process::read_stdout_frame(std::chrono::milliseconds timeout,
+                                            FrameFormat format) {
+    // Feed whole lines back through a FrameReader so subclasses that only
+    // implement line reads still get the same framing rules
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    std::string_view frame;
+
+    while (true) {
+        switch (line_frames_.extract(format, frame)) {
+            case FrameReader::Result::Frame:
+                return frame;
+            case FrameReader::Result::TooLarge:
+                throw std::runtime_error("Frame on stdout exceeds " +
+                                         std::to_string(line_frames_.max_frame_bytes()) + " bytes");
+            case FrameReader::Result::Malformed:
+                throw std::runtime_error("Malformed frame header on stdout");
+            case FrameReader::Result::NeedMore:
+                break;
+        }
+
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now());
+        if (remaining.count() <= 0) {
+            throw ReadTimeout("Timeout reading from stdout");
+        }
+
+        std::string line = read_stdout_line(remaining);
+        line += '\n';
+        line_frames_.append(line.data(), line.size());
+    }
+}
+
+std::string_view Process::read_stdout_partial(std::chrono::milliseconds timeout, bool& end) {
+    std::string_view piece;
+    if (line_frames_.extract_partial(piece, end) == FrameReader::Result::Frame) {
+        return piece;
+    }
+
+    std::string line = read_stdout_line(timeout);
+    line += '\n';
+    line_frames_.append(line.data(), line.size());
+    line_frames_.extract_partial(piece, end);
+    return piece;
+}
 
 } // namespace kyros
@@ -0,0 +1,100 @@
+#include <kyros/platform/process_table.hpp>
+
+namespace kyros {
+
+std::vector<std::string_view> ProcessTable::argv(size_t row) const {
+    std::vector<std::string_view> result;
+    size_t begin = argv_begin_[row];
+    size_t end = (row + 1 < argv_begin_.size()) ? argv_begin_[row + 1] : argv_spans_.size();
+    result.reserve(end - begin);
+    for (size_t i = begin; i < end; i++) {
+        result.push_back(view(argv_spans_[i]));
+    }
+    return result;
+}
+
+std::optional<size_t> ProcessTable::find(int pid) const {
+    auto it = index_.find(pid);
+    if (it == index_.end()) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+void ProcessTable::add(int pid, int ppid, uint32_t uid, uint64_t start_time,
+                       std::string_view name, const std::vector<std::string>& argv,
+                       uint32_t exec_count) {
+    index_[pid] = pids_.size();
+
+    pids_.push_back(pid);
+    ppids_.push_back(ppid);
+    uids_.push_back(uid);
+    start_times_.push_back(start_time);
+    exec_counts_.push_back(exec_count);
+    name_spans_.push_back(append(name));
+
+    // Arguments are written once, space-joined; each argv entry is a view
+    // into that joined command line rather than a second copy
+    Span command;
+    command.offset = static_cast<uint32_t>(arena_.size());
+    argv_begin_.push_back(static_cast<uint32_t>(argv_spans_.size()));
+    for (size_t i = 0; i < argv.size(); i++) {
+        if (i > 0) {
+            arena_ += ' ';
+        }
+        argv_spans_.push_back(append(argv[i]));
+    }
+    command.length = static_cast<uint32_t>(arena_.size() - command.offset);
+    command_spans_.push_back(command);
+}
+
+void ProcessTable::copy_row(const ProcessTable& source, size_t row) {
+    index_[source.pid(row)] = pids_.size();
+
+    pids_.push_back(source.pid(row));
+    ppids_.push_back(source.ppid(row));
+    uids_.push_back(source.uid(row));
+    start_times_.push_back(source.start_time(row));
+    exec_counts_.push_back(source.exec_count(row));
+    name_spans_.push_back(append(source.name(row)));
+
+    // The command line is contiguous, so copy it once and rebase the
+    // argv spans onto the new offset
+    const Span& command = source.command_spans_[row];
+    Span copied = append(source.view(command));
+    command_spans_.push_back(copied);
+
+    argv_begin_.push_back(static_cast<uint32_t>(argv_spans_.size()));
+    size_t begin = source.argv_begin_[row];
+    size_t end = (row + 1 < source.argv_begin_.size()) ? source.argv_begin_[row + 1]
+                                                        : source.argv_spans_.size();
+    for (size_t i = begin; i < end; i++) {
+        Span arg = source.argv_spans_[i];
+        arg.offset = arg.offset - command.offset + copied.offset;
+        argv_spans_.push_back(arg);
+    }
+}
+
+void ProcessTable::reserve(size_t count) {
+    pids_.reserve(count);
+    ppids_.reserve(count);
+    uids_.reserve(count);
+    start_times_.reserve(count);
+    exec_counts_.reserve(count);
+    name_spans_.reserve(count);
+    command_spans_.reserve(count);
+    argv_begin_.reserve(count);
+    argv_spans_.reserve(count * 4);
+    arena_.reserve(count * 96);
+    index_.reserve(count);
+}
+
+ProcessTable::Span ProcessTable::append(std::string_view text) {
+    Span span;
+    span.offset = static_cast<uint32_t>(arena_.size());
+    span.length = static_cast<uint32_t>(text.size());
+    arena_.append(text.data(), text.size());
+    return span;
+}
+
+} // namespace kyros
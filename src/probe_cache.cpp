@@ -0,0 +1,382 @@
+// Persistent cache of active probe outcomes
+
+#include <kyros/probe_cache.hpp>
+#include <kyros/utils/cache_file.hpp>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef PLATFORM_MACOS
+#include <libproc.h>
+#endif
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace kyros {
+
+namespace {
+
+constexpr int kFormatVersion = 1;
+
+// Arguments joined with single spaces. argv is kept as is, empty
+// arguments included, so "a '' b" and "a b" differ; a bare command string
+// is split on whitespace, whatever the original spacing.
+std::string normalize_command(const Candidate& candidate) {
+    std::string normalized;
+    if (!candidate.argv.empty()) {
+        for (size_t i = 0; i < candidate.argv.size(); i++) {
+            if (i > 0) {
+                normalized += ' ';
+            }
+            normalized += candidate.argv[i];
+        }
+        return normalized;
+    }
+
+    std::istringstream words(candidate.command);
+    std::string word;
+    while (words >> word) {
+        if (!normalized.empty()) {
+            normalized += ' ';
+        }
+        normalized += word;
+    }
+    return normalized;
+}
+
+// The executable a command runs. For a running process that is the image
+// it was started from; a relative path is otherwise resolved against the
+// process' working directory, not ours. Without a process: as given when
+// it has a slash, otherwise the first match on PATH.
+std::string resolve_executable(const Candidate& candidate) {
+    std::string program;
+    if (!candidate.argv.empty()) {
+        program = candidate.argv[0];
+    } else {
+        std::istringstream words(candidate.command);
+        words >> program;
+    }
+    if (program.empty()) {
+        return program;
+    }
+
+    if (candidate.pid > 0) {
+#ifdef PLATFORM_MACOS
+        char image[PROC_PIDPATHINFO_MAXSIZE];
+        if (proc_pidpath(candidate.pid, image, sizeof(image)) > 0) {
+            return image;
+        }
+#else
+        std::string proc_dir = "/proc/" + std::to_string(candidate.pid);
+        std::string image = proc_dir + "/exe";
+        struct stat st;
+        if (stat(image.c_str(), &st) == 0) {
+            return image;
+        }
+        if (program[0] != '/' && program.find('/') != std::string::npos) {
+            return proc_dir + "/cwd/" + program;
+        }
+#endif
+    }
+
+    if (program.find('/') != std::string::npos) {
+        return program;
+    }
+
+    const char* path = std::getenv("PATH");
+    std::istringstream dirs(path ? path : "");
+    std::string dir;
+    while (std::getline(dirs, dir, ':')) {
+        std::string full = (dir.empty() ? "." : dir) + "/" + program;
+        if (access(full.c_str(), X_OK) == 0) {
+            return full;
+        }
+    }
+    return program;
+}
+
+// "dev:inode:mtime_ns" of a file, or "-" if it cannot be stat()ed
+std::string file_identity(const std::string& path) {
+    struct stat st;
+    if (path.empty() || stat(path.c_str(), &st) != 0) {
+        return "-";
+    }
+#ifdef PLATFORM_MACOS
+    const struct timespec& mtime = st.st_mtimespec;
+#else
+    const struct timespec& mtime = st.st_mtim;
+#endif
+    int64_t mtime_ns = static_cast<int64_t>(mtime.tv_sec) * 1000000000 + mtime.tv_nsec;
+    return std::to_string(st.st_dev) + ":" + std::to_string(st.st_ino) + ":" +
+           std::to_string(mtime_ns);
+}
+
+const char* transport_name(TransportType type) {
+    switch (type) {
+        case TransportType::Stdio: return "stdio";
+        case TransportType::Http: return "http";
+        case TransportType::Sse: return "sse";
+        default: return "unknown";
+    }
+}
+
+TransportType transport_from_name(const std::string& name) {
+    if (name == "stdio") return TransportType::Stdio;
+    if (name == "http") return TransportType::Http;
+    if (name == "sse") return TransportType::Sse;
+    return TransportType::Unknown;
+}
+
+nlohmann::json server_to_json(const MCPServer& server) {
+    nlohmann::json s = {
+        {"server_name", server.server_name},
+        {"server_version", server.server_version},
+        {"protocol_version", server.protocol_version},
+        {"capabilities", server.capabilities},
+        {"transport", transport_name(server.transport_type)},
+        {"discovered_at", to_epoch_seconds(server.discovered_at)},
+        {"interrogation_attempted", server.interrogation_attempted},
+        {"interrogation_successful", server.interrogation_successful},
+        {"interrogation_errors", server.interrogation_errors}
+    };
+
+    auto& tools = s["tools"] = nlohmann::json::array();
+    for (const auto& tool : server.tools) {
+        tools.push_back({
+            {"name", tool.name},
+            {"description", tool.description},
+            {"input_schema", tool.input_schema},
+            {"required_parameters", tool.required_parameters},
+            {"optional_parameters", tool.optional_parameters}
+        });
+    }
+
+    auto& resources = s["resources"] = nlohmann::json::array();
+    for (const auto& resource : server.resources) {
+        resources.push_back({
+            {"uri", resource.uri},
+            {"name", resource.name},
+            {"description", resource.description},
+            {"mime_type", resource.mime_type}
+        });
+    }
+
+    auto& templates = s["resource_templates"] = nlohmann::json::array();
+    for (const auto& tmpl : server.resource_templates) {
+        templates.push_back({
+            {"uri_template", tmpl.uri_template},
+            {"name", tmpl.name},
+            {"description", tmpl.description},
+            {"mime_type", tmpl.mime_type},
+            {"parameters", tmpl.parameters}
+        });
+    }
+
+    auto& prompts = s["prompts"] = nlohmann::json::array();
+    for (const auto& prompt : server.prompts) {
+        nlohmann::json p = {
+            {"name", prompt.name},
+            {"description", prompt.description}
+        };
+        auto& arguments = p["arguments"] = nlohmann::json::array();
+        for (const auto& arg : prompt.arguments) {
+            arguments.push_back({
+                {"name", arg.name},
+                {"type", arg.type},
+                {"description", arg.description},
+                {"required", arg.required}
+            });
+        }
+        prompts.push_back(std::move(p));
+    }
+
+    return s;
+}
+
+MCPServer server_from_json(const nlohmann::json& s) {
+    MCPServer server;
+    server.server_name = s.at("server_name").get<std::string>();
+    server.server_version = s.at("server_version").get<std::string>();
+    server.protocol_version = s.at("protocol_version").get<std::string>();
+    server.capabilities = s.at("capabilities");
+    server.transport_type = transport_from_name(s.at("transport").get<std::string>());
+    server.discovered_at = from_epoch_seconds(s.at("discovered_at").get<int64_t>());
+    server.interrogation_attempted = s.at("interrogation_attempted").get<bool>();
+    server.interrogation_successful = s.at("interrogation_successful").get<bool>();
+    server.interrogation_errors = s.at("interrogation_errors").get<std::vector<std::string>>();
+
+    for (const auto& t : s.at("tools")) {
+        ToolDefinition tool;
+        tool.name = t.at("name").get<std::string>();
+        tool.description = t.at("description").get<std::string>();
+        tool.input_schema = t.at("input_schema");
+        tool.required_parameters = t.at("required_parameters").get<std::vector<std::string>>();
+        tool.optional_parameters = t.at("optional_parameters").get<std::vector<std::string>>();
+        server.tools.push_back(std::move(tool));
+    }
+
+    for (const auto& r : s.at("resources")) {
+        ResourceDefinition resource;
+        resource.uri = r.at("uri").get<std::string>();
+        resource.name = r.at("name").get<std::string>();
+        resource.description = r.at("description").get<std::string>();
+        resource.mime_type = r.at("mime_type").get<std::string>();
+        server.resources.push_back(std::move(resource));
+    }
+
+    for (const auto& rt : s.at("resource_templates")) {
+        ResourceTemplate tmpl;
+        tmpl.uri_template = rt.at("uri_template").get<std::string>();
+        tmpl.name = rt.at("name").get<std::string>();
+        tmpl.description = rt.at("description").get<std::string>();
+        tmpl.mime_type = rt.at("mime_type").get<std::string>();
+        tmpl.parameters = rt.at("parameters").get<std::vector<std::string>>();
+        server.resource_templates.push_back(std::move(tmpl));
+    }
+
+    for (const auto& p : s.at("prompts")) {
+        PromptDefinition prompt;
+        prompt.name = p.at("name").get<std::string>();
+        prompt.description = p.at("description").get<std::string>();
+        for (const auto& a : p.at("arguments")) {
+            PromptArgument arg;
+            arg.name = a.at("name").get<std::string>();
+            arg.type = a.at("type").get<std::string>();
+            arg.description = a.at("description").get<std::string>();
+            arg.required = a.at("required").get<bool>();
+            prompt.arguments.push_back(std::move(arg));
+        }
+        server.prompts.push_back(std::move(prompt));
+    }
+
+    return server;
+}
+
+} // namespace
+
+ProbeCache::ProbeCache(std::string path, std::chrono::seconds ttl, std::chrono::seconds failure_ttl)
+    : path_(std::move(path)), ttl_(ttl), failure_ttl_(failure_ttl) {}
+
+std::string ProbeCache::default_path() {
+    return cache_file_path("probe-cache.json");
+}
+
+std::string ProbeCache::fingerprint(const Candidate& candidate, uint64_t owner_start_time) {
+    // Whatever listens on a URL may be replaced at any time; only the
+    // start time of its owner tells one listener from the next
+    if (!candidate.url.empty() && owner_start_time == 0) {
+        return "";
+    }
+
+    std::string key;
+    std::string command = normalize_command(candidate);
+    if (!command.empty()) {
+        key += "stdio " + file_identity(resolve_executable(candidate)) + " " + command;
+    }
+    if (!candidate.url.empty()) {
+        if (!key.empty()) {
+            key += '\n';
+        }
+        key += "http " + std::to_string(owner_start_time) + " " + candidate.url;
+    }
+    return key;
+}
+
+void ProbeCache::load() {
+    entries_.clear();
+
+    std::ifstream file(path_);
+    if (!file) {
+        return;  // First run
+    }
+
+    try {
+        nlohmann::json json = nlohmann::json::parse(file);
+        if (json.value("version", 0) != kFormatVersion) {
+            return;
+        }
+        for (const auto& [key, e] : json.at("entries").items()) {
+            Entry entry;
+            entry.confirmed = e.at("confirmed").get<bool>();
+            entry.interrogated = e.value("interrogated", false);
+            entry.stored_at = from_epoch_seconds(e.at("stored_at").get<int64_t>());
+            if (entry.confirmed) {
+                entry.server = server_from_json(e.at("server"));
+            } else {
+                entry.error = e.value("error", "");
+            }
+            entries_[key] = std::move(entry);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Warning: Ignoring probe cache " << path_ << ": " << e.what() << "\n";
+        entries_.clear();
+    }
+}
+
+bool ProbeCache::save() const {
+    auto now = std::chrono::system_clock::now();
+    nlohmann::json entries = nlohmann::json::object();
+    for (const auto& [key, entry] : entries_) {
+        if (!fresh(entry, now)) {
+            continue;
+        }
+        nlohmann::json e = {
+            {"confirmed", entry.confirmed},
+            {"interrogated", entry.interrogated},
+            {"stored_at", to_epoch_seconds(entry.stored_at)}
+        };
+        if (entry.server) {
+            e["server"] = server_to_json(*entry.server);
+        } else {
+            e["error"] = entry.error;
+        }
+        entries[key] = std::move(e);
+    }
+    nlohmann::json json = {{"version", kFormatVersion}, {"entries", std::move(entries)}};
+
+    try {
+        write_json_atomically(path_, json);
+    } catch (const std::exception& e) {
+        std::cerr << "Warning: Failed to save probe cache " << path_ << ": " << e.what() << "\n";
+        return false;
+    }
+    return true;
+}
+
+const ProbeCache::Entry* ProbeCache::find(const std::string& fingerprint, Timestamp now) const {
+    auto it = entries_.find(fingerprint);
+    if (it == entries_.end() || !fresh(it->second, now)) {
+        return nullptr;
+    }
+    return &it->second;
+}
+
+void ProbeCache::store_confirmed(const std::string& fingerprint, const MCPServer& server,
+                                 bool interrogated, Timestamp now) {
+    Entry entry;
+    entry.confirmed = true;
+    entry.interrogated = interrogated;
+    entry.server = server;
+    entry.server->candidate = Candidate{};
+    entry.server->session.reset();
+    entry.stored_at = now;
+    entries_[fingerprint] = std::move(entry);
+}
+
+void ProbeCache::store_failure(const std::string& fingerprint, const std::string& error,
+                               Timestamp now) {
+    Entry entry;
+    entry.error = error;
+    entry.stored_at = now;
+    entries_[fingerprint] = std::move(entry);
+}
+
+bool ProbeCache::fresh(const Entry& entry, Timestamp now) const {
+    auto ttl = entry.confirmed ? ttl_ : failure_ttl_;
+    return now >= entry.stored_at && now - entry.stored_at < ttl;
+}
+
+} // namespace kyros
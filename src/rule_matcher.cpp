@@ -0,0 +1,642 @@
+// Compiled rule matching: one automaton per candidate field
+
+#include <kyros/rule_matcher.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <stdexcept>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace kyros {
+
+namespace {
+
+// Index of the lowest set bit of a non-zero word
+size_t lowest_bit(uint64_t word) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, word);
+    return index;
+#else
+    return static_cast<size_t>(__builtin_ctzll(word));
+#endif
+}
+
+} // namespace
+
+// PatternSet
+
+size_t PatternSet::add(std::string_view pattern) {
+    auto it = ids_.find(pattern);
+    if (it != ids_.end()) {
+        return it->second;
+    }
+    size_t id = patterns_.size();
+    patterns_.emplace_back(pattern);
+    ids_.emplace(std::string(pattern), id);
+    return id;
+}
+
+void PatternSet::build() {
+    // Byte classes: 0 for bytes in no pattern, then one per distinct byte
+    classes_.fill(0);
+    class_count_ = 1;
+    for (const auto& pattern : patterns_) {
+        for (unsigned char c : pattern) {
+            if (classes_[c] == 0) {
+                classes_[c] = static_cast<uint8_t>(class_count_++);
+            }
+        }
+    }
+
+    // Trie; 0 in a non-root row means "no edge yet"
+    next_.assign(class_count_, 0);
+    output_.assign(1, -1);
+    empty_patterns_.clear();
+    for (size_t id = 0; id < patterns_.size(); id++) {
+        const auto& pattern = patterns_[id];
+        if (pattern.empty()) {
+            empty_patterns_.push_back(id);
+            continue;
+        }
+        uint32_t state = 0;
+        for (unsigned char c : pattern) {
+            uint32_t& edge = next_[state * class_count_ + classes_[c]];
+            if (edge == 0) {
+                edge = static_cast<uint32_t>(output_.size());
+                output_.push_back(-1);
+                next_.resize(next_.size() + class_count_, 0);
+            }
+            state = next_[state * class_count_ + classes_[c]];
+        }
+        output_[state] = static_cast<int32_t>(id);
+    }
+
+    // Breadth-first: failure links, then missing edges borrowed from the
+    // failure state so scanning never backtracks
+    size_t states = output_.size();
+    std::vector<uint32_t> fail(states, 0);
+    dict_link_.assign(states, 0);
+    std::deque<uint32_t> queue;
+    for (size_t c = 0; c < class_count_; c++) {
+        if (next_[c] != 0) {
+            queue.push_back(next_[c]);
+        }
+    }
+    while (!queue.empty()) {
+        uint32_t state = queue.front();
+        queue.pop_front();
+        for (size_t c = 0; c < class_count_; c++) {
+            uint32_t& edge = next_[state * class_count_ + c];
+            uint32_t borrowed = next_[fail[state] * class_count_ + c];
+            if (edge == 0) {
+                edge = borrowed;
+                continue;
+            }
+            fail[edge] = borrowed;
+            dict_link_[edge] = output_[borrowed] >= 0 ? borrowed : dict_link_[borrowed];
+            queue.push_back(edge);
+        }
+    }
+}
+
+void PatternSet::write(BinaryWriter& out) const {
+    out.u32(static_cast<uint32_t>(patterns_.size()));
+    for (const auto& pattern : patterns_) {
+        out.str(pattern);
+    }
+    out.bytes(std::string_view(reinterpret_cast<const char*>(classes_.data()), classes_.size()));
+    out.u32(static_cast<uint32_t>(class_count_));
+    out.u32(static_cast<uint32_t>(output_.size()));
+    for (uint32_t next : next_) {
+        out.u32(next);
+    }
+    for (int32_t output : output_) {
+        out.u32(static_cast<uint32_t>(output));
+    }
+    for (uint32_t link : dict_link_) {
+        out.u32(link);
+    }
+}
+
+void PatternSet::read(BinaryReader& in) {
+    auto invalid = [] { return std::runtime_error("Invalid pattern table"); };
+
+    patterns_.clear();
+    ids_.clear();
+    empty_patterns_.clear();
+    uint32_t count = in.count(4);
+    for (uint32_t id = 0; id < count; id++) {
+        patterns_.push_back(in.str());
+        if (!ids_.emplace(patterns_.back(), id).second) {
+            throw invalid();
+        }
+        if (patterns_.back().empty()) {
+            empty_patterns_.push_back(id);
+        }
+    }
+
+    std::string_view classes = in.bytes(classes_.size());
+    std::memcpy(classes_.data(), classes.data(), classes_.size());
+    class_count_ = in.u32();
+    uint32_t states = in.u32();
+    if (class_count_ == 0 || class_count_ > 256 || states == 0 ||
+        static_cast<uint64_t>(states) * (class_count_ + 2) * 4 > in.remaining()) {
+        throw invalid();
+    }
+    for (uint8_t c : classes_) {
+        if (c >= class_count_) {
+            throw invalid();
+        }
+    }
+
+    next_.resize(static_cast<size_t>(states) * class_count_);
+    for (auto& next : next_) {
+        next = in.u32();
+        if (next >= states) {
+            throw invalid();
+        }
+    }
+    output_.resize(states);
+    for (auto& output : output_) {
+        output = static_cast<int32_t>(in.u32());
+        if (output < -1 || output >= static_cast<int64_t>(count)) {
+            throw invalid();
+        }
+    }
+    dict_link_.resize(states);
+    for (auto& link : dict_link_) {
+        link = in.u32();
+        if (link >= states || (link != 0 && output_[link] < 0)) {
+            throw invalid();
+        }
+    }
+
+    // scan() follows dictionary links until the root; they must reach it.
+    // Each chain is walked once, stopping at states already known to end.
+    std::vector<uint8_t> seen(states, 0);  // 1: on the current chain, 2: reaches the root
+    seen[0] = 2;
+    for (uint32_t start = 1; start < states; start++) {
+        uint32_t s = start;
+        while (seen[s] == 0) {
+            seen[s] = 1;
+            s = dict_link_[s];
+        }
+        if (seen[s] == 1) {
+            throw invalid();
+        }
+        for (s = start; seen[s] == 1; s = dict_link_[s]) {
+            seen[s] = 2;
+        }
+    }
+}
+
+// RuleMatcher
+
+RuleMatcher::RuleMatcher(const std::vector<Rulepack>& rulepacks) {
+    compile(rulepacks, nullptr);
+}
+
+RuleMatcher::RuleMatcher(const std::vector<Rulepack>& rulepacks, BinaryReader& tables) {
+    compile(rulepacks, &tables);
+}
+
+void RuleMatcher::write_tables(BinaryWriter& out) const {
+    for (const auto& patterns : patterns_) {
+        patterns.write(out);
+    }
+}
+
+void RuleMatcher::compile(const std::vector<Rulepack>& rulepacks, BinaryReader* tables) {
+    // Loaded tables already hold every pattern, so add() below only looks
+    // up their ids
+    std::array<size_t, kFieldCount> loaded_sizes{};
+    if (tables) {
+        for (size_t f = 0; f < kFieldCount; f++) {
+            patterns_[f].read(*tables);
+            loaded_sizes[f] = patterns_[f].size();
+        }
+    }
+
+    for (const auto& rulepack : rulepacks) {
+        for (const auto& rule : rulepack.rules) {
+            CompiledRule compiled;
+            compiled.actions = rule.actions;
+
+            for (const auto& match : rule.match_conditions) {
+                Condition condition;
+                condition.type = match.type;
+                switch (match.type) {
+                    case RuleMatch::Type::ProcessName:
+                        condition.field = ProcessNameField;
+                        break;
+                    case RuleMatch::Type::CommandContains:
+                        condition.field = CommandField;
+                        break;
+                    case RuleMatch::Type::URLContains:
+                        condition.field = UrlField;
+                        break;
+                    case RuleMatch::Type::ConfigFile:
+                        condition.field = ConfigFileField;
+                        break;
+                    case RuleMatch::Type::CommandRegex:
+                        try {
+                            condition.regex = std::make_shared<const std::regex>(match.value);
+                        } catch (const std::regex_error&) {
+                        }
+                        break;
+                    case RuleMatch::Type::PortEquals:
+                        condition.port = std::stoi(match.value);
+                        break;
+                    case RuleMatch::Type::EvidenceType:
+                        condition.value = match.value;
+                        break;
+                    case RuleMatch::Type::ParentProcess:
+                        break;
+                }
+                if (condition.field >= 0) {
+                    auto& patterns = patterns_[static_cast<size_t>(condition.field)];
+                    condition.pattern = patterns.add(match.value);
+                }
+                compiled.conditions.push_back(std::move(condition));
+            }
+            rules_.push_back(std::move(compiled));
+        }
+    }
+
+    for (size_t f = 0; f < kFieldCount; f++) {
+        if (!tables) {
+            patterns_[f].build();
+        } else if (patterns_[f].size() != loaded_sizes[f]) {
+            throw std::runtime_error("Pattern tables do not match the rulepacks");
+        }
+        by_pattern_[f].resize(patterns_[f].size());
+    }
+    for (size_t r = 0; r < rules_.size(); r++) {
+        index(static_cast<uint32_t>(r));
+    }
+}
+
+void RuleMatcher::index(uint32_t rule) {
+    // Anchor on the longest literal, else a port, else an evidence type
+    const Condition* literal = nullptr;
+    const Condition* port = nullptr;
+    const Condition* evidence = nullptr;
+    for (const auto& condition : rules_[rule].conditions) {
+        switch (condition.type) {
+            case RuleMatch::Type::ParentProcess:
+                return;  // Never matches
+            case RuleMatch::Type::PortEquals:
+                port = port ? port : &condition;
+                break;
+            case RuleMatch::Type::EvidenceType:
+                evidence = evidence ? evidence : &condition;
+                break;
+            case RuleMatch::Type::CommandRegex:
+                break;
+            default: {
+                const auto& patterns = patterns_[static_cast<size_t>(condition.field)];
+                if (!literal || patterns.pattern(condition.pattern).size() >
+                                    patterns_[static_cast<size_t>(literal->field)]
+                                        .pattern(literal->pattern)
+                                        .size()) {
+                    literal = &condition;
+                }
+                break;
+            }
+        }
+    }
+
+    if (literal) {
+        by_pattern_[static_cast<size_t>(literal->field)][literal->pattern].push_back(rule);
+    } else if (port) {
+        by_port_[port->port].push_back(rule);
+    } else if (evidence) {
+        by_evidence_[evidence->value].push_back(rule);
+    } else {
+        residual_.push_back(rule);
+    }
+}
+
+// A slot counts as set when it holds the current epoch, so nothing is
+// cleared between candidates
+struct RuleMatcher::Scratch {
+    uint32_t epoch = 0;
+    std::array<std::vector<uint32_t>, kFieldCount> pattern_stamps;
+    std::vector<uint32_t> rule_stamps;
+    std::vector<uint32_t> queue;  // Min-heap of rule indices
+};
+
+RuleMatcher::Scratch& RuleMatcher::scratch() {
+    thread_local Scratch scratch;
+    return scratch;
+}
+
+void RuleMatcher::begin(Scratch& scratch) const {
+    if (++scratch.epoch == 0) {
+        for (auto& stamps : scratch.pattern_stamps) {
+            std::fill(stamps.begin(), stamps.end(), 0);
+        }
+        std::fill(scratch.rule_stamps.begin(), scratch.rule_stamps.end(), 0);
+        scratch.epoch = 1;
+    }
+    for (size_t f = 0; f < kFieldCount; f++) {
+        if (scratch.pattern_stamps[f].size() < patterns_[f].size()) {
+            scratch.pattern_stamps[f].resize(patterns_[f].size(), 0);
+        }
+    }
+    if (scratch.rule_stamps.size() < rules_.size()) {
+        scratch.rule_stamps.resize(rules_.size(), 0);
+    }
+    scratch.queue.clear();
+}
+
+void RuleMatcher::push(Scratch& scratch, uint32_t rule) {
+    if (scratch.rule_stamps[rule] != scratch.epoch) {
+        scratch.rule_stamps[rule] = scratch.epoch;
+        scratch.queue.push_back(rule);
+        std::push_heap(scratch.queue.begin(), scratch.queue.end(), std::greater<>());
+    }
+}
+
+void RuleMatcher::enqueue(Scratch& scratch, const RuleList& rules, int64_t after) {
+    auto it = std::upper_bound(rules.begin(), rules.end(), after,
+                               [](int64_t value, uint32_t rule) { return value < rule; });
+    for (; it != rules.end(); ++it) {
+        push(scratch, *it);
+    }
+}
+
+size_t RuleMatcher::apply(Candidate& candidate) const {
+    Scratch& s = scratch();
+    begin(s);
+
+    // The text fields are not changed by any action, so one scan each
+    // answers every literal condition for the whole pass
+    const std::string* fields[kFieldCount] = {&candidate.process_name, &candidate.command,
+                                              &candidate.url, &candidate.config_file};
+    for (size_t f = 0; f < kFieldCount; f++) {
+        auto& stamps = s.pattern_stamps[f];
+        patterns_[f].scan(*fields[f], [&](size_t id) {
+            if (stamps[id] != s.epoch) {
+                stamps[id] = s.epoch;
+                enqueue(s, by_pattern_[f][id], -1);
+            }
+        });
+    }
+    if (auto it = by_port_.find(candidate.port); it != by_port_.end()) {
+        enqueue(s, it->second, -1);
+    }
+    return evaluate(candidate, s);
+}
+
+size_t RuleMatcher::apply_batch(std::vector<Candidate>& candidates) const {
+    using Bitset = std::vector<uint64_t>;
+    const size_t n = candidates.size();
+    const size_t words = (n + 63) / 64;
+
+    // Columns are dictionary-encoded: each distinct value of a field is
+    // appended once to a contiguous buffer and scanned once, however many
+    // candidates share it (process names, config files and empty URLs
+    // repeat heavily on a real host)
+    struct Column {
+        std::vector<uint32_t> value_of;     // Candidate -> distinct value
+        std::vector<uint32_t> hit_offsets;  // Distinct value -> range of hit_ids
+        std::vector<uint32_t> hit_ids;      // Patterns found in the value, once each
+    };
+    std::array<Column, kFieldCount> columns;
+    std::array<std::vector<Bitset>, kFieldCount> hits;  // Per pattern, allocated on first hit
+    std::string buffer;
+    std::vector<size_t> offsets;
+    std::vector<uint32_t> slots;  // Open-addressed: hash -> first candidate with the value
+    std::vector<uint32_t> last_value;
+    size_t slot_mask = 1;
+    while (slot_mask < 2 * n) {
+        slot_mask <<= 1;
+    }
+    slot_mask--;
+    for (size_t f = 0; f < kFieldCount; f++) {
+        auto field = [&](const Candidate& c) -> const std::string& {
+            switch (f) {
+                case ProcessNameField: return c.process_name;
+                case CommandField: return c.command;
+                case UrlField: return c.url;
+                default: return c.config_file;
+            }
+        };
+        Column& column = columns[f];
+        column.value_of.resize(n);
+        buffer.clear();
+        offsets.assign(1, 0);
+        slots.assign(slot_mask + 1, UINT32_MAX);
+        for (size_t i = 0; i < n; i++) {
+            const std::string& value = field(candidates[i]);
+            size_t slot = std::hash<std::string_view>()(value) & slot_mask;
+            while (slots[slot] != UINT32_MAX && field(candidates[slots[slot]]) != value) {
+                slot = (slot + 1) & slot_mask;
+            }
+            if (slots[slot] == UINT32_MAX) {
+                slots[slot] = static_cast<uint32_t>(i);
+                column.value_of[i] = static_cast<uint32_t>(offsets.size() - 1);
+                buffer += value;
+                offsets.push_back(buffer.size());
+            } else {
+                column.value_of[i] = column.value_of[slots[slot]];
+            }
+        }
+
+        std::string_view text(buffer);
+        last_value.assign(patterns_[f].size(), UINT32_MAX);
+        column.hit_offsets.assign(1, 0);
+        for (uint32_t v = 0; v + 1 < offsets.size(); v++) {
+            patterns_[f].scan(text.substr(offsets[v], offsets[v + 1] - offsets[v]), [&](size_t id) {
+                if (last_value[id] != v) {
+                    last_value[id] = v;
+                    column.hit_ids.push_back(static_cast<uint32_t>(id));
+                }
+            });
+            column.hit_offsets.push_back(static_cast<uint32_t>(column.hit_ids.size()));
+        }
+
+        hits[f].resize(patterns_[f].size());
+        for (size_t i = 0; i < n; i++) {
+            uint32_t v = column.value_of[i];
+            for (uint32_t h = column.hit_offsets[v]; h < column.hit_offsets[v + 1]; h++) {
+                Bitset& bits = hits[f][column.hit_ids[h]];
+                if (bits.empty()) {
+                    bits.assign(words, 0);
+                }
+                bits[i / 64] |= uint64_t{1} << (i % 64);
+            }
+        }
+    }
+
+    // The port column, as one bitset per distinct port
+    std::unordered_map<int, Bitset> ports;
+    for (size_t i = 0; i < n; i++) {
+        Bitset& bits = ports[candidates[i].port];
+        if (bits.empty()) {
+            bits.assign(words, 0);
+        }
+        bits[i / 64] |= uint64_t{1} << (i % 64);
+    }
+
+    // AND the literal and port conditions of each indexed rule; the
+    // candidates left are seeded with the rule
+    std::vector<std::pair<uint32_t, uint32_t>> seeds;  // (candidate, rule)
+    Bitset mask;
+    auto seed = [&](uint32_t rule, const Bitset& anchor) {
+        mask = anchor;
+        for (const auto& condition : rules_[rule].conditions) {
+            const Bitset* bits = nullptr;
+            if (condition.field >= 0) {
+                bits = &hits[static_cast<size_t>(condition.field)][condition.pattern];
+            } else if (condition.type == RuleMatch::Type::PortEquals) {
+                auto it = ports.find(condition.port);
+                bits = it == ports.end() ? nullptr : &it->second;
+            } else {
+                continue;
+            }
+            if (!bits || bits->empty()) {
+                return;
+            }
+            for (size_t w = 0; w < words; w++) {
+                mask[w] &= (*bits)[w];
+            }
+        }
+        for (size_t w = 0; w < words; w++) {
+            for (uint64_t word = mask[w]; word != 0; word &= word - 1) {
+                seeds.emplace_back(static_cast<uint32_t>(w * 64 + lowest_bit(word)), rule);
+            }
+        }
+    };
+    for (size_t f = 0; f < kFieldCount; f++) {
+        for (size_t id = 0; id < hits[f].size(); id++) {
+            if (!hits[f][id].empty()) {
+                for (uint32_t rule : by_pattern_[f][id]) {
+                    seed(rule, hits[f][id]);
+                }
+            }
+        }
+    }
+    for (const auto& [port, bits] : ports) {
+        if (auto it = by_port_.find(port); it != by_port_.end()) {
+            for (uint32_t rule : it->second) {
+                seed(rule, bits);
+            }
+        }
+    }
+
+    // Group the seeds by candidate (counting sort), then run the rules per
+    // candidate and in rulepack order
+    std::vector<uint32_t> seed_offsets(n + 1, 0);
+    for (const auto& [i, rule] : seeds) {
+        seed_offsets[i + 1]++;
+    }
+    for (size_t i = 0; i < n; i++) {
+        seed_offsets[i + 1] += seed_offsets[i];
+    }
+    std::vector<uint32_t> seed_rules(seeds.size());
+    std::vector<uint32_t> next(seed_offsets.begin(), seed_offsets.end() - 1);
+    for (const auto& [i, rule] : seeds) {
+        seed_rules[next[i]++] = rule;
+    }
+
+    Scratch& s = scratch();
+    size_t evaluated = 0;
+    for (size_t i = 0; i < n; i++) {
+        begin(s);
+        for (size_t f = 0; f < kFieldCount; f++) {
+            const Column& column = columns[f];
+            uint32_t v = column.value_of[i];
+            for (uint32_t h = column.hit_offsets[v]; h < column.hit_offsets[v + 1]; h++) {
+                s.pattern_stamps[f][column.hit_ids[h]] = s.epoch;
+            }
+        }
+        for (uint32_t k = seed_offsets[i]; k < seed_offsets[i + 1]; k++) {
+            push(s, seed_rules[k]);
+        }
+        evaluated += evaluate(candidates[i], s);
+    }
+    return evaluated;
+}
+
+size_t RuleMatcher::evaluate(Candidate& candidate, Scratch& scratch) const {
+    for (const auto& evidence : candidate.evidence) {
+        if (auto it = by_evidence_.find(evidence.type); it != by_evidence_.end()) {
+            enqueue(scratch, it->second, -1);
+        }
+    }
+    enqueue(scratch, residual_, -1);
+
+    std::array<const uint32_t*, kFieldCount> pattern_stamps;
+    for (size_t f = 0; f < kFieldCount; f++) {
+        pattern_stamps[f] = scratch.pattern_stamps[f].data();
+    }
+
+    auto& queue = scratch.queue;
+    size_t evaluated = 0;
+    while (!queue.empty()) {
+        std::pop_heap(queue.begin(), queue.end(), std::greater<>());
+        uint32_t r = queue.back();
+        queue.pop_back();
+        const CompiledRule& rule = rules_[r];
+        evaluated++;
+
+        bool matched = true;
+        for (const auto& condition : rule.conditions) {
+            if (!matches(condition, candidate, pattern_stamps, scratch.epoch)) {
+                matched = false;
+                break;
+            }
+        }
+        if (!matched) {
+            continue;
+        }
+
+        size_t evidence_before = candidate.evidence.size();
+        for (const auto& action : rule.actions) {
+            action.apply(candidate);
+        }
+        for (size_t i = evidence_before; i < candidate.evidence.size(); i++) {
+            if (auto it = by_evidence_.find(candidate.evidence[i].type); it != by_evidence_.end()) {
+                enqueue(scratch, it->second, r);
+            }
+        }
+    }
+    return evaluated;
+}
+
+bool RuleMatcher::matches(const Condition& condition, const Candidate& candidate,
+                          const std::array<const uint32_t*, kFieldCount>& pattern_stamps,
+                          uint32_t epoch) const {
+    if (condition.field >= 0) {
+        return pattern_stamps[static_cast<size_t>(condition.field)][condition.pattern] == epoch;
+    }
+
+    switch (condition.type) {
+        case RuleMatch::Type::CommandRegex:
+            return condition.regex && std::regex_search(candidate.command, *condition.regex);
+
+        case RuleMatch::Type::PortEquals:
+            return candidate.port == condition.port;
+
+        case RuleMatch::Type::EvidenceType:
+            for (const auto& evidence : candidate.evidence) {
+                if (evidence.type == condition.value) {
+                    return true;
+                }
+            }
+            return false;
+
+        default:
+            return false;
+    }
+}
+
+} // namespace kyros
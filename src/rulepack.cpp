@@ -1,5 +1,9 @@
 #include <kyros/rulepack.hpp>
+#include <kyros/rule_matcher.hpp>
+#include <kyros/rulepack_binary.hpp>
+#include <algorithm>
 #include <fstream>
+#include <iterator>
 #include <regex>
 #include <stdexcept>
 
@@ -184,6 +188,19 @@ Rulepack Rulepack::load_from_json(const nlohmann::json& json) {
         throw std::runtime_error("Rulepack must contain 'rules' array");
     }
 
+    // Extra environment variable prefixes for ProcessDetectionEngine
+    if (json.contains("environment_prefixes")) {
+        if (!json["environment_prefixes"].is_array()) {
+            throw std::runtime_error("'environment_prefixes' must be an array of strings");
+        }
+        for (const auto& prefix : json["environment_prefixes"]) {
+            if (!prefix.is_string() || prefix.get<std::string>().empty()) {
+                throw std::runtime_error("'environment_prefixes' must be an array of strings");
+            }
+            rulepack.environment_prefixes.push_back(prefix.get<std::string>());
+        }
+    }
+
     for (const auto& rule_json : json["rules"]) {
         Rule rule;
         rule.name = rule_json.value("name", "Unnamed Rule");
@@ -332,18 +349,134 @@ void Rulepack::apply(Candidate& candidate) const {
 }
 
 // RuleEngine implementation
+namespace {
+
+// The rulepacks of a JSON or compiled rulepack file, with the compiled
+// file's matcher if it was one
+CompiledRulepacks read_rulepack_file(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Failed to open rulepack file: " + path);
+    }
+    char magic[sizeof(kCompiledRulepackMagic)] = {};
+    file.read(magic, sizeof(magic));
+    if (!is_compiled_rulepack(std::string_view(magic, static_cast<size_t>(file.gcount())))) {
+        return {{Rulepack::load_from_file(path)}, nullptr};
+    }
+
+    file.seekg(0);
+    std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    try {
+        return load_compiled_rulepacks(data);
+    } catch (const std::runtime_error& e) {
+        throw std::runtime_error("Failed to load compiled rulepack " + path + ": " + e.what());
+    }
+}
+
+} // namespace
+
+RuleEngine::RuleEngine() : snapshot_(std::make_shared<const Snapshot>()) {}
+
+void RuleEngine::publish(std::vector<Rulepack> rulepacks, std::vector<std::string> paths,
+                         std::shared_ptr<const RuleMatcher> matcher) {
+    auto next = std::make_shared<Snapshot>();
+    next->rulepacks = std::move(rulepacks);
+    next->paths = std::move(paths);
+    next->matcher = matcher ? std::move(matcher)
+                            : std::make_shared<const RuleMatcher>(next->rulepacks);
+    for (const auto& rulepack : next->rulepacks) {
+        for (const auto& prefix : rulepack.environment_prefixes) {
+            auto& prefixes = next->environment_prefixes;
+            if (std::find(prefixes.begin(), prefixes.end(), prefix) == prefixes.end()) {
+                prefixes.push_back(prefix);
+            }
+        }
+    }
+    next->generation = snapshot()->generation + 1;
+    std::atomic_store(&snapshot_, std::shared_ptr<const Snapshot>(std::move(next)));
+}
+
 void RuleEngine::add_rulepack(const Rulepack& rulepack) {
-    rulepacks_.push_back(rulepack);
+    std::lock_guard<std::mutex> lock(publish_mutex_);
+    auto current = snapshot();
+    auto rulepacks = current->rulepacks;
+    auto paths = current->paths;
+    rulepacks.push_back(rulepack);
+    paths.emplace_back();
+    publish(std::move(rulepacks), std::move(paths));
 }
 
 void RuleEngine::load_rulepack(const std::string& path) {
-    auto rulepack = Rulepack::load_from_file(path);
-    add_rulepack(rulepack);
+    auto loaded = read_rulepack_file(path);
+    append(std::move(loaded.rulepacks), path, std::move(loaded.matcher));
+}
+
+void RuleEngine::load_compiled(std::string_view data) {
+    auto loaded = load_compiled_rulepacks(data);
+    append(std::move(loaded.rulepacks), "", std::move(loaded.matcher));
+}
+
+void RuleEngine::append(std::vector<Rulepack> added, const std::string& path,
+                        std::shared_ptr<const RuleMatcher> matcher) {
+    std::lock_guard<std::mutex> lock(publish_mutex_);
+    auto current = snapshot();
+    if (!current->rulepacks.empty()) {
+        matcher = nullptr;  // Built for the added rulepacks alone
+    }
+    auto rulepacks = current->rulepacks;
+    auto paths = current->paths;
+    for (auto& rulepack : added) {
+        rulepacks.push_back(std::move(rulepack));
+        paths.push_back(path);
+    }
+    publish(std::move(rulepacks), std::move(paths), std::move(matcher));
+}
+
+void RuleEngine::reload() {
+    std::lock_guard<std::mutex> lock(publish_mutex_);
+    auto current = snapshot();
+    std::vector<Rulepack> rulepacks;
+    std::vector<std::string> paths;
+    for (size_t i = 0; i < current->rulepacks.size(); i++) {
+        const auto& path = current->paths[i];
+        if (path.empty()) {
+            rulepacks.push_back(current->rulepacks[i]);
+            paths.emplace_back();
+        } else if (i == 0 || current->paths[i - 1] != path) {
+            // A compiled file's rulepacks are adjacent and share its path;
+            // read it once, however many it holds now
+            for (auto& rulepack : read_rulepack_file(path).rulepacks) {
+                rulepacks.push_back(std::move(rulepack));
+                paths.push_back(path);
+            }
+        }
+    }
+    publish(std::move(rulepacks), std::move(paths));
+}
+
+std::shared_ptr<const RuleEngine::Snapshot> RuleEngine::snapshot() const {
+    return std::atomic_load(&snapshot_);
+}
+
+std::vector<std::string> RuleEngine::environment_prefixes() const {
+    return snapshot()->environment_prefixes;
+}
+
+std::vector<Rulepack> RuleEngine::rulepacks() const {
+    return snapshot()->rulepacks;
 }
 
 void RuleEngine::apply(Candidate& candidate) const {
-    for (const auto& rulepack : rulepacks_) {
-        rulepack.apply(candidate);
+    auto current = snapshot();
+    if (current->matcher) {
+        current->matcher->apply(candidate);
+    }
+}
+
+void RuleEngine::apply(std::vector<Candidate>& candidates) const {
+    auto current = snapshot();
+    if (current->matcher) {
+        current->matcher->apply_batch(candidates);
     }
 }
 
@@ -0,0 +1,169 @@
+// Precompiled rulepack files
+
+#include <kyros/rulepack_binary.hpp>
+
+#include <kyros/utils/binary_io.hpp>
+
+#include <cstring>
+#include <stdexcept>
+
+namespace kyros {
+
+namespace {
+
+constexpr size_t kMagicSize = sizeof(kCompiledRulepackMagic);
+
+// Smallest encoding of each element, for BinaryReader::count()
+constexpr size_t kMinRulepackSize = 4 * 4 + 4;
+constexpr size_t kMinRuleSize = 4 * 4;
+constexpr size_t kMinMatchSize = 1 + 4;
+constexpr size_t kMinActionSize = 1 + 4 * 6 + 8 * 5;
+
+template <typename Enum>
+Enum read_enum(BinaryReader& in, Enum last) {
+    uint8_t value = in.u8();
+    if (value > static_cast<uint8_t>(last)) {
+        throw std::runtime_error("Invalid compiled rulepack: unknown enum value");
+    }
+    return static_cast<Enum>(value);
+}
+
+void write_action(BinaryWriter& out, const RuleAction& action) {
+    out.u8(static_cast<uint8_t>(action.type));
+    out.str(action.evidence_type);
+    out.str(action.evidence_description);
+    out.f64(action.evidence_confidence);
+    out.str(action.evidence_source);
+    out.f64(action.boost_factor);
+    out.f64(action.minimum_confidence);
+    out.str(action.tag);
+    out.str(action.negative_evidence_type);
+    out.str(action.negative_evidence_description);
+    out.f64(action.negative_evidence_confidence);
+    out.f64(action.maximum_confidence);
+}
+
+RuleAction read_action(BinaryReader& in) {
+    RuleAction action;
+    action.type = read_enum(in, RuleAction::Type::Exclude);
+    action.evidence_type = in.str();
+    action.evidence_description = in.str();
+    action.evidence_confidence = in.f64();
+    action.evidence_source = in.str();
+    action.boost_factor = in.f64();
+    action.minimum_confidence = in.f64();
+    action.tag = in.str();
+    action.negative_evidence_type = in.str();
+    action.negative_evidence_description = in.str();
+    action.negative_evidence_confidence = in.f64();
+    action.maximum_confidence = in.f64();
+    return action;
+}
+
+void write_rulepack(BinaryWriter& out, const Rulepack& rulepack) {
+    out.str(rulepack.name);
+    out.str(rulepack.version);
+    out.str(rulepack.description);
+    out.u32(static_cast<uint32_t>(rulepack.environment_prefixes.size()));
+    for (const auto& prefix : rulepack.environment_prefixes) {
+        out.str(prefix);
+    }
+    out.u32(static_cast<uint32_t>(rulepack.rules.size()));
+    for (const auto& rule : rulepack.rules) {
+        out.str(rule.name);
+        out.str(rule.description);
+        out.u32(static_cast<uint32_t>(rule.match_conditions.size()));
+        for (const auto& match : rule.match_conditions) {
+            out.u8(static_cast<uint8_t>(match.type));
+            out.str(match.value);
+        }
+        out.u32(static_cast<uint32_t>(rule.actions.size()));
+        for (const auto& action : rule.actions) {
+            write_action(out, action);
+        }
+    }
+}
+
+Rulepack read_rulepack(BinaryReader& in) {
+    Rulepack rulepack;
+    rulepack.name = in.str();
+    rulepack.version = in.str();
+    rulepack.description = in.str();
+    for (uint32_t n = in.count(4); n > 0; n--) {
+        rulepack.environment_prefixes.push_back(in.str());
+    }
+    for (uint32_t n = in.count(kMinRuleSize); n > 0; n--) {
+        Rule rule;
+        rule.name = in.str();
+        rule.description = in.str();
+        for (uint32_t m = in.count(kMinMatchSize); m > 0; m--) {
+            RuleMatch match;
+            match.type = read_enum(in, RuleMatch::Type::ParentProcess);
+            match.value = in.str();
+            rule.match_conditions.push_back(std::move(match));
+        }
+        for (uint32_t a = in.count(kMinActionSize); a > 0; a--) {
+            rule.actions.push_back(read_action(in));
+        }
+        rulepack.rules.push_back(std::move(rule));
+    }
+    return rulepack;
+}
+
+} // namespace
+
+bool is_compiled_rulepack(std::string_view data) {
+    return data.size() >= kMagicSize &&
+           std::memcmp(data.data(), kCompiledRulepackMagic, kMagicSize) == 0;
+}
+
+std::string compile_rulepacks(const std::vector<Rulepack>& rulepacks) {
+    std::string data;
+    BinaryWriter out(data);
+    out.bytes(std::string_view(kCompiledRulepackMagic, kMagicSize));
+    out.u32(kCompiledRulepackVersion);
+    out.u32(static_cast<uint32_t>(rulepacks.size()));
+    for (const auto& rulepack : rulepacks) {
+        write_rulepack(out, rulepack);
+    }
+    RuleMatcher(rulepacks).write_tables(out);
+    return data;
+}
+
+std::string compile_rulepack_files(const std::vector<std::string>& paths) {
+    std::vector<Rulepack> rulepacks;
+    for (const auto& path : paths) {
+        rulepacks.push_back(Rulepack::load_from_file(path));
+    }
+    return compile_rulepacks(rulepacks);
+}
+
+CompiledRulepacks load_compiled_rulepacks(std::string_view data) {
+    if (!is_compiled_rulepack(data)) {
+        throw std::runtime_error("Not a compiled rulepack");
+    }
+    BinaryReader in(data.substr(kMagicSize));
+    uint32_t version = in.u32();
+    if (version != kCompiledRulepackVersion) {
+        throw std::runtime_error("Unsupported compiled rulepack version " +
+                                 std::to_string(version) + " (expected " +
+                                 std::to_string(kCompiledRulepackVersion) + ")");
+    }
+
+    CompiledRulepacks compiled;
+    for (uint32_t n = in.count(kMinRulepackSize); n > 0; n--) {
+        compiled.rulepacks.push_back(read_rulepack(in));
+    }
+    try {
+        compiled.matcher = std::make_shared<const RuleMatcher>(compiled.rulepacks, in);
+    } catch (const std::logic_error& e) {
+        // std::stoi on a port_equals value that is not a number
+        throw std::runtime_error("Invalid compiled rulepack: " + std::string(e.what()));
+    }
+    if (in.remaining() != 0) {
+        throw std::runtime_error("Invalid compiled rulepack: trailing data");
+    }
+    return compiled;
+}
+
+} // namespace kyros
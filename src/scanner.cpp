@@ -1,5 +1,7 @@
 #include <kyros/scanner.hpp>
 #include <kyros/rulepack.hpp>
+#include <kyros/rule_matcher.hpp>
+#include <kyros/rulepack_binary.hpp>
 #include <kyros/detection/detection_engine.hpp>
 #include <kyros/detection/config_detection_engine.hpp>
 #include <kyros/detection/process_detection_engine.hpp>
@@ -8,19 +10,29 @@
 #include <kyros/testing/stdio_testing_engine.hpp>
 #include <kyros/testing/http_testing_engine.hpp>
 #include <kyros/testing/server_interrogator.hpp>
+#include <kyros/testing/preflight.hpp>
 #include <kyros/reporting/reporting_engine.hpp>
 #include <kyros/reporting/cli_reporter.hpp>
 #include <kyros/reporting/json_reporter.hpp>
 #include <kyros/reporting/html_reporter.hpp>
 #include <kyros/reporting/csv_reporter.hpp>
 #include <kyros/platform/platform_adapter.hpp>
+#include <kyros/probe_cache.hpp>
+#include <kyros/latency_tracker.hpp>
 #include <kyros/scan_types/config_scan.hpp>
 #include <kyros/http/http_client.hpp>
+#include <kyros/utils/parallel.hpp>
 
+#include <atomic>
 #include <chrono>
 #include <algorithm>
 #include <iostream>
 #include <filesystem>
+#include <iterator>
+#include <optional>
+#include <thread>
+#include <unordered_map>
+#include <utility>
 
 namespace kyros {
 
@@ -72,6 +84,10 @@ namespace {
             }
         }
     }
+
+    // How long the rulepack watch thread blocks per poll, which bounds how
+    // long stopping it takes
+    constexpr int kRulepackPollMs = 200;
 }
 
 // Scanner::Impl - Private implementation
@@ -165,6 +181,10 @@ const ReportingEngine& Scanner::reporting_engine() const {
     return *impl_->reporting_engine;
 }
 
+bool Scanner::wait_for_config_changes(int timeout_ms) {
+    return impl_->passive_scanner.wait_for_config_changes(timeout_ms);
+}
+
 void Scanner::set_platform_adapter(std::shared_ptr<PlatformAdapter> adapter) {
     impl_->platform_adapter = adapter;
 }
@@ -177,13 +197,120 @@ void Scanner::load_default_rulepacks() {
     impl_->passive_scanner.load_default_rulepacks();
 }
 
+bool Scanner::reload_rulepacks() {
+    return impl_->passive_scanner.reload_rulepacks();
+}
+
 // PassiveScanner
 PassiveScanner::PassiveScanner() : rule_engine_(std::make_unique<RuleEngine>()) {
     // Load default rulepacks on initialization
     load_default_rulepacks();
 }
+
+struct PassiveScanner::RulepackWatch {
+    std::unique_ptr<FileWatcher> watcher;
+    std::atomic<bool> stop{false};
+    std::thread thread;
+
+    ~RulepackWatch() {
+        stop = true;
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+};
+
 PassiveScanner::~PassiveScanner() = default;
 
+void PassiveScanner::set_rulepack_watch(bool enabled) {
+    if (!enabled) {
+        rulepack_watch_.reset();
+        return;
+    }
+    if (rulepack_watch_ || !platform_) {
+        return;
+    }
+    auto watcher = platform_->create_file_watcher();
+    if (!watcher) {
+        return;  // Unsupported here; reload_rulepacks() still works
+    }
+
+    auto watch = std::make_unique<RulepackWatch>();
+    watch->watcher = std::move(watcher);
+    watch->thread = std::thread([this, watch = watch.get()] {
+        uint64_t watched_generation = 0;
+        std::vector<std::string> files;
+        std::vector<std::string> directories;  // Of `files`, without duplicates
+        std::vector<std::string> unwatched;    // Not (or no longer) watched
+        std::vector<std::string> lost;         // Unwatched after being removed
+        while (!watch->stop) {
+            // Watch the directories of files added since the last pass
+            auto rules = rule_engine_->snapshot();
+            if (rules->generation != watched_generation) {
+                files.clear();
+                directories.clear();
+                for (const auto& path : rules->paths) {
+                    if (path.empty()) {
+                        continue;
+                    }
+                    auto file = std::filesystem::absolute(path).lexically_normal();
+                    std::string directory = file.parent_path().string();
+                    if (std::find(directories.begin(), directories.end(), directory) ==
+                        directories.end()) {
+                        directories.push_back(directory);
+                    }
+                    files.push_back(file.string());
+                }
+                unwatched = directories;
+                lost.clear();
+                watched_generation = rules->generation;
+            }
+
+            // A directory that was removed, or whose watch failed, is
+            // retried every pass. One that comes back may hold new
+            // rulepacks written while it was not watched.
+            bool affected = false;
+            for (auto it = unwatched.begin(); it != unwatched.end();) {
+                if (!watch->watcher->watch_directory(*it)) {
+                    ++it;
+                    continue;
+                }
+                auto was_lost = std::find(lost.begin(), lost.end(), *it);
+                if (was_lost != lost.end()) {
+                    lost.erase(was_lost);
+                    affected = true;
+                }
+                it = unwatched.erase(it);
+            }
+
+            if (unwatched.size() == directories.size()) {
+                // Nothing is watched, so there is nothing to poll (and a
+                // watcher that cannot watch may not block in poll())
+                std::this_thread::sleep_for(std::chrono::milliseconds(kRulepackPollMs));
+                continue;
+            }
+
+            std::vector<std::string> changed;
+            affected = !watch->watcher->poll(changed, kRulepackPollMs) || affected;
+            for (const auto& path : changed) {
+                affected = affected || std::find(files.begin(), files.end(), path) != files.end();
+                if (std::find(directories.begin(), directories.end(), path) != directories.end() &&
+                    std::find(unwatched.begin(), unwatched.end(), path) == unwatched.end()) {
+                    // The directory itself was removed or replaced, which
+                    // ends its watch (IN_IGNORED); watch it again
+                    unwatched.push_back(path);
+                    lost.push_back(path);
+                    affected = true;
+                }
+            }
+            if (affected && !watch->stop) {
+                reload_rulepacks();
+            }
+        }
+    });
+    rulepack_watch_ = std::move(watch);
+}
+
 PassiveScanResults PassiveScanner::scan(const PassiveScanConfig& config) {
     auto start_time = std::chrono::system_clock::now();
     PassiveScanResults results;
@@ -194,47 +321,101 @@ PassiveScanResults PassiveScanner::scan(const PassiveScanConfig& config) {
         initialize_engines();
     }
 
-    // Run all detection engines
-    for (auto& engine : engines_) {
+    // The whole scan uses the rules current now, even if a reload swaps in
+    // new ones while it runs
+    set_rulepack_watch(config.watch_rulepacks);
+    auto rules = rule_engine_->snapshot();
+
+    // Take one process snapshot for the whole scan so every engine resolves
+    // names, command lines and parents from the same table
+    std::shared_ptr<const ProcessTable> snapshot;
+    if (platform_) {
         try {
-            auto candidates = engine->detect();
+            snapshot = platform_->snapshot_processes();
+        } catch (const std::exception& e) {
+            results.errors.push_back(std::string("Error taking process snapshot: ") + e.what());
+        }
+    }
+    for (auto& engine : engines_) {
+        engine->set_process_snapshot(snapshot);
 
-            // Apply rulepacks before filtering
-            for (auto& candidate : candidates) {
-                rule_engine_->apply(candidate);
-            }
+        if (auto* config_engine = dynamic_cast<ConfigDetectionEngine*>(engine.get())) {
+            config_engine->set_watch_mode(config.watch_configs);
+        }
+        if (auto* process_engine = dynamic_cast<ProcessDetectionEngine*>(engine.get())) {
+            process_engine->set_environment_prefixes(rules->environment_prefixes);
+        }
+    }
 
-            // Filter by confidence threshold
-            for (auto& candidate : candidates) {
-                if (candidate.confidence_score >= config.min_confidence) {
-                    results.candidates.push_back(std::move(candidate));
-                }
-            }
+    // Run all detection engines. They are independent and mostly wait on
+    // I/O, so each gets its own thread; outputs go into per-engine slots
+    // and are merged in engine order, so results don't depend on which
+    // engine finishes first.
+    struct EngineOutput {
+        std::vector<Candidate> candidates;
+        std::string error;
+    };
+    std::vector<EngineOutput> outputs(engines_.size());
 
-            // Update statistics
-            if (engine->name() == "ConfigDetectionEngine") {
-                auto* config_engine = dynamic_cast<ConfigDetectionEngine*>(engine.get());
-                if (config_engine) {
-                    results.config_files_checked += config_engine->get_last_scan_config_count();
-                }
-            } else if (engine->name() == "ProcessDetectionEngine") {
-                auto* process_engine = dynamic_cast<ProcessDetectionEngine*>(engine.get());
-                if (process_engine) {
-                    results.processes_scanned += process_engine->get_last_scan_process_count();
-                }
-            } else if (engine->name() == "NetworkDetectionEngine") {
-                auto* network_engine = dynamic_cast<NetworkDetectionEngine*>(engine.get());
-                if (network_engine) {
-                    results.network_sockets_checked += network_engine->get_last_scan_socket_count();
-                }
-            }
+    parallel_for(engines_.size(), config.parallel_engines ? engines_.size() : 1, [&](size_t i) {
+        auto& engine = engines_[i];
+        try {
+            outputs[i].candidates = engine->detect();
         } catch (const std::exception& e) {
             // Continue on error - don't fail entire scan
-            std::string error_msg = std::string("Error in ") + engine->name() + ": " + e.what();
-            results.errors.push_back(error_msg);
+            outputs[i].error = std::string("Error in ") + engine->name() + ": " + e.what();
+        }
+    });
+
+    // Apply rulepacks to every engine's candidates in one batch, before
+    // filtering
+    std::vector<Candidate> detected;
+    for (auto& output : outputs) {
+        std::move(output.candidates.begin(), output.candidates.end(),
+                  std::back_inserter(detected));
+    }
+    if (rules->matcher) {
+        rules->matcher->apply_batch(detected);
+    }
+    for (auto& candidate : detected) {
+        if (candidate.confidence_score >= config.min_confidence) {
+            results.candidates.push_back(std::move(candidate));
         }
     }
 
+    for (size_t i = 0; i < engines_.size(); i++) {
+        auto& engine = engines_[i];
+        auto& output = outputs[i];
+
+        if (!output.error.empty()) {
+            results.errors.push_back(std::move(output.error));
+            continue;
+        }
+
+        // Update statistics
+        if (engine->name() == "ConfigDetectionEngine") {
+            auto* config_engine = dynamic_cast<ConfigDetectionEngine*>(engine.get());
+            if (config_engine) {
+                results.config_files_checked += config_engine->get_last_scan_config_count();
+            }
+        } else if (engine->name() == "ProcessDetectionEngine") {
+            auto* process_engine = dynamic_cast<ProcessDetectionEngine*>(engine.get());
+            if (process_engine) {
+                results.processes_scanned += process_engine->get_last_scan_process_count();
+            }
+        } else if (engine->name() == "NetworkDetectionEngine") {
+            auto* network_engine = dynamic_cast<NetworkDetectionEngine*>(engine.get());
+            if (network_engine) {
+                results.network_sockets_checked += network_engine->get_last_scan_socket_count();
+            }
+        }
+    }
+
+    // Don't keep the snapshot alive between scans
+    for (auto& engine : engines_) {
+        engine->set_process_snapshot(nullptr);
+    }
+
     // Deduplicate candidates
     deduplicate_candidates(results.candidates);
 
@@ -258,6 +439,22 @@ PassiveScanResults PassiveScanner::scan(const PassiveScanConfig& config) {
     return results;
 }
 
+bool PassiveScanner::wait_for_config_changes(int timeout_ms) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    for (auto& engine : engines_) {
+        if (auto* config_engine = dynamic_cast<ConfigDetectionEngine*>(engine.get())) {
+            if (config_engine->wait_for_changes(timeout_ms)) {
+                return true;
+            }
+        }
+    }
+
+    // Not watching (or no FileWatcher here): wait_for_changes() returned
+    // at once, so sit out the rest of the timeout
+    std::this_thread::sleep_until(deadline);
+    return false;
+}
+
 void PassiveScanner::set_platform_adapter(std::shared_ptr<PlatformAdapter> adapter) {
     platform_ = adapter;
 }
@@ -297,41 +494,100 @@ void PassiveScanner::load_rulepack(const std::string& path) {
     }
 }
 
+bool PassiveScanner::reload_rulepacks() {
+    try {
+        rule_engine_->reload();
+    } catch (const std::exception& e) {
+        std::cerr << "Warning: Failed to reload rulepacks, keeping the current ones: " << e.what()
+                  << "\n";
+        return false;
+    }
+    return true;
+}
+
 void PassiveScanner::load_default_rulepacks() {
-    // Try to load default detection rulepack from common locations
-    std::vector<std::string> default_rulepack_paths = {
-        "config/rulepacks/default.json",
-        "./config/rulepacks/default.json",
-        "../config/rulepacks/default.json",
-        "/usr/local/share/kyros/rulepacks/default.json",
-        "/usr/share/kyros/rulepacks/default.json"
+    // Each default rulepack comes from the first location that has it,
+    // compiled (.kyrb) or JSON, so an installed copy can be edited and is
+    // watched and reloaded like any other rulepack file. The copy embedded
+    // at build time (KYROS_EMBED_RULEPACKS, in this order) stands in for
+    // one found nowhere, or one that fails to load.
+    const std::vector<std::string> names = {"default", "exclusions"};
+    const std::vector<std::string> directories = {
+        "config/rulepacks",
+        "./config/rulepacks",
+        "../config/rulepacks",
+        "/usr/local/share/kyros/rulepacks",
+        "/usr/share/kyros/rulepacks"
+    };
+
+    // Stop probing a name at its first hit: every exists() is a stat on
+    // the startup path
+    auto locate = [&](const std::string& name) -> std::string {
+        for (const auto& directory : directories) {
+            for (const char* extension : {".kyrb", ".json"}) {
+                std::string path = directory + "/" + name + extension;
+                if (std::filesystem::exists(path)) {
+                    return path;
+                }
+            }
+        }
+        return {};
     };
 
-    for (const auto& path : default_rulepack_paths) {
-        if (std::filesystem::exists(path)) {
-            load_rulepack(path);
-            break;  // Load only the first found default rulepack
+    std::vector<std::string> found(names.size());
+    for (size_t n = 0; n < names.size(); n++) {
+        found[n] = locate(names[n]);
+    }
+
+    std::string_view embedded = embedded_rulepacks();
+    bool none_found = std::all_of(found.begin(), found.end(),
+                                  [](const std::string& path) { return path.empty(); });
+    if (!embedded.empty() && none_found) {
+        // Nothing on disk: the embedded file as it is, with its tables
+        try {
+            rule_engine_->load_compiled(embedded);
+        } catch (const std::exception& e) {
+            std::cerr << "Warning: Failed to load embedded rulepacks: " << e.what() << "\n";
         }
+        return;
     }
 
-    // Try to load exclusion rulepack from common locations
-    std::vector<std::string> exclusion_rulepack_paths = {
-        "config/rulepacks/exclusions.json",
-        "./config/rulepacks/exclusions.json",
-        "../config/rulepacks/exclusions.json",
-        "/usr/local/share/kyros/rulepacks/exclusions.json",
-        "/usr/share/kyros/rulepacks/exclusions.json"
+    std::optional<CompiledRulepacks> fallback;
+    auto load_embedded = [&](size_t n) {
+        try {
+            if (!fallback && !embedded.empty()) {
+                fallback = load_compiled_rulepacks(embedded);
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "Warning: Failed to load embedded rulepacks: " << e.what() << "\n";
+            embedded = {};
+        }
+        if (fallback && n < fallback->rulepacks.size()) {
+            rule_engine_->add_rulepack(fallback->rulepacks[n]);
+        }
     };
 
-    for (const auto& path : exclusion_rulepack_paths) {
-        if (std::filesystem::exists(path)) {
-            load_rulepack(path);
-            break;  // Load only the first found exclusion rulepack
+    for (size_t n = 0; n < names.size(); n++) {
+        if (found[n].empty()) {
+            load_embedded(n);
+            continue;
+        }
+        try {
+            rule_engine_->load_rulepack(found[n]);
+        } catch (const std::exception& e) {
+            std::cerr << "Warning: Failed to load rulepack " << found[n] << ": " << e.what() << "\n";
+            load_embedded(n);
         }
     }
 }
 
 // ActiveScanner
+struct ActiveScanner::ProbeWorker {
+    std::shared_ptr<HttpClient> http_client;
+    std::vector<std::unique_ptr<TestingEngine>> testing_engines;
+    std::unique_ptr<ServerInterrogator> interrogator;
+};
+
 ActiveScanner::ActiveScanner() {}
 ActiveScanner::~ActiveScanner() = default;
 
@@ -343,20 +599,9 @@ ActiveScanResults ActiveScanner::scan(
     results.scan_timestamp = start_time;
     results.candidates_tested = candidates;
 
-    // Initialize engines if not done yet
-    if (testing_engines_.empty()) {
-        initialize_engines();
-    }
-
-    // Set timeout for all testing engines
-    auto timeout = std::chrono::milliseconds(config.probe_timeout_ms);
-    for (auto& engine : testing_engines_) {
-        engine->set_timeout(timeout);
-    }
-
-    // Test each candidate
+    // Drop candidates in the skip lists up front
+    std::vector<const Candidate*> to_test;
     for (const auto& candidate : candidates) {
-        // Skip if in skip lists
         if (candidate.pid > 0 &&
             std::find(config.skip_pids.begin(), config.skip_pids.end(),
                      candidate.pid) != config.skip_pids.end()) {
@@ -367,40 +612,258 @@ ActiveScanResults ActiveScanner::scan(
                      candidate.url) != config.skip_urls.end()) {
             continue;
         }
+        to_test.push_back(&candidate);
+    }
 
-        bool confirmed = false;
-        results.candidates_tested_count++;
+    // One worker per concurrent probe, each with its own engines; kept
+    // between scans
+    size_t worker_count = parallel_worker_count(
+        to_test.size(), static_cast<size_t>(std::max(config.max_parallel_probes, 1)));
+    while (workers_.size() < worker_count) {
+        workers_.push_back(create_worker());
+    }
+
+    // Size each candidate's deadline and hedge point from the latencies
+    // and timeouts of earlier scans; probe_timeout_ms is the ceiling. A
+    // probe still unanswered at its hedge point is sent again by engines
+    // that can, and the first answer wins.
+    auto timeout = std::chrono::milliseconds(config.probe_timeout_ms);
+    using DeadlineMap = std::unordered_map<const Candidate*, std::chrono::milliseconds>;
+    auto deadlines = std::make_shared<DeadlineMap>();
+    auto hedge_points = std::make_shared<DeadlineMap>();
+    if (config.adaptive_timeouts) {
+        if (!latency_ || latency_->path() != config.latency_history_path) {
+            latency_ = std::make_unique<LatencyTracker>(config.latency_history_path);
+            latency_->load();
+        }
+        LatencyTracker::DeadlinePolicy policy;
+        policy.floor = std::chrono::milliseconds(config.min_probe_timeout_ms);
+        policy.ceiling = timeout;
+        policy.headroom = config.latency_headroom;
+        for (const Candidate* candidate : to_test) {
+            (*deadlines)[candidate] = latency_->deadline(*candidate, policy);
+            auto hedge = latency_->hedge_point(*candidate, policy);
+            if (hedge.count() > 0) {
+                (*hedge_points)[candidate] = hedge;
+            }
+        }
+    }
+    TestingEngine::TimeoutFunction deadline_for;
+    if (!deadlines->empty()) {
+        deadline_for = [deadlines, timeout](const Candidate& candidate) {
+            auto it = deadlines->find(&candidate);
+            return it == deadlines->end() ? timeout : it->second;
+        };
+    }
+    TestingEngine::TimeoutFunction hedge_for;
+    if (!hedge_points->empty()) {
+        hedge_for = [hedge_points](const Candidate& candidate) {
+            auto it = hedge_points->find(&candidate);
+            return it == hedge_points->end() ? std::chrono::milliseconds(0) : it->second;
+        };
+    }
+
+    // Set timeouts for all testing engines, and have them keep the
+    // confirming connection when it will be interrogated
+    bool interrogate = config.interrogate && config.interrogation_config.interrogate_enabled;
+    for (auto& worker : workers_) {
+        for (auto& engine : worker->testing_engines) {
+            engine->set_timeout(timeout);
+            engine->set_timeout_function(deadline_for);
+            engine->set_hedge_function(hedge_for);
+            engine->set_keep_sessions(interrogate);
+        }
+    }
+
+    // Outcome of each probe, by candidate position
+    struct ProbeOutcome {
+        std::optional<MCPServer> server;
+        std::string error;
+        bool cached = false;
+        std::optional<std::chrono::milliseconds> latency;  // Of the confirming probe
+        bool timed_out = false;  // A probe ran out of its deadline
+        bool hedged = false;     // A probe was sent again at its hedge point
+        bool filtered = false;   // Dropped by the preflight; not probed
+    };
+    std::vector<ProbeOutcome> outcomes(to_test.size());
+
+    // Take outcomes for unchanged targets from the probe cache. A cached
+    // server only counts if it was interrogated whenever we interrogate.
+    // A refresh ignores the entries but still loads them, so the entries
+    // of targets it does not probe survive the save.
+    std::optional<ProbeCache> cache;
+    std::vector<std::string> fingerprints(to_test.size());
+    if (!config.probe_cache_path.empty()) {
+        cache.emplace(config.probe_cache_path,
+                      std::chrono::seconds(config.probe_cache_ttl_seconds),
+                      std::chrono::seconds(config.probe_cache_failure_ttl_seconds));
+        cache->load();
+
+        std::shared_ptr<const ProcessTable> processes;
+        if (platform_) {
+            processes = platform_->snapshot_processes();
+        }
+        for (size_t i = 0; i < to_test.size(); i++) {
+            const Candidate& candidate = *to_test[i];
+            uint64_t owner_start_time = 0;
+            if (processes && candidate.pid > 0) {
+                if (auto row = processes->find(candidate.pid)) {
+                    owner_start_time = processes->start_time(*row);
+                }
+            }
+            fingerprints[i] = ProbeCache::fingerprint(candidate, owner_start_time);
+
+            const ProbeCache::Entry* entry =
+                fingerprints[i].empty() || config.refresh_probe_cache
+                    ? nullptr : cache->find(fingerprints[i], start_time);
+            if (!entry || (entry->confirmed && interrogate && !entry->interrogated)) {
+                continue;
+            }
+            outcomes[i].cached = true;
+            if (entry->confirmed) {
+                outcomes[i].server = *entry->server;
+                outcomes[i].server->candidate = candidate;
+            } else {
+                outcomes[i].error = entry->error;
+            }
+        }
+    }
+
+    // Of the rest, drop listeners that cannot be MCP over HTTP before any
+    // handshake; they fail with the preflight's reason
+    if (config.preflight) {
+        std::vector<const Candidate*> unchecked;
+        std::vector<size_t> positions;
+        for (size_t i = 0; i < to_test.size(); i++) {
+            if (!outcomes[i].cached) {
+                unchecked.push_back(to_test[i]);
+                positions.push_back(i);
+            }
+        }
+        Preflight preflight(std::chrono::milliseconds(config.preflight_timeout_ms));
+        auto reasons = preflight.check(unchecked);
+        for (size_t j = 0; j < reasons.size() && j < positions.size(); j++) {
+            if (reasons[j].empty()) {
+                continue;
+            }
+            ProbeOutcome& outcome = outcomes[positions[j]];
+            outcome.filtered = true;
+            outcome.error = "Not probed (url: " + unchecked[j]->url + ") - Preflight: " +
+                            reasons[j];
+            results.preflight_filtered_count++;
+        }
+    }
+
+    auto interrogator_for = [&](ProbeWorker& worker) -> ServerInterrogator& {
+        if (!worker.interrogator) {
+            worker.interrogator = std::make_unique<ServerInterrogator>(
+                config.interrogation_config,
+                platform_,
+                worker.http_client
+            );
+        }
+        return *worker.interrogator;
+    };
+
+    // Engines that overlap probes themselves (stdio through the platform's
+    // probe reactor) get every candidate at once, from worker 0's
+    // instance, before the per-candidate pass. They interrogate each
+    // server as it is confirmed, with the workers' interrogators, while
+    // the rest of the batch is still being probed.
+    std::vector<bool> batched(workers_.empty() ? 0 : workers_[0]->testing_engines.size(), false);
+    for (size_t e = 0; e < batched.size(); e++) {
+        auto& engine = workers_[0]->testing_engines[e];
+        if (!engine->prefers_batch()) {
+            continue;
+        }
+        batched[e] = true;
+
+        std::vector<const Candidate*> pending;
+        std::vector<size_t> positions;
+        for (size_t i = 0; i < to_test.size(); i++) {
+            if (!outcomes[i].server && !outcomes[i].cached && !outcomes[i].filtered) {
+                pending.push_back(to_test[i]);
+                positions.push_back(i);
+            }
+        }
+
+        TestingEngine::SessionHandler handler;
+        if (interrogate) {
+            handler = [&](MCPServer& server, size_t thread) {
+                interrogator_for(*workers_[thread]).interrogate(server);
+            };
+        }
+        engine->set_session_handler(std::move(handler), worker_count);
+
+        try {
+            std::vector<TestingEngine::ProbeTiming> timings;
+            auto servers = engine->test_batch(pending, &timings);
+            for (size_t j = 0; j < servers.size() && j < positions.size(); j++) {
+                ProbeOutcome& outcome = outcomes[positions[j]];
+                if (j < timings.size()) {
+                    outcome.hedged = timings[j].hedged;
+                }
+                if (servers[j]) {
+                    outcome.server = std::move(servers[j]);
+                    if (j < timings.size()) {
+                        outcome.latency = timings[j].elapsed;
+                    }
+                } else if (j < timings.size() && timings[j].timed_out) {
+                    outcome.timed_out = true;
+                }
+            }
+        } catch (const std::exception& e) {
+            results.errors.push_back(std::string(engine->name()) + ": " + e.what());
+        }
+    }
+
+    parallel_for_workers(to_test.size(), worker_count, [&](size_t index, size_t worker_index) {
+        const Candidate& candidate = *to_test[index];
+        ProbeWorker& worker = *workers_[worker_index];
+        ProbeOutcome& outcome = outcomes[index];
         std::vector<std::string> engine_errors;
+        if (outcome.cached || outcome.filtered) {
+            return;
+        }
 
-        // Try each testing engine
-        for (auto& engine : testing_engines_) {
+        // Try each testing engine (a batched engine may already have
+        // confirmed the candidate)
+        for (size_t e = 0; e < worker.testing_engines.size(); e++) {
+            auto& engine = worker.testing_engines[e];
+            bool from_batch = e < batched.size() && batched[e];
+            if (from_batch && !outcome.server) {
+                continue;
+            }
             try {
-                auto server_opt = engine->test(candidate);
+                std::optional<MCPServer> server_opt;
+                if (from_batch) {
+                    server_opt = std::exchange(outcome.server, std::nullopt);
+                } else {
+                    server_opt = engine->test(candidate);
+                    const auto& probe = engine->last_probe();
+                    outcome.hedged = outcome.hedged || probe.hedged;
+                    if (server_opt) {
+                        outcome.latency = probe.elapsed;
+                    } else if (probe.timed_out) {
+                        outcome.timed_out = true;
+                    }
+                }
                 if (server_opt.has_value()) {
                     // Test succeeded!
-                    auto server = server_opt.value();
+                    auto server = std::move(*server_opt);
 
                     // Store the candidate information in the server
                     server.candidate = candidate;
 
-                    // Interrogate the server if enabled
-                    if (config.interrogate && config.interrogation_config.interrogate_enabled) {
-                        // Create interrogator if not already created
-                        if (!interrogator_) {
-                            interrogator_ = std::make_unique<ServerInterrogator>(
-                                config.interrogation_config,
-                                platform_,
-                                http_client_
-                            );
-                        }
-                        // Perform interrogation
-                        interrogator_->interrogate(server);
+                    // Interrogate the server if enabled (and the batch
+                    // has not already)
+                    if (interrogate && !server.interrogation_attempted) {
+                        interrogator_for(worker).interrogate(server);
                     }
+                    server.session.reset();
 
-                    results.confirmed_servers.push_back(std::move(server));
-                    results.servers_confirmed_count++;
-                    confirmed = true;
-                    break;  // Don't try other engines for this candidate
+                    outcome.server = std::move(server);
+                    return;  // Don't try other engines for this candidate
                 }
             } catch (const std::exception& e) {
                 // Collect error for this engine
@@ -408,27 +871,68 @@ ActiveScanResults ActiveScanner::scan(
             }
         }
 
-        // If no engine succeeded, add to failed tests and log errors
-        if (!confirmed) {
-            results.failed_tests.push_back(candidate);
-            if (!engine_errors.empty()) {
-                std::string error_msg = "Failed to test candidate";
-                if (!candidate.command.empty()) {
-                    error_msg += " (command: " + candidate.command + ")";
-                } else if (!candidate.url.empty()) {
-                    error_msg += " (url: " + candidate.url + ")";
-                }
-                error_msg += " - Errors: ";
-                for (size_t i = 0; i < engine_errors.size(); i++) {
-                    if (i > 0) error_msg += "; ";
-                    error_msg += engine_errors[i];
-                }
-                results.errors.push_back(error_msg);
+        // No engine succeeded: describe why
+        if (!engine_errors.empty()) {
+            std::string error_msg = "Failed to test candidate";
+            if (!candidate.command.empty()) {
+                error_msg += " (command: " + candidate.command + ")";
+            } else if (!candidate.url.empty()) {
+                error_msg += " (url: " + candidate.url + ")";
+            }
+            error_msg += " - Errors: ";
+            for (size_t i = 0; i < engine_errors.size(); i++) {
+                if (i > 0) error_msg += "; ";
+                error_msg += engine_errors[i];
+            }
+            outcome.error = std::move(error_msg);
+        }
+    });
+
+    // Merge in candidate order, recording fresh outcomes in the cache
+    for (size_t i = 0; i < to_test.size(); i++) {
+        auto& outcome = outcomes[i];
+        results.candidates_tested_count++;
+
+        if (outcome.hedged) {
+            results.hedged_probes_count++;
+        }
+        if (config.adaptive_timeouts && latency_) {
+            if (outcome.server && outcome.latency) {
+                latency_->record(*to_test[i], *outcome.latency, start_time);
+            } else if (!outcome.server && outcome.timed_out) {
+                latency_->record_timeout(*to_test[i], start_time);
+            }
+        }
+
+        if (outcome.cached) {
+            results.cached_results_count++;
+        } else if (cache && !fingerprints[i].empty()) {
+            if (outcome.server) {
+                cache->store_confirmed(fingerprints[i], *outcome.server, interrogate, start_time);
+            } else {
+                cache->store_failure(fingerprints[i], outcome.error, start_time);
+            }
+        }
+
+        if (outcome.server) {
+            results.confirmed_servers.push_back(std::move(*outcome.server));
+            results.servers_confirmed_count++;
+        } else {
+            results.failed_tests.push_back(*to_test[i]);
+            if (!outcome.error.empty()) {
+                results.errors.push_back(std::move(outcome.error));
             }
             results.tests_failed_count++;
         }
     }
 
+    if (cache) {
+        cache->save();
+    }
+    if (latency_ && config.adaptive_timeouts) {
+        latency_->save();
+    }
+
     // Calculate scan duration
     auto end_time = std::chrono::system_clock::now();
     Duration duration = end_time - start_time;
@@ -439,19 +943,22 @@ ActiveScanResults ActiveScanner::scan(
 
 void ActiveScanner::set_platform_adapter(std::shared_ptr<PlatformAdapter> adapter) {
     platform_ = adapter;
+    workers_.clear();  // Engines hold the adapter they were created with
 }
 
-void ActiveScanner::initialize_engines() {
-    // Create shared HttpClient (used by both HttpTestingEngine and ServerInterrogator)
-    http_client_ = std::make_shared<HttpClient>();
+std::unique_ptr<ActiveScanner::ProbeWorker> ActiveScanner::create_worker() const {
+    auto worker = std::make_unique<ProbeWorker>();
+
+    // HttpClient shared by this worker's HttpTestingEngine and ServerInterrogator
+    worker->http_client = std::make_shared<HttpClient>();
 
     // Create StdioTestingEngine
-    auto stdio_engine = std::make_unique<StdioTestingEngine>(platform_);
-    testing_engines_.push_back(std::move(stdio_engine));
+    worker->testing_engines.push_back(std::make_unique<StdioTestingEngine>(platform_));
 
     // Create HttpTestingEngine
-    auto http_engine = std::make_unique<HttpTestingEngine>(http_client_);
-    testing_engines_.push_back(std::move(http_engine));
+    worker->testing_engines.push_back(std::make_unique<HttpTestingEngine>(worker->http_client));
+
+    return worker;
 }
 
 } // namespace kyros
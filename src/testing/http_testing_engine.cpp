@@ -1,9 +1,13 @@
 #include <kyros/testing/http_testing_engine.hpp>
+#include <kyros/testing/mcp_session.hpp>
+#include <kyros/utils/parallel.hpp>
 
 #include <algorithm>
 #include <cctype>
 #include <chrono>
+#include <condition_variable>
 #include <iostream>
+#include <mutex>
 #include <sstream>
 
 namespace kyros {
@@ -12,6 +16,8 @@ HttpTestingEngine::HttpTestingEngine(std::shared_ptr<HttpClient> http_client)
     : http_client_(http_client) {}
 
 std::optional<MCPServer> HttpTestingEngine::test(const Candidate& candidate) {
+    last_probe_ = ProbeTiming{};
+
     // Check if candidate has a URL
     if (candidate.url.empty()) {
         return std::nullopt;
@@ -27,98 +33,179 @@ std::optional<MCPServer> HttpTestingEngine::test(const Candidate& candidate) {
         return std::nullopt;
     }
 
-    // First, try SSE-based MCP transport
-    auto sse_result = try_sse_transport(candidate);
-    if (sse_result.has_value()) {
-        return sse_result;
+    // Race the SSE transport against direct HTTP POSTs to common MCP
+    // paths. Each variant has its own client; the first to confirm an MCP
+    // server cancels the others, so a candidate costs one timeout rather
+    // than one per variant.
+    //
+    // A variant still unanswered at the candidate's hedge point is sent
+    // again on a fresh connection, with what is left of the timeout, so
+    // one stalled request does not hold up an endpoint that usually
+    // answers quickly. The copy races like any other variant.
+    static const std::vector<std::string> paths_to_try = {"", "/messages", "/rpc"};
+    size_t variant_count = 1 + paths_to_try.size();
+    auto timeout = timeout_for(candidate);
+    auto hedge_after = hedge_for(candidate);
+    bool hedging = hedge_after.count() > 0 && hedge_after < timeout;
+    size_t task_count = hedging ? 2 * variant_count : variant_count;
+    while (variant_clients_.size() < task_count) {
+        variant_clients_.push_back(std::make_unique<HttpClient>());
     }
 
-    // Fall back to trying direct HTTP POST to common MCP paths
-    std::vector<std::string> paths_to_try = {"", "/messages", "/rpc"};
-
-    for (const auto& path : paths_to_try) {
-        std::string test_url = candidate.url + path;
+    auto start = std::chrono::steady_clock::now();
+    auto cancel = std::make_shared<HttpCancelToken>();
+    std::vector<std::optional<MCPServer>> found(task_count);
+    std::vector<char> timed_out(task_count, 0);
+
+    // Copies wait for their variant to settle, a winner, or the hedge point
+    std::mutex mutex;
+    std::condition_variable settled_changed;
+    std::vector<char> settled(variant_count, 0);
+    bool hedged = false;
+
+    parallel_for(task_count, task_count, [&](size_t task) {
+        size_t i = task % variant_count;
+        auto budget = timeout;
+        if (task >= variant_count) {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (settled_changed.wait_for(lock, hedge_after, [&]() {
+                    return settled[i] || cancel->cancelled();
+                })) {
+                return;
+            }
+            hedged = true;
+            budget -= hedge_after;
+        }
 
-        try {
-            // Create the MCP initialize request
-            auto request = create_initialize_request(1);
-            std::string request_body = request.dump();
+        HttpClient& client = *variant_clients_[task];
+        client.set_cancel_token(cancel);
+        bool ran_out = false;
+        found[task] = i == 0 ? try_sse_transport(candidate, client, budget, ran_out)
+                             : try_path(candidate, paths_to_try[i - 1], client, budget, ran_out);
+        client.set_cancel_token(nullptr);
+        timed_out[task] = ran_out;
+        if (found[task]) {
+            cancel->cancel();
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            settled[i] = 1;
+        }
+        settled_changed.notify_all();
+    });
 
-            // Send HTTP POST request to the server
-            auto response = http_client_->post(test_url, request_body, {}, timeout_);
+    // Keep the connections warm for interrogation
+    for (auto& client : variant_clients_) {
+        http_client_->adopt_idle_connections(*client);
+    }
 
-            // Check HTTP status code - accept 200 OK or auth-related responses
-            bool is_success = (response.status_code == 200);
-            bool is_auth_challenge = (response.status_code == 401 || response.status_code == 403);
+    last_probe_.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start);
+    last_probe_.hedged = hedged;
 
-            if (!is_success && !is_auth_challenge) {
-                continue;  // Try next path
+    // Normally only the winner is set; on a tie, SSE and then path order
+    // decide
+    for (size_t i = 0; i < variant_count; i++) {
+        for (size_t task = i; task < task_count; task += variant_count) {
+            if (found[task]) {
+                return std::move(found[task]);
             }
+        }
+    }
+    last_probe_.timed_out =
+        std::find(timed_out.begin(), timed_out.end(), 1) != timed_out.end();
+    return std::nullopt;
+}
+
+std::optional<MCPServer> HttpTestingEngine::try_path(const Candidate& candidate,
+                                                     const std::string& path,
+                                                     HttpClient& client,
+                                                     std::chrono::milliseconds timeout,
+                                                     bool& timed_out) {
+    std::string test_url = candidate.url + path;
+
+    try {
+        // Create the MCP initialize request
+        auto request = create_initialize_request(1);
+        std::string request_body = request.dump();
+
+        // Send HTTP POST request to the server
+        auto response = client.post(test_url, request_body, {}, timeout);
+        timed_out = response.timed_out;
+
+        // Check HTTP status code - accept 200 OK or auth-related responses
+        bool is_success = (response.status_code == 200);
+        bool is_auth_challenge = (response.status_code == 401 || response.status_code == 403);
+
+        if (!is_success && !is_auth_challenge) {
+            return std::nullopt;
+        }
 
-            // Parse the JSON response
-            nlohmann::json json_response;
-            bool is_json = false;
-            try {
-                json_response = nlohmann::json::parse(response.body);
-                is_json = true;
-            } catch (const nlohmann::json::parse_error& e) {
-                // Not JSON - check if it's an auth challenge with MCP keywords
-                if (is_auth_challenge) {
-                    std::string body_lower = response.body;
-                    std::transform(body_lower.begin(), body_lower.end(), body_lower.begin(), ::tolower);
-
-                    // Check for MCP-related keywords in auth responses
-                    if (body_lower.find("authentication") != std::string::npos ||
-                        body_lower.find("unauthorized") != std::string::npos ||
-                        body_lower.find("session") != std::string::npos ||
-                        body_lower.find("mcp") != std::string::npos) {
-                        // Auth challenge with MCP keywords - this is an indicator!
-                        // Continue to create server object
-                    } else {
-                        continue;  // Not MCP-related
-                    }
+        // Parse the JSON response
+        nlohmann::json json_response;
+        bool is_json = false;
+        try {
+            json_response = nlohmann::json::parse(response.body);
+            is_json = true;
+        } catch (const nlohmann::json::parse_error& e) {
+            // Not JSON - check if it's an auth challenge with MCP keywords
+            if (is_auth_challenge) {
+                std::string body_lower = response.body;
+                std::transform(body_lower.begin(), body_lower.end(), body_lower.begin(), ::tolower);
+
+                // Check for MCP-related keywords in auth responses
+                if (body_lower.find("authentication") != std::string::npos ||
+                    body_lower.find("unauthorized") != std::string::npos ||
+                    body_lower.find("session") != std::string::npos ||
+                    body_lower.find("mcp") != std::string::npos) {
+                    // Auth challenge with MCP keywords - this is an indicator!
+                    // Continue to create server object
                 } else {
-                    continue;  // Not JSON and not an auth challenge
+                    return std::nullopt;  // Not MCP-related
                 }
+            } else {
+                return std::nullopt;  // Not JSON and not an auth challenge
             }
+        }
 
-            // If JSON, validate it's a proper JSON-RPC 2.0 response
-            // (accepts both result and error responses - both are indicators)
-            if (is_json && !is_valid_mcp_response(json_response)) {
-                continue;  // Not valid JSON-RPC 2.0
-            }
+        // If JSON, validate it's a proper JSON-RPC 2.0 response
+        // (accepts both result and error responses - both are indicators)
+        if (is_json && !is_valid_mcp_response(json_response)) {
+            return std::nullopt;  // Not valid JSON-RPC 2.0
+        }
 
-            // If we got here, we found a valid MCP indicator!
-            // - Valid JSON-RPC 2.0 response (success or error)
-            // - Or auth challenge with MCP-related keywords
+        // If we got here, we found a valid MCP indicator!
+        // - Valid JSON-RPC 2.0 response (success or error)
+        // - Or auth challenge with MCP-related keywords
 
-            // Success! Create MCPServer object from successful response
-            MCPServer server;
-            server.candidate = candidate;
-            server.candidate.url = test_url;  // Update URL to the successful path
-            server.transport_type = TransportType::Http;
-            server.discovered_at = std::chrono::system_clock::now();
+        // Success! Create MCPServer object from successful response
+        MCPServer server;
+        server.candidate = candidate;
+        server.candidate.url = test_url;  // Update URL to the successful path
+        server.transport_type = TransportType::Http;
+        server.discovered_at = std::chrono::system_clock::now();
 
-            // Extract server information from the initialize response (if JSON)
-            if (is_json) {
-                extract_server_info(json_response, server);
+        // Extract server information from the initialize response (if JSON)
+        if (is_json) {
+            extract_server_info(json_response, server);
+            if (keep_sessions_) {
+                server.session = make_session(test_url, response, server);
             }
-            // For auth challenges without JSON-RPC, we still confirm the server exists
-            // but won't have detailed server info
+        }
+        // For auth challenges without JSON-RPC, we still confirm the server exists
+        // but won't have detailed server info
 
-            return server;
+        return server;
 
-        } catch (const std::exception& e) {
-            // Continue to next path on error
-            continue;
-        }
+    } catch (const std::exception& e) {
+        return std::nullopt;
     }
-
-    // All paths failed
-    return std::nullopt;
 }
 
-std::optional<MCPServer> HttpTestingEngine::try_sse_transport(const Candidate& candidate) {
+std::optional<MCPServer> HttpTestingEngine::try_sse_transport(const Candidate& candidate,
+                                                              HttpClient& client,
+                                                              std::chrono::milliseconds timeout,
+                                                              bool& timed_out) {
     // Try SSE endpoint
     std::string sse_url = candidate.url + "/sse";
 
@@ -128,7 +215,8 @@ std::optional<MCPServer> HttpTestingEngine::try_sse_transport(const Candidate& c
         headers["Accept"] = "text/event-stream";
 
         // GET request to /sse endpoint
-        auto response = http_client_->get(sse_url, headers, timeout_);
+        auto response = client.get(sse_url, headers, timeout);
+        timed_out = response.timed_out;
 
         // Check for auth challenge on SSE endpoint first
         if (response.status_code == 401 || response.status_code == 403) {
@@ -180,7 +268,8 @@ std::optional<MCPServer> HttpTestingEngine::try_sse_transport(const Candidate& c
         auto request = create_initialize_request(1);
         std::string request_body = request.dump();
 
-        auto messages_response = http_client_->post(messages_url, request_body, {}, timeout_);
+        auto messages_response = client.post(messages_url, request_body, {}, timeout);
+        timed_out = messages_response.timed_out;
 
         // Accept 200 OK or auth challenges
         if (messages_response.status_code != 200 &&
@@ -213,6 +302,9 @@ std::optional<MCPServer> HttpTestingEngine::try_sse_transport(const Candidate& c
 
         // Extract server information from the initialize response
         extract_server_info(json_response, server);
+        if (keep_sessions_) {
+            server.session = make_session(messages_url, messages_response, server);
+        }
 
         return server;
 
@@ -221,6 +313,17 @@ std::optional<MCPServer> HttpTestingEngine::try_sse_transport(const Candidate& c
     }
 }
 
+std::shared_ptr<McpSession> HttpTestingEngine::make_session(const std::string& url,
+                                                           const HttpResponse& response,
+                                                           const MCPServer& server) const {
+    // Interrogation runs on the worker's shared client, which by then
+    // holds this variant's pooled connection
+    auto session_id = response.headers.find("mcp-session-id");
+    return std::make_shared<HttpMcpSession>(
+        http_client_, url, session_id != response.headers.end() ? session_id->second : "",
+        server.protocol_version, server.capabilities);
+}
+
 std::string HttpTestingEngine::parse_sse_endpoint(const std::string& sse_body) {
     // Parse SSE format to extract endpoint
     // Expected format:
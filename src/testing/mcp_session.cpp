@@ -0,0 +1,657 @@
+// MCP sessions carried from confirmation to interrogation
+
+#include <kyros/testing/mcp_session.hpp>
+
+#include <algorithm>
+#include <istream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+namespace kyros {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// A response to `request`, rather than a notification or another reply
+bool answers(const nlohmann::json& message, const nlohmann::json& request) {
+    return message.is_object() && message.contains("id") && message["id"] == request["id"] &&
+           (message.contains("result") || message.contains("error"));
+}
+
+// Store `message` as the response to whichever of `requests` it answers;
+// returns true if it answered one that was still outstanding
+bool settle(const nlohmann::json& message, const std::vector<nlohmann::json>& requests,
+            std::vector<nlohmann::json>& responses) {
+    for (size_t i = 0; i < requests.size(); i++) {
+        if (responses[i].is_null() && answers(message, requests[i])) {
+            responses[i] = message;
+            return true;
+        }
+    }
+    return false;
+}
+
+// The data: payloads of an SSE body, one per event
+std::vector<std::string> sse_data(const std::string& body) {
+    std::vector<std::string> events;
+    std::istringstream stream(body);
+    std::string line;
+    std::string data;
+    while (std::getline(stream, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (line.empty()) {
+            if (!data.empty()) {
+                events.push_back(std::move(data));
+                data.clear();
+            }
+        } else if (line.compare(0, 5, "data:") == 0) {
+            size_t start = line.find_first_not_of(' ', 5);
+            if (!data.empty()) {
+                data += '\n';
+            }
+            data += start == std::string::npos ? "" : line.substr(start);
+        }
+    }
+    if (!data.empty()) {
+        events.push_back(std::move(data));
+    }
+    return events;
+}
+
+bool is_event_stream(const HttpResponse& response) {
+    auto content_type = response.headers.find("content-type");
+    return content_type != response.headers.end() &&
+           content_type->second.find("text/event-stream") != std::string::npos;
+}
+
+// Every JSON-RPC message in a response, with batch arrays flattened: the
+// events of an event stream, or `payload`, the JSON body parsed as it
+// arrived
+std::vector<nlohmann::json> messages_in(const HttpResponse& response, nlohmann::json payload,
+                                        const ResultLimits& limits) {
+    std::vector<nlohmann::json> payloads;
+    if (is_event_stream(response)) {
+        for (const auto& data : sse_data(response.body)) {
+            payloads.push_back(parse_capped_message(data, limits));
+        }
+    } else {
+        payloads.push_back(std::move(payload));
+    }
+
+    std::vector<nlohmann::json> messages;
+    for (auto& payload : payloads) {
+        if (payload.is_array()) {
+            for (auto& message : payload) {
+                messages.push_back(std::move(message));
+            }
+        } else if (payload.is_object()) {
+            messages.push_back(std::move(payload));
+        }
+    }
+    return messages;
+}
+
+/**
+ * A message read piece by piece, as a stream for nlohmann's parser. Only
+ * the current piece is held.
+ */
+class MessageStream : public std::streambuf {
+public:
+    explicit MessageStream(const MessageReader& read) : read_(read) {}
+
+    // Bytes handed to the parser so far
+    size_t consumed() const { return received_ - static_cast<size_t>(egptr() - gptr()); }
+
+protected:
+    int_type underflow() override {
+        while (!ended_) {
+            if (next()) {
+                return traits_type::to_int_type(*gptr());
+            }
+        }
+        return traits_type::eof();
+    }
+
+private:
+    const MessageReader& read_;
+    size_t received_ = 0;
+    bool ended_ = false;
+
+    bool next() {
+        bool end = false;
+        std::string_view piece = read_(end);
+        ended_ = end;
+        received_ += piece.size();
+        char* begin = const_cast<char*>(piece.data());
+        setg(begin, begin, begin + piece.size());
+        return !piece.empty();
+    }
+};
+
+/**
+ * SAX handler building a DOM like nlohmann's own, except that arrays
+ * named in the limits, directly inside a "result" object, stop growing
+ * at their cap: further entries are skipped event by event
+ *
+ * Given the stream it parses, the handler also bounds what it holds: the
+ * bytes of kept values, and of any single token, stay within max_bytes.
+ * It stops the parse as soon as a single response's capped array is full
+ * and its id has been seen, as the rest cannot add to the result.
+ */
+class CappedSax {
+public:
+    CappedSax(nlohmann::json& root, const ResultLimits& limits,
+              const MessageStream* stream = nullptr, size_t max_bytes = 0)
+        : root_(root), limits_(limits), stream_(stream), max_bytes_(max_bytes) {}
+
+    // The parse ended at a full capped array with a usable message
+    bool complete() const { return complete_; }
+    // The parse failed on the byte bound
+    bool oversized() const { return oversized_; }
+
+    bool null() { return add(nullptr); }
+    bool boolean(bool value) { return add(value); }
+    bool number_integer(nlohmann::json::number_integer_t value) { return add(value); }
+    bool number_unsigned(nlohmann::json::number_unsigned_t value) { return add(value); }
+    bool number_float(nlohmann::json::number_float_t value, const std::string&) { return add(value); }
+    bool string(nlohmann::json::string_t& value) { return add(std::move(value)); }
+    bool binary(nlohmann::json::binary_t& value) { return add(std::move(value)); }
+
+    bool start_object(std::size_t) { return open(nlohmann::json::value_t::object); }
+    bool end_object() { return close(); }
+    bool start_array(std::size_t) { return open(nlohmann::json::value_t::array); }
+    bool end_array() { return close(); }
+
+    bool key(nlohmann::json::string_t& key) {
+        if (!charge(skip_depth_ == 0)) {
+            return false;
+        }
+        if (skip_depth_ == 0) {
+            key_ = std::move(key);
+        }
+        return true;
+    }
+
+    bool parse_error(std::size_t, const std::string&, const nlohmann::json::exception&) {
+        return false;
+    }
+
+private:
+    struct Container {
+        nlohmann::json* value;
+        bool result;   // The object under a "result" key
+        size_t cap;    // Entries kept, for a limited array
+        size_t count;
+    };
+
+    nlohmann::json& root_;
+    const ResultLimits& limits_;
+    const MessageStream* stream_;
+    size_t max_bytes_;
+    size_t position_ = 0;    // Stream bytes accounted for
+    size_t kept_bytes_ = 0;
+    bool complete_ = false;
+    bool oversized_ = false;
+    std::vector<Container> stack_;
+    std::string key_;
+    size_t skip_depth_ = 0;  // Nesting inside a skipped entry
+
+    // Account for the bytes parsed since the last event, as kept or not
+    bool charge(bool kept) {
+        if (!stream_) {
+            return true;
+        }
+        size_t span = stream_->consumed() - position_;
+        position_ += span;
+        if (kept) {
+            kept_bytes_ += span;
+        }
+        if (span > max_bytes_ || kept_bytes_ > max_bytes_) {
+            oversized_ = true;
+            return false;
+        }
+        return true;
+    }
+
+    // After a skipped entry starts: stop if that was the capped array of
+    // a single response, once its id is in
+    bool skipped() {
+        if (stream_ && root_.is_object() && root_.contains("id") && stack_.back().value->is_array() &&
+            stack_.back().cap != std::numeric_limits<size_t>::max()) {
+            complete_ = true;
+            return false;
+        }
+        return true;
+    }
+
+    // Where the next value goes, or nullptr if it is skipped
+    nlohmann::json* slot() {
+        if (stack_.empty()) {
+            return &root_;
+        }
+        Container& top = stack_.back();
+        if (!top.value->is_array()) {
+            return &(*top.value)[key_];
+        }
+        if (top.count >= top.cap) {
+            return nullptr;
+        }
+        top.count++;
+        top.value->push_back(nullptr);
+        return &top.value->back();
+    }
+
+    template <typename T>
+    bool add(T&& value) {
+        if (skip_depth_ > 0) {
+            return charge(false);
+        }
+        nlohmann::json* target = slot();
+        if (!charge(target != nullptr)) {
+            return false;
+        }
+        if (!target) {
+            return skipped();
+        }
+        *target = nlohmann::json(std::forward<T>(value));
+        return true;
+    }
+
+    bool open(nlohmann::json::value_t type) {
+        if (skip_depth_ > 0) {
+            skip_depth_++;
+            return charge(false);
+        }
+        bool in_result = !stack_.empty() && stack_.back().result && stack_.back().value->is_object();
+        bool is_result = !stack_.empty() && stack_.back().value->is_object() && key_ == "result";
+        nlohmann::json* target = slot();
+        if (!charge(target != nullptr)) {
+            return false;
+        }
+        if (!target) {
+            skip_depth_ = 1;
+            return skipped();
+        }
+        *target = nlohmann::json(type);
+
+        size_t cap = std::numeric_limits<size_t>::max();
+        if (type == nlohmann::json::value_t::array && in_result) {
+            auto limit = limits_.find(key_);
+            if (limit != limits_.end()) {
+                cap = limit->second;
+            }
+        }
+        stack_.push_back({target, is_result && type == nlohmann::json::value_t::object, cap, 0});
+        return true;
+    }
+
+    bool close() {
+        if (!charge(skip_depth_ == 0)) {
+            return false;
+        }
+        if (skip_depth_ > 0) {
+            skip_depth_--;
+        } else {
+            stack_.pop_back();
+        }
+        return true;
+    }
+};
+
+// The next line on stdout, parsed while it arrives. The rest of the line
+// is read and dropped if the parse stops early.
+nlohmann::json read_message(Process& process, Clock::time_point deadline,
+                            const ResultLimits& limits, size_t max_bytes) {
+    bool ended = false;
+    MessageReader read = [&](bool& end) {
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now());
+        if (remaining.count() <= 0) {
+            throw ReadTimeout("Timeout reading from stdout");
+        }
+        std::string_view piece = process.read_stdout_partial(remaining, end);
+        ended = end;
+        return piece;
+    };
+
+    // Leave the pipe at a line boundary for the next message
+    auto drain = [&]() {
+        bool end = ended;
+        while (!end) {
+            read(end);
+        }
+    };
+
+    nlohmann::json message;
+    try {
+        message = parse_capped_message(read, limits, max_bytes);
+    } catch (const std::runtime_error&) {
+        drain();
+        throw;
+    }
+    drain();
+    return message;
+}
+
+} // namespace
+
+nlohmann::json parse_capped_message(std::string_view text, const ResultLimits& limits) {
+    nlohmann::json message;
+    CappedSax sax(message, limits);
+    if (!nlohmann::json::sax_parse(text.begin(), text.end(), &sax)) {
+        return nlohmann::json(nlohmann::json::value_t::discarded);
+    }
+    return message;
+}
+
+nlohmann::json parse_capped_message(const MessageReader& read, const ResultLimits& limits,
+                                    size_t max_bytes) {
+    MessageStream stream(read);
+    std::istream input(&stream);
+    nlohmann::json message;
+    CappedSax sax(message, limits, &stream, max_bytes);
+    bool parsed = nlohmann::json::sax_parse(input, &sax);
+    if (sax.oversized()) {
+        throw std::runtime_error("Message exceeds " + std::to_string(max_bytes) + " bytes");
+    }
+    if (!parsed && !sax.complete()) {
+        return nlohmann::json(nlohmann::json::value_t::discarded);
+    }
+    return message;
+}
+
+nlohmann::json McpSession::initialize_request(int id) {
+    return nlohmann::json{
+        {"jsonrpc", "2.0"},
+        {"id", id},
+        {"method", "initialize"},
+        {"params", {
+            {"protocolVersion", "2024-11-05"},
+            {"capabilities", nlohmann::json::object()},
+            {"clientInfo", {
+                {"name", "Kyros"},
+                {"version", "2.0.0"}
+            }}
+        }}
+    };
+}
+
+nlohmann::json McpSession::initialize(std::chrono::milliseconds timeout) {
+    auto response = exchange(initialize_request(1), timeout);
+    if (response.contains("result") && response["result"].is_object()) {
+        const auto& result = response["result"];
+        if (result.contains("protocolVersion") && result["protocolVersion"].is_string()) {
+            protocol_version_ = result["protocolVersion"].get<std::string>();
+        }
+        if (result.contains("capabilities") && result["capabilities"].is_object()) {
+            capabilities_ = result["capabilities"];
+        }
+    }
+    initialized_sent_ = false;
+    return response;
+}
+
+nlohmann::json McpSession::request(const nlohmann::json& request,
+                                   std::chrono::milliseconds timeout) {
+    complete_handshake(timeout);
+    return exchange(request, timeout);
+}
+
+std::vector<nlohmann::json> McpSession::request_all(const std::vector<nlohmann::json>& requests,
+                                                    std::chrono::milliseconds timeout,
+                                                    std::vector<std::string>* errors) {
+    complete_handshake(timeout);
+    std::vector<std::string> reasons(requests.size());
+    auto responses = exchange_all(requests, timeout, reasons);
+    for (size_t i = 0; i < responses.size(); i++) {
+        if (responses[i].is_null() && reasons[i].empty()) {
+            reasons[i] = "No response before timeout";
+        }
+    }
+    if (errors) {
+        *errors = std::move(reasons);
+    }
+    return responses;
+}
+
+std::vector<nlohmann::json> McpSession::exchange_all(const std::vector<nlohmann::json>& requests,
+                                                     std::chrono::milliseconds timeout,
+                                                     std::vector<std::string>& errors) {
+    std::vector<nlohmann::json> responses(requests.size());
+    auto deadline = Clock::now() + timeout;
+    for (size_t i = 0; i < requests.size(); i++) {
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now());
+        if (remaining.count() <= 0) {
+            break;
+        }
+        try {
+            responses[i] = exchange(requests[i], remaining);
+        } catch (const std::exception& e) {
+            errors[i] = e.what();
+        }
+    }
+    return responses;
+}
+
+void McpSession::complete_handshake(std::chrono::milliseconds timeout) {
+    if (!is_open()) {
+        throw std::runtime_error("Session is closed");
+    }
+    if (!initialized_sent_) {
+        notify(nlohmann::json{{"jsonrpc", "2.0"}, {"method", "notifications/initialized"}}, timeout);
+        initialized_sent_ = true;
+    }
+}
+
+// StdioMcpSession
+
+StdioMcpSession::StdioMcpSession(std::unique_ptr<Process> process, std::string protocol_version,
+                                 nlohmann::json capabilities)
+    : McpSession(std::move(protocol_version), std::move(capabilities)),
+      process_(std::move(process)) {}
+
+StdioMcpSession::~StdioMcpSession() {
+    close();
+}
+
+nlohmann::json StdioMcpSession::exchange(const nlohmann::json& request,
+                                         std::chrono::milliseconds timeout) {
+    process_->write_stdin(request.dump() + "\n");
+
+    // Skip notifications and log messages until the matching response
+    auto deadline = Clock::now() + timeout;
+    while (true) {
+        auto message = read_message(*process_, deadline, result_limits_, max_message_bytes_);
+        if (!message.is_discarded() && answers(message, request)) {
+            return message;
+        }
+    }
+}
+
+std::vector<nlohmann::json> StdioMcpSession::exchange_all(
+    const std::vector<nlohmann::json>& requests, std::chrono::milliseconds timeout,
+    std::vector<std::string>& errors) {
+    // Write every request before reading any response
+    std::string batch;
+    for (const auto& request : requests) {
+        batch += request.dump();
+        batch += '\n';
+    }
+    process_->write_stdin(batch);
+
+    std::vector<nlohmann::json> responses(requests.size());
+    size_t outstanding = requests.size();
+    auto deadline = Clock::now() + timeout;
+    while (outstanding > 0) {
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now());
+        if (remaining.count() <= 0) {
+            break;  // The rest stay unanswered
+        }
+        nlohmann::json message;
+        try {
+            message = read_message(*process_, deadline, result_limits_, max_message_bytes_);
+        } catch (const std::exception& e) {
+            // EOF, or a message past the byte bound: responses already read
+            // stand, the rest fail with the reason
+            if (Clock::now() < deadline) {
+                for (size_t i = 0; i < requests.size(); i++) {
+                    if (responses[i].is_null()) {
+                        errors[i] = e.what();
+                    }
+                }
+            }
+            break;
+        }
+        if (!message.is_discarded() && settle(message, requests, responses)) {
+            outstanding--;
+        }
+    }
+    return responses;
+}
+
+void StdioMcpSession::notify(const nlohmann::json& notification, std::chrono::milliseconds) {
+    process_->write_stdin(notification.dump() + "\n");
+}
+
+void StdioMcpSession::set_max_message_bytes(size_t bytes) {
+    max_message_bytes_ = bytes;
+}
+
+bool StdioMcpSession::is_open() const {
+    return process_ && process_->is_running();
+}
+
+void StdioMcpSession::close() {
+    if (process_) {
+        process_->terminate();
+        process_.reset();
+    }
+}
+
+// HttpMcpSession
+
+HttpMcpSession::HttpMcpSession(std::shared_ptr<HttpClient> client, std::string url,
+                               std::string session_id, std::string protocol_version,
+                               nlohmann::json capabilities)
+    : McpSession(std::move(protocol_version), std::move(capabilities)),
+      client_(std::move(client)), url_(std::move(url)), session_id_(std::move(session_id)) {}
+
+nlohmann::json HttpMcpSession::exchange(const nlohmann::json& request,
+                                        std::chrono::milliseconds timeout) {
+    auto message = nlohmann::json(nlohmann::json::value_t::discarded);
+    auto response = post(request, timeout, &message);
+
+    // Assigned in the initialize response
+    auto session_id = response.headers.find("mcp-session-id");
+    if (session_id_.empty() && session_id != response.headers.end()) {
+        session_id_ = session_id->second;
+    }
+    if (response.status_code != 200) {
+        if (!response.error_message.empty()) {
+            throw std::runtime_error(response.error_message);
+        }
+        throw std::runtime_error("HTTP request failed with status " + std::to_string(response.status_code));
+    }
+
+    if (is_event_stream(response)) {
+        for (const auto& event : messages_in(response, nullptr, result_limits_)) {
+            if (answers(event, request)) {
+                return event;
+            }
+        }
+        throw std::runtime_error("No response in event stream");
+    }
+
+    if (message.is_discarded()) {
+        throw std::runtime_error("Invalid JSON in response");
+    }
+    return message;
+}
+
+std::vector<nlohmann::json> HttpMcpSession::exchange_all(
+    const std::vector<nlohmann::json>& requests, std::chrono::milliseconds timeout,
+    std::vector<std::string>& errors) {
+    if (requests.size() < 2 || batch_rejected_) {
+        return McpSession::exchange_all(requests, timeout, errors);
+    }
+
+    auto deadline = Clock::now() + timeout;
+    auto payload = nlohmann::json(nlohmann::json::value_t::discarded);
+    auto response = post(nlohmann::json(requests), timeout, &payload);
+    std::vector<nlohmann::json> responses(requests.size());
+    if (response.status_code == 0) {
+        std::fill(errors.begin(), errors.end(),
+                  response.error_message.empty() ? "HTTP request failed" : response.error_message);
+        return responses;
+    }
+
+    size_t answered = 0;
+    if (response.status_code == 200) {
+        for (const auto& message : messages_in(response, std::move(payload), result_limits_)) {
+            if (settle(message, requests, responses)) {
+                answered++;
+            }
+        }
+    }
+    if (answered == 0) {
+        // An error status, or a lone "Invalid Request" error: no batches
+        batch_rejected_ = true;
+    }
+
+    // Send whatever the batch left unanswered on its own
+    for (size_t i = 0; i < requests.size(); i++) {
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now());
+        if (!responses[i].is_null() || remaining.count() <= 0) {
+            continue;
+        }
+        try {
+            responses[i] = exchange(requests[i], remaining);
+        } catch (const std::exception& e) {
+            errors[i] = e.what();
+        }
+    }
+    return responses;
+}
+
+void HttpMcpSession::notify(const nlohmann::json& notification, std::chrono::milliseconds timeout) {
+    post(notification, timeout);  // 202 Accepted; nothing to check
+}
+
+HttpResponse HttpMcpSession::post(const nlohmann::json& message, std::chrono::milliseconds timeout,
+                                  nlohmann::json* parsed) {
+    std::map<std::string, std::string> headers = {
+        {"Content-Type", "application/json"},
+        {"Accept", "application/json, text/event-stream"}
+    };
+    if (!session_id_.empty()) {
+        headers["Mcp-Session-Id"] = session_id_;
+    }
+    if (!protocol_version_.empty()) {
+        headers["MCP-Protocol-Version"] = protocol_version_;
+    }
+    HttpClient::BodyHandler handler;
+    if (parsed) {
+        handler = [&](const HttpResponse& head, const HttpClient::BodyReader& read) {
+            if (head.status_code != 200) {
+                return;
+            }
+            *parsed = parse_capped_message([&](bool& end) {
+                std::string_view piece = read();
+                end = piece.empty();
+                return piece;
+            }, result_limits_, max_body_bytes_);
+        };
+    }
+
+    size_t client_limit = client_->max_body_bytes();
+    client_->set_max_body_bytes(max_body_bytes_);
+    auto response = client_->post(url_, message.dump(), headers, timeout, handler);
+    client_->set_max_body_bytes(client_limit);
+    return response;
+}
+
+} // namespace kyros
@@ -0,0 +1,246 @@
+// Pre-flight filtering of listener candidates
+
+#include <kyros/testing/preflight.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <map>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace kyros {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+#ifdef MSG_NOSIGNAL
+constexpr int kSendFlags = MSG_NOSIGNAL;
+#else
+constexpr int kSendFlags = 0;  // SO_NOSIGPIPE is set on the socket instead
+#endif
+
+// Sockets open at once; later endpoints wait for the next round
+constexpr size_t kMaxInFlight = 256;
+
+constexpr std::string_view kStatusPrefix = "HTTP/";
+
+// Where to connect for a listener address, and the Host header naming
+// it; wildcards mean loopback
+bool endpoint_address(const Candidate& candidate, struct sockaddr_storage& storage,
+                      socklen_t& length, std::string& host_header) {
+    std::string host = candidate.address;
+    if (host.size() > 2 && host.front() == '[' && host.back() == ']') {
+        host = host.substr(1, host.size() - 2);
+    }
+    if (host.empty() || host == "0.0.0.0" || host == "*") {
+        host = "127.0.0.1";
+    } else if (host == "::") {
+        host = "::1";
+    }
+
+    std::memset(&storage, 0, sizeof(storage));
+    auto* v4 = reinterpret_cast<struct sockaddr_in*>(&storage);
+    if (inet_pton(AF_INET, host.c_str(), &v4->sin_addr) == 1) {
+        v4->sin_family = AF_INET;
+        v4->sin_port = htons(static_cast<uint16_t>(candidate.port));
+        length = sizeof(*v4);
+        host_header = host + ":" + std::to_string(candidate.port);
+        return true;
+    }
+    auto* v6 = reinterpret_cast<struct sockaddr_in6*>(&storage);
+    if (inet_pton(AF_INET6, host.c_str(), &v6->sin6_addr) == 1) {
+        v6->sin6_family = AF_INET6;
+        v6->sin6_port = htons(static_cast<uint16_t>(candidate.port));
+        length = sizeof(*v6);
+        host_header = "[" + host + "]:" + std::to_string(candidate.port);
+        return true;
+    }
+    return false;
+}
+
+// The first bytes for a rejection message, non-printables shown as '.'
+std::string printable_prefix(std::string_view bytes) {
+    std::string text;
+    for (char c : bytes.substr(0, 16)) {
+        text += (c >= 0x20 && c < 0x7f) ? c : '.';
+    }
+    return text;
+}
+
+struct Sniff {
+    size_t position;
+    int fd;
+    std::string host_header;
+    bool connected = false;
+    std::string received;
+};
+
+} // namespace
+
+Preflight::Preflight(std::chrono::milliseconds timeout) : timeout_(timeout) {}
+
+Preflight::Verdict Preflight::classify(std::string_view first_bytes) {
+    size_t length = std::min(first_bytes.size(), kStatusPrefix.size());
+    if (first_bytes.substr(0, length) != kStatusPrefix.substr(0, length)) {
+        return Verdict::NotHttp;
+    }
+    return length == kStatusPrefix.size() ? Verdict::Http : Verdict::Undecided;
+}
+
+std::vector<std::string> Preflight::check(const std::vector<const Candidate*>& candidates) {
+    std::vector<std::string> reasons(candidates.size());
+    std::map<std::pair<int, int>, size_t> first_by_owner;  // (pid, port) -> position
+    std::vector<size_t> to_sniff;
+
+    for (size_t i = 0; i < candidates.size(); i++) {
+        const Candidate& candidate = *candidates[i];
+        if (candidate.port <= 0) {
+            continue;
+        }
+        if (candidate.socket_protocol == "udp") {
+            reasons[i] = "UDP listener";
+            continue;
+        }
+        if (candidate.pid > 0) {
+            auto [first, inserted] = first_by_owner.emplace(std::make_pair(candidate.pid, candidate.port), i);
+            if (!inserted) {
+                reasons[i] = "Same listener as " + candidates[first->second]->url;
+                continue;
+            }
+        }
+        to_sniff.push_back(i);
+    }
+
+    for (size_t start = 0; start < to_sniff.size(); start += kMaxInFlight) {
+        size_t end = std::min(start + kMaxInFlight, to_sniff.size());
+        sniff(candidates, std::vector<size_t>(to_sniff.begin() + start, to_sniff.begin() + end),
+              reasons);
+    }
+    return reasons;
+}
+
+void Preflight::sniff(const std::vector<const Candidate*>& candidates,
+                      const std::vector<size_t>& positions, std::vector<std::string>& reasons) {
+    std::vector<Sniff> active;
+
+    for (size_t position : positions) {
+        const Candidate& candidate = *candidates[position];
+        struct sockaddr_storage address;
+        socklen_t length = 0;
+        std::string host_header;
+        if (!endpoint_address(candidate, address, length, host_header)) {
+            continue;  // Not an address we can sniff; leave it to the probe
+        }
+
+        int fd = socket(address.ss_family, SOCK_STREAM, 0);
+        if (fd < 0) {
+            continue;
+        }
+        fcntl(fd, F_SETFD, FD_CLOEXEC);
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+#ifdef SO_NOSIGPIPE
+        int one = 1;
+        setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+
+        if (connect(fd, reinterpret_cast<struct sockaddr*>(&address), length) != 0 &&
+            errno != EINPROGRESS) {
+            reasons[position] = std::string("Connection failed: ") + strerror(errno);
+            close(fd);
+            continue;
+        }
+        active.push_back({position, fd, std::move(host_header), false, {}});
+    }
+
+    auto deadline = Clock::now() + timeout_;
+    std::vector<struct pollfd> pfds;
+    while (!active.empty()) {
+        auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now());
+        if (left.count() <= 0) {
+            break;
+        }
+
+        pfds.clear();
+        for (const auto& sniff : active) {
+            pfds.push_back({sniff.fd, static_cast<short>(sniff.connected ? POLLIN : POLLOUT), 0});
+        }
+        int rc = poll(pfds.data(), pfds.size(), static_cast<int>(left.count()));
+        if (rc < 0 && errno != EINTR) {
+            break;
+        }
+
+        for (size_t i = 0; i < active.size(); i++) {
+            if (rc <= 0 || pfds[i].revents == 0) {
+                continue;
+            }
+            Sniff& sniff = active[i];
+            std::string& reason = reasons[sniff.position];
+            bool finished = false;
+
+            if (!sniff.connected) {
+                int so_error = 0;
+                socklen_t length = sizeof(so_error);
+                getsockopt(sniff.fd, SOL_SOCKET, SO_ERROR, &so_error, &length);
+                if (so_error != 0) {
+                    reason = std::string("Connection failed: ") + strerror(so_error);
+                    finished = true;
+                } else {
+                    sniff.connected = true;
+                    std::string request = "HEAD / HTTP/1.1\r\nHost: " + sniff.host_header +
+                                          "\r\nConnection: close\r\n\r\n";
+                    // A banner already waiting is read on the next round
+                    send(sniff.fd, request.data(), request.size(), kSendFlags);
+                }
+            } else {
+                char buffer[64];
+                ssize_t n = recv(sniff.fd, buffer, sizeof(buffer), 0);
+                if (n > 0) {
+                    sniff.received.append(buffer, static_cast<size_t>(n));
+                    switch (classify(sniff.received)) {
+                        case Verdict::Http:
+                            finished = true;
+                            break;
+                        case Verdict::NotHttp:
+                            reason = "Not HTTP (sent \"" + printable_prefix(sniff.received) + "\")";
+                            finished = true;
+                            break;
+                        case Verdict::Undecided:
+                            break;
+                    }
+                } else if (n == 0) {
+                    reason = sniff.received.empty()
+                                 ? "Closed without a response"
+                                 : "Not HTTP (sent \"" + printable_prefix(sniff.received) + "\")";
+                    finished = true;
+                } else if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                    reason = std::string("Connection failed: ") + strerror(errno);
+                    finished = true;
+                }
+            }
+
+            if (finished) {
+                close(sniff.fd);
+                sniff.fd = -1;
+            }
+        }
+
+        // pfds was built from active, so compact only after the pass
+        active.erase(std::remove_if(active.begin(), active.end(),
+                                    [](const Sniff& sniff) { return sniff.fd < 0; }),
+                     active.end());
+    }
+
+    // Silent until the deadline: undecided, so the full probe runs
+    for (const auto& sniff : active) {
+        close(sniff.fd);
+    }
+}
+
+} // namespace kyros
@@ -167,10 +167,11 @@ ProtocolSignature ProtocolDetector::detect_lsp(Process* process,
 
         process->write_stdin(request);
 
-        // LSP responses start with "Content-Length: "
-        std::string response = process->read_stdout_line(timeout);
+        // LSP responses carry a Content-Length header block; a frame only
+        // comes back if one was parsed
+        std::string_view response = process->read_stdout_frame(timeout, FrameFormat::ContentLength);
 
-        if (response.find("Content-Length:") == 0) {
+        if (!response.empty()) {
             return ProtocolSignature(
                 ProtocolType::LSP,
                 "Language Server Protocol",
@@ -1,6 +1,8 @@
 #include <kyros/testing/server_interrogator.hpp>
 #include <kyros/platform/process.hpp>
+#include <kyros/testing/mcp_session.hpp>
 
+#include <algorithm>
 #include <iostream>
 
 namespace kyros {
@@ -20,151 +22,180 @@ void ServerInterrogator::interrogate(MCPServer& server) {
 
     auto start_time = std::chrono::steady_clock::now();
 
-    try {
-        // Create a communication function based on transport type
-        std::function<nlohmann::json(const nlohmann::json&)> send_request;
-        std::unique_ptr<Process> process;  // For stdio servers
-
-        if (server.transport_type == TransportType::Stdio) {
-            // Stdio transport: spawn process and communicate via pipes
-            if (!platform_ || server.candidate.command.empty()) {
-                server.interrogation_errors.push_back("Cannot interrogate stdio server: missing platform or command");
-                server.interrogation_successful = false;
-                return;
-            }
-
-            // Spawn the server process
-            process = platform_->spawn_process_with_pipes(server.candidate.command);
-            if (!process || !process->is_running()) {
-                server.interrogation_errors.push_back("Failed to spawn process for interrogation");
-                server.interrogation_successful = false;
-                return;
-            }
-
-            // Create send_request lambda for stdio
-            send_request = [&](const nlohmann::json& request) -> nlohmann::json {
-                // Send request
-                std::string request_str = request.dump() + "\n";
-                process->write_stdin(request_str);
-
-                // Read response with timeout
-                std::string response_line = process->read_stdout_line(config_.timeout);
+    // Prefer the connection the testing engine kept from confirmation
+    std::shared_ptr<McpSession> session = std::move(server.session);
 
-                // Parse and return
-                return nlohmann::json::parse(response_line);
-            };
-
-        } else if (server.transport_type == TransportType::Http) {
-            // HTTP transport: send POST requests
-            if (!http_client_ || server.candidate.url.empty()) {
-                server.interrogation_errors.push_back("Cannot interrogate HTTP server: missing HTTP client or URL");
+    try {
+        if (!session || !session->is_open()) {
+            session = open_session(server);
+            if (!session) {
                 server.interrogation_successful = false;
                 return;
             }
-
-            // Create send_request lambda for HTTP
-            send_request = [&](const nlohmann::json& request) -> nlohmann::json {
-                std::string request_body = request.dump();
-                auto response = http_client_->post(
-                    server.candidate.url,
-                    request_body,
-                    {{"Content-Type", "application/json"}},
-                    config_.timeout
-                );
-
-                if (response.status_code != 200) {
-                    throw std::runtime_error("HTTP request failed with status " + std::to_string(response.status_code));
-                }
-
-                return nlohmann::json::parse(response.body);
-            };
-
-        } else {
-            server.interrogation_errors.push_back("Unknown transport type");
-            server.interrogation_successful = false;
-            return;
         }
 
-        // Perform interrogation based on config
+        // Every enabled list goes out at once (pipelined over stdio, one
+        // batch over HTTP), then each list's next page, round by round,
+        // until its cursor runs out or it reaches its limit
+        struct ListRequest {
+            const char* label;
+            const char* key;  // The result array
+            size_t limit;
+            nlohmann::json (ServerInterrogator::*create)(int) const;
+            void (ServerInterrogator::*parse)(const nlohmann::json&, MCPServer&);
+            size_t (*collected)(const MCPServer&);
+        };
+        auto limit = [](int configured) { return static_cast<size_t>(std::max(configured, 0)); };
+        std::vector<ListRequest> lists;
         if (config_.get_tools && server.has_tools()) {
-            interrogate_tools(server, send_request);
+            lists.push_back({"Tools", "tools", limit(config_.max_tools),
+                             &ServerInterrogator::create_tools_list_request,
+                             &ServerInterrogator::parse_tools_response,
+                             [](const MCPServer& s) { return s.tools.size(); }});
         }
-
         if (config_.get_resources && server.has_resources()) {
-            interrogate_resources(server, send_request);
+            lists.push_back({"Resources", "resources", limit(config_.max_resources),
+                             &ServerInterrogator::create_resources_list_request,
+                             &ServerInterrogator::parse_resources_response,
+                             [](const MCPServer& s) { return s.resources.size(); }});
         }
-
         if (config_.get_resource_templates && server.has_resources()) {
-            interrogate_resource_templates(server, send_request);
+            lists.push_back({"Resource templates", "resourceTemplates", limit(config_.max_resources),
+                             &ServerInterrogator::create_resource_templates_list_request,
+                             &ServerInterrogator::parse_resource_templates_response,
+                             [](const MCPServer& s) { return s.resource_templates.size(); }});
         }
-
         if (config_.get_prompts && server.has_prompts()) {
-            interrogate_prompts(server, send_request);
+            lists.push_back({"Prompts", "prompts", limit(config_.max_prompts),
+                             &ServerInterrogator::create_prompts_list_request,
+                             &ServerInterrogator::parse_prompts_response,
+                             [](const MCPServer& s) { return s.prompts.size(); }});
         }
 
-        // Clean up stdio process if needed
-        if (process && process->is_running()) {
-            process->terminate();
+        struct Paging {
+            std::string cursor;
+            int pages = 0;
+            bool done = false;
+        };
+        std::vector<Paging> paging(lists.size());
+
+        int next_id = 1;
+        while (true) {
+            std::vector<size_t> round;
+            std::vector<nlohmann::json> requests;
+            ResultLimits limits;
+            for (size_t i = 0; i < lists.size(); i++) {
+                const auto& list = lists[i];
+                if (paging[i].done) {
+                    continue;
+                }
+                auto request = (this->*list.create)(next_id++);
+                if (!paging[i].cursor.empty()) {
+                    request["params"]["cursor"] = paging[i].cursor;
+                }
+                round.push_back(i);
+                requests.push_back(std::move(request));
+                // Entries past the limit are skipped while parsing
+                limits[list.key] = list.limit - std::min(list.limit, list.collected(server));
+            }
+            if (round.empty()) {
+                break;
+            }
+
+            // A list that fails does so on its own; the others keep what
+            // they were sent
+            session->set_result_limits(std::move(limits));
+            std::vector<std::string> errors;
+            auto responses = session->request_all(requests, config_.timeout, &errors);
+
+            for (size_t j = 0; j < round.size(); j++) {
+                const auto& list = lists[round[j]];
+                auto& page = paging[round[j]];
+                page.done = true;
+                try {
+                    if (responses[j].is_null()) {
+                        throw std::runtime_error(errors[j]);
+                    }
+                    size_t before = list.collected(server);
+                    (this->*list.parse)(responses[j], server);
+                    page.pages++;
+
+                    // Follow nextCursor while the page added something new
+                    const auto& result = responses[j].value("result", nlohmann::json::object());
+                    auto cursor = result.find("nextCursor");
+                    if (cursor != result.end() && cursor->is_string() && *cursor != page.cursor &&
+                        list.collected(server) > before && list.collected(server) < list.limit &&
+                        page.pages < config_.max_pages) {
+                        page.cursor = cursor->get<std::string>();
+                        page.done = false;
+                    }
+                } catch (const std::exception& e) {
+                    server.interrogation_errors.push_back(std::string(list.label) +
+                                                          " interrogation failed: " + e.what());
+                }
+            }
         }
 
     } catch (const std::exception& e) {
         server.interrogation_errors.push_back(std::string("Interrogation failed: ") + e.what());
     }
 
+    // Terminates a stdio server
+    if (session) {
+        session->close();
+    }
+
     auto end_time = std::chrono::steady_clock::now();
     std::chrono::duration<double> elapsed = end_time - start_time;
     server.interrogation_time_seconds = elapsed.count();
     server.interrogation_successful = server.interrogation_errors.empty();
 }
 
-// Interrogation helper methods
+std::shared_ptr<McpSession> ServerInterrogator::open_session(MCPServer& server) {
+    std::shared_ptr<McpSession> session;
 
-void ServerInterrogator::interrogate_tools(
-    MCPServer& server,
-    const std::function<nlohmann::json(const nlohmann::json&)>& send_request) {
-    try {
-        auto request = create_tools_list_request(1);
-        auto response = send_request(request);
-        parse_tools_response(response, server);
-    } catch (const std::exception& e) {
-        server.interrogation_errors.push_back(std::string("Tools interrogation failed: ") + e.what());
-    }
-}
+    if (server.transport_type == TransportType::Stdio) {
+        // Stdio transport: spawn process and communicate via pipes
+        if (!platform_ || server.candidate.command.empty()) {
+            server.interrogation_errors.push_back("Cannot interrogate stdio server: missing platform or command");
+            return nullptr;
+        }
 
-void ServerInterrogator::interrogate_resources(
-    MCPServer& server,
-    const std::function<nlohmann::json(const nlohmann::json&)>& send_request) {
-    try {
-        auto request = create_resources_list_request(2);
-        auto response = send_request(request);
-        parse_resources_response(response, server);
-    } catch (const std::exception& e) {
-        server.interrogation_errors.push_back(std::string("Resources interrogation failed: ") + e.what());
-    }
-}
+        // Spawn the server process, from the unjoined argv when known
+        std::unique_ptr<Process> process;
+        const auto& argv = server.candidate.argv;
+        if (!argv.empty()) {
+            process = platform_->spawn_process_with_pipes(
+                argv[0], std::vector<std::string>(argv.begin() + 1, argv.end()));
+        } else {
+            process = platform_->spawn_process_with_pipes(server.candidate.command);
+        }
+        if (!process || !process->is_running()) {
+            server.interrogation_errors.push_back("Failed to spawn process for interrogation");
+            return nullptr;
+        }
 
-void ServerInterrogator::interrogate_resource_templates(
-    MCPServer& server,
-    const std::function<nlohmann::json(const nlohmann::json&)>& send_request) {
-    try {
-        auto request = create_resource_templates_list_request(3);
-        auto response = send_request(request);
-        parse_resource_templates_response(response, server);
-    } catch (const std::exception& e) {
-        server.interrogation_errors.push_back(std::string("Resource templates interrogation failed: ") + e.what());
-    }
-}
+        session = std::make_shared<StdioMcpSession>(std::move(process), server.protocol_version,
+                                                    server.capabilities);
 
-void ServerInterrogator::interrogate_prompts(
-    MCPServer& server,
-    const std::function<nlohmann::json(const nlohmann::json&)>& send_request) {
-    try {
-        auto request = create_prompts_list_request(4);
-        auto response = send_request(request);
-        parse_prompts_response(response, server);
-    } catch (const std::exception& e) {
-        server.interrogation_errors.push_back(std::string("Prompts interrogation failed: ") + e.what());
+    } else if (server.transport_type == TransportType::Http) {
+        // HTTP transport: send POST requests
+        if (!http_client_ || server.candidate.url.empty()) {
+            server.interrogation_errors.push_back("Cannot interrogate HTTP server: missing HTTP client or URL");
+            return nullptr;
+        }
+
+        session = std::make_shared<HttpMcpSession>(http_client_, server.candidate.url, "",
+                                                   server.protocol_version, server.capabilities);
+
+    } else {
+        server.interrogation_errors.push_back("Unknown transport type");
+        return nullptr;
     }
+
+    // A fresh connection needs its own handshake before any list request
+    session->initialize(config_.timeout);
+    return session;
 }
 
 // Request creation helpers
@@ -217,7 +248,8 @@ void ServerInterrogator::parse_tools_response(const nlohmann::json& response, MC
         return;
     }
 
-    int count = 0;
+    // Earlier pages count towards the limit
+    int count = static_cast<int>(server.tools.size());
     for (const auto& tool_json : result["tools"]) {
         if (count >= config_.max_tools) {
             break;
@@ -272,7 +304,8 @@ void ServerInterrogator::parse_resources_response(const nlohmann::json& response
         return;
     }
 
-    int count = 0;
+    // Earlier pages count towards the limit
+    int count = static_cast<int>(server.resources.size());
     for (const auto& resource_json : result["resources"]) {
         if (count >= config_.max_resources) {
             break;
@@ -311,7 +344,8 @@ void ServerInterrogator::parse_resource_templates_response(const nlohmann::json&
         return;
     }
 
-    int count = 0;
+    // Earlier pages count towards the limit
+    int count = static_cast<int>(server.resource_templates.size());
     for (const auto& template_json : result["resourceTemplates"]) {
         if (count >= config_.max_resources) {
             break;
@@ -365,7 +399,8 @@ void ServerInterrogator::parse_prompts_response(const nlohmann::json& response,
         return;
     }
 
-    int count = 0;
+    // Earlier pages count towards the limit
+    int count = static_cast<int>(server.prompts.size());
     for (const auto& prompt_json : result["prompts"]) {
         if (count >= config_.max_prompts) {
             break;
@@ -1,9 +1,14 @@
 #include <kyros/testing/stdio_testing_engine.hpp>
+#include <kyros/testing/mcp_session.hpp>
 #include <kyros/testing/protocol_detector.hpp>
 #include <kyros/platform/process.hpp>
 
 #include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <iostream>
+#include <mutex>
+#include <thread>
 
 namespace kyros {
 
@@ -11,38 +16,23 @@ StdioTestingEngine::StdioTestingEngine(std::shared_ptr<PlatformAdapter> platform
     : platform_(platform) {}
 
 std::optional<MCPServer> StdioTestingEngine::test(const Candidate& candidate) {
-    // Check if candidate has a command to execute
-    if (candidate.command.empty()) {
-        return std::nullopt;
-    }
-
-    // Only test stdio transport candidates
-    if (candidate.transport_hint != TransportType::Stdio &&
-        candidate.transport_hint != TransportType::Unknown) {
-        return std::nullopt;
-    }
-
-    if (!platform_) {
-        return std::nullopt;
-    }
-
-    // PHASE 3: Passive protocol detection (before spawning)
-    // Skip obvious non-MCP processes to save time and avoid false positives
-    ProtocolDetector detector;
-    auto passive_signature = detector.detect_from_process_info(candidate);
-
-    // If confirmed NOT MCP (Chromium IPC or LSP), skip active testing
-    if (passive_signature.type == ProtocolType::ChromiumIPC ||
-        passive_signature.type == ProtocolType::LSP) {
-        // Skip active testing for known non-MCP protocols
+    last_probe_ = ProbeTiming{};
+    if (!should_probe(candidate)) {
         return std::nullopt;
     }
 
+    // Not hedged: a second copy of a local server would not start faster,
+    // and spawning one can have side effects
+    auto start = std::chrono::steady_clock::now();
+    auto finish = [&]() {
+        last_probe_.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start);
+    };
     std::unique_ptr<Process> process;
 
     try {
         // Spawn the MCP server process with pipes
-        process = platform_->spawn_process_with_pipes(candidate.command);
+        process = spawn(candidate);
 
         if (!process || !process->is_running()) {
             return std::nullopt;
@@ -61,43 +51,33 @@ std::optional<MCPServer> StdioTestingEngine::test(const Candidate& candidate) {
         process->write_stdin(request_str);
 
         // Read the response from stdout (with timeout)
-        std::string response_line = process->read_stdout_line(timeout_);
-
-        // Parse the JSON response
-        nlohmann::json response;
-        try {
-            response = nlohmann::json::parse(response_line);
-        } catch (const nlohmann::json::parse_error& e) {
-            // Invalid JSON response - not a valid MCP server
+        std::string_view response_line = process->read_stdout_frame(timeout_for(candidate), FrameFormat::Ndjson);
+        finish();
+        auto server = parse_response(candidate, response_line);
+
+        if (server && keep_sessions_) {
+            // Interrogation continues on this initialized process
+            server->session = std::make_shared<StdioMcpSession>(
+                std::move(process), server->protocol_version, server->capabilities);
+        } else {
+            // Terminate the process (we're done testing)
             process->terminate();
-            return std::nullopt;
         }
 
-        // Validate it's a proper JSON-RPC 2.0 response
-        // (accepts both result and error - both are MCP indicators)
-        if (!is_valid_mcp_response(response)) {
+        return server;
+
+    } catch (const ReadTimeout&) {
+        // No answer in time: not an MCP server, or a slow one
+        finish();
+        last_probe_.timed_out = true;
+        if (process && process->is_running()) {
             process->terminate();
-            return std::nullopt;
         }
-
-        // Any valid JSON-RPC 2.0 response is an indicator (success or error)
-
-        // Create MCPServer object from successful response
-        MCPServer server;
-        server.candidate = candidate;
-        server.transport_type = TransportType::Stdio;
-        server.discovered_at = std::chrono::system_clock::now();
-
-        // Extract server information from the initialize response
-        extract_server_info(response, server);
-
-        // Terminate the process (we're done testing)
-        process->terminate();
-
-        return server;
+        return std::nullopt;
 
     } catch (const std::exception& e) {
         // Handle any errors during testing
+        finish();
         std::cerr << "Error testing candidate " << candidate.command << ": "
                   << e.what() << std::endl;
 
@@ -110,6 +90,212 @@ std::optional<MCPServer> StdioTestingEngine::test(const Candidate& candidate) {
     }
 }
 
+std::vector<std::optional<MCPServer>> StdioTestingEngine::test_batch(
+    const std::vector<const Candidate*>& candidates, std::vector<ProbeTiming>* timings) {
+    if (!prefers_batch()) {
+        return TestingEngine::test_batch(candidates, timings);
+    }
+
+    std::vector<std::optional<MCPServer>> servers(candidates.size());
+    if (timings) {
+        timings->assign(candidates.size(), ProbeTiming{});
+    }
+    std::string request_str = create_initialize_request(1).dump() + "\n";
+
+    // Queue a probe per candidate; slot[i] is the reactor index or -1
+    std::vector<long> slot(candidates.size(), -1);
+    std::vector<size_t> position;  // Candidate of each reactor index
+    for (size_t i = 0; i < candidates.size(); i++) {
+        const Candidate& candidate = *candidates[i];
+        if (!should_probe(candidate)) {
+            continue;
+        }
+        slot[i] = static_cast<long>(reactor_->add(
+            [this, &candidate]() { return spawn(candidate); }, request_str, timeout_for(candidate)));
+        position.resize(static_cast<size_t>(slot[i]) + 1);
+        position[static_cast<size_t>(slot[i])] = i;
+    }
+
+    // With a session handler, each responder is passed to a handler thread
+    // as soon as it answers and keeps its reactor slot until its session
+    // is closed, so the reactor never has more live children than slots
+    struct Handoff {
+        size_t position;
+        std::string frame;
+        std::unique_ptr<Process> process;
+    };
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::deque<Handoff> queue;
+    bool done = false;
+    std::vector<bool> handed_off(candidates.size(), false);
+    std::vector<std::thread> threads;
+
+    if (keep_sessions_ && session_handler_) {
+        reactor_->set_response_handler([&](size_t index, ProbeReactor::Result& result) {
+            std::lock_guard<std::mutex> lock(mutex);
+            handed_off[position[index]] = true;
+            queue.push_back({position[index], result.frame, std::move(result.process)});
+            ready.notify_one();
+        });
+        for (size_t t = 0; t < session_threads_; t++) {
+            threads.emplace_back([&, t]() {
+                while (true) {
+                    Handoff handoff;
+                    {
+                        std::unique_lock<std::mutex> lock(mutex);
+                        ready.wait(lock, [&]() { return done || !queue.empty(); });
+                        if (queue.empty()) {
+                            return;
+                        }
+                        handoff = std::move(queue.front());
+                        queue.pop_front();
+                    }
+
+                    const Candidate& candidate = *candidates[handoff.position];
+                    auto server = parse_response(candidate, handoff.frame);
+                    if (server) {
+                        server->session = std::make_shared<StdioMcpSession>(
+                            std::move(handoff.process), server->protocol_version,
+                            server->capabilities);
+                        try {
+                            session_handler_(*server, t);
+                        } catch (const std::exception& e) {
+                            std::cerr << "Error continuing session with " << candidate.command
+                                      << ": " << e.what() << std::endl;
+                        }
+                        server->session.reset();
+                    } else if (handoff.process) {
+                        handoff.process->terminate();
+                    }
+                    servers[handoff.position] = std::move(server);
+                }
+            });
+        }
+    } else {
+        reactor_->set_response_handler(nullptr);
+    }
+
+    auto stop_threads = [&]() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            done = true;
+        }
+        ready.notify_all();
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        reactor_->set_response_handler(nullptr);
+    };
+    std::vector<ProbeReactor::Result> results;
+    try {
+        results = reactor_->run();
+    } catch (...) {
+        stop_threads();
+        throw;
+    }
+    stop_threads();
+
+    for (size_t i = 0; i < candidates.size(); i++) {
+        if (slot[i] < 0) {
+            continue;
+        }
+        const Candidate& candidate = *candidates[i];
+        auto& result = results[static_cast<size_t>(slot[i])];
+        if (timings) {
+            (*timings)[i] = {result.elapsed, result.status == ProbeReactor::Status::Timeout};
+        }
+
+        if (handed_off[i]) {
+            continue;  // Parsed on a handler thread
+        }
+        if (result.status == ProbeReactor::Status::Response) {
+            servers[i] = parse_response(candidate, result.frame);
+        } else if (result.status == ProbeReactor::Status::Error) {
+            std::cerr << "Error testing candidate " << candidate.command << ": "
+                      << result.error << std::endl;
+        }
+        // Timeouts and early exits just mean "not an MCP server"
+    }
+
+    return servers;
+}
+
+bool StdioTestingEngine::prefers_batch() {
+    if (!reactor_checked_) {
+        reactor_checked_ = true;
+        if (platform_) {
+            reactor_ = platform_->create_probe_reactor();
+        }
+    }
+    return reactor_ != nullptr;
+}
+
+bool StdioTestingEngine::should_probe(const Candidate& candidate) const {
+    // Check if candidate has a command to execute
+    if (candidate.command.empty()) {
+        return false;
+    }
+
+    // Only test stdio transport candidates
+    if (candidate.transport_hint != TransportType::Stdio &&
+        candidate.transport_hint != TransportType::Unknown) {
+        return false;
+    }
+
+    if (!platform_) {
+        return false;
+    }
+
+    // PHASE 3: Passive protocol detection (before spawning)
+    // Skip obvious non-MCP processes to save time and avoid false positives
+    ProtocolDetector detector;
+    auto passive_signature = detector.detect_from_process_info(candidate);
+
+    // If confirmed NOT MCP (Chromium IPC or LSP), skip active testing
+    return passive_signature.type != ProtocolType::ChromiumIPC &&
+           passive_signature.type != ProtocolType::LSP;
+}
+
+std::unique_ptr<Process> StdioTestingEngine::spawn(const Candidate& candidate) const {
+    // Prefer the unjoined argv so arguments with spaces survive
+    if (!candidate.argv.empty()) {
+        return platform_->spawn_process_with_pipes(
+            candidate.argv[0],
+            std::vector<std::string>(candidate.argv.begin() + 1, candidate.argv.end()));
+    }
+    return platform_->spawn_process_with_pipes(candidate.command);
+}
+
+std::optional<MCPServer> StdioTestingEngine::parse_response(const Candidate& candidate,
+                                                            std::string_view response_line) {
+    // Parse the JSON response
+    nlohmann::json response;
+    try {
+        response = nlohmann::json::parse(response_line);
+    } catch (const nlohmann::json::parse_error&) {
+        // Invalid JSON response - not a valid MCP server
+        return std::nullopt;
+    }
+
+    // Validate it's a proper JSON-RPC 2.0 response
+    // (accepts both result and error - both are MCP indicators)
+    if (!is_valid_mcp_response(response)) {
+        return std::nullopt;
+    }
+
+    // Create MCPServer object from successful response
+    MCPServer server;
+    server.candidate = candidate;
+    server.transport_type = TransportType::Stdio;
+    server.discovered_at = std::chrono::system_clock::now();
+
+    // Extract server information from the initialize response
+    extract_server_info(response, server);
+
+    return server;
+}
+
 void StdioTestingEngine::extract_server_info(const nlohmann::json& response,
                                              MCPServer& server) {
     if (!response.contains("result")) {
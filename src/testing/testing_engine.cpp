@@ -1,7 +1,24 @@
 #include <kyros/testing/testing_engine.hpp>
+#include <kyros/testing/mcp_session.hpp>
 
 namespace kyros {
 
+std::vector<std::optional<MCPServer>> TestingEngine::test_batch(
+    const std::vector<const Candidate*>& candidates, std::vector<ProbeTiming>* timings) {
+    if (timings) {
+        timings->clear();
+    }
+    std::vector<std::optional<MCPServer>> servers;
+    servers.reserve(candidates.size());
+    for (const Candidate* candidate : candidates) {
+        servers.push_back(test(*candidate));
+        if (timings) {
+            timings->push_back(last_probe_);
+        }
+    }
+    return servers;
+}
+
 bool TestingEngine::is_valid_mcp_response(const nlohmann::json& response) const {
     // Check for required JSON-RPC fields
     if (!response.contains("jsonrpc") || response["jsonrpc"] != "2.0") {
@@ -22,19 +39,7 @@ bool TestingEngine::is_valid_mcp_response(const nlohmann::json& response) const
 }
 
 nlohmann::json TestingEngine::create_initialize_request(int id) const {
-    return nlohmann::json{
-        {"jsonrpc", "2.0"},
-        {"id", id},
-        {"method", "initialize"},
-        {"params", {
-            {"protocolVersion", "2024-11-05"},
-            {"capabilities", nlohmann::json::object()},
-            {"clientInfo", {
-                {"name", "Kyros"},
-                {"version", "2.0.0"}
-            }}
-        }}
-    };
+    return McpSession::initialize_request(id);
 }
 
 } // namespace kyros
@@ -0,0 +1,85 @@
+/**
+ * kyros-rulec: build-time rulepack compiler
+ *
+ * Compiles JSON rulepacks into one compiled rulepack file, or with --cpp
+ * into a C++ source defining kyros::embedded_rulepacks() over the same
+ * bytes. The build runs it to embed the default rulepacks; it links only
+ * the rule sources so it can run before the library exists.
+ *
+ *   kyros-rulec [--cpp] -o OUTPUT INPUT.json...
+ */
+
+#include <kyros/rulepack_binary.hpp>
+
+#include <cstdio>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::string to_cpp(const std::string& data, const std::vector<std::string>& inputs) {
+    std::string out = "// Generated by kyros-rulec from";
+    for (const auto& input : inputs) {
+        out += " " + input.substr(input.find_last_of("/\\") + 1);
+    }
+    out +=
+        "; do not edit\n\n"
+        "#include <kyros/rulepack_binary.hpp>\n\n"
+        "namespace kyros {\n\n"
+        "namespace {\n\n"
+        "alignas(8) const unsigned char kEmbeddedRulepacks[] = {";
+    char byte[8];
+    for (size_t i = 0; i < data.size(); i++) {
+        std::snprintf(byte, sizeof(byte), "0x%02x,", static_cast<unsigned char>(data[i]));
+        out += i % 16 == 0 ? "\n    " : " ";
+        out += byte;
+    }
+    out +=
+        "\n};\n\n"
+        "} // namespace\n\n"
+        "std::string_view embedded_rulepacks() {\n"
+        "    return std::string_view(reinterpret_cast<const char*>(kEmbeddedRulepacks),\n"
+        "                            sizeof(kEmbeddedRulepacks));\n"
+        "}\n\n"
+        "} // namespace kyros\n";
+    return out;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bool cpp = false;
+    std::string output;
+    std::vector<std::string> inputs;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--cpp") {
+            cpp = true;
+        } else if (arg == "-o" && i + 1 < argc) {
+            output = argv[++i];
+        } else {
+            inputs.push_back(arg);
+        }
+    }
+    if (output.empty() || inputs.empty()) {
+        std::cerr << "Usage: kyros-rulec [--cpp] -o OUTPUT INPUT.json...\n";
+        return 2;
+    }
+
+    try {
+        std::string data = kyros::compile_rulepack_files(inputs);
+        std::ofstream file(output, std::ios::binary | std::ios::trunc);
+        file << (cpp ? to_cpp(data, inputs) : data);
+        if (!file.flush()) {
+            throw std::runtime_error("Failed to write " + output);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "kyros-rulec: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,56 @@
+// JSON state files under the user's cache directory
+
+#include <kyros/utils/cache_file.hpp>
+
+#include <unistd.h>
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+namespace kyros {
+
+std::string cache_file_path(const std::string& name) {
+    const char* cache_home = std::getenv("XDG_CACHE_HOME");
+    if (cache_home && *cache_home) {
+        return std::string(cache_home) + "/kyros/" + name;
+    }
+    const char* home = std::getenv("HOME");
+    if (home && *home) {
+        return std::string(home) + "/.cache/kyros/" + name;
+    }
+    return "";
+}
+
+void write_json_atomically(const std::string& path, const nlohmann::json& json) {
+    std::filesystem::path target(path);
+    if (target.has_parent_path()) {
+        std::filesystem::create_directories(target.parent_path());
+    }
+    std::string temp = path + ".tmp" + std::to_string(getpid());
+    try {
+        {
+            std::ofstream file(temp, std::ios::trunc);
+            file << json.dump();
+            if (!file.flush()) {
+                throw std::runtime_error("write failed");
+            }
+        }
+        std::filesystem::rename(temp, target);
+    } catch (...) {
+        std::error_code ignored;
+        std::filesystem::remove(temp, ignored);
+        throw;
+    }
+}
+
+int64_t to_epoch_seconds(Timestamp time) {
+    return std::chrono::duration_cast<std::chrono::seconds>(time.time_since_epoch()).count();
+}
+
+Timestamp from_epoch_seconds(int64_t seconds) {
+    return Timestamp(std::chrono::seconds(seconds));
+}
+
+} // namespace kyros
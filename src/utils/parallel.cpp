@@ -0,0 +1,58 @@
+// Fork-join helper for running independent work items on a few threads
+
+#include <kyros/utils/parallel.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace kyros {
+
+void parallel_for(size_t count, size_t max_workers, const std::function<void(size_t)>& body) {
+    parallel_for_workers(count, max_workers, [&](size_t index, size_t) { body(index); });
+}
+
+size_t parallel_worker_count(size_t count, size_t max_workers) {
+    return std::min(count, std::max<size_t>(max_workers, 1));
+}
+
+void parallel_for_workers(size_t count, size_t max_workers,
+                          const std::function<void(size_t index, size_t worker)>& body) {
+    if (count == 0) {
+        return;
+    }
+
+    size_t workers = parallel_worker_count(count, max_workers);
+    std::atomic<size_t> next{0};
+    std::vector<std::exception_ptr> errors(count);
+
+    auto work = [&](size_t worker) {
+        for (size_t i = next.fetch_add(1); i < count; i = next.fetch_add(1)) {
+            try {
+                body(i, worker);
+            } catch (...) {
+                errors[i] = std::current_exception();
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(workers - 1);
+    for (size_t worker = 1; worker < workers; worker++) {
+        threads.emplace_back(work, worker);
+    }
+    work(0);  // The calling thread is worker 0 (and the only one if workers == 1)
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (const auto& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+} // namespace kyros
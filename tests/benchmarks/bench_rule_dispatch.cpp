@@ -0,0 +1,123 @@
+// Per-candidate cost of RuleMatcher::apply as the rule count grows
+//
+// Loads N synthetic rules (literals, ports and evidence types, none of which
+// match) plus the shipped rulepacks, then times apply() over a fixed set of
+// candidates. With indexed dispatch the per-candidate time should stay
+// roughly flat from 100 to 10,000 rules. Both columns run over the same
+// 4,000 candidates: apply() one at a time, then apply_batch() on all.
+//
+// Usage: bench_rule_dispatch [iterations]   (run from tests/)
+
+#include <kyros/rule_matcher.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace kyros;
+
+namespace {
+
+Rulepack synthetic_rulepack(int rule_count) {
+    nlohmann::json rules = nlohmann::json::array();
+    for (int i = 0; i < rule_count; i++) {
+        std::string name = "synthetic-server-" + std::to_string(i);
+        nlohmann::json match;
+        switch (i % 4) {
+            case 0: match = {{"command_contains", name}}; break;
+            case 1: match = {{"process_name", name}, {"port", 40000 + i % 20000}}; break;
+            case 2: match = {{"port", 40000 + i % 20000}}; break;
+            case 3: match = {{"has_evidence_type", name}}; break;
+        }
+        rules.push_back({{"name", name}, {"match", match},
+                         {"action", {{"add_evidence", {{"type", name}}}}}});
+    }
+    return Rulepack::load_from_json({{"name", "synthetic"}, {"rules", rules}});
+}
+
+std::vector<Candidate> sample_candidates() {
+    std::vector<Candidate> candidates(4);
+    candidates[0].process_name = "node";
+    candidates[0].command = "npx -y @modelcontextprotocol/server-filesystem /tmp";
+    candidates[1].process_name = "python3";
+    candidates[1].command = "python3 -m mcp_server_git --repository /srv/repo";
+    candidates[1].url = "http://127.0.0.1:8000/mcp";
+    candidates[1].port = 8000;
+    candidates[2].process_name = "docker";
+    candidates[2].command = "docker run -i --rm mcp/fetch";
+    candidates[3].process_name = "code";
+    candidates[3].command = "/usr/share/code/code --type=renderer --enable-crash-reporter";
+    return candidates;
+}
+
+// Elapsed nanoseconds of `run` over a fresh copy of `host`, per candidate
+template <typename Run>
+double time_per_candidate(const std::vector<Candidate>& host, int iterations, Run&& run) {
+    int64_t total = 0;
+    for (int i = 0; i < iterations; i++) {
+        std::vector<Candidate> copy = host;
+        auto start = std::chrono::steady_clock::now();
+        run(copy);
+        total += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                     std::chrono::steady_clock::now() - start)
+                     .count();
+    }
+    return static_cast<double>(total) /
+           (static_cast<double>(iterations) * static_cast<double>(host.size()));
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int iterations = argc > 1 ? std::atoi(argv[1]) : 20;
+
+    std::vector<Rulepack> shipped;
+    for (const char* path : {"../config/rulepacks/default.json",
+                             "../config/rulepacks/docker-mcp.json",
+                             "../config/rulepacks/exclusions.json"}) {
+        try {
+            shipped.push_back(Rulepack::load_from_file(path));
+        } catch (const std::exception& e) {
+            std::fprintf(stderr, "Skipping %s: %s\n", path, e.what());
+        }
+    }
+
+    // A large host: the sample candidates repeated, with worker pools
+    // sharing a command line four at a time
+    const auto samples = sample_candidates();
+    std::vector<Candidate> host;
+    for (int i = 0; i < 1000; i++) {
+        for (auto candidate : samples) {
+            candidate.pid = static_cast<int>(host.size()) + 1;
+            candidate.command += " --worker " + std::to_string(i / 4);
+            host.push_back(std::move(candidate));
+        }
+    }
+
+    std::printf("%8s %14s %16s %20s\n", "rules", "ns/candidate", "rules evaluated",
+                "batch ns/candidate");
+    for (int rule_count : {100, 1000, 10000}) {
+        std::vector<Rulepack> rulepacks = shipped;
+        rulepacks.push_back(synthetic_rulepack(rule_count));
+        RuleMatcher matcher(rulepacks);
+
+        size_t evaluated = 0;
+        double single = time_per_candidate(host, iterations, [&](std::vector<Candidate>& copy) {
+            for (auto& candidate : copy) {
+                evaluated += matcher.apply(candidate);
+            }
+        });
+        double batch = time_per_candidate(host, iterations, [&](std::vector<Candidate>& copy) {
+            matcher.apply_batch(copy);
+        });
+
+        std::printf("%8d %14.0f %16.1f %20.0f\n", rule_count, single,
+                    static_cast<double>(evaluated) /
+                        (static_cast<double>(iterations) * static_cast<double>(host.size())),
+                    batch);
+    }
+    return 0;
+}
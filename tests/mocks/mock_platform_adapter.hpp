@@ -31,6 +31,7 @@ public:
     MOCK_METHOD(int, get_parent_pid, (int), (override));
     MOCK_METHOD((std::map<std::string, std::string>), get_environment, (int), (override));
     MOCK_METHOD(bool, has_bidirectional_pipes, (int), (override));
+    MOCK_METHOD((std::shared_ptr<const PipeIndex>), build_pipe_index, (), (override));
 
     // Network operations
     MOCK_METHOD(std::vector<NetworkListener>, get_listening_sockets, (), (override));
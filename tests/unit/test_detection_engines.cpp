@@ -6,12 +6,17 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 #include <kyros/detection/detection_engine.hpp>
+#include <kyros/detection/process_detection_engine.hpp>
+#include <kyros/detection/config_detection_engine.hpp>
 #include <kyros/candidate.hpp>
 #include <kyros/rulepack.hpp>
+#include "../mocks/mock_platform_adapter.hpp"
 #include "test_helpers.hpp"
 
 using namespace kyros;
 using namespace kyros::test;
+using ::testing::NiceMock;
+using ::testing::Return;
 
 // ============================================================================
 // Detection Engine Basic Tests
@@ -185,3 +190,206 @@ TEST(DetectionEngineTest, RulepackSourceIndicatesDirectDetection) {
 
     EXPECT_TRUE(candidate.is_direct_detection());
 }
+
+// ============================================================================
+// Process Detection Engine Tests
+// ============================================================================
+
+static bool has_evidence(const Candidate& candidate, const std::string& type) {
+    for (const auto& e : candidate.evidence) {
+        if (e.type == type) return true;
+    }
+    return false;
+}
+
+TEST(ProcessDetectionEngineTest, ReportsClientHoldingStdioPipes) {
+    auto adapter = std::make_shared<NiceMock<MockPlatformAdapter>>();
+    adapter->set_process_list({100, 200});
+    ON_CALL(*adapter, get_process_name(100)).WillByDefault(Return("Claude"));
+    ON_CALL(*adapter, get_process_name(200)).WillByDefault(Return("node"));
+    ON_CALL(*adapter, get_command_line(200)).WillByDefault(Return("node server.js"));
+    ON_CALL(*adapter, get_parent_pid(200)).WillByDefault(Return(1));
+
+    // Server 200 reads pipe 11 and writes pipe 12; the client holds the
+    // other ends on ordinary descriptors
+    auto pipes = std::make_shared<PipeIndex>();
+    pipes->add(200, 0, 11);
+    pipes->add(200, 1, 12);
+    pipes->add(100, 37, 11);
+    pipes->add(100, 38, 12);
+    ON_CALL(*adapter, build_pipe_index()).WillByDefault(Return(pipes));
+
+    ProcessDetectionEngine engine;
+    engine.set_platform_adapter(adapter);
+    auto candidates = engine.detect();
+
+    ASSERT_EQ(candidates.size(), 1u);
+    EXPECT_EQ(candidates[0].pid, 200);
+    EXPECT_EQ(candidates[0].transport_hint, TransportType::Stdio);
+    EXPECT_TRUE(has_evidence(candidates[0], "stdio_client"));
+}
+
+TEST(ProcessDetectionEngineTest, IgnoresShellPipelineNeighbours) {
+    auto adapter = std::make_shared<NiceMock<MockPlatformAdapter>>();
+    adapter->set_process_list({100, 200});
+    ON_CALL(*adapter, get_process_name(100)).WillByDefault(Return("Claude"));
+    ON_CALL(*adapter, get_process_name(200)).WillByDefault(Return("grep"));
+    ON_CALL(*adapter, get_command_line(200)).WillByDefault(Return("grep foo"));
+
+    // `Claude | grep foo`: the neighbour holds the pipe as its own stdout
+    auto pipes = std::make_shared<PipeIndex>();
+    pipes->add(200, 0, 11);
+    pipes->add(200, 1, 12);
+    pipes->add(100, 1, 11);
+    ON_CALL(*adapter, build_pipe_index()).WillByDefault(Return(pipes));
+
+    ProcessDetectionEngine engine;
+    engine.set_platform_adapter(adapter);
+    auto candidates = engine.detect();
+
+    ASSERT_EQ(candidates.size(), 1u);
+    EXPECT_FALSE(has_evidence(candidates[0], "stdio_client"));
+}
+
+TEST(ProcessDetectionEngineTest, ReevaluatesOnlyNewProcessGenerations) {
+    auto adapter = std::make_shared<NiceMock<MockPlatformAdapter>>();
+    std::map<std::string, std::string> env = {{"MCP_SERVER_NAME", "files"}};
+    ON_CALL(*adapter, get_environment(200)).WillByDefault(Return(env));
+
+    auto first = std::make_shared<ProcessTable>();
+    first->add(100, 1, 501, 1000, "bash", {"bash"});
+    first->add(200, 100, 501, 2000, "node", {"node", "server.js"});
+
+    ProcessDetectionEngine engine;
+    engine.set_platform_adapter(adapter);
+    engine.set_process_snapshot(first);
+
+    EXPECT_CALL(*adapter, get_environment(200)).Times(1);
+    EXPECT_CALL(*adapter, get_environment(100)).Times(1);
+    auto candidates = engine.detect();
+    EXPECT_EQ(engine.get_last_scan_evaluated_count(), 2);
+    ASSERT_EQ(candidates.size(), 1u);
+
+    // Same processes again: environment is not re-read, evidence is kept
+    candidates = engine.detect();
+    EXPECT_EQ(engine.get_last_scan_evaluated_count(), 0);
+    ASSERT_EQ(candidates.size(), 1u);
+    EXPECT_TRUE(has_evidence(candidates[0], "environment"));
+    ::testing::Mock::VerifyAndClearExpectations(adapter.get());
+
+    // PID 200 reused by a new process: re-evaluated
+    auto second = std::make_shared<ProcessTable>();
+    second->add(100, 1, 501, 1000, "bash", {"bash"});
+    second->add(200, 100, 501, 3000, "node", {"node", "server.js"});
+    engine.set_process_snapshot(second);
+
+    ON_CALL(*adapter, get_environment(200)).WillByDefault(Return(env));
+    EXPECT_CALL(*adapter, get_environment(200)).Times(1);
+    EXPECT_CALL(*adapter, get_environment(100)).Times(0);
+    engine.detect();
+    EXPECT_EQ(engine.get_last_scan_evaluated_count(), 1);
+    ::testing::Mock::VerifyAndClearExpectations(adapter.get());
+
+    // PID 200 exec'd the same command line: re-evaluated
+    auto third = std::make_shared<ProcessTable>();
+    third->add(100, 1, 501, 1000, "bash", {"bash"});
+    third->add(200, 100, 501, 3000, "node", {"node", "server.js"}, 1);
+    engine.set_process_snapshot(third);
+
+    ON_CALL(*adapter, get_environment(200)).WillByDefault(Return(env));
+    EXPECT_CALL(*adapter, get_environment(200)).Times(1);
+    EXPECT_CALL(*adapter, get_environment(100)).Times(0);
+    engine.detect();
+    EXPECT_EQ(engine.get_last_scan_evaluated_count(), 1);
+}
+
+TEST(ProcessDetectionEngineTest, ReportsRulepackEnvironmentPrefixes) {
+    auto adapter = std::make_shared<NiceMock<MockPlatformAdapter>>();
+    std::map<std::string, std::string> env = {{"ACME_AGENT_PORT", "7000"}, {"PATH", "/bin"}};
+    ON_CALL(*adapter, get_environment(200)).WillByDefault(Return(env));
+
+    auto table = std::make_shared<ProcessTable>();
+    table->add(200, 1, 501, 2000, "node", {"node", "server.js"});
+
+    ProcessDetectionEngine engine;
+    engine.set_platform_adapter(adapter);
+    engine.set_process_snapshot(table);
+
+    // Nothing matches the built-in prefixes
+    EXPECT_TRUE(engine.detect().empty());
+
+    // New prefixes invalidate cached results
+    engine.set_environment_prefixes({"ACME_"});
+    auto candidates = engine.detect();
+    EXPECT_EQ(engine.get_last_scan_evaluated_count(), 1);
+    ASSERT_EQ(candidates.size(), 1u);
+    EXPECT_TRUE(has_evidence(candidates[0], "environment"));
+}
+
+// ============================================================================
+// Config Detection Engine Tests
+// ============================================================================
+
+#ifdef PLATFORM_LINUX
+#include <filesystem>
+#include <fstream>
+#include <unistd.h>
+
+static size_t count_from(const std::vector<Candidate>& candidates, const std::string& path) {
+    size_t count = 0;
+    for (const auto& c : candidates) {
+        if (c.config_file == path) count++;
+    }
+    return count;
+}
+
+TEST(ConfigDetectionEngineTest, WatchModeReparsesOnlyChangedFiles) {
+    namespace fs = std::filesystem;
+    fs::path root = fs::temp_directory_path() / ("kyros_watch_" + std::to_string(getpid()));
+    fs::remove_all(root);
+    fs::create_directories(root);
+
+    // The config's directory doesn't exist yet; its creation must be seen
+    std::string config_path = (root / "app" / "mcp.json").string();
+
+    auto scan = std::make_shared<ConfigScan>();
+    scan->add_config_path(config_path);
+
+    ConfigDetectionEngine engine(scan);
+    engine.set_platform_adapter(std::shared_ptr<PlatformAdapter>(create_platform_adapter()));
+    engine.set_watch_mode(true);
+
+    auto candidates = engine.detect();
+    EXPECT_EQ(count_from(candidates, config_path), 0u);
+
+    fs::create_directories(root / "app");
+    {
+        std::ofstream file(config_path);
+        file << R"({"mcpServers": {"files": {"command": "npx", "args": ["server-files"]}}})";
+    }
+    EXPECT_TRUE(engine.wait_for_changes(1000));
+
+    candidates = engine.detect();
+    EXPECT_EQ(count_from(candidates, config_path), 1u);
+    EXPECT_EQ(engine.get_last_scan_parsed_count(), 1);
+
+    // Nothing changed: served from cache
+    candidates = engine.detect();
+    EXPECT_EQ(count_from(candidates, config_path), 1u);
+    EXPECT_EQ(engine.get_last_scan_parsed_count(), 0);
+
+    // Atomic replace via rename
+    {
+        std::ofstream file(config_path + ".tmp");
+        file << R"({"mcpServers": {"files": {"command": "npx"}, "git": {"command": "uvx"}}})";
+    }
+    fs::rename(config_path + ".tmp", config_path);
+    engine.wait_for_changes(1000);
+
+    candidates = engine.detect();
+    EXPECT_EQ(count_from(candidates, config_path), 2u);
+    EXPECT_EQ(engine.get_last_scan_parsed_count(), 1);
+
+    fs::remove_all(root);
+}
+#endif // PLATFORM_LINUX
@@ -0,0 +1,603 @@
+/**
+ * Kyros HTTP Client Test Suite
+ * Tests response parsing, chunked decoding, the keep-alive pool and
+ * pre-flight sniffing against loopback servers
+ */
+
+#include <gtest/gtest.h>
+#include <kyros/http/http_client.hpp>
+#include <kyros/http/http_parser.hpp>
+#include <kyros/testing/http_testing_engine.hpp>
+#include <kyros/testing/mcp_session.hpp>
+#include <kyros/testing/preflight.hpp>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace kyros;
+
+namespace {
+
+/**
+ * Loopback HTTP server that answers each request with the next scripted
+ * response, serving connections one at a time
+ */
+class ScriptedServer {
+public:
+    explicit ScriptedServer(std::vector<std::string> responses)
+        : responses_(std::move(responses)) {
+        listen_fd_ = socket(AF_INET, SOCK_STREAM, 0);
+        struct sockaddr_in addr = {};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        bind(listen_fd_, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr));
+        listen(listen_fd_, 8);
+        socklen_t length = sizeof(addr);
+        getsockname(listen_fd_, reinterpret_cast<struct sockaddr*>(&addr), &length);
+        port_ = ntohs(addr.sin_port);
+        thread_ = std::thread([this]() { serve(); });
+    }
+
+    ~ScriptedServer() {
+        shutdown(listen_fd_, SHUT_RDWR);
+        close(listen_fd_);
+        thread_.join();
+    }
+
+    std::string url(const std::string& path = "") const {
+        return "http://127.0.0.1:" + std::to_string(port_) + path;
+    }
+
+    int connections() const { return connections_; }
+    const std::vector<std::string>& requests() const { return requests_; }
+
+private:
+    int listen_fd_ = -1;
+    int port_ = 0;
+    std::vector<std::string> responses_;
+    std::vector<std::string> requests_;
+    std::atomic<int> connections_{0};
+    std::thread thread_;
+
+    void serve() {
+        size_t next = 0;
+        while (next < responses_.size()) {
+            int fd = accept(listen_fd_, nullptr, nullptr);
+            if (fd < 0) {
+                return;
+            }
+            connections_++;
+            std::string buffer;
+            while (next < responses_.size() && read_request(fd, buffer)) {
+                const std::string& response = responses_[next++];
+                if (send(fd, response.data(), response.size(), MSG_NOSIGNAL) < 0) {
+                    break;
+                }
+                if (response.find("Connection: close") != std::string::npos) {
+                    break;
+                }
+            }
+            close(fd);
+        }
+    }
+
+    // Read one request (head plus Content-Length body) into requests_
+    bool read_request(int fd, std::string& buffer) {
+        while (true) {
+            size_t head_end = buffer.find("\r\n\r\n");
+            if (head_end != std::string::npos) {
+                size_t length = 0;
+                size_t field = buffer.find("Content-Length: ");
+                if (field != std::string::npos && field < head_end) {
+                    length = std::stoul(buffer.substr(field + 16));
+                }
+                size_t total = head_end + 4 + length;
+                if (buffer.size() >= total) {
+                    requests_.push_back(buffer.substr(0, total));
+                    buffer.erase(0, total);
+                    return true;
+                }
+            }
+            char chunk[4096];
+            ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+            if (n <= 0) {
+                return false;
+            }
+            buffer.append(chunk, static_cast<size_t>(n));
+        }
+    }
+};
+
+/**
+ * Loopback HTTP server answering by request path, one thread per
+ * connection. Paths without a route never get an answer.
+ */
+class RoutedServer {
+public:
+    // The first `stalled` requests for each routed path get no answer either
+    explicit RoutedServer(std::map<std::string, std::string> routes, size_t stalled = 0)
+        : routes_(std::move(routes)), stalled_(stalled) {
+        listen_fd_ = socket(AF_INET, SOCK_STREAM, 0);
+        struct sockaddr_in addr = {};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        bind(listen_fd_, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr));
+        listen(listen_fd_, 16);
+        socklen_t length = sizeof(addr);
+        getsockname(listen_fd_, reinterpret_cast<struct sockaddr*>(&addr), &length);
+        port_ = ntohs(addr.sin_port);
+        accept_thread_ = std::thread([this]() { serve(); });
+    }
+
+    // Clients must have closed their connections by now
+    ~RoutedServer() {
+        shutdown(listen_fd_, SHUT_RDWR);
+        close(listen_fd_);
+        accept_thread_.join();
+        for (auto& thread : connection_threads_) {
+            thread.join();
+        }
+    }
+
+    std::string url() const { return "http://127.0.0.1:" + std::to_string(port_); }
+
+private:
+    int listen_fd_ = -1;
+    int port_ = 0;
+    std::map<std::string, std::string> routes_;
+    size_t stalled_ = 0;
+    std::mutex mutex_;
+    std::map<std::string, size_t> requests_;
+    std::thread accept_thread_;
+    std::vector<std::thread> connection_threads_;
+
+    void serve() {
+        while (true) {
+            int fd = accept(listen_fd_, nullptr, nullptr);
+            if (fd < 0) {
+                return;
+            }
+            connection_threads_.emplace_back([this, fd]() { handle(fd); });
+        }
+    }
+
+    void handle(int fd) {
+        std::string buffer;
+        char chunk[4096];
+        ssize_t n;
+        while ((n = recv(fd, chunk, sizeof(chunk), 0)) > 0) {
+            buffer.append(chunk, static_cast<size_t>(n));
+            size_t head_end = buffer.find("\r\n\r\n");
+            if (head_end == std::string::npos) {
+                continue;
+            }
+            // Bodies are small enough to arrive with the head
+            size_t path_start = buffer.find(' ') + 1;
+            std::string path = buffer.substr(path_start, buffer.find(' ', path_start) - path_start);
+            buffer.clear();
+
+            auto route = routes_.find(path);
+            if (route != routes_.end()) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (++requests_[path] > stalled_) {
+                    send(fd, route->second.data(), route->second.size(), MSG_NOSIGNAL);
+                }
+            }
+        }
+        close(fd);
+    }
+};
+
+std::string json_response(const std::string& body) {
+    return "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Length: " +
+           std::to_string(body.size()) + "\r\n\r\n" + body;
+}
+
+std::vector<nlohmann::json> list_requests() {
+    return {
+        {{"jsonrpc", "2.0"}, {"id", 1}, {"method", "tools/list"}},
+        {{"jsonrpc", "2.0"}, {"id", 2}, {"method", "prompts/list"}},
+    };
+}
+
+} // namespace
+
+TEST(HttpParserTest, ParsesStatusLineAndHeaders) {
+    std::string data = "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\n"
+                       "X-Empty:\r\nContent-Length:  7 \r\n\r\nbody...";
+    HttpResponseHead head;
+    ASSERT_EQ(parse_response_head(data, head), HttpParseResult::Complete);
+    EXPECT_EQ(head.status_code, 200);
+    EXPECT_EQ(head.minor_version, 1);
+    EXPECT_EQ(head.size, data.size() - 7);
+    ASSERT_EQ(head.headers.size(), 3u);
+    EXPECT_EQ(head.find("content-length"), "7");
+    EXPECT_EQ(head.find("CONTENT-TYPE"), "application/json");
+    EXPECT_EQ(head.find("x-empty"), "");
+
+    EXPECT_EQ(parse_response_head("HTTP/1.1 200 OK\r\nContent-", head), HttpParseResult::Incomplete);
+    EXPECT_EQ(parse_response_head("HTT", head), HttpParseResult::Incomplete);
+    EXPECT_EQ(parse_response_head("SSH-2.0-OpenSSH\r\n", head), HttpParseResult::Invalid);
+    EXPECT_EQ(parse_response_head("HTTP/1.1 2x0 OK\r\n\r\n", head), HttpParseResult::Invalid);
+}
+
+TEST(HttpParserTest, DecodesChunkedBodySplitAnywhere) {
+    std::string encoded = "4;ext=1\r\nWiki\r\n5\r\npedia\r\nE\r\n in\r\n\r\nchunks.\r\n0\r\nX-Trailer: 1\r\n\r\n";
+
+    // Feed the encoding in every possible pair of pieces
+    for (size_t split = 0; split <= encoded.size(); split++) {
+        ChunkedDecoder decoder;
+        std::string body;
+        std::string pending = encoded.substr(0, split);
+        size_t consumed = 0;
+
+        auto result = decoder.decode(pending, consumed, body);
+        pending.erase(0, consumed);
+        if (result != HttpParseResult::Complete) {
+            ASSERT_EQ(result, HttpParseResult::Incomplete) << "split at " << split;
+            pending += encoded.substr(split);
+            result = decoder.decode(pending, consumed, body);
+        }
+        ASSERT_EQ(result, HttpParseResult::Complete) << "split at " << split;
+        EXPECT_EQ(body, "Wikipedia in\r\n\r\nchunks.");
+    }
+
+    ChunkedDecoder decoder;
+    std::string body;
+    size_t consumed = 0;
+    EXPECT_EQ(decoder.decode("zz\r\n", consumed, body), HttpParseResult::Invalid);
+}
+
+TEST(HttpClientTest, ReusesKeepAliveConnection) {
+    ScriptedServer server({
+        "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Length: 11\r\n\r\n{\"id\":\"a\"}\n",
+        "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n\r\n",
+        "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n3\r\n{\"i\r\n7\r\nd\":\"c\"}\r\n0\r\n\r\n",
+    });
+
+    HttpClient client;
+    auto first = client.post(server.url("/mcp"), "{\"jsonrpc\":\"2.0\"}");
+    EXPECT_TRUE(first.success);
+    EXPECT_EQ(first.body, "{\"id\":\"a\"}\n");
+    EXPECT_EQ(first.headers["content-type"], "application/json");
+    EXPECT_EQ(client.idle_connections(), 1u);
+
+    auto second = client.get(server.url("/missing"));
+    EXPECT_FALSE(second.success);
+    EXPECT_EQ(second.status_code, 404);
+
+    auto third = client.post(server.url("/rpc"), "{}");
+    EXPECT_TRUE(third.success);
+    EXPECT_EQ(third.body, "{\"id\":\"c\"}");
+
+    EXPECT_EQ(server.connections(), 1);
+    ASSERT_EQ(server.requests().size(), 3u);
+    EXPECT_EQ(server.requests()[0].rfind("POST /mcp HTTP/1.1\r\n", 0), 0u);
+    EXPECT_NE(server.requests()[0].find("Content-Type: application/json\r\n"), std::string::npos);
+    EXPECT_NE(server.requests()[0].find("Content-Length: 17\r\n\r\n{\"jsonrpc\":\"2.0\"}"),
+              std::string::npos);
+    EXPECT_EQ(server.requests()[1].rfind("GET /missing HTTP/1.1\r\n", 0), 0u);
+}
+
+TEST(HttpClientTest, ReconnectsAfterConnectionClose) {
+    ScriptedServer server({
+        "HTTP/1.1 200 OK\r\nConnection: close\r\nContent-Length: 2\r\n\r\nok",
+        "HTTP/1.1 200 OK\r\nContent-Length: 5\r\n\r\nagain",
+    });
+
+    HttpClient client;
+    EXPECT_EQ(client.get(server.url()).body, "ok");
+    EXPECT_EQ(client.idle_connections(), 0u);
+    EXPECT_EQ(client.get(server.url()).body, "again");
+    EXPECT_EQ(server.connections(), 2);
+}
+
+TEST(HttpClientTest, ReturnsFirstEventOfOpenStream) {
+    // The second entry keeps the server waiting, so the stream stays open
+    ScriptedServer server({
+        "HTTP/1.1 200 OK\r\nContent-Type: text/event-stream\r\n\r\n"
+        "event: endpoint\ndata: /messages?session=1\n\n",
+        "unused",
+    });
+
+    HttpClient client;
+    auto start = std::chrono::steady_clock::now();
+    auto response = client.get(server.url("/sse"), {{"Accept", "text/event-stream"}},
+                               std::chrono::milliseconds(5000));
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(1000));
+
+    EXPECT_TRUE(response.success);
+    EXPECT_EQ(response.body, "event: endpoint\ndata: /messages?session=1\n\n");
+    EXPECT_EQ(client.idle_connections(), 0u);
+}
+
+TEST(HttpClientTest, HonoursSubSecondTimeout) {
+    // Connections complete from the listen backlog, but nothing answers
+    int listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    ASSERT_EQ(bind(listen_fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)), 0);
+    ASSERT_EQ(listen(listen_fd, 8), 0);
+    socklen_t length = sizeof(addr);
+    getsockname(listen_fd, reinterpret_cast<struct sockaddr*>(&addr), &length);
+    std::string url = "http://127.0.0.1:" + std::to_string(ntohs(addr.sin_port)) + "/";
+
+    HttpClient client;
+    auto start = std::chrono::steady_clock::now();
+    auto response = client.post(url, "{}", {}, std::chrono::milliseconds(200));
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    EXPECT_FALSE(response.success);
+    EXPECT_EQ(response.status_code, 0);
+    EXPECT_EQ(response.error_message, "Request timed out");
+    EXPECT_GE(elapsed, std::chrono::milliseconds(150));
+    EXPECT_LT(elapsed, std::chrono::milliseconds(1000));
+
+    close(listen_fd);
+}
+
+TEST(HttpTestingEngineTest, RacesVariantsAndCancelsLosers) {
+    RoutedServer server(std::map<std::string, std::string>{
+        {"/rpc", "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Length: 88\r\n\r\n"
+                 "{\"jsonrpc\":\"2.0\",\"id\":1,\"result\":{\"serverInfo\":{\"name\":\"slow-paths\"},\"capabilities\":{}}}"},
+    });
+
+    auto client = std::make_shared<HttpClient>();
+    HttpTestingEngine engine(client);
+    engine.set_timeout(std::chrono::milliseconds(3000));
+
+    Candidate candidate;
+    candidate.url = server.url();
+    candidate.transport_hint = TransportType::Http;
+
+    // /sse, "" and /messages never answer; tried in turn, that would be
+    // three full timeouts before /rpc
+    auto start = std::chrono::steady_clock::now();
+    auto result = engine.test(candidate);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(result->candidate.url, server.url() + "/rpc");
+    EXPECT_EQ(result->server_name, "slow-paths");
+    EXPECT_LT(elapsed, std::chrono::milliseconds(1000));
+
+    // The winner's connection is kept for interrogation
+    EXPECT_EQ(client->idle_connections(), 1u);
+    client->close_idle_connections();
+}
+
+TEST(HttpTestingEngineTest, HedgesVariantsStillUnansweredAtTheHedgePoint) {
+    std::map<std::string, std::string> routes{
+        {"/rpc", "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Length: 88\r\n\r\n"
+                 "{\"jsonrpc\":\"2.0\",\"id\":1,\"result\":{\"serverInfo\":{\"name\":\"slow-paths\"},\"capabilities\":{}}}"},
+    };
+    RoutedServer server(routes, 1);
+
+    auto client = std::make_shared<HttpClient>();
+    HttpTestingEngine engine(client);
+    engine.set_timeout(std::chrono::milliseconds(3000));
+    engine.set_hedge_function([](const Candidate&) { return std::chrono::milliseconds(100); });
+
+    Candidate candidate;
+    candidate.url = server.url();
+    candidate.transport_hint = TransportType::Http;
+
+    // The first /rpc request stalls; its copy, sent at the hedge point,
+    // answers and cancels it
+    auto start = std::chrono::steady_clock::now();
+    auto result = engine.test(candidate);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(result->candidate.url, server.url() + "/rpc");
+    EXPECT_LT(elapsed, std::chrono::milliseconds(1000));
+    EXPECT_TRUE(engine.last_probe().hedged);
+    EXPECT_FALSE(engine.last_probe().timed_out);
+    EXPECT_EQ(client->idle_connections(), 1u);
+    client->close_idle_connections();
+
+    // Unhedged, the stall runs the probe out of time, and that is reported
+    RoutedServer stalling(routes, 1);
+    candidate.url = stalling.url();
+    engine.set_hedge_function(nullptr);
+    engine.set_timeout(std::chrono::milliseconds(300));
+    EXPECT_FALSE(engine.test(candidate).has_value());
+    EXPECT_FALSE(engine.last_probe().hedged);
+    EXPECT_TRUE(engine.last_probe().timed_out);
+    client->close_idle_connections();
+}
+
+TEST(McpSessionTest, HttpSendsListsAsOneBatch) {
+    ScriptedServer server({
+        "HTTP/1.1 202 Accepted\r\nContent-Length: 0\r\n\r\n",
+        json_response("[{\"jsonrpc\":\"2.0\",\"id\":2,\"result\":{\"prompts\":[]}},"
+                      "{\"jsonrpc\":\"2.0\",\"id\":1,\"result\":{\"tools\":[]}}]"),
+    });
+
+    auto client = std::make_shared<HttpClient>();
+    HttpMcpSession session(client, server.url(), "abc", "2024-11-05", nlohmann::json::object());
+    auto responses = session.request_all(list_requests(), std::chrono::milliseconds(2000));
+    client->close_idle_connections();
+
+    // Answered out of order, returned in request order
+    ASSERT_EQ(responses.size(), 2u);
+    EXPECT_TRUE(responses[0]["result"].contains("tools"));
+    EXPECT_TRUE(responses[1]["result"].contains("prompts"));
+
+    // The initialized notification, then a single batch
+    ASSERT_EQ(server.requests().size(), 2u);
+    EXPECT_NE(server.requests()[1].find("Mcp-Session-Id: abc\r\n"), std::string::npos);
+    EXPECT_NE(server.requests()[1].find("\r\n\r\n[{"), std::string::npos);
+}
+
+TEST(McpSessionTest, HttpFallsBackWhenBatchRejected) {
+    ScriptedServer server({
+        "HTTP/1.1 202 Accepted\r\nContent-Length: 0\r\n\r\n",
+        json_response("{\"jsonrpc\":\"2.0\",\"id\":null,\"error\":{\"code\":-32600,"
+                      "\"message\":\"Invalid Request\"}}"),
+        json_response("{\"jsonrpc\":\"2.0\",\"id\":1,\"result\":{\"tools\":[]}}"),
+        json_response("{\"jsonrpc\":\"2.0\",\"id\":2,\"result\":{\"prompts\":[]}}"),
+        json_response("{\"jsonrpc\":\"2.0\",\"id\":1,\"result\":{\"tools\":[]}}"),
+        json_response("{\"jsonrpc\":\"2.0\",\"id\":2,\"result\":{\"prompts\":[]}}"),
+    });
+
+    auto client = std::make_shared<HttpClient>();
+    HttpMcpSession session(client, server.url(), "", "2024-11-05", nlohmann::json::object());
+    auto responses = session.request_all(list_requests(), std::chrono::milliseconds(2000));
+    ASSERT_EQ(responses.size(), 2u);
+    EXPECT_TRUE(responses[0]["result"].contains("tools"));
+    EXPECT_TRUE(responses[1]["result"].contains("prompts"));
+
+    // Later lists skip the batch attempt
+    responses = session.request_all(list_requests(), std::chrono::milliseconds(2000));
+    EXPECT_TRUE(responses[1]["result"].contains("prompts"));
+    client->close_idle_connections();
+    EXPECT_EQ(server.requests().size(), 6u);
+}
+
+TEST(McpSessionTest, HttpKeepsAnsweredListsWhenOneFails) {
+    ScriptedServer server({
+        "HTTP/1.1 202 Accepted\r\nContent-Length: 0\r\n\r\n",
+        json_response("{\"jsonrpc\":\"2.0\",\"id\":null,\"error\":{\"code\":-32600,"
+                      "\"message\":\"Invalid Request\"}}"),
+        json_response("{\"jsonrpc\":\"2.0\",\"id\":1,\"result\":{\"tools\":[]}}"),
+        "HTTP/1.1 500 Internal Server Error\r\nContent-Length: 0\r\n\r\n",
+    });
+
+    auto client = std::make_shared<HttpClient>();
+    HttpMcpSession session(client, server.url(), "", "2024-11-05", nlohmann::json::object());
+    std::vector<std::string> errors;
+    auto responses = session.request_all(list_requests(), std::chrono::milliseconds(2000), &errors);
+    client->close_idle_connections();
+
+    ASSERT_EQ(responses.size(), 2u);
+    EXPECT_TRUE(responses[0]["result"].contains("tools"));
+    EXPECT_TRUE(errors[0].empty());
+    EXPECT_TRUE(responses[1].is_null());
+    EXPECT_NE(errors[1].find("500"), std::string::npos);
+}
+
+TEST(McpSessionTest, HttpReadsListsPastTheClientBodyLimit) {
+    std::string tools(200, 'x');
+    ScriptedServer server({
+        "HTTP/1.1 202 Accepted\r\nContent-Length: 0\r\n\r\n",
+        json_response("{\"jsonrpc\":\"2.0\",\"id\":1,\"result\":{\"tools\":[],\"pad\":\"" +
+                      tools + "\"}}"),
+    });
+
+    auto client = std::make_shared<HttpClient>();
+    client->set_max_body_bytes(64);
+    HttpMcpSession session(client, server.url(), "", "2024-11-05", nlohmann::json::object());
+    session.set_max_message_bytes(1024);
+    auto response = session.request({{"jsonrpc", "2.0"}, {"id", 1}, {"method", "tools/list"}},
+                                    std::chrono::milliseconds(2000));
+    client->close_idle_connections();
+
+    EXPECT_TRUE(response["result"].contains("tools"));
+    EXPECT_EQ(client->max_body_bytes(), 64u);  // Probes keep their own limit
+}
+
+TEST(McpSessionTest, HttpParsesListsLargerThanTheMessageLimit) {
+    std::string tools;
+    for (int i = 0; i < 5000; i++) {
+        tools += (i ? ",{\"name\":\"tool" : "{\"name\":\"tool") + std::to_string(i) + "\"}";
+    }
+    ScriptedServer server({
+        "HTTP/1.1 202 Accepted\r\nContent-Length: 0\r\n\r\n",
+        json_response("{\"jsonrpc\":\"2.0\",\"id\":1,\"result\":{\"tools\":[" + tools + "]}}"),
+    });
+
+    auto client = std::make_shared<HttpClient>();
+    HttpMcpSession session(client, server.url(), "", "2024-11-05", nlohmann::json::object());
+    session.set_max_message_bytes(1024);
+    session.set_result_limits({{"tools", 3}});
+    auto response = session.request({{"jsonrpc", "2.0"}, {"id", 1}, {"method", "tools/list"}},
+                                    std::chrono::milliseconds(2000));
+
+    // Parsed as it arrived: only the kept entries count towards the limit
+    ASSERT_EQ(response["result"]["tools"].size(), 3u);
+    EXPECT_EQ(response["result"]["tools"][2]["name"], "tool2");
+    // The unread rest of the body is dropped with its connection
+    EXPECT_EQ(client->idle_connections(), 0u);
+}
+
+TEST(PreflightTest, ClassifiesFirstBytes) {
+    EXPECT_EQ(Preflight::classify("HTTP/1.1 200 OK"), Preflight::Verdict::Http);
+    EXPECT_EQ(Preflight::classify("HTT"), Preflight::Verdict::Undecided);
+    EXPECT_EQ(Preflight::classify("SSH-2.0-OpenSSH_9.6"), Preflight::Verdict::NotHttp);
+    EXPECT_EQ(Preflight::classify(std::string_view("\x15\x03\x01", 3)), Preflight::Verdict::NotHttp);
+}
+
+TEST(PreflightTest, KeepsOnlyTcpListenersThatMayBeHttp) {
+    RoutedServer http(std::map<std::string, std::string>{
+        {"/", "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n\r\n"},
+    });
+    RoutedServer ssh(std::map<std::string, std::string>{{"/", "SSH-2.0-OpenSSH_9.6\r\n"}});
+    RoutedServer silent(std::map<std::string, std::string>{});
+
+    // A port nothing listens on
+    int closed_fd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    bind(closed_fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr));
+    socklen_t length = sizeof(addr);
+    getsockname(closed_fd, reinterpret_cast<struct sockaddr*>(&addr), &length);
+    int closed_port = ntohs(addr.sin_port);
+    close(closed_fd);
+
+    auto listener = [](const std::string& url, const std::string& address, int pid,
+                       const std::string& protocol) {
+        Candidate candidate;
+        candidate.url = url;
+        candidate.address = address;
+        candidate.port = std::stoi(url.substr(url.rfind(':') + 1));
+        candidate.pid = pid;
+        candidate.socket_protocol = protocol;
+        return candidate;
+    };
+    std::vector<Candidate> candidates = {
+        listener(http.url(), "127.0.0.1", 100, "tcp"),
+        listener(ssh.url(), "0.0.0.0", 101, "tcp"),
+        listener(silent.url(), "127.0.0.1", 102, "tcp"),
+        listener("http://127.0.0.1:" + std::to_string(closed_port), "127.0.0.1", 103, "tcp"),
+        listener(http.url(), "::", 100, "tcp"),
+        listener(http.url(), "127.0.0.1", 104, "udp"),
+    };
+    Candidate stdio;
+    stdio.command = "npx @modelcontextprotocol/server-filesystem";
+    candidates.push_back(stdio);
+
+    std::vector<const Candidate*> pointers;
+    for (const auto& candidate : candidates) {
+        pointers.push_back(&candidate);
+    }
+
+    Preflight preflight(std::chrono::milliseconds(300));
+    auto start = std::chrono::steady_clock::now();
+    auto reasons = preflight.check(pointers);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    ASSERT_EQ(reasons.size(), candidates.size());
+    EXPECT_EQ(reasons[0], "");
+    EXPECT_NE(reasons[1].find("Not HTTP"), std::string::npos);
+    EXPECT_EQ(reasons[2], "");  // Silent until the deadline
+    EXPECT_NE(reasons[3].find("Connection failed"), std::string::npos);
+    EXPECT_NE(reasons[4].find("Same listener"), std::string::npos);
+    EXPECT_EQ(reasons[5], "UDP listener");
+    EXPECT_EQ(reasons[6], "");
+
+    // Sniffed together: one deadline, not one per endpoint
+    EXPECT_LT(elapsed, std::chrono::milliseconds(600));
+}
@@ -6,14 +6,18 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 #include <kyros/platform/platform_adapter.hpp>
+#include <kyros/platform/environ_scanner.hpp>
+#include <kyros/platform/frame_reader.hpp>
 #include "../mocks/mock_platform_adapter.hpp"
 #include "test_helpers.hpp"
+#include <unistd.h>
 
 using namespace kyros;
 using namespace kyros::test;
 using ::testing::Return;
 using ::testing::SizeIs;
 using ::testing::Contains;
+using ::testing::IsEmpty;
 
 // ============================================================================
 // Mock Platform Adapter Tests
@@ -152,3 +156,808 @@ TEST(PlatformAdapterTest, ExpandPath) {
     auto expanded = adapter.expand_path("~/file.txt");
     EXPECT_EQ(expanded, "/home/user/file.txt");
 }
+
+// ============================================================================
+// Process Table Tests
+// ============================================================================
+
+TEST(ProcessTableTest, StoresColumnsPerRow) {
+    ProcessTable table;
+    table.add(100, 1, 501, 42, "node", {"/usr/bin/node", "server.js"});
+    table.add(200, 100, 501, 43, "python3", {"python3", "-m", "mcp_server"});
+
+    ASSERT_EQ(table.size(), 2u);
+    EXPECT_EQ(table.pid(1), 200);
+    EXPECT_EQ(table.ppid(1), 100);
+    EXPECT_EQ(table.uid(0), 501u);
+    EXPECT_EQ(table.start_time(1), 43u);
+    EXPECT_EQ(table.name(0), "node");
+    EXPECT_EQ(table.command_line(0), "/usr/bin/node server.js");
+    EXPECT_EQ(table.command_line(1), "python3 -m mcp_server");
+
+    auto args = table.argv(1);
+    ASSERT_THAT(args, SizeIs(3));
+    EXPECT_EQ(args[2], "mcp_server");
+}
+
+TEST(ProcessTableTest, FindsRowByPid) {
+    ProcessTable table;
+    table.add(100, 1, 0, 0, "a", {});
+    table.add(200, 1, 0, 0, "b", {});
+
+    ASSERT_TRUE(table.find(200).has_value());
+    EXPECT_EQ(*table.find(200), 1u);
+    EXPECT_FALSE(table.find(300).has_value());
+}
+
+TEST(ProcessTableTest, HandlesEmptyArgv) {
+    ProcessTable table;
+    table.add(2, 0, 0, 0, "kthreadd", {});
+
+    EXPECT_EQ(table.name(0), "kthreadd");
+    EXPECT_TRUE(table.command_line(0).empty());
+    EXPECT_TRUE(table.argv(0).empty());
+}
+
+TEST(ProcessTableTest, CopyRowPreservesArgv) {
+    ProcessTable source;
+    source.add(100, 1, 0, 7, "a", {"first", "x"});
+    source.add(200, 1, 0, 9, "node", {"node", "server.js", "--stdio"});
+
+    ProcessTable copy;
+    copy.copy_row(source, 1);
+
+    ASSERT_EQ(copy.size(), 1u);
+    EXPECT_EQ(copy.pid(0), 200);
+    EXPECT_EQ(copy.start_time(0), 9u);
+    EXPECT_EQ(copy.name(0), "node");
+    EXPECT_EQ(copy.command_line(0), "node server.js --stdio");
+    auto args = copy.argv(0);
+    ASSERT_THAT(args, SizeIs(3));
+    EXPECT_EQ(args[1], "server.js");
+    EXPECT_EQ(*copy.find(200), 0u);
+}
+
+TEST(ProcessTableTest, DefaultSnapshotUsesPerPidGetters) {
+    MockPlatformAdapter adapter;
+    adapter.set_process_list({100, 200});
+
+    EXPECT_CALL(adapter, get_process_list()).Times(1);
+    ON_CALL(adapter, get_process_name(100)).WillByDefault(Return("Claude"));
+    ON_CALL(adapter, get_process_name(200)).WillByDefault(Return("node"));
+    ON_CALL(adapter, get_command_line(200)).WillByDefault(Return("node server.js"));
+    ON_CALL(adapter, get_parent_pid(200)).WillByDefault(Return(100));
+
+    auto table = adapter.snapshot_processes();
+
+    ASSERT_EQ(table->size(), 2u);
+    auto row = table->find(200);
+    ASSERT_TRUE(row.has_value());
+    EXPECT_EQ(table->name(*row), "node");
+    EXPECT_EQ(table->command_line(*row), "node server.js");
+    EXPECT_EQ(table->ppid(*row), 100);
+}
+
+TEST(PipeIndexTest, FindsClientHoldingBothPipes) {
+    PipeIndex index;
+    index.add(200, 0, 11);
+    index.add(200, 1, 12);
+    index.add(150, 40, 11);   // Holds only stdin's pipe
+    index.add(300, 20, 11);
+    index.add(300, 21, 12);
+
+    EXPECT_TRUE(index.has_bidirectional_pipes(200));
+    EXPECT_EQ(index.stdin_pipe(200), 11u);
+    EXPECT_EQ(index.stdout_pipe(200), 12u);
+    ASSERT_TRUE(index.find_client(200).has_value());
+    EXPECT_EQ(*index.find_client(200), 300);
+    EXPECT_THAT(index.holders(11, 200), SizeIs(2));
+}
+
+TEST(PipeIndexTest, NoClientWithoutStdioPipes) {
+    PipeIndex index;
+    index.add(200, 5, 11);
+    index.add(300, 6, 11);
+
+    EXPECT_FALSE(index.has_bidirectional_pipes(200));
+    EXPECT_FALSE(index.find_client(200).has_value());
+}
+
+// ============================================================================
+// Frame Reader Tests
+// ============================================================================
+
+TEST(FrameReaderTest, SplitsSeveralNdjsonMessagesFromOneChunk) {
+    FrameReader reader;
+    std::string chunk = "{\"id\":1}\r\n\n{\"id\":2}\n{\"id\":";
+    reader.append(chunk.data(), chunk.size());
+
+    std::string_view frame;
+    ASSERT_EQ(reader.extract(FrameFormat::Ndjson, frame), FrameReader::Result::Frame);
+    EXPECT_EQ(frame, "{\"id\":1}");
+    ASSERT_EQ(reader.extract(FrameFormat::Ndjson, frame), FrameReader::Result::Frame);
+    EXPECT_EQ(frame, "{\"id\":2}");
+    EXPECT_EQ(reader.extract(FrameFormat::Ndjson, frame), FrameReader::Result::NeedMore);
+
+    reader.append("3}\n", 3);
+    ASSERT_EQ(reader.extract(FrameFormat::Ndjson, frame), FrameReader::Result::Frame);
+    EXPECT_EQ(frame, "{\"id\":3}");
+}
+
+TEST(FrameReaderTest, DecodesContentLengthFrames) {
+    FrameReader reader;
+    std::string chunk = "Content-Type: application/json\r\ncontent-length: 7\r\n\r\n{\"a\":1}"
+                        "Content-Length: 2\r\n\r\n[]";
+    reader.append(chunk.data(), chunk.size() - 1);
+
+    std::string_view frame;
+    ASSERT_EQ(reader.extract(FrameFormat::ContentLength, frame), FrameReader::Result::Frame);
+    EXPECT_EQ(frame, "{\"a\":1}");
+    EXPECT_EQ(reader.extract(FrameFormat::ContentLength, frame), FrameReader::Result::NeedMore);
+
+    reader.append("]", 1);
+    ASSERT_EQ(reader.extract(FrameFormat::ContentLength, frame), FrameReader::Result::Frame);
+    EXPECT_EQ(frame, "[]");
+}
+
+TEST(FrameReaderTest, DiscardsOversizedFramesAndResynchronises) {
+    FrameReader reader(16);
+    std::string flood(40, 'x');
+    reader.append(flood.data(), flood.size());
+
+    std::string_view frame;
+    EXPECT_EQ(reader.extract(FrameFormat::Line, frame), FrameReader::Result::TooLarge);
+    EXPECT_EQ(reader.buffered(), 0u);
+
+    std::string rest = "xxxx\nok\n";
+    reader.append(rest.data(), rest.size());
+    ASSERT_EQ(reader.extract(FrameFormat::Line, frame), FrameReader::Result::Frame);
+    EXPECT_EQ(frame, "ok");
+
+    std::string declared = "Content-Length: 100\r\n\r\n";
+    reader.append(declared.data(), declared.size());
+    EXPECT_EQ(reader.extract(FrameFormat::ContentLength, frame), FrameReader::Result::TooLarge);
+}
+
+TEST(FrameReaderTest, RaisedLimitAdmitsLargerFrames) {
+    FrameReader reader(16);
+    reader.set_max_frame_bytes(64);
+    std::string line = std::string(40, 'x') + "\n";
+    reader.append(line.data(), line.size());
+
+    std::string_view frame;
+    ASSERT_EQ(reader.extract(FrameFormat::Line, frame), FrameReader::Result::Frame);
+    EXPECT_EQ(frame.size(), 40u);
+}
+
+TEST(FrameReaderTest, HandsOutLinesInPiecesAsTheyArrive) {
+    FrameReader reader(4);
+    std::string chunk = "{\"tools\":[1,";
+    reader.append(chunk.data(), chunk.size());
+
+    // Longer than the frame limit, yet nothing is held back
+    std::string_view piece;
+    bool end = true;
+    ASSERT_EQ(reader.extract_partial(piece, end), FrameReader::Result::Frame);
+    EXPECT_EQ(piece, chunk);
+    EXPECT_FALSE(end);
+    EXPECT_EQ(reader.extract_partial(piece, end), FrameReader::Result::NeedMore);
+
+    std::string rest = "2]}\n{}\n";
+    reader.append(rest.data(), rest.size());
+    ASSERT_EQ(reader.extract_partial(piece, end), FrameReader::Result::Frame);
+    EXPECT_EQ(piece, "2]}");
+    EXPECT_TRUE(end);
+    ASSERT_EQ(reader.extract_partial(piece, end), FrameReader::Result::Frame);
+    EXPECT_EQ(piece, "{}");
+    EXPECT_TRUE(end);
+}
+
+TEST(FrameReaderTest, ReadsFramesFromPipe) {
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+    std::string data = "first\nsecond\nlast";
+    ASSERT_EQ(write(fds[1], data.data(), data.size()), static_cast<ssize_t>(data.size()));
+    close(fds[1]);
+
+    FrameReader reader;
+    auto timeout = std::chrono::milliseconds(1000);
+    EXPECT_EQ(reader.read_frame(fds[0], FrameFormat::Line, timeout, "pipe"), "first");
+    EXPECT_EQ(reader.read_frame(fds[0], FrameFormat::Line, timeout, "pipe"), "second");
+    EXPECT_EQ(reader.read_frame(fds[0], FrameFormat::Line, timeout, "pipe"), "last");
+    EXPECT_THROW(reader.read_frame(fds[0], FrameFormat::Line, timeout, "pipe"), std::runtime_error);
+    close(fds[0]);
+}
+
+// ============================================================================
+// Environ Scanner Tests
+// ============================================================================
+
+TEST(EnvironScannerTest, MatchesPrefixesAtVariableStartsOnly) {
+    std::string block("PATH=/usr/bin\0MCP_SERVER=files\0HOME=/root\0"
+                      "NOT_MCP_X=1\0CLAUDE_CONFIG=/tmp/c\0MCP_FLAG\0", 76);
+    EnvironScanner scanner;
+    std::vector<EnvironMatch> matches;
+
+    EXPECT_EQ(scanner.scan(block, matches), 2u);
+    ASSERT_THAT(matches, SizeIs(2));
+    EXPECT_EQ(matches[0].name, "MCP_SERVER");
+    EXPECT_EQ(matches[0].value, "files");
+    EXPECT_EQ(matches[1].name, "CLAUDE_CONFIG");
+    EXPECT_EQ(matches[1].value, "/tmp/c");
+}
+
+TEST(EnvironScannerTest, FindsVariablesAcrossChunkBoundaries) {
+    // Filler of every length shifts the match through all 16 byte offsets
+    EnvironScanner scanner({"ACME_"});
+    for (size_t filler = 1; filler < 40; filler++) {
+        std::string block = "X=" + std::string(filler, 'x');
+        block += '\0';
+        block += "ACME_TOKEN=1";
+        std::vector<EnvironMatch> matches;
+        ASSERT_EQ(scanner.scan(block, matches), 1u) << "filler " << filler;
+        EXPECT_EQ(matches[0].name, "ACME_TOKEN");
+        EXPECT_EQ(matches[0].value, "1");
+    }
+}
+
+// ============================================================================
+// Linux /proc Reader Tests
+// ============================================================================
+
+#ifdef PLATFORM_LINUX
+#include <kyros/platform/linux/child_reaper.hpp>
+#include <kyros/platform/linux/epoll_probe_reactor.hpp>
+#include <kyros/platform/linux/proc_events.hpp>
+#include <kyros/platform/linux/proc_reader.hpp>
+#include <kyros/platform/linux/socket_diag.hpp>
+#include <kyros/testing/mcp_session.hpp>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <mutex>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+
+TEST(ProcReaderTest, ParseStatHandlesParenthesesInComm) {
+    ProcEntry entry;
+    std::string stat =
+        "4242 (node (mcp) x) S 4100 4242 4100 0 -1 4194560 1 0 0 0 0 0 0 0 20 0 "
+        "11 0 987654 1000 100 18446744073709551615";
+
+    ASSERT_TRUE(ProcReader::parse_stat(stat, entry));
+    EXPECT_EQ(entry.name, "node (mcp) x");
+    EXPECT_EQ(entry.ppid, 4100);
+    EXPECT_EQ(entry.start_time, 987654ULL);
+}
+
+TEST(ProcReaderTest, ParseStatRejectsTruncatedInput) {
+    ProcEntry entry;
+    EXPECT_FALSE(ProcReader::parse_stat("4242 (node) S 4100", entry));
+    EXPECT_FALSE(ProcReader::parse_stat("garbage", entry));
+}
+
+TEST(ProcReaderTest, SplitNulKeepsArgvBoundaries) {
+    const char cmdline[] = "node\0/app/server.js\0--port\0""3000\0";
+    auto argv = ProcReader::split_nul(cmdline, sizeof(cmdline) - 1);
+
+    ASSERT_THAT(argv, SizeIs(4));
+    EXPECT_EQ(argv[0], "node");
+    EXPECT_EQ(argv[1], "/app/server.js");
+    EXPECT_EQ(argv[3], "3000");
+
+    const char with_empty[] = "a\0\0b\0";
+    argv = ProcReader::split_nul(with_empty, sizeof(with_empty) - 1);
+    ASSERT_THAT(argv, SizeIs(3));
+    EXPECT_EQ(argv[0], "a");
+    EXPECT_EQ(argv[1], "");
+    EXPECT_EQ(argv[2], "b");
+}
+
+TEST(ProcReaderTest, ReadsOwnProcess) {
+    ProcReader reader;
+    ASSERT_TRUE(reader.is_open());
+
+    ProcEntry entry;
+    ASSERT_TRUE(reader.read(getpid(), entry));
+    EXPECT_EQ(entry.pid, getpid());
+    EXPECT_EQ(entry.ppid, getppid());
+    EXPECT_EQ(entry.uid, geteuid());
+    EXPECT_GT(entry.start_time, 0ULL);
+    EXPECT_FALSE(entry.argv.empty());
+
+    EXPECT_THAT(reader.list_pids(), Contains(getpid()));
+}
+
+TEST(LinuxPlatformAdapterTest, IncrementalSnapshotTracksExec) {
+    auto adapter = create_platform_adapter();
+    auto first = adapter->snapshot_processes();
+    ASSERT_TRUE(first->find(getpid()).has_value());
+
+    pid_t child = fork();
+    ASSERT_GE(child, 0);
+    if (child == 0) {
+        execl("/bin/sleep", "sleep", "5", static_cast<char*>(nullptr));
+        _exit(127);
+    }
+
+    // Poll until the child has exec'd into sleep
+    std::shared_ptr<const ProcessTable> table;
+    std::optional<size_t> row;
+    for (int attempt = 0; attempt < 100; attempt++) {
+        table = adapter->snapshot_processes();
+        row = table->find(child);
+        if (row && table->command_line(*row) == "sleep 5") break;
+        usleep(10000);
+    }
+
+    kill(child, SIGKILL);
+    waitpid(child, nullptr, 0);
+
+    ASSERT_TRUE(row.has_value());
+    EXPECT_EQ(table->name(*row), "sleep");
+    EXPECT_EQ(table->command_line(*row), "sleep 5");
+
+    // Unchanged process carried over from the previous snapshot
+    auto self = table->find(getpid());
+    ASSERT_TRUE(self.has_value());
+    EXPECT_EQ(table->command_line(*self), first->command_line(*first->find(getpid())));
+}
+
+TEST(LinuxPlatformAdapterTest, IncrementalSnapshotTracksExecKeepingComm) {
+    if (geteuid() != 0 || !ProcEvents().is_open()) {
+        GTEST_SKIP() << "proc connector unavailable";
+    }
+
+    auto adapter = create_platform_adapter();
+    int ready[2], go[2];
+    ASSERT_EQ(pipe(ready), 0);
+    ASSERT_EQ(pipe(go), 0);
+    pid_t child = fork();
+    ASSERT_GE(child, 0);
+    if (child == 0) {
+        // Both images are sh, so comm never changes; the exec waits for
+        // a line on stdin so the first image is snapshotted
+        dup2(go[0], STDIN_FILENO);
+        dup2(ready[1], STDOUT_FILENO);
+        close(go[1]);
+        close(ready[0]);
+        execl("/bin/sh", "sh", "-c", "echo; read x; exec sh -c 'read y; :' kyros-exec-\"test\"",
+              static_cast<char*>(nullptr));
+        _exit(127);
+    }
+    close(go[0]);
+    close(ready[1]);
+
+    char byte;
+    ASSERT_EQ(read(ready[0], &byte, 1), 1);
+    auto first = adapter->snapshot_processes();
+    auto first_row = first->find(child);
+    ASSERT_TRUE(first_row.has_value());
+    EXPECT_EQ(first->command_line(*first_row).find("kyros-exec-test"), std::string_view::npos);
+    ASSERT_EQ(write(go[1], "\n", 1), 1);
+
+    std::shared_ptr<const ProcessTable> table;
+    std::optional<size_t> row;
+    for (int attempt = 0; attempt < 100; attempt++) {
+        table = adapter->snapshot_processes();
+        row = table->find(child);
+        if (row && table->command_line(*row).find("kyros-exec-test") != std::string_view::npos) break;
+        usleep(10000);
+    }
+
+    kill(child, SIGKILL);
+    waitpid(child, nullptr, 0);
+    close(go[1]);
+    close(ready[0]);
+
+    ASSERT_TRUE(row.has_value());
+    EXPECT_EQ(table->name(*row), "sh");
+    EXPECT_NE(table->command_line(*row).find("kyros-exec-test"), std::string_view::npos);
+    EXPECT_GT(table->exec_count(*row), first->exec_count(*first_row));
+}
+
+TEST(SocketDiagTest, ParsesListeningTcpLine) {
+    SocketEntry entry;
+    std::string line =
+        "   0: 0100007F:0BB8 00000000:0000 0A 00000000:00000000 00:00000000 "
+        "00000000  1000        0 123456 1 0000000000000000 100 0 0 10 0";
+
+    ASSERT_TRUE(SocketDiag::parse_proc_net_line(line, false, "tcp", entry));
+    EXPECT_EQ(entry.address, "127.0.0.1");
+    EXPECT_EQ(entry.port, 3000);
+    EXPECT_EQ(entry.inode, 123456u);
+    EXPECT_EQ(entry.protocol, "tcp");
+}
+
+TEST(SocketDiagTest, ParsesIpv6AnyAddress) {
+    SocketEntry entry;
+    std::string line =
+        "   1: 00000000000000000000000000000000:1F90 00000000000000000000000000000000:0000 "
+        "0A 00000000:00000000 00:00000000 00000000     0        0 777 1 0000000000000000 100 0 0 10 0";
+
+    ASSERT_TRUE(SocketDiag::parse_proc_net_line(line, true, "tcp", entry));
+    EXPECT_EQ(entry.address, "::");
+    EXPECT_EQ(entry.port, 8080);
+}
+
+TEST(SocketDiagTest, SkipsHeaderAndEstablishedSockets) {
+    SocketEntry entry;
+    EXPECT_FALSE(SocketDiag::parse_proc_net_line(
+        "  sl  local_address rem_address   st tx_queue rx_queue tr tm->when retrnsmt   uid  timeout inode",
+        false, "tcp", entry));
+    EXPECT_FALSE(SocketDiag::parse_proc_net_line(
+        "   2: 0100007F:0BB8 0100007F:D431 01 00000000:00000000 00:00000000 00000000  1000        0 42 1",
+        false, "tcp", entry));
+}
+
+TEST(LinuxPlatformAdapterTest, FindsOwnListeningSocket) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT_GE(fd, 0);
+
+    struct sockaddr_in addr {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    ASSERT_EQ(bind(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)), 0);
+    ASSERT_EQ(listen(fd, 1), 0);
+
+    socklen_t len = sizeof(addr);
+    ASSERT_EQ(getsockname(fd, reinterpret_cast<struct sockaddr*>(&addr), &len), 0);
+    int port = ntohs(addr.sin_port);
+
+    auto adapter = create_platform_adapter();
+    auto listeners = adapter->get_listening_sockets();
+    close(fd);
+
+    bool found = false;
+    for (const auto& listener : listeners) {
+        if (listener.port == port && listener.protocol == "tcp") {
+            found = true;
+            EXPECT_EQ(listener.pid, getpid());
+            EXPECT_EQ(listener.address, "127.0.0.1");
+        }
+    }
+    EXPECT_TRUE(found);
+}
+
+TEST(LinuxPlatformAdapterTest, PipeIndexPairsChildWithParent) {
+    int to_child[2];
+    int from_child[2];
+    ASSERT_EQ(pipe(to_child), 0);
+    ASSERT_EQ(pipe(from_child), 0);
+
+    pid_t child = fork();
+    ASSERT_GE(child, 0);
+    if (child == 0) {
+        dup2(to_child[0], 0);
+        dup2(from_child[1], 1);
+        close(to_child[0]);
+        close(to_child[1]);
+        close(from_child[0]);
+        close(from_child[1]);
+        pause();
+        _exit(0);
+    }
+    close(to_child[0]);
+    close(from_child[1]);
+
+    // Wait until the child has moved the pipes onto its stdio
+    auto adapter = create_platform_adapter();
+    std::shared_ptr<const PipeIndex> index;
+    for (int attempt = 0; attempt < 100; attempt++) {
+        index = adapter->build_pipe_index();
+        if (index && index->has_bidirectional_pipes(child)) break;
+        usleep(10000);
+    }
+
+    kill(child, SIGKILL);
+    waitpid(child, nullptr, 0);
+    close(to_child[1]);
+    close(from_child[0]);
+
+    ASSERT_TRUE(index);
+    ASSERT_TRUE(index->has_bidirectional_pipes(child));
+    auto client = index->find_client(child);
+    ASSERT_TRUE(client.has_value());
+    EXPECT_EQ(*client, getpid());
+}
+
+TEST(LinuxPlatformAdapterTest, DescriptorsAreOnlyWalkedForChangedProcesses) {
+    if (geteuid() != 0 || !ProcEvents().is_open()) {
+        GTEST_SKIP() << "proc connector unavailable";
+    }
+
+    auto adapter = create_platform_adapter();
+    adapter->snapshot_processes();
+    auto first = adapter->build_pipe_index();
+    ASSERT_TRUE(first);
+    EXPECT_EQ(adapter->build_pipe_index(), first);
+
+    // We have no proc connector events, so our descriptors are not walked
+    // again and a pipe opened since stays out of the index
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+    struct stat st;
+    ASSERT_EQ(fstat(fds[0], &st), 0);
+    adapter->snapshot_processes();
+    EXPECT_THAT(adapter->build_pipe_index()->holders(st.st_ino), IsEmpty());
+    close(fds[0]);
+    close(fds[1]);
+
+    // A listener opened without any event is still attributed to us
+    int listener_fd = socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT_GE(listener_fd, 0);
+    struct sockaddr_in addr {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    ASSERT_EQ(bind(listener_fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)), 0);
+    ASSERT_EQ(listen(listener_fd, 1), 0);
+    socklen_t len = sizeof(addr);
+    ASSERT_EQ(getsockname(listener_fd, reinterpret_cast<struct sockaddr*>(&addr), &len), 0);
+    int port = ntohs(addr.sin_port);
+    int owner = 0;
+    for (const auto& listener : adapter->get_listening_sockets()) {
+        if (listener.port == port && listener.protocol == "tcp") {
+            owner = listener.pid;
+        }
+    }
+    close(listener_fd);
+    EXPECT_EQ(owner, getpid());
+
+    // Spawning a child forks us: both the child and we are walked again
+    auto process = adapter->spawn_process_with_pipes("sleep", {"30"});
+    std::shared_ptr<const PipeIndex> index;
+    for (int attempt = 0; attempt < 100; attempt++) {
+        adapter->snapshot_processes();
+        index = adapter->build_pipe_index();
+        if (index->has_bidirectional_pipes(process->pid())) break;
+        usleep(10000);
+    }
+    int child = process->pid();
+    process->terminate();
+
+    ASSERT_TRUE(index->has_bidirectional_pipes(child));
+    EXPECT_EQ(index->find_client(child), std::optional<int>(getpid()));
+}
+
+TEST(LinuxProcessTest, SpawnsWithStdioPipes) {
+    auto adapter = create_platform_adapter();
+    auto process = adapter->spawn_process_with_pipes("cat", {});
+    ASSERT_TRUE(process);
+    EXPECT_TRUE(process->is_running());
+
+    process->write_stdin("hello\n");
+    EXPECT_EQ(process->read_stdout_line(std::chrono::milliseconds(2000)), "hello");
+
+    process->terminate();
+    EXPECT_FALSE(process->is_running());
+}
+
+TEST(LinuxProcessTest, TerminateReturnsPromptlyForCooperativeChild) {
+    auto adapter = create_platform_adapter();
+    auto process = adapter->spawn_process_with_pipes("sleep", {"30"});
+
+    auto start = std::chrono::steady_clock::now();
+    process->terminate();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    EXPECT_FALSE(process->is_running());
+    EXPECT_LT(elapsed, std::chrono::milliseconds(200));
+}
+
+TEST(LinuxProcessTest, ReaperKillsChildrenIgnoringSigterm) {
+    auto adapter = create_platform_adapter();
+
+    // Ignored signal dispositions survive exec, so sleep ignores SIGTERM
+    std::vector<std::unique_ptr<Process>> processes;
+    std::vector<int> pids;
+    for (int i = 0; i < 4; i++) {
+        processes.push_back(adapter->spawn_process_with_pipes(
+            "sh", {"-c", "trap '' TERM; exec sleep 30"}));
+        pids.push_back(processes.back()->pid());
+    }
+    usleep(100000);  // Let the shells install the trap
+
+    // All four shut down concurrently: none blocks for the kill grace period
+    auto start = std::chrono::steady_clock::now();
+    for (auto& process : processes) {
+        process->terminate();
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    EXPECT_LT(elapsed, std::chrono::milliseconds(500));
+
+    ASSERT_TRUE(ChildReaper::instance().wait_idle(std::chrono::milliseconds(5000)));
+    for (int pid : pids) {
+        EXPECT_EQ(kill(pid, 0), -1);
+    }
+}
+TEST(EpollProbeReactorTest, ReportsResponsesTimeoutsAndEarlyExits) {
+    auto adapter = create_platform_adapter();
+    EpollProbeReactor reactor;
+    ASSERT_TRUE(reactor.is_open());
+
+    auto spawn = [&](std::string script) {
+        return [&adapter, script]() {
+            return adapter->spawn_process_with_pipes("sh", {"-c", script});
+        };
+    };
+    auto timeout = std::chrono::milliseconds(2000);
+
+    size_t responder = reactor.add(spawn("read line; echo '{\"id\":1}'"), "{}\n", timeout);
+    size_t silent = reactor.add(spawn("exec sleep 30"), "{}\n", std::chrono::milliseconds(200));
+    size_t exits = reactor.add(spawn("echo bye >&2; exit 0"), "{}\n", timeout);
+    // 1 MB on stderr first: blocks forever unless stderr is drained
+    size_t chatty = reactor.add(
+        spawn("head -c 1000000 /dev/zero >&2; read line; echo '{\"id\":2}'"), "{}\n", timeout);
+    size_t broken = reactor.add([]() -> std::unique_ptr<Process> {
+        throw std::runtime_error("spawn failed");
+    }, "{}\n", timeout);
+    size_t missing = reactor.add([]() -> std::unique_ptr<Process> {
+        return nullptr;
+    }, "{}\n", timeout);
+
+    auto start = std::chrono::steady_clock::now();
+    auto results = reactor.run();
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(1500));
+
+    ASSERT_EQ(results.size(), 6u);
+    EXPECT_EQ(results[responder].status, ProbeReactor::Status::Response);
+    EXPECT_EQ(results[responder].frame, "{\"id\":1}");
+    EXPECT_EQ(results[silent].status, ProbeReactor::Status::Timeout);
+    EXPECT_EQ(results[exits].status, ProbeReactor::Status::Closed);
+    EXPECT_EQ(results[exits].stderr_tail, "bye\n");
+    EXPECT_EQ(results[chatty].status, ProbeReactor::Status::Response);
+    EXPECT_EQ(results[chatty].frame, "{\"id\":2}");
+    EXPECT_EQ(results[broken].status, ProbeReactor::Status::Error);
+    EXPECT_EQ(results[broken].error, "spawn failed");
+    // Finished before any deadline was armed: elapsed is still measured
+    EXPECT_EQ(results[missing].status, ProbeReactor::Status::Error);
+    EXPECT_LT(results[missing].elapsed, timeout);
+}
+
+TEST(EpollProbeReactorTest, QueuesProbesBeyondTheInFlightLimit) {
+    auto adapter = create_platform_adapter();
+    EpollProbeReactor reactor(4);
+
+    for (int i = 0; i < 32; i++) {
+        reactor.add([&adapter]() { return adapter->spawn_process_with_pipes("cat", {}); },
+                    "{\"id\":" + std::to_string(i) + "}\n", std::chrono::milliseconds(5000));
+    }
+
+    auto results = reactor.run();
+    ASSERT_EQ(results.size(), 32u);
+    for (int i = 0; i < 32; i++) {
+        EXPECT_EQ(results[i].status, ProbeReactor::Status::Response);
+        EXPECT_EQ(results[i].frame, "{\"id\":" + std::to_string(i) + "}");
+    }
+
+    // The reactor is reusable once run() returns
+    reactor.add([&adapter]() { return adapter->spawn_process_with_pipes("cat", {}); },
+                "{}\n", std::chrono::milliseconds(5000));
+    EXPECT_EQ(reactor.run().at(0).frame, "{}");
+}
+
+TEST(EpollProbeReactorTest, HandedOverRespondersKeepTheirSlotUntilExit) {
+    auto adapter = create_platform_adapter();
+    EpollProbeReactor reactor(1);
+
+    // Answers, then writes 1 MB to stderr before it reads the next line:
+    // the conversation only continues if the reactor still drains stderr
+    for (int i = 0; i < 2; i++) {
+        reactor.add([&adapter]() {
+            return adapter->spawn_process_with_pipes("sh", {"-c",
+                "read line; echo '{\"id\":1}'; head -c 1000000 /dev/zero >&2; "
+                "read line; echo done; sleep 30"});
+        }, "{}\n", std::chrono::milliseconds(2000));
+    }
+
+    std::mutex mutex;
+    std::vector<std::string> replies;
+    std::vector<std::chrono::steady_clock::time_point> handed, exited;
+    std::vector<std::thread> threads;
+    reactor.set_response_handler([&](size_t, ProbeReactor::Result& result) {
+        std::lock_guard<std::mutex> lock(mutex);
+        handed.push_back(std::chrono::steady_clock::now());
+        threads.emplace_back([&, process = std::move(result.process)]() {
+            process->write_stdin("next\n");
+            std::string reply = process->read_stdout_line(std::chrono::milliseconds(2000));
+            // Stamped before terminate(): the reactor may free the slot and
+            // hand over the next probe before terminate() returns
+            auto exit_time = std::chrono::steady_clock::now();
+            process->terminate();
+            std::lock_guard<std::mutex> lock(mutex);
+            replies.push_back(reply);
+            exited.push_back(exit_time);
+        });
+    });
+
+    auto results = reactor.run();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    ASSERT_EQ(results.size(), 2u);
+    EXPECT_EQ(results[0].status, ProbeReactor::Status::Response);
+    EXPECT_EQ(results[1].status, ProbeReactor::Status::Response);
+    EXPECT_EQ(replies, (std::vector<std::string>{"done", "done"}));
+
+    // With one slot, the second probe only started once the first exited
+    ASSERT_EQ(handed.size(), 2u);
+    ASSERT_EQ(exited.size(), 2u);
+    EXPECT_GE(handed[1], exited[0]);
+}
+
+TEST(StdioMcpSessionTest, PipelinesRequestsAndMatchesResponsesById) {
+    auto adapter = create_platform_adapter();
+    // Answers only once the notification and both requests have arrived,
+    // so a request-at-a-time session would time out
+    auto process = adapter->spawn_process_with_pipes("sh", {"-c",
+        "read n; read a; read b; echo '{\"jsonrpc\":\"2.0\",\"method\":\"log\"}'; "
+        "echo '{\"jsonrpc\":\"2.0\",\"id\":2,\"result\":{\"b\":1}}'; "
+        "echo '{\"jsonrpc\":\"2.0\",\"id\":1,\"result\":{\"a\":1}}'; sleep 30"});
+    ASSERT_TRUE(process);
+    StdioMcpSession session(std::move(process), "2024-11-05", nlohmann::json::object());
+
+    std::vector<nlohmann::json> requests = {
+        {{"jsonrpc", "2.0"}, {"id", 1}, {"method", "tools/list"}},
+        {{"jsonrpc", "2.0"}, {"id", 2}, {"method", "prompts/list"}},
+    };
+    auto responses = session.request_all(requests, std::chrono::milliseconds(2000));
+
+    ASSERT_EQ(responses.size(), 2u);
+    EXPECT_TRUE(responses[0]["result"].contains("a"));
+    EXPECT_TRUE(responses[1]["result"].contains("b"));
+    session.close();
+    EXPECT_FALSE(session.is_open());
+}
+
+TEST(StdioMcpSessionTest, KeepsAnsweredRequestsOnEof) {
+    auto adapter = create_platform_adapter();
+    // Answers one list, then exits before the other
+    auto process = adapter->spawn_process_with_pipes("sh", {"-c",
+        "read n; read a; read b; echo '{\"jsonrpc\":\"2.0\",\"id\":1,\"result\":{\"a\":1}}'"});
+    ASSERT_TRUE(process);
+    StdioMcpSession session(std::move(process), "2024-11-05", nlohmann::json::object());
+
+    std::vector<nlohmann::json> requests = {
+        {{"jsonrpc", "2.0"}, {"id", 1}, {"method", "tools/list"}},
+        {{"jsonrpc", "2.0"}, {"id", 2}, {"method", "prompts/list"}},
+    };
+    std::vector<std::string> errors;
+    auto responses = session.request_all(requests, std::chrono::milliseconds(2000), &errors);
+
+    ASSERT_EQ(responses.size(), 2u);
+    EXPECT_TRUE(responses[0]["result"].contains("a"));
+    EXPECT_TRUE(responses[1].is_null());
+    EXPECT_NE(errors[1].find("EOF"), std::string::npos);
+}
+
+TEST(StdioMcpSessionTest, ParsesListsLargerThanTheMessageLimit) {
+    auto adapter = create_platform_adapter();
+    // A ~260 KB tools list, then a second response on the next line
+    auto process = adapter->spawn_process_with_pipes("sh", {"-c",
+        "read n; read a; read b; printf '{\"jsonrpc\":\"2.0\",\"id\":1,\"result\":{\"tools\":['; "
+        "yes '{\"name\":\"t\"},' | head -n 20000 | tr -d '\\n'; echo '{\"name\":\"t\"}]}}'; "
+        "echo '{\"jsonrpc\":\"2.0\",\"id\":2,\"result\":{\"b\":1}}'; sleep 30"});
+    ASSERT_TRUE(process);
+    StdioMcpSession session(std::move(process), "2024-11-05", nlohmann::json::object());
+    session.set_max_message_bytes(1024);
+    session.set_result_limits({{"tools", 3}});
+
+    std::vector<nlohmann::json> requests = {
+        {{"jsonrpc", "2.0"}, {"id", 1}, {"method", "tools/list"}},
+        {{"jsonrpc", "2.0"}, {"id", 2}, {"method", "prompts/list"}},
+    };
+    std::vector<std::string> errors;
+    auto responses = session.request_all(requests, std::chrono::milliseconds(5000), &errors);
+
+    // The rest of the long line is drained, so the next response still parses
+    ASSERT_EQ(responses.size(), 2u);
+    EXPECT_EQ(responses[0]["result"]["tools"].size(), 3u) << errors[0];
+    EXPECT_TRUE(responses[1]["result"].contains("b")) << errors[1];
+}
+#endif // PLATFORM_LINUX
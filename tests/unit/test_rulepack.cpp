@@ -5,10 +5,16 @@
 
 #include <gtest/gtest.h>
 #include <kyros/rulepack.hpp>
+#include <kyros/rule_matcher.hpp>
+#include <kyros/rulepack_binary.hpp>
 #include <kyros/candidate.hpp>
 #include <nlohmann/json.hpp>
 #include "test_helpers.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
 using namespace kyros;
 using namespace kyros::test;
 
@@ -326,6 +332,85 @@ TEST(RuleEngineTest, AddRulepack) {
     EXPECT_EQ(engine.rulepacks().size(), 2);
 }
 
+TEST(RuleEngineTest, CollectsEnvironmentPrefixes) {
+    nlohmann::json pack = {
+        {"name", "env"},
+        {"environment_prefixes", {"ACME_MCP_", "MCP_"}},
+        {"rules", nlohmann::json::array()}
+    };
+
+    RuleEngine engine;
+    engine.add_rulepack(Rulepack::load_from_json(pack));
+    engine.add_rulepack(Rulepack::load_from_json(pack));
+
+    auto prefixes = engine.environment_prefixes();
+    ASSERT_EQ(prefixes.size(), 2u);
+    EXPECT_EQ(prefixes[0], "ACME_MCP_");
+
+    pack["environment_prefixes"] = {""};
+    EXPECT_THROW(Rulepack::load_from_json(pack), std::runtime_error);
+}
+
+TEST(RuleEngineTest, ReloadPublishesNewSnapshot) {
+    auto pack = [](const std::string& evidence) {
+        nlohmann::json json = {
+            {"name", "reloadable"},
+            {"rules", {{{"name", "node"}, {"match", {{"process_name", "node"}}},
+                        {"action", {{"add_evidence", {{"type", evidence}}}}}}}}};
+        return json.dump();
+    };
+    TempFile file(pack("before"));
+
+    RuleEngine engine;
+    engine.load_rulepack(file.path());
+    auto before = engine.snapshot();
+
+    file.write(pack("after"));
+    engine.reload();
+    auto after = engine.snapshot();
+    EXPECT_GT(after->generation, before->generation);
+
+    // A holder of the old snapshot keeps the old rules
+    Candidate old_rules = create_test_candidate("node", 100);
+    before->matcher->apply(old_rules);
+    ASSERT_EQ(old_rules.evidence.size(), 1u);
+    EXPECT_EQ(old_rules.evidence[0].type, "before");
+
+    Candidate new_rules = create_test_candidate("node", 100);
+    engine.apply(new_rules);
+    ASSERT_EQ(new_rules.evidence.size(), 1u);
+    EXPECT_EQ(new_rules.evidence[0].type, "after");
+
+    // A broken file leaves the current snapshot in place
+    file.write("{\"rules\": [");
+    EXPECT_THROW(engine.reload(), std::runtime_error);
+    EXPECT_EQ(engine.snapshot(), after);
+}
+
+TEST(RuleEngineTest, ApplyDuringReload) {
+    TempFile file(R"({"name": "p", "rules": [{"name": "r", "match": {"process_name": "node"},
+                      "action": {"add_tag": "seen"}}]})");
+    RuleEngine engine;
+    engine.load_rulepack(file.path());
+
+    std::atomic<bool> done{false};
+    std::thread reloader([&] {
+        for (int i = 0; i < 50; i++) {
+            engine.reload();
+        }
+        done = true;
+    });
+    size_t applied = 0;
+    while (!done || applied == 0) {
+        Candidate candidate = create_test_candidate("node", 100);
+        engine.apply(candidate);
+        ASSERT_EQ(candidate.evidence.size(), 1u);
+        applied++;
+    }
+    reloader.join();
+    EXPECT_EQ(engine.snapshot()->generation, 51u);
+}
+
 TEST(RuleEngineTest, ApplyAllRulepacks) {
     RuleEngine engine;
 
@@ -370,6 +455,260 @@ TEST(RuleEngineTest, ApplyAllRulepacks) {
     EXPECT_GE(candidate.evidence.size(), 2);
 }
 
+// ============================================================================
+// Compiled Matcher Tests
+// ============================================================================
+
+TEST(PatternSetTest, FindsOverlappingPatternsInOnePass) {
+    PatternSet patterns;
+    size_t he = patterns.add("he");
+    size_t she = patterns.add("she");
+    size_t his = patterns.add("his");
+    size_t hers = patterns.add("hers");
+    size_t empty = patterns.add("");
+    EXPECT_EQ(patterns.add("she"), she);
+    patterns.build();
+
+    std::vector<int> hits(patterns.size(), 0);
+    patterns.scan("ushers", [&](size_t id) { hits[id]++; });
+    EXPECT_EQ(hits[he], 1);
+    EXPECT_EQ(hits[she], 1);
+    EXPECT_EQ(hits[his], 0);
+    EXPECT_EQ(hits[hers], 1);
+    EXPECT_EQ(hits[empty], 1);
+
+    hits.assign(patterns.size(), 0);
+    patterns.scan("HIS hi", [&](size_t id) { hits[id]++; });
+    EXPECT_EQ(hits[his], 0);  // Case-sensitive, like std::string::find
+    EXPECT_EQ(hits[he], 0);
+
+    hits.assign(patterns.size(), 0);
+    patterns.scan("he said hello", [&](size_t id) { hits[id]++; });
+    EXPECT_EQ(hits[he], 2);  // Every occurrence
+}
+
+TEST(RuleMatcherTest, MatchesLikeRulepackApply) {
+    RuleEngine engine;
+    std::vector<Rulepack> rulepacks;
+    for (const char* path : {"../config/rulepacks/default.json",
+                             "../config/rulepacks/docker-mcp.json",
+                             "../config/rulepacks/exclusions.json"}) {
+        rulepacks.push_back(Rulepack::load_from_file(path));
+        engine.add_rulepack(rulepacks.back());
+    }
+
+    // Conditions the shipped rulepacks do not exercise
+    nlohmann::json extra = {
+        {"name", "extra"},
+        {"rules", {
+            {{"name", "regex"}, {"match", {{"command_regex", "server-[a-z]+\\.js$"}}},
+             {"action", {{"add_evidence", {{"type", "regex_hit"}}}}}},
+            {{"name", "bad regex"}, {"match", {{"command_regex", "("}}},
+             {"action", {{"add_evidence", {{"type", "never"}}}}}},
+            {{"name", "chained"},
+             {"match", {{"has_evidence_type", "regex_hit"}, {"url_contains", "/mcp"}}},
+             {"action", {{"boost_confidence", 1.5}}}},
+            {{"name", "port"}, {"match", {{"port", 3000}, {"config_file", "claude"}}},
+             {"action", {{"add_tag", "port-3000"}}}}
+        }}
+    };
+    rulepacks.push_back(Rulepack::load_from_json(extra));
+    engine.add_rulepack(rulepacks.back());
+
+    std::vector<Candidate> candidates;
+    candidates.push_back(create_test_candidate("node", 100));
+    candidates.back().command = "npx -y @modelcontextprotocol/server-filesystem /tmp";
+    candidates.push_back(create_test_candidate("node", 101));
+    candidates.back().command = "node /srv/server-weather.js";
+    candidates.back().url = "http://127.0.0.1:3000/mcp";
+    candidates.back().port = 3000;
+    candidates.back().config_file = "/home/u/.config/claude/claude_desktop_config.json";
+    candidates.push_back(create_test_candidate("docker", 102));
+    candidates.back().command = "docker run -i --rm mcp/fetch";
+    candidates.push_back(create_test_candidate("code", 103));
+    candidates.back().command = "/usr/share/code/code --type=renderer";
+
+    for (const auto& original : candidates) {
+        Candidate compiled = original;
+        Candidate interpreted = original;
+        engine.apply(compiled);
+        for (const auto& rulepack : rulepacks) {
+            rulepack.apply(interpreted);
+        }
+
+        ASSERT_EQ(compiled.evidence.size(), interpreted.evidence.size()) << original.command;
+        for (size_t i = 0; i < compiled.evidence.size(); i++) {
+            EXPECT_EQ(compiled.evidence[i].type, interpreted.evidence[i].type);
+        }
+        EXPECT_DOUBLE_EQ(compiled.confidence_score, interpreted.confidence_score);
+    }
+
+    // Batch mode gives the same result for every candidate, past one
+    // bitset word
+    std::vector<Candidate> batch;
+    for (size_t i = 0; i < 70; i++) {
+        batch.push_back(candidates[i % candidates.size()]);
+    }
+    engine.apply(batch);
+    for (size_t i = 0; i < batch.size(); i++) {
+        Candidate single = candidates[i % candidates.size()];
+        engine.apply(single);
+        ASSERT_EQ(batch[i].evidence.size(), single.evidence.size()) << i;
+        for (size_t j = 0; j < single.evidence.size(); j++) {
+            EXPECT_EQ(batch[i].evidence[j].type, single.evidence[j].type);
+        }
+        EXPECT_DOUBLE_EQ(batch[i].confidence_score, single.confidence_score);
+    }
+
+    Candidate weather = candidates[1];
+    engine.apply(weather);
+    auto has = [&](const std::string& type) {
+        return std::any_of(weather.evidence.begin(), weather.evidence.end(),
+                           [&](const Evidence& e) { return e.type == type; });
+    };
+    EXPECT_TRUE(has("regex_hit"));
+    EXPECT_TRUE(has("tag"));
+    EXPECT_FALSE(has("never"));
+}
+
+TEST(RuleMatcherTest, EvaluatesOnlyPlausibleRules) {
+    // Many rules that the candidate cannot match, one of each kind that it can
+    nlohmann::json rules = nlohmann::json::array();
+    for (int i = 0; i < 10000; i++) {
+        std::string name = "server-" + std::to_string(i);
+        nlohmann::json match;
+        switch (i % 3) {
+            case 0: match = {{"command_contains", name}}; break;
+            case 1: match = {{"port", 20000 + i}}; break;
+            case 2: match = {{"has_evidence_type", name}}; break;
+        }
+        rules.push_back({{"name", name}, {"match", match},
+                         {"action", {{"add_evidence", {{"type", name}}}}}});
+    }
+    rules.push_back({{"name", "literal"}, {"match", {{"command_contains", "mcp-weather"}}},
+                     {"action", {{"add_evidence", {{"type", "weather"}}}}}});
+    rules.push_back({{"name", "chained"}, {"match", {{"has_evidence_type", "weather"}}},
+                     {"action", {{"add_tag", "chained"}}}});
+    rules.push_back({{"name", "port"}, {"match", {{"port", 8080}}},
+                     {"action", {{"add_evidence", {{"type", "port_8080"}}}}}});
+    rules.push_back({{"name", "regex"}, {"match", {{"command_regex", "weather$"}}},
+                     {"action", {{"add_evidence", {{"type", "regex_hit"}}}}}});
+
+    std::vector<Rulepack> rulepacks{Rulepack::load_from_json({{"name", "many"}, {"rules", rules}})};
+    RuleMatcher matcher(rulepacks);
+    ASSERT_EQ(matcher.rule_count(), 10004u);
+
+    Candidate candidate = create_test_candidate("node", 100);
+    candidate.command = "npx mcp-weather";
+    candidate.port = 8080;
+    EXPECT_EQ(matcher.apply(candidate), 4u);
+
+    Candidate interpreted = create_test_candidate("node", 100);
+    interpreted.command = "npx mcp-weather";
+    interpreted.port = 8080;
+    rulepacks[0].apply(interpreted);
+    ASSERT_EQ(candidate.evidence.size(), interpreted.evidence.size());
+    for (size_t i = 0; i < candidate.evidence.size(); i++) {
+        EXPECT_EQ(candidate.evidence[i].type, interpreted.evidence[i].type);
+    }
+    EXPECT_EQ(candidate.evidence.size(), 4u);
+}
+
+// ============================================================================
+// Compiled Rulepack Tests
+// ============================================================================
+
+TEST(CompiledRulepackTest, RoundTripsShippedRulepacks) {
+    std::vector<std::string> paths = {"../config/rulepacks/default.json",
+                                      "../config/rulepacks/docker-mcp.json",
+                                      "../config/rulepacks/exclusions.json"};
+    std::string data = compile_rulepack_files(paths);
+    ASSERT_TRUE(is_compiled_rulepack(data));
+
+    auto compiled = load_compiled_rulepacks(data);
+    ASSERT_EQ(compiled.rulepacks.size(), paths.size());
+    std::vector<Rulepack> json;
+    for (const auto& path : paths) {
+        json.push_back(Rulepack::load_from_file(path));
+    }
+    for (size_t i = 0; i < json.size(); i++) {
+        EXPECT_EQ(compiled.rulepacks[i].name, json[i].name);
+        EXPECT_EQ(compiled.rulepacks[i].rules.size(), json[i].rules.size());
+        EXPECT_EQ(compiled.rulepacks[i].environment_prefixes, json[i].environment_prefixes);
+    }
+    ASSERT_TRUE(compiled.matcher);
+
+    // The loaded tables match like a matcher built from the JSON
+    RuleMatcher built(json);
+    for (const char* command : {"npx -y @modelcontextprotocol/server-filesystem /tmp",
+                                "docker run -i --rm mcp/fetch",
+                                "/usr/share/code/code --type=renderer",
+                                "python -m mcp_server_git"}) {
+        Candidate loaded = create_test_candidate("node", 100);
+        loaded.command = command;
+        Candidate expected = loaded;
+        compiled.matcher->apply(loaded);
+        built.apply(expected);
+        ASSERT_EQ(loaded.evidence.size(), expected.evidence.size()) << command;
+        for (size_t i = 0; i < loaded.evidence.size(); i++) {
+            EXPECT_EQ(loaded.evidence[i].type, expected.evidence[i].type);
+        }
+        EXPECT_DOUBLE_EQ(loaded.confidence_score, expected.confidence_score);
+    }
+}
+
+TEST(CompiledRulepackTest, RejectsDamagedFiles) {
+    std::string data = compile_rulepack_files({"../config/rulepacks/default.json"});
+
+    EXPECT_THROW(load_compiled_rulepacks("{\"rules\": []}"), std::runtime_error);
+
+    std::string other_version = data;
+    other_version[8] = 2;
+    EXPECT_THROW(load_compiled_rulepacks(other_version), std::runtime_error);
+
+    // Every truncation fails cleanly rather than reading past the end
+    for (size_t size = 0; size < data.size(); size += 97) {
+        EXPECT_THROW(load_compiled_rulepacks(data.substr(0, size)), std::runtime_error) << size;
+    }
+    EXPECT_THROW(load_compiled_rulepacks(data + "x"), std::runtime_error);
+}
+
+TEST(CompiledRulepackTest, EngineLoadsCompiledFiles) {
+    TempFile json(R"({"name": "p", "rules": [{"name": "r", "match": {"process_name": "node"},
+                      "action": {"add_tag": "seen"}}]})");
+    TempFile compiled(compile_rulepack_files({json.path(), json.path()}));
+
+    RuleEngine engine;
+    engine.load_rulepack(compiled.path());
+    auto loaded = engine.snapshot();
+    ASSERT_EQ(loaded->rulepacks.size(), 2u);
+    EXPECT_EQ(loaded->paths[0], compiled.path());
+    EXPECT_EQ(loaded->paths[1], compiled.path());
+
+    // Reloading reads the compiled file once, with whatever it holds now
+    compiled.write(compile_rulepack_files({json.path()}));
+    engine.reload();
+    EXPECT_EQ(engine.snapshot()->rulepacks.size(), 1u);
+
+    Candidate candidate = create_test_candidate("node", 100);
+    engine.apply(candidate);
+    EXPECT_EQ(candidate.evidence.size(), 1u);
+}
+
+TEST(CompiledRulepackTest, EmbeddedRulepacksLoad) {
+    if (embedded_rulepacks().empty()) {
+        GTEST_SKIP() << "Built without KYROS_EMBED_RULEPACKS";
+    }
+    RuleEngine engine;
+    engine.load_compiled(embedded_rulepacks());
+    auto embedded = engine.snapshot();
+    ASSERT_EQ(embedded->rulepacks.size(), 2u);
+    EXPECT_EQ(embedded->rulepacks[0].name,
+              Rulepack::load_from_file("../config/rulepacks/default.json").name);
+    EXPECT_EQ(embedded->rulepacks[1].name,
+              Rulepack::load_from_file("../config/rulepacks/exclusions.json").name);
+}
+
 // ============================================================================
 // JSON Loading Tests (Structure only - actual file I/O tested separately)
 // ============================================================================
@@ -6,9 +6,26 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 #include <kyros/scanner.hpp>
+#include <kyros/rulepack.hpp>
+#include <kyros/rulepack_binary.hpp>
 #include <kyros/testing/server_interrogator.hpp>
+#include <kyros/testing/mcp_session.hpp>
+#include <kyros/probe_cache.hpp>
+#include <kyros/latency_tracker.hpp>
 #include <kyros/mcp_server.hpp>
+#include <kyros/utils/parallel.hpp>
 #include <nlohmann/json.hpp>
+#include "mock_platform_adapter.hpp"
+#ifdef PLATFORM_LINUX
+#include <kyros/platform/linux/inotify_watcher.hpp>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <thread>
 
 using ::testing::ElementsAre;
 using ::testing::SizeIs;
@@ -345,6 +362,143 @@ TEST_F(ServerInterrogatorTest, ServerCapabilityHelpers) {
     EXPECT_FALSE(server.has_tools());
 }
 
+// ============================================================================
+// Session Reuse Tests
+// ============================================================================
+
+namespace {
+
+// Answers list requests in-process and records what it was sent
+class FakeMcpSession : public kyros::McpSession {
+public:
+    FakeMcpSession() : McpSession("2024-11-05", nlohmann::json::object()) {}
+
+    bool is_open() const override { return open_; }
+    void close() override { open_ = false; }
+    void set_max_message_bytes(size_t) override {}
+
+    std::vector<std::string> methods;
+
+    // tools/list pages, each of page_size tools after "echo"
+    int tool_pages = 1;
+    int page_size = 1;
+
+protected:
+    nlohmann::json exchange(const nlohmann::json& request, std::chrono::milliseconds) override {
+        methods.push_back(request["method"]);
+        nlohmann::json result = nlohmann::json::object();
+        if (request["method"] == "tools/list") {
+            int page = std::stoi(request["params"].value("cursor", "0"));
+            result["tools"] = nlohmann::json::array();
+            for (int i = 0; i < page_size; i++) {
+                std::string name = page == 0 && i == 0
+                                       ? "echo"
+                                       : "tool" + std::to_string(page) + "." + std::to_string(i);
+                result["tools"].push_back({{"name", name}});
+            }
+            if (page + 1 < tool_pages) {
+                result["nextCursor"] = std::to_string(page + 1);
+            }
+        }
+        // Through the capped parser, as a real transport would
+        nlohmann::json response = {{"jsonrpc", "2.0"}, {"id", request["id"]}, {"result", result}};
+        return parse_message(response.dump());
+    }
+
+    void notify(const nlohmann::json& notification, std::chrono::milliseconds) override {
+        methods.push_back(notification["method"]);
+    }
+
+private:
+    bool open_ = true;
+};
+
+} // namespace
+
+TEST_F(ServerInterrogatorTest, ReusesConfirmingSession) {
+    auto adapter = std::make_shared<::testing::StrictMock<kyros::test::MockPlatformAdapter>>();
+    EXPECT_CALL(*adapter, spawn_process_with_pipes(::testing::_, ::testing::_)).Times(0);
+
+    kyros::MCPServer server;
+    server.transport_type = kyros::TransportType::Stdio;
+    server.candidate.command = "node server.js";
+    server.capabilities = nlohmann::json{{"tools", nlohmann::json::object()}};
+    auto session = std::make_shared<FakeMcpSession>();
+    server.session = session;
+
+    config.get_resources = false;
+    config.get_resource_templates = false;
+    config.get_prompts = false;
+    kyros::ServerInterrogator interrogator(config, adapter, nullptr);
+    interrogator.interrogate(server);
+
+    EXPECT_TRUE(server.interrogation_successful);
+    ASSERT_EQ(server.tools.size(), 1);
+    EXPECT_EQ(server.tools[0].name, "echo");
+
+    // The handshake is completed once, then the session is released
+    EXPECT_EQ(session->methods,
+              (std::vector<std::string>{"notifications/initialized", "tools/list"}));
+    EXPECT_FALSE(session->is_open());
+    EXPECT_EQ(server.session, nullptr);
+}
+
+TEST_F(ServerInterrogatorTest, FollowsCursorsUpToTheLimit) {
+    kyros::MCPServer server;
+    server.transport_type = kyros::TransportType::Stdio;
+    server.capabilities = nlohmann::json{{"tools", nlohmann::json::object()}};
+    auto session = std::make_shared<FakeMcpSession>();
+    session->tool_pages = 100;
+    session->page_size = 3;
+    server.session = session;
+
+    config.max_tools = 7;
+    kyros::ServerInterrogator interrogator(config, nullptr, nullptr);
+    interrogator.interrogate(server);
+
+    // Three pages of three, the last cut to the one tool still allowed
+    EXPECT_TRUE(server.interrogation_successful);
+    ASSERT_EQ(server.tools.size(), 7);
+    EXPECT_EQ(server.tools[0].name, "echo");
+    EXPECT_EQ(server.tools[6].name, "tool2.0");
+    EXPECT_EQ(std::count(session->methods.begin(), session->methods.end(), "tools/list"), 3);
+}
+
+TEST_F(ServerInterrogatorTest, StopsAtMaxPages) {
+    kyros::MCPServer server;
+    server.transport_type = kyros::TransportType::Stdio;
+    server.capabilities = nlohmann::json{{"tools", nlohmann::json::object()}};
+    auto session = std::make_shared<FakeMcpSession>();
+    session->tool_pages = 100;
+    server.session = session;
+
+    config.max_pages = 4;
+    kyros::ServerInterrogator interrogator(config, nullptr, nullptr);
+    interrogator.interrogate(server);
+
+    EXPECT_EQ(server.tools.size(), 4);
+}
+
+TEST(CappedParseTest, SkipsResultEntriesPastTheCap) {
+    std::string text = R"([{"jsonrpc":"2.0","id":1,"result":{"tools":[{"name":"a"},{"name":"b",)"
+                       R"("inputSchema":{"tools":[1,2,3]}},{"name":"c"}],"nextCursor":"x"}},)"
+                       R"({"jsonrpc":"2.0","id":2,"result":{"prompts":[1,[2],{"p":3}]}}])";
+
+    auto message = kyros::parse_capped_message(text, {{"tools", 2}, {"prompts", 0}});
+    ASSERT_TRUE(message.is_array());
+    ASSERT_EQ(message[0]["result"]["tools"].size(), 2u);
+    EXPECT_EQ(message[0]["result"]["tools"][1]["name"], "b");
+    // Only arrays directly inside a result are capped
+    EXPECT_EQ(message[0]["result"]["tools"][1]["inputSchema"]["tools"].size(), 3u);
+    EXPECT_EQ(message[0]["result"]["nextCursor"], "x");
+    EXPECT_EQ(message[0]["id"], 1);
+    EXPECT_TRUE(message[1]["result"]["prompts"].empty());
+
+    // Uncapped, it matches the DOM parser
+    EXPECT_EQ(kyros::parse_capped_message(text, {}), nlohmann::json::parse(text));
+    EXPECT_TRUE(kyros::parse_capped_message("{\"id\":", {}).is_discarded());
+}
+
 // ============================================================================
 // InterrogationConfig Tests
 // ============================================================================
@@ -360,6 +514,7 @@ TEST(InterrogationConfigTest, DefaultValues) {
     EXPECT_EQ(config.max_tools, 100);
     EXPECT_EQ(config.max_resources, 100);
     EXPECT_EQ(config.max_prompts, 50);
+    EXPECT_EQ(config.max_pages, 10);
     EXPECT_EQ(config.timeout.count(), 5000);
 }
 
@@ -379,3 +534,755 @@ TEST(ScannerTest, BasicConfiguration) {
     // Should not crash
     SUCCEED();
 }
+
+// ============================================================================
+// Parallel Execution Tests
+// ============================================================================
+
+TEST(ParallelForTest, RunsEveryIndexOnce) {
+    std::vector<std::atomic<int>> hits(100);
+    kyros::parallel_for(hits.size(), 4, [&](size_t i) { hits[i]++; });
+
+    for (const auto& hit : hits) {
+        EXPECT_EQ(hit.load(), 1);
+    }
+}
+
+TEST(ParallelForTest, RethrowsLowestFailingIndexAfterAllItems) {
+    std::atomic<int> completed{0};
+    try {
+        kyros::parallel_for(8, 3, [&](size_t i) {
+            if (i == 5 || i == 2) {
+                throw std::runtime_error("item " + std::to_string(i));
+            }
+            completed++;
+        });
+        FAIL() << "expected an exception";
+    } catch (const std::runtime_error& e) {
+        EXPECT_STREQ(e.what(), "item 2");
+    }
+    EXPECT_EQ(completed.load(), 6);
+}
+
+TEST(PassiveScannerTest, DefaultRulepacksOnDiskOverrideEmbeddedOnes) {
+    namespace fs = std::filesystem;
+    fs::path root = fs::temp_directory_path() / ("kyros_defaults_" + std::to_string(getpid()));
+    fs::create_directories(root / "work" / "config" / "rulepacks");
+    std::ofstream(root / "work" / "config" / "rulepacks" / "default.json")
+        << nlohmann::json{{"name", "edited-default"}, {"rules", nlohmann::json::array()}};
+
+    auto cwd = fs::current_path();
+    fs::current_path(root / "work");
+    kyros::PassiveScanner scanner;
+    fs::current_path(cwd);
+
+    // The edited default is loaded from its file, so it can be reloaded;
+    // exclusions, found nowhere, come from the embedded copy if any
+    auto rules = scanner.rule_engine().snapshot();
+    ASSERT_FALSE(rules->rulepacks.empty());
+    EXPECT_EQ(rules->rulepacks[0].name, "edited-default");
+    EXPECT_FALSE(rules->paths[0].empty());
+    if (!kyros::embedded_rulepacks().empty()) {
+        ASSERT_EQ(rules->rulepacks.size(), 2u);
+        EXPECT_TRUE(rules->paths[1].empty());
+    } else {
+        EXPECT_EQ(rules->rulepacks.size(), 1u);
+    }
+
+    fs::remove_all(root);
+}
+
+TEST(PassiveScannerTest, ParallelEnginesMergeInEngineOrder) {
+    auto adapter = std::make_shared<::testing::NiceMock<kyros::test::MockPlatformAdapter>>();
+    adapter->set_process_list({100, 200});
+    ON_CALL(*adapter, get_process_name(100)).WillByDefault(::testing::Return("Claude"));
+    ON_CALL(*adapter, get_process_name(200)).WillByDefault(::testing::Return("node"));
+    ON_CALL(*adapter, get_command_line(200)).WillByDefault(::testing::Return("node server.js"));
+    ON_CALL(*adapter, get_parent_pid(200)).WillByDefault(::testing::Return(100));
+
+    kyros::PassiveScanConfig config;
+    auto summarize = [](const kyros::PassiveScanResults& results) {
+        std::vector<std::string> keys;
+        for (const auto& c : results.candidates) {
+            keys.push_back(std::to_string(c.pid) + ":" + c.config_file + ":" + c.url);
+        }
+        return keys;
+    };
+
+    kyros::PassiveScanner sequential;
+    sequential.set_platform_adapter(adapter);
+    config.parallel_engines = false;
+    auto expected = summarize(sequential.scan(config));
+
+    kyros::PassiveScanner parallel;
+    parallel.set_platform_adapter(adapter);
+    config.parallel_engines = true;
+    for (int run = 0; run < 3; run++) {
+        EXPECT_EQ(summarize(parallel.scan(config)), expected);
+    }
+}
+
+#ifdef PLATFORM_LINUX
+TEST(PassiveScannerTest, WatchRulepacksReloadsOnChange) {
+    namespace fs = std::filesystem;
+    fs::path root = fs::temp_directory_path() / ("kyros_rules_" + std::to_string(getpid()));
+    fs::remove_all(root);
+    fs::create_directories(root);
+    std::string path = (root / "custom.json").string();
+    auto write = [&](const std::string& name) {
+        std::ofstream(path + ".tmp") << nlohmann::json{{"name", name}, {"rules", nlohmann::json::array()}};
+        fs::rename(path + ".tmp", path);  // As editors and config tools do
+    };
+    write("v1");
+
+    struct WatchingAdapter : ::testing::NiceMock<kyros::test::MockPlatformAdapter> {
+        std::unique_ptr<kyros::FileWatcher> create_file_watcher() override {
+            return std::make_unique<kyros::InotifyWatcher>();
+        }
+    };
+    kyros::PassiveScanner scanner;
+    scanner.set_platform_adapter(std::make_shared<WatchingAdapter>());
+    scanner.load_rulepack(path);
+
+    kyros::PassiveScanConfig config;
+    config.watch_rulepacks = true;
+    scanner.scan(config);
+    auto before = scanner.rule_engine().snapshot();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));  // Let the watch settle
+
+    write("v2");
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (scanner.rule_engine().snapshot() == before && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    auto after = scanner.rule_engine().snapshot();
+    ASSERT_NE(after, before);
+    EXPECT_EQ(after->rulepacks.back().name, "v2");
+    EXPECT_EQ(before->rulepacks.back().name, "v1");  // Still intact for its holders
+
+    // Removing the directory ends its watch; it is watched again once it
+    // is back, and the rulepack written meanwhile is picked up
+    fs::remove_all(root);
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    fs::create_directories(root);
+    write("v3");
+    deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (scanner.rule_engine().snapshot()->rulepacks.back().name != "v3" &&
+           std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(scanner.rule_engine().snapshot()->rulepacks.back().name, "v3");
+
+    fs::remove_all(root);
+}
+#endif // PLATFORM_LINUX
+
+TEST(PassiveScannerTest, WatchRulepacksIdlesWhenNothingCanBeWatched) {
+    // Fails every watch and reports an overflow without blocking, as a
+    // watcher without its kernel object would
+    struct BrokenWatcher : kyros::FileWatcher {
+        std::atomic<int>& polls;
+        explicit BrokenWatcher(std::atomic<int>& polls) : polls(polls) {}
+        bool watch_directory(const std::string&) override { return false; }
+        bool poll(std::vector<std::string>&, int) override {
+            polls++;
+            return false;
+        }
+    };
+    struct BrokenAdapter : ::testing::NiceMock<kyros::test::MockPlatformAdapter> {
+        std::atomic<int> polls{0};
+        std::unique_ptr<kyros::FileWatcher> create_file_watcher() override {
+            return std::make_unique<BrokenWatcher>(polls);
+        }
+    };
+    auto adapter = std::make_shared<BrokenAdapter>();
+
+    auto path = std::filesystem::temp_directory_path() /
+                ("kyros_idle_rules_" + std::to_string(getpid()) + ".json");
+    std::ofstream(path) << nlohmann::json{{"name", "idle"}, {"rules", nlohmann::json::array()}};
+
+    kyros::PassiveScanner scanner;
+    scanner.set_platform_adapter(adapter);
+    scanner.load_rulepack(path.string());
+    kyros::PassiveScanConfig config;
+    config.watch_rulepacks = true;
+    scanner.scan(config);
+    auto generation = scanner.rule_engine().snapshot()->generation;
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    EXPECT_EQ(adapter->polls.load(), 0);
+    EXPECT_EQ(scanner.rule_engine().snapshot()->generation, generation);
+
+    std::filesystem::remove(path);
+}
+
+TEST(PassiveScannerTest, WaitForConfigChangesSitsOutTheTimeoutWithoutAWatch) {
+    kyros::PassiveScanner scanner;
+    scanner.set_platform_adapter(
+        std::make_shared<::testing::NiceMock<kyros::test::MockPlatformAdapter>>());
+    kyros::PassiveScanConfig config;
+    config.watch_configs = true;  // No FileWatcher from the mock: nothing is watched
+    scanner.scan(config);
+
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_FALSE(scanner.wait_for_config_changes(100));
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(100));
+}
+
+// Stdio server that answers initialize after a fixed delay
+class DelayedMcpProcess : public kyros::Process {
+public:
+    DelayedMcpProcess(std::chrono::milliseconds delay, std::atomic<int>& active, std::atomic<int>& peak)
+        : delay_(delay), active_(active), peak_(peak) {}
+
+    void write_stdin(const std::string&) override {}
+
+    std::string read_stdout_line(std::chrono::milliseconds) override {
+        int now = ++active_;
+        int previous = peak_.load();
+        while (now > previous && !peak_.compare_exchange_weak(previous, now)) {}
+        std::this_thread::sleep_for(delay_);
+        --active_;
+        return R"({"jsonrpc":"2.0","id":1,"result":{"protocolVersion":"2024-11-05"}})";
+    }
+
+    std::string read_stderr_line(std::chrono::milliseconds) override { return ""; }
+    void terminate() override { running_ = false; }
+    bool is_running() const override { return running_; }
+    int exit_code() const override { return 0; }
+
+private:
+    std::chrono::milliseconds delay_;
+    std::atomic<int>& active_;
+    std::atomic<int>& peak_;
+    bool running_ = true;
+};
+
+TEST(ActiveScannerTest, ProbesConcurrentlyAndReportsInCandidateOrder) {
+    auto adapter = std::make_shared<::testing::NiceMock<kyros::test::MockPlatformAdapter>>();
+    std::atomic<int> active{0};
+    std::atomic<int> peak{0};
+    ON_CALL(*adapter, spawn_process_with_pipes(::testing::_, ::testing::_))
+        .WillByDefault([&](const std::string&, const std::vector<std::string>&) {
+            return std::unique_ptr<kyros::Process>(
+                new DelayedMcpProcess(std::chrono::milliseconds(100), active, peak));
+        });
+
+    std::vector<kyros::Candidate> candidates;
+    for (int i = 0; i < 8; i++) {
+        kyros::Candidate candidate;
+        candidate.pid = 1000 + i;
+        candidate.command = "server-" + std::to_string(i);
+        candidate.transport_hint = kyros::TransportType::Stdio;
+        candidates.push_back(candidate);
+    }
+
+    kyros::ActiveScanConfig config;
+    config.max_parallel_probes = 4;
+
+    kyros::ActiveScanner scanner;
+    scanner.set_platform_adapter(adapter);
+    auto results = scanner.scan(candidates, config);
+
+    ASSERT_EQ(results.confirmed_servers.size(), 8u);
+    for (int i = 0; i < 8; i++) {
+        EXPECT_EQ(results.confirmed_servers[i].candidate.pid, 1000 + i);
+    }
+    EXPECT_GT(peak.load(), 1);
+    EXPECT_LE(peak.load(), 4);
+}
+
+// ============================================================================
+// Probe Cache Tests
+// ============================================================================
+
+TEST(ProbeCacheTest, FingerprintTracksExecutableAndListener) {
+    auto executable = std::filesystem::temp_directory_path() /
+                      ("kyros-fingerprint-" + std::to_string(getpid()));
+    std::ofstream(executable) << "#!/bin/sh\n";
+
+    kyros::Candidate stdio;
+    stdio.argv = {executable.string(), "--stdio"};
+    stdio.command = executable.string() + "   --stdio";
+    auto before = kyros::ProbeCache::fingerprint(stdio, 0);
+
+    // Spacing does not matter, a rebuilt executable does
+    stdio.argv.clear();
+    EXPECT_EQ(kyros::ProbeCache::fingerprint(stdio, 0), before);
+    std::filesystem::last_write_time(
+        executable, std::filesystem::last_write_time(executable) + std::chrono::seconds(5));
+    EXPECT_NE(kyros::ProbeCache::fingerprint(stdio, 0), before);
+    std::filesystem::remove(executable);
+
+    // Empty arguments are arguments
+    kyros::Candidate spaced;
+    spaced.argv = {"server", "--prefix", "", "x"};
+    kyros::Candidate unspaced;
+    unspaced.argv = {"server", "--prefix", "x"};
+    EXPECT_NE(kyros::ProbeCache::fingerprint(spaced, 0),
+              kyros::ProbeCache::fingerprint(unspaced, 0));
+
+    // A running process' relative argv[0] is not looked up in our cwd
+    kyros::Candidate relative;
+    relative.argv = {"./kyros-no-such-server"};
+    EXPECT_EQ(kyros::ProbeCache::fingerprint(relative, 0).rfind("stdio - ", 0), 0u);
+    relative.pid = getpid();
+    EXPECT_NE(kyros::ProbeCache::fingerprint(relative, 0).rfind("stdio - ", 0), 0u);
+
+    kyros::Candidate http;
+    http.url = "http://127.0.0.1:3000";
+    EXPECT_NE(kyros::ProbeCache::fingerprint(http, 100), kyros::ProbeCache::fingerprint(http, 200));
+    // Without an owner, the URL alone says nothing about what answers it
+    EXPECT_TRUE(kyros::ProbeCache::fingerprint(http, 0).empty());
+    EXPECT_TRUE(kyros::ProbeCache::fingerprint(kyros::Candidate{}, 0).empty());
+}
+
+TEST(ProbeCacheTest, EntriesExpireByKind) {
+    auto path = std::filesystem::temp_directory_path() /
+                ("kyros-cache-" + std::to_string(getpid()) + "/probe-cache.json");
+    auto now = std::chrono::system_clock::now();
+
+    kyros::MCPServer server;
+    server.server_name = "cached";
+    server.capabilities = nlohmann::json{{"tools", nlohmann::json::object()}};
+    server.tools.push_back({"echo", "Echoes", nlohmann::json::object(), {"text"}, {}});
+
+    kyros::ProbeCache cache(path.string(), std::chrono::seconds(3600), std::chrono::seconds(60));
+    cache.store_confirmed("a", server, true, now);
+    cache.store_failure("b", "no response", now);
+    ASSERT_TRUE(cache.save());
+
+    kyros::ProbeCache loaded(path.string(), std::chrono::seconds(3600), std::chrono::seconds(60));
+    loaded.load();
+    ASSERT_EQ(loaded.size(), 2u);
+    const auto* confirmed = loaded.find("a", now + std::chrono::seconds(120));
+    ASSERT_NE(confirmed, nullptr);
+    EXPECT_TRUE(confirmed->interrogated);
+    EXPECT_EQ(confirmed->server->server_name, "cached");
+    ASSERT_EQ(confirmed->server->tools.size(), 1u);
+    EXPECT_EQ(confirmed->server->tools[0].required_parameters, std::vector<std::string>{"text"});
+
+    // Failures are retried sooner than confirmed servers
+    EXPECT_NE(loaded.find("b", now + std::chrono::seconds(30)), nullptr);
+    EXPECT_EQ(loaded.find("b", now + std::chrono::seconds(120)), nullptr);
+    EXPECT_EQ(loaded.find("a", now + std::chrono::hours(2)), nullptr);
+
+    std::filesystem::remove_all(path.parent_path());
+}
+
+TEST(ActiveScannerTest, ReusesCachedOutcomesUnlessRefreshed) {
+    auto adapter = std::make_shared<::testing::NiceMock<kyros::test::MockPlatformAdapter>>();
+    std::atomic<int> active{0};
+    std::atomic<int> peak{0};
+    std::atomic<int> spawns{0};
+    ON_CALL(*adapter, spawn_process_with_pipes(::testing::_, ::testing::_))
+        .WillByDefault([&](const std::string& command, const std::vector<std::string>&) {
+            spawns++;
+            if (command == "broken-server") {
+                return std::unique_ptr<kyros::Process>();
+            }
+            return std::unique_ptr<kyros::Process>(
+                new DelayedMcpProcess(std::chrono::milliseconds(1), active, peak));
+        });
+
+    std::vector<kyros::Candidate> candidates(2);
+    candidates[0].pid = 1000;
+    candidates[0].command = "good-server";
+    candidates[1].pid = 1001;
+    candidates[1].command = "broken-server";
+    for (auto& candidate : candidates) {
+        candidate.transport_hint = kyros::TransportType::Stdio;
+    }
+
+    auto dir = std::filesystem::temp_directory_path() /
+               ("kyros-scan-cache-" + std::to_string(getpid()));
+    kyros::ActiveScanConfig config;
+    config.probe_cache_path = (dir / "probe-cache.json").string();
+
+    auto scan = [&]() {
+        kyros::ActiveScanner scanner;
+        scanner.set_platform_adapter(adapter);
+        return scanner.scan(candidates, config);
+    };
+
+    auto first = scan();
+    EXPECT_EQ(first.confirmed_servers.size(), 1u);
+    EXPECT_EQ(first.cached_results_count, 0);
+    int probed = spawns.load();
+    EXPECT_GE(probed, 2);
+
+    // Neither the confirmed server nor the failure is probed again
+    auto second = scan();
+    EXPECT_EQ(spawns.load(), probed);
+    EXPECT_EQ(second.cached_results_count, 2);
+    ASSERT_EQ(second.confirmed_servers.size(), 1u);
+    EXPECT_EQ(second.confirmed_servers[0].candidate.pid, 1000);
+    EXPECT_EQ(second.failed_tests.size(), 1u);
+
+    config.refresh_probe_cache = true;
+    auto third = scan();
+    EXPECT_EQ(spawns.load(), 2 * probed);
+    EXPECT_EQ(third.cached_results_count, 0);
+
+    // Refreshing some targets keeps the entries of the others
+    auto all = candidates;
+    candidates.resize(1);
+    scan();
+    candidates = all;
+    config.refresh_probe_cache = false;
+    auto fourth = scan();
+    EXPECT_EQ(fourth.cached_results_count, 2);
+
+    std::filesystem::remove_all(dir);
+}
+
+// Owner of the listeners below, with a start time so that their outcomes
+// can be cached
+class ListenerOwnerAdapter : public kyros::test::MockPlatformAdapter {
+public:
+    std::shared_ptr<const kyros::ProcessTable> snapshot_processes() override {
+        auto table = std::make_shared<kyros::ProcessTable>();
+        table->add(4242, 1, 0, 12345, "listener", {"listener"});
+        return table;
+    }
+};
+
+TEST(ActiveScannerTest, ReportsPreflightFailuresAndSkipsCachedTargets) {
+    auto adapter = std::make_shared<::testing::NiceMock<ListenerOwnerAdapter>>();
+
+    std::vector<kyros::Candidate> candidates(1);
+    candidates[0].pid = 4242;
+    candidates[0].port = 5353;
+    candidates[0].url = "http://127.0.0.1:5353";
+    candidates[0].socket_protocol = "udp";
+    candidates[0].transport_hint = kyros::TransportType::Http;
+
+    auto dir = std::filesystem::temp_directory_path() /
+               ("kyros-preflight-cache-" + std::to_string(getpid()));
+    kyros::ActiveScanConfig config;
+    config.probe_cache_path = (dir / "probe-cache.json").string();
+    config.adaptive_timeouts = false;
+
+    auto scan = [&]() {
+        kyros::ActiveScanner scanner;
+        scanner.set_platform_adapter(adapter);
+        return scanner.scan(candidates, config);
+    };
+
+    // Dropped, but still tested and failed, with the preflight's reason
+    auto first = scan();
+    EXPECT_EQ(first.preflight_filtered_count, 1);
+    EXPECT_EQ(first.candidates_tested_count, 1);
+    EXPECT_EQ(first.tests_failed_count, 1);
+    ASSERT_EQ(first.failed_tests.size(), 1u);
+    ASSERT_EQ(first.errors.size(), 1u);
+    EXPECT_NE(first.errors[0].find("Preflight: UDP listener"), std::string::npos);
+
+    // A cached outcome is not checked again
+    auto second = scan();
+    EXPECT_EQ(second.preflight_filtered_count, 0);
+    EXPECT_EQ(second.cached_results_count, 1);
+    ASSERT_EQ(second.errors.size(), 1u);
+    EXPECT_EQ(second.errors[0], first.errors[0]);
+
+    std::filesystem::remove_all(dir);
+}
+
+// ============================================================================
+// Adaptive Deadline Tests
+// ============================================================================
+
+TEST(LatencyTrackerTest, DeadlinesFollowEndpointHistory) {
+    using std::chrono::milliseconds;
+    auto now = std::chrono::system_clock::now();
+
+    kyros::Candidate known;
+    known.url = "http://127.0.0.1:3000";
+    kyros::Candidate unknown;
+    unknown.url = "http://127.0.0.1:4000";
+    kyros::Candidate stdio;
+    stdio.command = "npx -y @modelcontextprotocol/server-memory";
+
+    kyros::LatencyTracker::DeadlinePolicy policy;
+    policy.floor = milliseconds(50);
+    policy.ceiling = milliseconds(5000);
+    policy.headroom = 2.0;
+    policy.min_transport_samples = 10;
+
+    kyros::LatencyTracker tracker;
+    EXPECT_EQ(tracker.deadline(known, policy), milliseconds(5000));
+    EXPECT_EQ(tracker.hedge_point(known, policy), milliseconds(0));
+
+    for (int i = 0; i < 9; i++) {
+        tracker.record(known, milliseconds(40), now);
+    }
+    // 40 ms falls in the (32, 46] ms bucket
+    EXPECT_EQ(tracker.deadline(known, policy), milliseconds(92));
+    EXPECT_EQ(tracker.hedge_point(known, policy), milliseconds(46));
+
+    // An endpoint without answers gets the ceiling whatever its transport
+    // has seen, and no hedge
+    tracker.record(known, milliseconds(1), now);
+    EXPECT_EQ(tracker.deadline(unknown, policy), milliseconds(5000));
+    EXPECT_EQ(tracker.hedge_point(unknown, policy), milliseconds(0));
+
+    // Timeouts are counted apart from latencies: each one in a streak
+    // halves the deadline of an endpoint that never answered, but not
+    // below what the transport p99 gives, and every eighth gets the
+    // ceiling again
+    std::vector<milliseconds> deadlines;
+    for (int i = 0; i < 9; i++) {
+        tracker.record_timeout(unknown, now);
+        deadlines.push_back(tracker.deadline(unknown, policy));
+    }
+    EXPECT_EQ(deadlines, (std::vector<milliseconds>{
+        milliseconds(2500), milliseconds(1250), milliseconds(625), milliseconds(312),
+        milliseconds(156), milliseconds(92), milliseconds(92), milliseconds(5000),
+        milliseconds(2500)}));
+    EXPECT_EQ(tracker.timeout_streak(unknown), 9u);
+    EXPECT_EQ(tracker.hedge_point(unknown, policy), milliseconds(0));
+
+    // Without enough transport samples to bound it, it is not shortened
+    for (int i = 0; i < 3; i++) {
+        tracker.record_timeout(stdio, now);
+    }
+    EXPECT_EQ(tracker.deadline(stdio, policy), milliseconds(5000));
+
+    // An endpoint that answered before gets more time for each timeout,
+    // with the hedge point kept as far behind, and starts over once it
+    // timed out at the ceiling too
+    deadlines.clear();
+    std::vector<milliseconds> hedges;
+    for (int i = 0; i < 7; i++) {
+        tracker.record_timeout(known, now);
+        deadlines.push_back(tracker.deadline(known, policy));
+        hedges.push_back(tracker.hedge_point(known, policy));
+    }
+    EXPECT_EQ(deadlines, (std::vector<milliseconds>{
+        milliseconds(184), milliseconds(368), milliseconds(736), milliseconds(1472),
+        milliseconds(2944), milliseconds(5000), milliseconds(92)}));
+    EXPECT_EQ(hedges, (std::vector<milliseconds>{
+        milliseconds(92), milliseconds(184), milliseconds(368), milliseconds(736),
+        milliseconds(1472), milliseconds(2500), milliseconds(46)}));
+
+    // An answer ends the streak; the transport p99 lengthens the deadline
+    tracker.record(unknown, milliseconds(1), now);
+    EXPECT_EQ(tracker.timeout_streak(unknown), 0u);
+    EXPECT_EQ(tracker.deadline(unknown, policy), milliseconds(92));
+
+    // Clamped, and transports do not mix
+    policy.headroom = 1000.0;
+    EXPECT_EQ(tracker.deadline(known, policy), milliseconds(5000));
+    EXPECT_EQ(tracker.hedge_point(known, policy), milliseconds(46));
+    tracker.record(stdio, milliseconds(3000), now);
+    EXPECT_EQ(tracker.deadline(stdio, policy), milliseconds(5000));
+    EXPECT_EQ(tracker.hedge_point(stdio, policy), milliseconds(4096));
+    EXPECT_EQ(kyros::LatencyTracker::transport_key(stdio), "stdio");
+}
+
+TEST(LatencyTrackerTest, HistoryPersistsAndDecays) {
+    auto path = std::filesystem::temp_directory_path() /
+                ("kyros-latency-" + std::to_string(getpid()) + "/probe-latency.json");
+    auto now = std::chrono::system_clock::now();
+
+    kyros::Candidate candidate;
+    candidate.url = "http://127.0.0.1:3000";
+
+    kyros::LatencyTracker tracker(path.string());
+    for (uint32_t i = 0; i < kyros::LatencyTracker::kMaxSamples - 1; i++) {
+        tracker.record(candidate, std::chrono::milliseconds(1000), now);
+    }
+    kyros::Candidate silent;
+    silent.url = "http://127.0.0.1:4000";
+    tracker.record_timeout(silent, now);
+    ASSERT_TRUE(tracker.save());
+
+    kyros::LatencyTracker loaded(path.string());
+    loaded.load();
+    EXPECT_EQ(loaded.timeout_streak(silent), 1u);
+    ASSERT_NE(loaded.endpoint(candidate), nullptr);
+    EXPECT_EQ(loaded.endpoint(candidate)->count(), kyros::LatencyTracker::kMaxSamples - 1);
+
+    // Reaching the cap halves the old samples, so new ones take over
+    for (int i = 0; i < 200; i++) {
+        loaded.record(candidate, std::chrono::milliseconds(2), now);
+    }
+    EXPECT_LT(loaded.endpoint(candidate)->count(), kyros::LatencyTracker::kMaxSamples);
+    EXPECT_EQ(loaded.endpoint(candidate)->percentile(0.5), std::chrono::milliseconds(2));
+
+    std::filesystem::remove_all(path.parent_path());
+}
+
+// Stdio server that answers after `delay`, or stays silent past the
+// caller's timeout
+class SlowMcpProcess : public kyros::Process {
+public:
+    explicit SlowMcpProcess(std::chrono::milliseconds delay) : delay_(delay) {}
+
+    void write_stdin(const std::string&) override {}
+
+    std::string read_stdout_line(std::chrono::milliseconds timeout) override {
+        if (delay_ > timeout) {
+            std::this_thread::sleep_for(timeout);
+            return "";
+        }
+        std::this_thread::sleep_for(delay_);
+        return R"({"jsonrpc":"2.0","id":1,"result":{"protocolVersion":"2024-11-05"}})";
+    }
+
+    std::string read_stderr_line(std::chrono::milliseconds) override { return ""; }
+    void terminate() override { running_ = false; }
+    bool is_running() const override { return running_; }
+    int exit_code() const override { return 0; }
+
+private:
+    std::chrono::milliseconds delay_;
+    bool running_ = true;
+};
+
+TEST(ActiveScannerTest, GivesSlowedDownServersMoreTimeAfterEachTimeout) {
+    auto adapter = std::make_shared<::testing::NiceMock<kyros::test::MockPlatformAdapter>>();
+    std::atomic<int> delay_ms{5};
+    std::atomic<int> spawns{0};
+    ON_CALL(*adapter, spawn_process_with_pipes(::testing::_, ::testing::_))
+        .WillByDefault([&](const std::string&, const std::vector<std::string>&) {
+            spawns++;
+            return std::unique_ptr<kyros::Process>(
+                new SlowMcpProcess(std::chrono::milliseconds(delay_ms.load())));
+        });
+
+    std::vector<kyros::Candidate> candidates(1);
+    candidates[0].pid = 1000;
+    candidates[0].command = "usually-fast-server";
+    candidates[0].transport_hint = kyros::TransportType::Stdio;
+
+    kyros::ActiveScanConfig config;
+    config.probe_timeout_ms = 2000;
+    config.min_probe_timeout_ms = 50;
+
+    kyros::ActiveScanner scanner;
+    scanner.set_platform_adapter(adapter);
+    auto first = scanner.scan(candidates, config);
+    ASSERT_EQ(first.confirmed_servers.size(), 1u);
+
+    // Now slower than its learned 50 ms deadline: each timeout doubles it
+    // (100, 200, then 400 ms) until the answer fits again. Stdio probes
+    // are never sent twice.
+    delay_ms = 300;
+    spawns = 0;
+    std::vector<size_t> confirmed;
+    for (int scan = 0; scan < 4; scan++) {
+        auto results = scanner.scan(candidates, config);
+        confirmed.push_back(results.confirmed_servers.size());
+        EXPECT_EQ(results.hedged_probes_count, 0);
+        EXPECT_LT(results.scan_duration_seconds, 1.0);
+    }
+    EXPECT_EQ(confirmed, (std::vector<size_t>{0, 0, 0, 1}));
+    EXPECT_EQ(spawns.load(), 4);
+}
+
+TEST(ActiveScannerTest, ConfirmsASlowServerAfterATimeout) {
+    auto adapter = std::make_shared<::testing::NiceMock<kyros::test::MockPlatformAdapter>>();
+    std::atomic<int> delay_ms{60 * 60 * 1000};
+    ON_CALL(*adapter, spawn_process_with_pipes(::testing::_, ::testing::_))
+        .WillByDefault([&](const std::string&, const std::vector<std::string>&) {
+            return std::unique_ptr<kyros::Process>(
+                new SlowMcpProcess(std::chrono::milliseconds(delay_ms.load())));
+        });
+
+    std::vector<kyros::Candidate> candidates(1);
+    candidates[0].pid = 1000;
+    candidates[0].command = "cold-npx-server";
+    candidates[0].transport_hint = kyros::TransportType::Stdio;
+
+    kyros::ActiveScanConfig config;
+    config.probe_timeout_ms = 400;
+    config.min_probe_timeout_ms = 50;
+    kyros::ActiveScanner scanner;
+    scanner.set_platform_adapter(adapter);
+    EXPECT_EQ(scanner.scan(candidates, config).confirmed_servers.size(), 0u);
+
+    // Without transport history to bound it, a timeout does not cut the
+    // next deadline short of an answer that takes most of the timeout
+    delay_ms = 300;
+    EXPECT_EQ(scanner.scan(candidates, config).confirmed_servers.size(), 1u);
+}
+
+TEST(ActiveScannerTest, ShortensScansOfEndpointsThatKeepTimingOut) {
+    auto adapter = std::make_shared<::testing::NiceMock<kyros::test::MockPlatformAdapter>>();
+    ON_CALL(*adapter, spawn_process_with_pipes(::testing::_, ::testing::_))
+        .WillByDefault([&](const std::string& command, const std::vector<std::string>&) {
+            auto delay = command == "silent-server" ? std::chrono::hours(1)
+                                                    : std::chrono::milliseconds(5);
+            return std::unique_ptr<kyros::Process>(
+                new SlowMcpProcess(std::chrono::duration_cast<std::chrono::milliseconds>(delay)));
+        });
+
+    // Enough fast servers for the transport's p99 to bound the deadline
+    std::vector<kyros::Candidate> candidates(11);
+    candidates[0].command = "silent-server";
+    for (size_t i = 0; i < candidates.size(); i++) {
+        candidates[i].pid = 1000 + static_cast<int>(i);
+        if (i > 0) {
+            candidates[i].command = "fast-server-" + std::to_string(i);
+        }
+        candidates[i].transport_hint = kyros::TransportType::Stdio;
+    }
+
+    kyros::ActiveScanConfig config;
+    config.probe_timeout_ms = 800;
+    config.min_probe_timeout_ms = 50;
+    kyros::ActiveScanner scanner;
+    scanner.set_platform_adapter(adapter);
+
+    // Each timeout halves the silent server's next deadline, and with it
+    // the whole scan, which waits on nothing else
+    std::vector<double> durations;
+    for (int scan = 0; scan < 4; scan++) {
+        auto results = scanner.scan(candidates, config);
+        ASSERT_EQ(results.confirmed_servers.size(), 10u);
+        EXPECT_EQ(results.failed_tests.size(), 1u);
+        durations.push_back(results.scan_duration_seconds);
+    }
+    EXPECT_GE(durations[0], 0.75);
+    EXPECT_LT(durations[1], 0.6);
+    EXPECT_LT(durations[3], 0.3);
+
+    // Without adaptive deadlines every scan waits out the full timeout
+    config.adaptive_timeouts = false;
+    EXPECT_GE(scanner.scan(candidates, config).scan_duration_seconds, 0.75);
+}
+
+TEST(ActiveScannerTest, GivesNewServersTheFullTimeout) {
+    auto adapter = std::make_shared<::testing::NiceMock<kyros::test::MockPlatformAdapter>>();
+    ON_CALL(*adapter, spawn_process_with_pipes(::testing::_, ::testing::_))
+        .WillByDefault([&](const std::string& command, const std::vector<std::string>&) {
+            auto delay = std::chrono::milliseconds(command == "cold-npx-server" ? 300 : 5);
+            return std::unique_ptr<kyros::Process>(new SlowMcpProcess(delay));
+        });
+
+    // Plenty of fast stdio history from other servers
+    std::vector<kyros::Candidate> fast(12);
+    for (size_t i = 0; i < fast.size(); i++) {
+        fast[i].pid = 1000 + static_cast<int>(i);
+        fast[i].command = "fast-server-" + std::to_string(i);
+        fast[i].transport_hint = kyros::TransportType::Stdio;
+    }
+    kyros::ActiveScanConfig config;
+    config.probe_timeout_ms = 2000;
+    config.min_probe_timeout_ms = 50;
+    kyros::ActiveScanner scanner;
+    scanner.set_platform_adapter(adapter);
+    ASSERT_EQ(scanner.scan(fast, config).confirmed_servers.size(), fast.size());
+
+    // A slow, low-confidence server seen for the first time is not cut
+    // short by the transport's history
+    std::vector<kyros::Candidate> cold(1);
+    cold[0].pid = 2000;
+    cold[0].command = "cold-npx-server";
+    cold[0].transport_hint = kyros::TransportType::Stdio;
+    cold[0].confidence_score = 0.1;
+    auto results = scanner.scan(cold, config);
+    ASSERT_EQ(results.confirmed_servers.size(), 1u);
+    EXPECT_EQ(results.hedged_probes_count, 0);
+}